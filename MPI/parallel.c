@@ -8,53 +8,121 @@
 #define TOTAL_POINTS 100000000
 #endif
 
+/* Mix a base seed with a rank so neighbouring ranks get decorrelated rand_r streams */
+static unsigned int stream_seed(unsigned int base, int rank) {
+    unsigned long long z = ((unsigned long long)base << 32) + (unsigned long long)rank + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (unsigned int)(z ^ (z >> 32));
+}
+
 int main(int argc, char *argv[]) {
     int rank, size;
+    int group_rank, group_size;
+    int num_groups = 1;
     long points_per_process;
     long local_circle_count = 0;
-    long total_circle_count = 0;
+    long group_circle_count = 0;
     double start_time, end_time;
-    
+    MPI_Comm group_comm;
+
     MPI_Init(&argc, &argv);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
-    
-    points_per_process = TOTAL_POINTS / size;
-    
+
+    // Optional ensemble size: number of independent estimates per launch
+    if (argc >= 2) {
+        num_groups = atoi(argv[1]);
+        if (num_groups < 1 || num_groups > size) {
+            if (rank == 0) {
+                printf("Usage: %s [ensemble_size]  (1 <= ensemble_size <= %d processes)\n", argv[0], size);
+            }
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    // Split the world into contiguous groups, one estimate per group
+    int color = (int)((long)rank * num_groups / size);
+    MPI_Comm_split(MPI_COMM_WORLD, color, rank, &group_comm);
+    MPI_Comm_rank(group_comm, &group_rank);
+    MPI_Comm_size(group_comm, &group_size);
+
+    points_per_process = TOTAL_POINTS / group_size;
+
+    // All ranks derive their stream from one base seed chosen by the master
+    unsigned int base_seed = (unsigned int)time(NULL);
+    MPI_Bcast(&base_seed, 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+
     // Master process
     if (rank == 0) {
         start_time = MPI_Wtime();
         printf("Starting parallel calculation with %d processes\n", size);
+        if (num_groups > 1) {
+            printf("Ensemble groups: %d\n", num_groups);
+        }
         printf("Points per process: %ld\n", points_per_process);
     }
-    
+
     // Each process calculates its portion
-    unsigned int seed = time(NULL) + rank;
+    unsigned int seed = stream_seed(base_seed, rank);
     for (long i = 0; i < points_per_process; i++) {
         double x = (double)rand_r(&seed) / RAND_MAX;
         double y = (double)rand_r(&seed) / RAND_MAX;
-        
+
         if (x * x + y * y <= 1.0) {
             local_circle_count++;
         }
     }
-    
-    // Reduce all local counts to master
-    MPI_Reduce(&local_circle_count, &total_circle_count, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
-    
+
+    // Reduce local counts to each group's root
+    MPI_Reduce(&local_circle_count, &group_circle_count, 1, MPI_LONG, MPI_SUM, 0, group_comm);
+
+    // Group roots contribute their estimate; everyone else contributes nothing
+    double group_estimate = 0.0;
+    if (group_rank == 0) {
+        group_estimate = 4.0 * (double)group_circle_count / (points_per_process * group_size);
+    }
+
+    double estimate_sum = 0.0;
+    MPI_Allreduce(&group_estimate, &estimate_sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    double ensemble_mean = estimate_sum / num_groups;
+
+    double sq_dev = (group_rank == 0) ? (group_estimate - ensemble_mean) * (group_estimate - ensemble_mean) : 0.0;
+    double sq_dev_sum = 0.0;
+    MPI_Reduce(&sq_dev, &sq_dev_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
     // Master calculates and displays results
     if (rank == 0) {
-        double pi_estimate = 4.0 * (double)total_circle_count / TOTAL_POINTS;
         end_time = MPI_Wtime();
-        
+
         printf("\nParallel Version Results:\n");
-        printf("Estimated Pi: %.10f\n", pi_estimate);
+        printf("Estimated Pi: %.10f\n", ensemble_mean);
         printf("Execution Time: %.6f seconds\n", end_time - start_time);
-        printf("Total Points: %d\n", TOTAL_POINTS);
-        printf("Points in Circle: %ld\n", total_circle_count);
+        // Every group samples TOTAL_POINTS, so an ensemble does num_groups times the work
+        printf("Total Points: %lld\n", (long long)num_groups * TOTAL_POINTS);
+        if (num_groups > 1) {
+            printf("Points per Estimate: %lld\n", (long long)TOTAL_POINTS);
+        }
+        if (num_groups == 1) {
+            printf("Points in Circle: %ld\n", group_circle_count);
+        }
         printf("Number of Processes: %d\n", size);
+
+        if (num_groups > 1) {
+            double variance = sq_dev_sum / (num_groups - 1);
+            printf("\nEnsemble Statistics:\n");
+            printf("Ensemble Size: %d\n", num_groups);
+            printf("Processes per Estimate: %d-%d\n", size / num_groups, (size + num_groups - 1) / num_groups);
+            printf("Ensemble Variance: %.6e\n", variance);
+            printf("Ensemble Std Dev: %.6e\n", sqrt(variance));
+            printf("Standard Error: %.6e\n", sqrt(variance / num_groups));
+            printf("Absolute Error: %.6e\n", fabs(ensemble_mean - M_PI));
+        }
     }
-    
+
+    MPI_Comm_free(&group_comm);
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,263 @@
+#!/usr/bin/env python3
+"""
+Scaling model fitter for MPI Pi estimation benchmarks.
+Fits Amdahl/Gustafson style models with fixed overheads to the timings stored in
+results/*.json, predicts runtime for unseen sizes and process counts, and
+recommends the -np that minimizes wall time or core-seconds for a workload.
+
+Model (per program, all coefficients non-negative):
+  sequential:        T(N)    = t0 + w*N
+  parallel/spawned:  T(N, p) = t0 + s*N + w*N/p + c*p
+
+  t0 - fixed overhead inside the timed region
+  s  - serial work per point (Amdahl serial fraction = s / (s + w))
+  w  - parallelizable work per point
+  c  - per-process overhead (spawning workers, reduction)
+
+T is the program's own "Execution Time", an MPI_Wtime interval that starts
+after MPI_Init, so mpirun launch and MPI_Init are not part of any term.
+Core-seconds charge a spawned run for its master as well as its p workers.
+"""
+
+import argparse
+import json
+import math
+import sys
+from pathlib import Path
+
+# Configuration
+RESULTS_DIR = "results"
+PROGRAMS = ['sequential', 'parallel', 'spawned']
+TERMS = {
+    'sequential': ['t0', 'w'],
+    'parallel': ['t0', 's', 'w', 'c'],
+    'spawned': ['t0', 's', 'w', 'c'],
+}
+
+def load_samples(results_files):
+    """Collect (program, total_points, workers, time) samples from results files."""
+    samples = {program: [] for program in PROGRAMS}
+
+    for results_file in results_files:
+        with open(results_file, 'r') as f:
+            results = json.load(f)
+
+        for total_points, seq_time in results.get('sequential', {}).items():
+            samples['sequential'].append((int(total_points), 1, float(seq_time)))
+
+        for program in ('parallel', 'spawned'):
+            for total_points, by_workers in results.get(program, {}).items():
+                for workers, exe_time in by_workers.items():
+                    samples[program].append((int(total_points), int(workers), float(exe_time)))
+
+    return samples
+
+def features(program, total_points, workers):
+    """Regressor row for one configuration, in the order of TERMS[program]."""
+    if program == 'sequential':
+        return [1.0, float(total_points)]
+    return [1.0, float(total_points), float(total_points) / workers, float(workers)]
+
+def solve_linear(a, b):
+    """Solve a small dense system a*x = b by Gaussian elimination with partial pivoting."""
+    n = len(b)
+    m = [row[:] + [b[i]] for i, row in enumerate(a)]
+
+    for k in range(n):
+        pivot = max(range(k, n), key=lambda i: abs(m[i][k]))
+        if abs(m[pivot][k]) < 1e-300:
+            return None
+        m[k], m[pivot] = m[pivot], m[k]
+        for i in range(k + 1, n):
+            factor = m[i][k] / m[k][k]
+            for j in range(k, n + 1):
+                m[i][j] -= factor * m[k][j]
+
+    x = [0.0] * n
+    for k in range(n - 1, -1, -1):
+        x[k] = (m[k][n] - sum(m[k][j] * x[j] for j in range(k + 1, n))) / m[k][k]
+    return x
+
+def least_squares(rows, targets, active):
+    """Weighted least squares restricted to the active columns (relative-error weighting)."""
+    cols = [j for j in range(len(rows[0])) if active[j]]
+    # Scale columns so N-sized regressors do not swamp the constant term
+    scale = [max(abs(r[j]) for r in rows) or 1.0 for j in cols]
+
+    ata = [[0.0] * len(cols) for _ in cols]
+    atb = [0.0] * len(cols)
+    for row, t in zip(rows, targets):
+        weight = 1.0 / (t * t)
+        x = [row[j] / scale[k] for k, j in enumerate(cols)]
+        for p in range(len(cols)):
+            atb[p] += weight * x[p] * t
+            for q in range(len(cols)):
+                ata[p][q] += weight * x[p] * x[q]
+
+    solution = solve_linear(ata, atb)
+    coeffs = [0.0] * len(rows[0])
+    if solution is None:
+        return None
+    for k, j in enumerate(cols):
+        coeffs[j] = solution[k] / scale[k]
+    return coeffs
+
+def fit_program(program, samples):
+    """Fit non-negative model coefficients by dropping negative terms and refitting."""
+    rows = [features(program, n, p) for n, p, _ in samples]
+    targets = [t for _, _, t in samples]
+    active = [True] * len(TERMS[program])
+
+    while True:
+        if sum(active) == 0 or len(samples) < sum(active):
+            return None
+        coeffs = least_squares(rows, targets, active)
+        if coeffs is None:
+            return None
+        negative = [j for j in range(len(coeffs)) if active[j] and coeffs[j] < 0]
+        if not negative:
+            break
+        active[min(negative, key=lambda j: coeffs[j])] = False
+
+    predictions = [sum(c * x for c, x in zip(coeffs, row)) for row in rows]
+    errors = [abs(pred - t) / t for pred, t in zip(predictions, targets)]
+    return {
+        'coefficients': dict(zip(TERMS[program], coeffs)),
+        'samples': len(samples),
+        'mean_abs_pct_error': 100.0 * sum(errors) / len(errors),
+        'max_abs_pct_error': 100.0 * max(errors),
+    }
+
+def predict(program, model, total_points, workers):
+    """Predicted runtime in seconds."""
+    coeffs = [model['coefficients'][term] for term in TERMS[program]]
+    return sum(c * x for c, x in zip(coeffs, features(program, total_points, workers)))
+
+def amdahl_serial_fraction(program, model, total_points):
+    """Fraction of single-process runtime at this size that does not shrink with p."""
+    if program == 'sequential':
+        return 1.0
+    coeffs = model['coefficients']
+    single = predict(program, model, total_points, 1)
+    parallel_part = coeffs['w'] * total_points
+    return 1.0 - parallel_part / single if single > 0 else 1.0
+
+def recommend(program, model, total_points, max_np, objective, deadline=None):
+    """Rank candidate process counts for a workload; returns (best_np, table)."""
+    table = []
+    for workers in range(1, max_np + 1):
+        exe_time = predict(program, model, total_points, workers)
+        # spawned runs its master alongside the workers it spawns
+        processes = workers + 1 if program == 'spawned' else workers
+        table.append((workers, exe_time, exe_time * processes))
+
+    candidates = table
+    if deadline is not None:
+        candidates = [row for row in table if row[1] <= deadline]
+        if not candidates:
+            return None, table
+
+    key = (lambda row: row[1]) if objective == 'time' else (lambda row: row[2])
+    return min(candidates, key=key)[0], table
+
+def print_model(program, model, total_points):
+    """Print fitted coefficients and derived Amdahl/Gustafson metrics."""
+    coeffs = model['coefficients']
+    print(f"\n{program.capitalize()} model ({model['samples']} samples, "
+          f"mean error {model['mean_abs_pct_error']:.1f}%, max error {model['max_abs_pct_error']:.1f}%)")
+    print("-" * 80)
+    print(f"  Fixed overhead t0:          {coeffs['t0']:.6f} s")
+    if program == 'sequential':
+        print(f"  Work per point w:           {coeffs['w'] * 1e9:.4f} ns")
+        return
+
+    print(f"  Serial work per point s:    {coeffs['s'] * 1e9:.4f} ns")
+    print(f"  Parallel work per point w:  {coeffs['w'] * 1e9:.4f} ns")
+    print(f"  Per-process overhead c:     {coeffs['c'] * 1e3:.4f} ms")
+
+    fraction = amdahl_serial_fraction(program, model, total_points)
+    print(f"  Amdahl serial fraction at N={total_points:,}: {fraction:.4f}"
+          + (f" (max speedup {1.0 / fraction:.1f}x)" if fraction > 0 else " (no serial bound)"))
+    if coeffs['c'] > 0:
+        best_p = math.sqrt(coeffs['w'] * total_points / coeffs['c'])
+        print(f"  Time-optimal process count at N={total_points:,}: {best_p:.1f} (unconstrained)")
+
+    # Gustafson: serial share of a p-process run when the problem grows with p
+    for workers in (2, 4, 8, 16):
+        scaled_points = total_points * workers
+        run = predict(program, model, scaled_points, workers)
+        serial = run - coeffs['w'] * scaled_points / workers
+        scaled_speedup = (serial + coeffs['w'] * scaled_points) / run
+        print(f"  Gustafson scaled speedup p={workers:<2d}: {scaled_speedup:.2f}x")
+
+def main():
+    parser = argparse.ArgumentParser(description="Fit scaling models to MPI benchmark results and recommend -np.")
+    parser.add_argument('results', nargs='*', help=f"results files (default: all {RESULTS_DIR}/benchmark_*.json)")
+    parser.add_argument('--points', type=int, default=100000000, help="workload size (total points) to plan for")
+    parser.add_argument('--max-np', type=int, default=16, help="largest process count to consider")
+    parser.add_argument('--objective', choices=['time', 'core-seconds'], default='time',
+                        help="minimize wall time or total core-seconds")
+    parser.add_argument('--deadline', type=float, help="only consider process counts finishing within this many seconds")
+    parser.add_argument('--program', choices=PROGRAMS, action='append', help="restrict to a program (repeatable)")
+    parser.add_argument('--json', action='store_true', help="print models and recommendations as JSON")
+    args = parser.parse_args()
+
+    results_files = args.results or sorted(str(p) for p in Path(RESULTS_DIR).glob("benchmark_*.json"))
+    if not results_files:
+        print(f"ERROR: No benchmark results found in {RESULTS_DIR}/. Run 'python3 benchmark.py' first.")
+        sys.exit(1)
+
+    samples = load_samples(results_files)
+    programs = args.program or PROGRAMS
+    report = {'results_files': results_files, 'points': args.points, 'objective': args.objective, 'programs': {}}
+
+    for program in programs:
+        model = fit_program(program, samples[program])
+        if model is None:
+            print(f"WARNING: Not enough data to fit the {program} model")
+            continue
+
+        max_np = 1 if program == 'sequential' else args.max_np
+        best_np, table = recommend(program, model, args.points, max_np, args.objective, args.deadline)
+        report['programs'][program] = {
+            'model': model,
+            'serial_fraction': amdahl_serial_fraction(program, model, args.points),
+            'recommended_np': best_np,
+            'predictions': [{'np': w, 'time': t, 'core_seconds': cs} for w, t, cs in table],
+        }
+
+    if args.json:
+        print(json.dumps(report, indent=2))
+        return
+
+    print("\n" + "="*80)
+    print("MPI Pi Estimation - Scaling Model")
+    print("="*80)
+    print(f"Results files: {', '.join(results_files)}")
+    print(f"Workload: {args.points:,} points, objective: {args.objective}"
+          + (f", deadline: {args.deadline:.3f}s" if args.deadline is not None else ""))
+
+    for program, entry in report['programs'].items():
+        print_model(program, entry['model'], args.points)
+        print(f"\n  {'np':<6} {'Predicted (s)':<15} {'Core-seconds':<15}")
+        for row in entry['predictions']:
+            marker = "  <-- recommended" if row['np'] == entry['recommended_np'] else ""
+            print(f"  {row['np']:<6} {row['time']:<15.6f} {row['core_seconds']:<15.6f}{marker}")
+        if entry['recommended_np'] is None:
+            print("  No process count meets the deadline")
+
+    print("\n" + "="*80)
+    for program, entry in report['programs'].items():
+        best_np = entry['recommended_np']
+        if best_np is None:
+            continue
+        if program == 'sequential':
+            print(f"  {program:<12} ./bin/sequential")
+        elif program == 'parallel':
+            print(f"  {program:<12} mpirun -np {best_np} ./bin/parallel")
+        else:
+            print(f"  {program:<12} mpirun -np 1 ./bin/spawned {best_np}")
+    print("="*80 + "\n")
+
+if __name__ == "__main__":
+    main()
@@ -38,6 +38,499 @@ struct matrix_result {
 };
 typedef struct matrix_result matrix_result;
 
+struct matrix32 {
+	int rows;
+	int cols;
+	struct {
+		u_int data_len;
+		float *data_val;
+	} data;
+};
+typedef struct matrix32 matrix32;
+
+struct matrix32_pair {
+	matrix32 first;
+	matrix32 second;
+};
+typedef struct matrix32_pair matrix32_pair;
+
+struct matrix32_result {
+	int success;
+	char *error_msg;
+	matrix32 result_matrix;
+};
+typedef struct matrix32_result matrix32_result;
+
+struct lu_result {
+	int success;
+	char *error_msg;
+	matrix lu;
+	struct {
+		u_int pivots_len;
+		int *pivots_val;
+	} pivots;
+};
+typedef struct lu_result lu_result;
+
+struct det_result {
+	int success;
+	char *error_msg;
+	double determinant;
+};
+typedef struct det_result det_result;
+
+struct cache_stats {
+	u_quad_t hits;
+	u_quad_t misses;
+	u_quad_t evictions;
+	u_quad_t entries;
+	u_quad_t bytes;
+	u_quad_t budget;
+};
+typedef struct cache_stats cache_stats;
+#define MAX_TILE 65536
+#define MAX_STAGE_DIM 8192
+
+enum matrix_op {
+	OP_ADD = 1,
+	OP_MULT = 2,
+	OP_INVERSE = 3,
+	OP_TRANSPOSE = 4,
+	OP_STORE = 5,
+	OP_SOLVE = 6,
+	OP_MULT32 = 7,
+	OP_SOLVE_MIXED = 8,
+	OP_LSTSQ = 9,
+};
+typedef enum matrix_op matrix_op;
+
+struct stage_request {
+	matrix_op op;
+	int first_rows;
+	int first_cols;
+	int second_rows;
+	int second_cols;
+};
+typedef struct stage_request stage_request;
+
+struct stage_tile {
+	int session;
+	int operand;
+	int row;
+	int col;
+	int rows;
+	int cols;
+	struct {
+		u_int data_len;
+		double *data_val;
+	} data;
+};
+typedef struct stage_tile stage_tile;
+
+struct stage_range {
+	int session;
+	int row;
+	int rows;
+};
+typedef struct stage_range stage_range;
+
+struct stage_status {
+	int success;
+	char *error_msg;
+	int session;
+	int rows;
+	int cols;
+};
+typedef struct stage_status stage_status;
+
+struct stage_rows {
+	int success;
+	char *error_msg;
+	int row;
+	int rows;
+	int cols;
+	struct {
+		u_int data_len;
+		double *data_val;
+	} data;
+};
+typedef struct stage_rows stage_rows;
+
+struct stage_tile32 {
+	int session;
+	int operand;
+	int row;
+	int col;
+	int rows;
+	int cols;
+	struct {
+		u_int data_len;
+		float *data_val;
+	} data;
+};
+typedef struct stage_tile32 stage_tile32;
+
+struct stage_rows32 {
+	int success;
+	char *error_msg;
+	int row;
+	int rows;
+	int cols;
+	struct {
+		u_int data_len;
+		float *data_val;
+	} data;
+};
+typedef struct stage_rows32 stage_rows32;
+
+struct handle_op {
+	matrix_op op;
+	int first;
+	int second;
+};
+typedef struct handle_op handle_op;
+
+struct handle_range {
+	int handle;
+	int row;
+	int rows;
+};
+typedef struct handle_range handle_range;
+
+struct handle_result {
+	int success;
+	char *error_msg;
+	int handle;
+	int rows;
+	int cols;
+};
+typedef struct handle_result handle_result;
+#define MAX_EXPR_OPERANDS 8
+#define MAX_EXPR_NODES 32
+
+enum expr_kind {
+	EXPR_OPERAND = 1,
+	EXPR_HANDLE = 2,
+	EXPR_ADD = 3,
+	EXPR_MULT = 4,
+	EXPR_TRANSPOSE = 5,
+	EXPR_INVERSE = 6,
+};
+typedef enum expr_kind expr_kind;
+
+struct expr_node {
+	expr_kind kind;
+	int arg;
+	int left;
+	int right;
+};
+typedef struct expr_node expr_node;
+
+struct expr_request {
+	struct {
+		u_int operands_len;
+		matrix *operands_val;
+	} operands;
+	struct {
+		u_int nodes_len;
+		expr_node *nodes_val;
+	} nodes;
+	int keep;
+};
+typedef struct expr_request expr_request;
+
+struct expr_result {
+	int success;
+	char *error_msg;
+	int handle;
+	matrix result_matrix;
+};
+typedef struct expr_result expr_result;
+#define MAX_SPARSE_DIM 1048576
+#define MAX_ROW_PTR 1048577
+#define MAX_NNZ 1048576
+
+struct csr_matrix {
+	int rows;
+	int cols;
+	struct {
+		u_int row_ptr_len;
+		int *row_ptr_val;
+	} row_ptr;
+	struct {
+		u_int col_idx_len;
+		int *col_idx_val;
+	} col_idx;
+	struct {
+		u_int values_len;
+		double *values_val;
+	} values;
+};
+typedef struct csr_matrix csr_matrix;
+
+struct csr_pair {
+	csr_matrix first;
+	csr_matrix second;
+};
+typedef struct csr_pair csr_pair;
+
+struct csr_result {
+	int success;
+	char *error_msg;
+	csr_matrix result;
+};
+typedef struct csr_result csr_result;
+
+struct sparse_vector {
+	csr_matrix a;
+	struct {
+		u_int x_len;
+		double *x_val;
+	} x;
+};
+typedef struct sparse_vector sparse_vector;
+
+struct vector_result {
+	int success;
+	char *error_msg;
+	struct {
+		u_int y_len;
+		double *y_val;
+	} y;
+};
+typedef struct vector_result vector_result;
+
+struct sparse_dense_op {
+	csr_matrix a;
+	int handle;
+};
+typedef struct sparse_dense_op sparse_dense_op;
+#define MAX_KRYLOV_ITER 10000
+#define MAX_KRYLOV_HISTORY 10001
+#define MAX_KRYLOV_RESTART 200
+
+enum krylov_precond {
+	PRECOND_NONE = 0,
+	PRECOND_JACOBI = 1,
+	PRECOND_ILU0 = 2,
+};
+typedef enum krylov_precond krylov_precond;
+
+struct krylov_request {
+	int handle;
+	csr_matrix sparse;
+	struct {
+		u_int b_len;
+		double *b_val;
+	} b;
+	struct {
+		u_int x0_len;
+		double *x0_val;
+	} x0;
+	double tol;
+	int max_iter;
+	krylov_precond precond;
+	int restart;
+};
+typedef struct krylov_request krylov_request;
+
+struct krylov_result {
+	int success;
+	char *error_msg;
+	int converged;
+	int iterations;
+	struct {
+		u_int x_len;
+		double *x_val;
+	} x;
+	struct {
+		u_int residuals_len;
+		double *residuals_val;
+	} residuals;
+};
+typedef struct krylov_result krylov_result;
+
+struct qr_result {
+	int success;
+	char *error_msg;
+	matrix q;
+	matrix r;
+};
+typedef struct qr_result qr_result;
+
+struct qr_handles {
+	int success;
+	char *error_msg;
+	int q;
+	int r;
+	int rows;
+	int cols;
+	int k;
+};
+typedef struct qr_handles qr_handles;
+#define MAX_TILE_BYTES 524288
+
+enum byte_order {
+	ORDER_LITTLE_ENDIAN = 0,
+	ORDER_BIG_ENDIAN = 1,
+};
+typedef enum byte_order byte_order;
+
+struct stage_tile_raw {
+	int session;
+	int operand;
+	int row;
+	int col;
+	int rows;
+	int cols;
+	byte_order order;
+	struct {
+		u_int data_len;
+		char *data_val;
+	} data;
+};
+typedef struct stage_tile_raw stage_tile_raw;
+
+struct stage_rows_raw {
+	int success;
+	char *error_msg;
+	int row;
+	int rows;
+	int cols;
+	byte_order order;
+	struct {
+		u_int data_len;
+		char *data_val;
+	} data;
+};
+typedef struct stage_rows_raw stage_rows_raw;
+#define COMPRESS_MIN_BYTES 16384
+
+enum payload_codec {
+	CODEC_NONE = 0,
+	CODEC_SHUFFLE_DEFLATE = 1,
+};
+typedef enum payload_codec payload_codec;
+
+struct stage_tile_packed {
+	int session;
+	int operand;
+	int row;
+	int col;
+	int rows;
+	int cols;
+	byte_order order;
+	payload_codec codec;
+	struct {
+		u_int data_len;
+		char *data_val;
+	} data;
+};
+typedef struct stage_tile_packed stage_tile_packed;
+
+struct packed_range {
+	int id;
+	int row;
+	int rows;
+	payload_codec accept;
+};
+typedef struct packed_range packed_range;
+
+struct stage_rows_packed {
+	int success;
+	char *error_msg;
+	int row;
+	int rows;
+	int cols;
+	byte_order order;
+	payload_codec codec;
+	struct {
+		u_int data_len;
+		char *data_val;
+	} data;
+};
+typedef struct stage_rows_packed stage_rows_packed;
+#define SHM_NAME_MAX 64
+
+struct shm_attach_result {
+	int success;
+	char *error_msg;
+	int segment;
+	u_quad_t size;
+};
+typedef struct shm_attach_result shm_attach_result;
+
+struct shm_operand {
+	u_quad_t offset;
+	int rows;
+	int cols;
+};
+typedef struct shm_operand shm_operand;
+
+struct shm_request {
+	int segment;
+	matrix_op op;
+	shm_operand first;
+	shm_operand second;
+	u_quad_t out;
+};
+typedef struct shm_request shm_request;
+
+struct shm_result {
+	int success;
+	char *error_msg;
+	int rows;
+	int cols;
+};
+typedef struct shm_result shm_result;
+
+struct gemm_request {
+	int a;
+	int b;
+	int c;
+	int trans_a;
+	int trans_b;
+	double alpha;
+	double beta;
+};
+typedef struct gemm_request gemm_request;
+
+struct syrk_request {
+	int a;
+	int c;
+	int trans;
+	double alpha;
+	double beta;
+};
+typedef struct syrk_request syrk_request;
+#define STATS_BUCKETS 24
+#define MAX_STATS_PROCS 64
+
+struct proc_stats {
+	int proc;
+	char *name;
+	u_quad_t calls;
+	u_quad_t errors;
+	u_quad_t bytes_in;
+	u_quad_t bytes_out;
+	u_quad_t decode_us[STATS_BUCKETS];
+	u_quad_t compute_us[STATS_BUCKETS];
+	u_quad_t encode_us[STATS_BUCKETS];
+	u_quad_t codec_raw_bytes;
+	u_quad_t codec_packed_bytes;
+	u_quad_t codec_us;
+};
+typedef struct proc_stats proc_stats;
+
+struct server_stats {
+	u_quad_t elapsed_ms;
+	struct {
+		u_int procs_len;
+		proc_stats *procs_val;
+	} procs;
+};
+typedef struct server_stats server_stats;
+
 #define MATRIX_OPERATIONS_PROG 0x20000001
 #define MATRIX_OPERATIONS_VERS 1
 
@@ -57,6 +550,78 @@ extern  matrix_result * matrix_transpose_1_svc(matrix *, struct svc_req *);
 #define PING 5
 extern  int * ping_1(void *, CLIENT *);
 extern  int * ping_1_svc(void *, struct svc_req *);
+#define STAGE_BEGIN 6
+extern  stage_status * stage_begin_1(stage_request *, CLIENT *);
+extern  stage_status * stage_begin_1_svc(stage_request *, struct svc_req *);
+#define STAGE_APPEND 7
+extern  stage_status * stage_append_1(stage_tile *, CLIENT *);
+extern  stage_status * stage_append_1_svc(stage_tile *, struct svc_req *);
+#define STAGE_COMMIT 8
+extern  stage_status * stage_commit_1(int *, CLIENT *);
+extern  stage_status * stage_commit_1_svc(int *, struct svc_req *);
+#define STAGE_READ 9
+extern  stage_rows * stage_read_1(stage_range *, CLIENT *);
+extern  stage_rows * stage_read_1_svc(stage_range *, struct svc_req *);
+#define STAGE_END 10
+extern  int * stage_end_1(int *, CLIENT *);
+extern  int * stage_end_1_svc(int *, struct svc_req *);
+#define STORE_PUT 11
+extern  handle_result * store_put_1(matrix *, CLIENT *);
+extern  handle_result * store_put_1_svc(matrix *, struct svc_req *);
+#define STORE_ADOPT 12
+extern  handle_result * store_adopt_1(int *, CLIENT *);
+extern  handle_result * store_adopt_1_svc(int *, struct svc_req *);
+#define STORE_APPLY 13
+extern  handle_result * store_apply_1(handle_op *, CLIENT *);
+extern  handle_result * store_apply_1_svc(handle_op *, struct svc_req *);
+#define STORE_READ 14
+extern  stage_rows * store_read_1(handle_range *, CLIENT *);
+extern  stage_rows * store_read_1_svc(handle_range *, struct svc_req *);
+#define STORE_FREE 15
+extern  int * store_free_1(int *, CLIENT *);
+extern  int * store_free_1_svc(int *, struct svc_req *);
+#define EVALUATE 16
+extern  expr_result * evaluate_1(expr_request *, CLIENT *);
+extern  expr_result * evaluate_1_svc(expr_request *, struct svc_req *);
+#define MATRIX_LU 17
+extern  lu_result * matrix_lu_1(matrix *, CLIENT *);
+extern  lu_result * matrix_lu_1_svc(matrix *, struct svc_req *);
+#define MATRIX_SOLVE 18
+extern  matrix_result * matrix_solve_1(matrix_pair *, CLIENT *);
+extern  matrix_result * matrix_solve_1_svc(matrix_pair *, struct svc_req *);
+#define MATRIX_DET 19
+extern  det_result * matrix_det_1(matrix *, CLIENT *);
+extern  det_result * matrix_det_1_svc(matrix *, struct svc_req *);
+#define CACHE_STATS 20
+extern  cache_stats * cache_stats_1(void *, CLIENT *);
+extern  cache_stats * cache_stats_1_svc(void *, struct svc_req *);
+#define MATRIX_MULT32 21
+extern  matrix32_result * matrix_mult32_1(matrix32_pair *, CLIENT *);
+extern  matrix32_result * matrix_mult32_1_svc(matrix32_pair *, struct svc_req *);
+#define STAGE_APPEND32 22
+extern  stage_status * stage_append32_1(stage_tile32 *, CLIENT *);
+extern  stage_status * stage_append32_1_svc(stage_tile32 *, struct svc_req *);
+#define STAGE_READ32 23
+extern  stage_rows32 * stage_read32_1(stage_range *, CLIENT *);
+extern  stage_rows32 * stage_read32_1_svc(stage_range *, struct svc_req *);
+#define SPARSE_MV 24
+extern  vector_result * sparse_mv_1(sparse_vector *, CLIENT *);
+extern  vector_result * sparse_mv_1_svc(sparse_vector *, struct svc_req *);
+#define SPARSE_MULT 25
+extern  csr_result * sparse_mult_1(csr_pair *, CLIENT *);
+extern  csr_result * sparse_mult_1_svc(csr_pair *, struct svc_req *);
+#define SPARSE_TRANSPOSE 26
+extern  csr_result * sparse_transpose_1(csr_matrix *, CLIENT *);
+extern  csr_result * sparse_transpose_1_svc(csr_matrix *, struct svc_req *);
+#define SPARSE_MULT_DENSE 27
+extern  handle_result * sparse_mult_dense_1(sparse_dense_op *, CLIENT *);
+extern  handle_result * sparse_mult_dense_1_svc(sparse_dense_op *, struct svc_req *);
+#define SPARSE_FROM_DENSE 28
+extern  csr_result * sparse_from_dense_1(int *, CLIENT *);
+extern  csr_result * sparse_from_dense_1_svc(int *, struct svc_req *);
+#define SPARSE_TO_DENSE 29
+extern  handle_result * sparse_to_dense_1(csr_matrix *, CLIENT *);
+extern  handle_result * sparse_to_dense_1_svc(csr_matrix *, struct svc_req *);
 extern int matrix_operations_prog_1_freeresult (SVCXPRT *, xdrproc_t, caddr_t);
 
 #else /* K&R C */
@@ -75,8 +640,306 @@ extern  matrix_result * matrix_transpose_1_svc();
 #define PING 5
 extern  int * ping_1();
 extern  int * ping_1_svc();
+#define STAGE_BEGIN 6
+extern  stage_status * stage_begin_1();
+extern  stage_status * stage_begin_1_svc();
+#define STAGE_APPEND 7
+extern  stage_status * stage_append_1();
+extern  stage_status * stage_append_1_svc();
+#define STAGE_COMMIT 8
+extern  stage_status * stage_commit_1();
+extern  stage_status * stage_commit_1_svc();
+#define STAGE_READ 9
+extern  stage_rows * stage_read_1();
+extern  stage_rows * stage_read_1_svc();
+#define STAGE_END 10
+extern  int * stage_end_1();
+extern  int * stage_end_1_svc();
+#define STORE_PUT 11
+extern  handle_result * store_put_1();
+extern  handle_result * store_put_1_svc();
+#define STORE_ADOPT 12
+extern  handle_result * store_adopt_1();
+extern  handle_result * store_adopt_1_svc();
+#define STORE_APPLY 13
+extern  handle_result * store_apply_1();
+extern  handle_result * store_apply_1_svc();
+#define STORE_READ 14
+extern  stage_rows * store_read_1();
+extern  stage_rows * store_read_1_svc();
+#define STORE_FREE 15
+extern  int * store_free_1();
+extern  int * store_free_1_svc();
+#define EVALUATE 16
+extern  expr_result * evaluate_1();
+extern  expr_result * evaluate_1_svc();
+#define MATRIX_LU 17
+extern  lu_result * matrix_lu_1();
+extern  lu_result * matrix_lu_1_svc();
+#define MATRIX_SOLVE 18
+extern  matrix_result * matrix_solve_1();
+extern  matrix_result * matrix_solve_1_svc();
+#define MATRIX_DET 19
+extern  det_result * matrix_det_1();
+extern  det_result * matrix_det_1_svc();
+#define CACHE_STATS 20
+extern  cache_stats * cache_stats_1();
+extern  cache_stats * cache_stats_1_svc();
+#define MATRIX_MULT32 21
+extern  matrix32_result * matrix_mult32_1();
+extern  matrix32_result * matrix_mult32_1_svc();
+#define STAGE_APPEND32 22
+extern  stage_status * stage_append32_1();
+extern  stage_status * stage_append32_1_svc();
+#define STAGE_READ32 23
+extern  stage_rows32 * stage_read32_1();
+extern  stage_rows32 * stage_read32_1_svc();
+#define SPARSE_MV 24
+extern  vector_result * sparse_mv_1();
+extern  vector_result * sparse_mv_1_svc();
+#define SPARSE_MULT 25
+extern  csr_result * sparse_mult_1();
+extern  csr_result * sparse_mult_1_svc();
+#define SPARSE_TRANSPOSE 26
+extern  csr_result * sparse_transpose_1();
+extern  csr_result * sparse_transpose_1_svc();
+#define SPARSE_MULT_DENSE 27
+extern  handle_result * sparse_mult_dense_1();
+extern  handle_result * sparse_mult_dense_1_svc();
+#define SPARSE_FROM_DENSE 28
+extern  csr_result * sparse_from_dense_1();
+extern  csr_result * sparse_from_dense_1_svc();
+#define SPARSE_TO_DENSE 29
+extern  handle_result * sparse_to_dense_1();
+extern  handle_result * sparse_to_dense_1_svc();
 extern int matrix_operations_prog_1_freeresult ();
 #endif /* K&R C */
+#define MATRIX_OPERATIONS_VERS2 2
+
+#if defined(__STDC__) || defined(__cplusplus)
+extern  matrix_result * matrix_add_2(matrix_pair *, CLIENT *);
+extern  matrix_result * matrix_add_2_svc(matrix_pair *, struct svc_req *);
+extern  matrix_result * matrix_mult_2(matrix_pair *, CLIENT *);
+extern  matrix_result * matrix_mult_2_svc(matrix_pair *, struct svc_req *);
+extern  matrix_result * matrix_inverse_2(matrix *, CLIENT *);
+extern  matrix_result * matrix_inverse_2_svc(matrix *, struct svc_req *);
+extern  matrix_result * matrix_transpose_2(matrix *, CLIENT *);
+extern  matrix_result * matrix_transpose_2_svc(matrix *, struct svc_req *);
+extern  int * ping_2(void *, CLIENT *);
+extern  int * ping_2_svc(void *, struct svc_req *);
+extern  stage_status * stage_begin_2(stage_request *, CLIENT *);
+extern  stage_status * stage_begin_2_svc(stage_request *, struct svc_req *);
+extern  stage_status * stage_append_2(stage_tile *, CLIENT *);
+extern  stage_status * stage_append_2_svc(stage_tile *, struct svc_req *);
+extern  stage_status * stage_commit_2(int *, CLIENT *);
+extern  stage_status * stage_commit_2_svc(int *, struct svc_req *);
+extern  stage_rows * stage_read_2(stage_range *, CLIENT *);
+extern  stage_rows * stage_read_2_svc(stage_range *, struct svc_req *);
+extern  int * stage_end_2(int *, CLIENT *);
+extern  int * stage_end_2_svc(int *, struct svc_req *);
+extern  handle_result * store_put_2(matrix *, CLIENT *);
+extern  handle_result * store_put_2_svc(matrix *, struct svc_req *);
+extern  handle_result * store_adopt_2(int *, CLIENT *);
+extern  handle_result * store_adopt_2_svc(int *, struct svc_req *);
+extern  handle_result * store_apply_2(handle_op *, CLIENT *);
+extern  handle_result * store_apply_2_svc(handle_op *, struct svc_req *);
+extern  stage_rows * store_read_2(handle_range *, CLIENT *);
+extern  stage_rows * store_read_2_svc(handle_range *, struct svc_req *);
+extern  int * store_free_2(int *, CLIENT *);
+extern  int * store_free_2_svc(int *, struct svc_req *);
+extern  expr_result * evaluate_2(expr_request *, CLIENT *);
+extern  expr_result * evaluate_2_svc(expr_request *, struct svc_req *);
+extern  lu_result * matrix_lu_2(matrix *, CLIENT *);
+extern  lu_result * matrix_lu_2_svc(matrix *, struct svc_req *);
+extern  matrix_result * matrix_solve_2(matrix_pair *, CLIENT *);
+extern  matrix_result * matrix_solve_2_svc(matrix_pair *, struct svc_req *);
+extern  det_result * matrix_det_2(matrix *, CLIENT *);
+extern  det_result * matrix_det_2_svc(matrix *, struct svc_req *);
+extern  cache_stats * cache_stats_2(void *, CLIENT *);
+extern  cache_stats * cache_stats_2_svc(void *, struct svc_req *);
+extern  matrix32_result * matrix_mult32_2(matrix32_pair *, CLIENT *);
+extern  matrix32_result * matrix_mult32_2_svc(matrix32_pair *, struct svc_req *);
+extern  stage_status * stage_append32_2(stage_tile32 *, CLIENT *);
+extern  stage_status * stage_append32_2_svc(stage_tile32 *, struct svc_req *);
+extern  stage_rows32 * stage_read32_2(stage_range *, CLIENT *);
+extern  stage_rows32 * stage_read32_2_svc(stage_range *, struct svc_req *);
+extern  vector_result * sparse_mv_2(sparse_vector *, CLIENT *);
+extern  vector_result * sparse_mv_2_svc(sparse_vector *, struct svc_req *);
+extern  csr_result * sparse_mult_2(csr_pair *, CLIENT *);
+extern  csr_result * sparse_mult_2_svc(csr_pair *, struct svc_req *);
+extern  csr_result * sparse_transpose_2(csr_matrix *, CLIENT *);
+extern  csr_result * sparse_transpose_2_svc(csr_matrix *, struct svc_req *);
+extern  handle_result * sparse_mult_dense_2(sparse_dense_op *, CLIENT *);
+extern  handle_result * sparse_mult_dense_2_svc(sparse_dense_op *, struct svc_req *);
+extern  csr_result * sparse_from_dense_2(int *, CLIENT *);
+extern  csr_result * sparse_from_dense_2_svc(int *, struct svc_req *);
+extern  handle_result * sparse_to_dense_2(csr_matrix *, CLIENT *);
+extern  handle_result * sparse_to_dense_2_svc(csr_matrix *, struct svc_req *);
+#define STAGE_APPEND_RAW 30
+extern  stage_status * stage_append_raw_2(stage_tile_raw *, CLIENT *);
+extern  stage_status * stage_append_raw_2_svc(stage_tile_raw *, struct svc_req *);
+#define STAGE_READ_RAW 31
+extern  stage_rows_raw * stage_read_raw_2(stage_range *, CLIENT *);
+extern  stage_rows_raw * stage_read_raw_2_svc(stage_range *, struct svc_req *);
+#define STORE_READ_RAW 32
+extern  stage_rows_raw * store_read_raw_2(handle_range *, CLIENT *);
+extern  stage_rows_raw * store_read_raw_2_svc(handle_range *, struct svc_req *);
+#define STATS 33
+extern  server_stats * stats_2(int *, CLIENT *);
+extern  server_stats * stats_2_svc(int *, struct svc_req *);
+#define GEMM 34
+extern  handle_result * gemm_2(gemm_request *, CLIENT *);
+extern  handle_result * gemm_2_svc(gemm_request *, struct svc_req *);
+#define SYRK 35
+extern  handle_result * syrk_2(syrk_request *, CLIENT *);
+extern  handle_result * syrk_2_svc(syrk_request *, struct svc_req *);
+#define STAGE_APPEND_PACKED 36
+extern  stage_status * stage_append_packed_2(stage_tile_packed *, CLIENT *);
+extern  stage_status * stage_append_packed_2_svc(stage_tile_packed *, struct svc_req *);
+#define STAGE_READ_PACKED 37
+extern  stage_rows_packed * stage_read_packed_2(packed_range *, CLIENT *);
+extern  stage_rows_packed * stage_read_packed_2_svc(packed_range *, struct svc_req *);
+#define STORE_READ_PACKED 38
+extern  stage_rows_packed * store_read_packed_2(packed_range *, CLIENT *);
+extern  stage_rows_packed * store_read_packed_2_svc(packed_range *, struct svc_req *);
+#define SHM_ATTACH 39
+extern  shm_attach_result * shm_attach_2(char **, CLIENT *);
+extern  shm_attach_result * shm_attach_2_svc(char **, struct svc_req *);
+#define SHM_DETACH 40
+extern  int * shm_detach_2(int *, CLIENT *);
+extern  int * shm_detach_2_svc(int *, struct svc_req *);
+#define SHM_APPLY 41
+extern  shm_result * shm_apply_2(shm_request *, CLIENT *);
+extern  shm_result * shm_apply_2_svc(shm_request *, struct svc_req *);
+#define SOLVE_CG 42
+extern  krylov_result * solve_cg_2(krylov_request *, CLIENT *);
+extern  krylov_result * solve_cg_2_svc(krylov_request *, struct svc_req *);
+#define SOLVE_GMRES 43
+extern  krylov_result * solve_gmres_2(krylov_request *, CLIENT *);
+extern  krylov_result * solve_gmres_2_svc(krylov_request *, struct svc_req *);
+#define MATRIX_QR 44
+extern  qr_result * matrix_qr_2(matrix *, CLIENT *);
+extern  qr_result * matrix_qr_2_svc(matrix *, struct svc_req *);
+#define MATRIX_LSTSQ 45
+extern  matrix_result * matrix_lstsq_2(matrix_pair *, CLIENT *);
+extern  matrix_result * matrix_lstsq_2_svc(matrix_pair *, struct svc_req *);
+#define STORE_QR 46
+extern  qr_handles * store_qr_2(int *, CLIENT *);
+extern  qr_handles * store_qr_2_svc(int *, struct svc_req *);
+extern int matrix_operations_prog_2_freeresult (SVCXPRT *, xdrproc_t, caddr_t);
+
+#else /* K&R C */
+extern  matrix_result * matrix_add_2();
+extern  matrix_result * matrix_add_2_svc();
+extern  matrix_result * matrix_mult_2();
+extern  matrix_result * matrix_mult_2_svc();
+extern  matrix_result * matrix_inverse_2();
+extern  matrix_result * matrix_inverse_2_svc();
+extern  matrix_result * matrix_transpose_2();
+extern  matrix_result * matrix_transpose_2_svc();
+extern  int * ping_2();
+extern  int * ping_2_svc();
+extern  stage_status * stage_begin_2();
+extern  stage_status * stage_begin_2_svc();
+extern  stage_status * stage_append_2();
+extern  stage_status * stage_append_2_svc();
+extern  stage_status * stage_commit_2();
+extern  stage_status * stage_commit_2_svc();
+extern  stage_rows * stage_read_2();
+extern  stage_rows * stage_read_2_svc();
+extern  int * stage_end_2();
+extern  int * stage_end_2_svc();
+extern  handle_result * store_put_2();
+extern  handle_result * store_put_2_svc();
+extern  handle_result * store_adopt_2();
+extern  handle_result * store_adopt_2_svc();
+extern  handle_result * store_apply_2();
+extern  handle_result * store_apply_2_svc();
+extern  stage_rows * store_read_2();
+extern  stage_rows * store_read_2_svc();
+extern  int * store_free_2();
+extern  int * store_free_2_svc();
+extern  expr_result * evaluate_2();
+extern  expr_result * evaluate_2_svc();
+extern  lu_result * matrix_lu_2();
+extern  lu_result * matrix_lu_2_svc();
+extern  matrix_result * matrix_solve_2();
+extern  matrix_result * matrix_solve_2_svc();
+extern  det_result * matrix_det_2();
+extern  det_result * matrix_det_2_svc();
+extern  cache_stats * cache_stats_2();
+extern  cache_stats * cache_stats_2_svc();
+extern  matrix32_result * matrix_mult32_2();
+extern  matrix32_result * matrix_mult32_2_svc();
+extern  stage_status * stage_append32_2();
+extern  stage_status * stage_append32_2_svc();
+extern  stage_rows32 * stage_read32_2();
+extern  stage_rows32 * stage_read32_2_svc();
+extern  vector_result * sparse_mv_2();
+extern  vector_result * sparse_mv_2_svc();
+extern  csr_result * sparse_mult_2();
+extern  csr_result * sparse_mult_2_svc();
+extern  csr_result * sparse_transpose_2();
+extern  csr_result * sparse_transpose_2_svc();
+extern  handle_result * sparse_mult_dense_2();
+extern  handle_result * sparse_mult_dense_2_svc();
+extern  csr_result * sparse_from_dense_2();
+extern  csr_result * sparse_from_dense_2_svc();
+extern  handle_result * sparse_to_dense_2();
+extern  handle_result * sparse_to_dense_2_svc();
+#define STAGE_APPEND_RAW 30
+extern  stage_status * stage_append_raw_2();
+extern  stage_status * stage_append_raw_2_svc();
+#define STAGE_READ_RAW 31
+extern  stage_rows_raw * stage_read_raw_2();
+extern  stage_rows_raw * stage_read_raw_2_svc();
+#define STORE_READ_RAW 32
+extern  stage_rows_raw * store_read_raw_2();
+extern  stage_rows_raw * store_read_raw_2_svc();
+#define STATS 33
+extern  server_stats * stats_2();
+extern  server_stats * stats_2_svc();
+#define GEMM 34
+extern  handle_result * gemm_2();
+extern  handle_result * gemm_2_svc();
+#define SYRK 35
+extern  handle_result * syrk_2();
+extern  handle_result * syrk_2_svc();
+#define STAGE_APPEND_PACKED 36
+extern  stage_status * stage_append_packed_2();
+extern  stage_status * stage_append_packed_2_svc();
+#define STAGE_READ_PACKED 37
+extern  stage_rows_packed * stage_read_packed_2();
+extern  stage_rows_packed * stage_read_packed_2_svc();
+#define STORE_READ_PACKED 38
+extern  stage_rows_packed * store_read_packed_2();
+extern  stage_rows_packed * store_read_packed_2_svc();
+#define SHM_ATTACH 39
+extern  shm_attach_result * shm_attach_2();
+extern  shm_attach_result * shm_attach_2_svc();
+#define SHM_DETACH 40
+extern  int * shm_detach_2();
+extern  int * shm_detach_2_svc();
+#define SHM_APPLY 41
+extern  shm_result * shm_apply_2();
+extern  shm_result * shm_apply_2_svc();
+#define SOLVE_CG 42
+extern  krylov_result * solve_cg_2();
+extern  krylov_result * solve_cg_2_svc();
+#define SOLVE_GMRES 43
+extern  krylov_result * solve_gmres_2();
+extern  krylov_result * solve_gmres_2_svc();
+#define MATRIX_QR 44
+extern  qr_result * matrix_qr_2();
+extern  qr_result * matrix_qr_2_svc();
+#define MATRIX_LSTSQ 45
+extern  matrix_result * matrix_lstsq_2();
+extern  matrix_result * matrix_lstsq_2_svc();
+#define STORE_QR 46
+extern  qr_handles * store_qr_2();
+extern  qr_handles * store_qr_2_svc();
+extern int matrix_operations_prog_2_freeresult ();
+#endif /* K&R C */
 
 /* the xdr functions */
 
@@ -84,11 +947,105 @@ extern int matrix_operations_prog_1_freeresult ();
 extern  bool_t xdr_matrix (XDR *, matrix*);
 extern  bool_t xdr_matrix_pair (XDR *, matrix_pair*);
 extern  bool_t xdr_matrix_result (XDR *, matrix_result*);
+extern  bool_t xdr_matrix32 (XDR *, matrix32*);
+extern  bool_t xdr_matrix32_pair (XDR *, matrix32_pair*);
+extern  bool_t xdr_matrix32_result (XDR *, matrix32_result*);
+extern  bool_t xdr_lu_result (XDR *, lu_result*);
+extern  bool_t xdr_det_result (XDR *, det_result*);
+extern  bool_t xdr_cache_stats (XDR *, cache_stats*);
+extern  bool_t xdr_matrix_op (XDR *, matrix_op*);
+extern  bool_t xdr_stage_request (XDR *, stage_request*);
+extern  bool_t xdr_stage_tile (XDR *, stage_tile*);
+extern  bool_t xdr_stage_range (XDR *, stage_range*);
+extern  bool_t xdr_stage_status (XDR *, stage_status*);
+extern  bool_t xdr_stage_rows (XDR *, stage_rows*);
+extern  bool_t xdr_stage_tile32 (XDR *, stage_tile32*);
+extern  bool_t xdr_stage_rows32 (XDR *, stage_rows32*);
+extern  bool_t xdr_handle_op (XDR *, handle_op*);
+extern  bool_t xdr_handle_range (XDR *, handle_range*);
+extern  bool_t xdr_handle_result (XDR *, handle_result*);
+extern  bool_t xdr_expr_kind (XDR *, expr_kind*);
+extern  bool_t xdr_expr_node (XDR *, expr_node*);
+extern  bool_t xdr_expr_request (XDR *, expr_request*);
+extern  bool_t xdr_expr_result (XDR *, expr_result*);
+extern  bool_t xdr_csr_matrix (XDR *, csr_matrix*);
+extern  bool_t xdr_csr_pair (XDR *, csr_pair*);
+extern  bool_t xdr_csr_result (XDR *, csr_result*);
+extern  bool_t xdr_sparse_vector (XDR *, sparse_vector*);
+extern  bool_t xdr_vector_result (XDR *, vector_result*);
+extern  bool_t xdr_sparse_dense_op (XDR *, sparse_dense_op*);
+extern  bool_t xdr_krylov_precond (XDR *, krylov_precond*);
+extern  bool_t xdr_krylov_request (XDR *, krylov_request*);
+extern  bool_t xdr_krylov_result (XDR *, krylov_result*);
+extern  bool_t xdr_qr_result (XDR *, qr_result*);
+extern  bool_t xdr_qr_handles (XDR *, qr_handles*);
+extern  bool_t xdr_byte_order (XDR *, byte_order*);
+extern  bool_t xdr_stage_tile_raw (XDR *, stage_tile_raw*);
+extern  bool_t xdr_stage_rows_raw (XDR *, stage_rows_raw*);
+extern  bool_t xdr_payload_codec (XDR *, payload_codec*);
+extern  bool_t xdr_stage_tile_packed (XDR *, stage_tile_packed*);
+extern  bool_t xdr_packed_range (XDR *, packed_range*);
+extern  bool_t xdr_stage_rows_packed (XDR *, stage_rows_packed*);
+extern  bool_t xdr_shm_attach_result (XDR *, shm_attach_result*);
+extern  bool_t xdr_shm_operand (XDR *, shm_operand*);
+extern  bool_t xdr_shm_request (XDR *, shm_request*);
+extern  bool_t xdr_shm_result (XDR *, shm_result*);
+extern  bool_t xdr_gemm_request (XDR *, gemm_request*);
+extern  bool_t xdr_syrk_request (XDR *, syrk_request*);
+extern  bool_t xdr_proc_stats (XDR *, proc_stats*);
+extern  bool_t xdr_server_stats (XDR *, server_stats*);
 
 #else /* K&R C */
 extern bool_t xdr_matrix ();
 extern bool_t xdr_matrix_pair ();
 extern bool_t xdr_matrix_result ();
+extern bool_t xdr_matrix32 ();
+extern bool_t xdr_matrix32_pair ();
+extern bool_t xdr_matrix32_result ();
+extern bool_t xdr_lu_result ();
+extern bool_t xdr_det_result ();
+extern bool_t xdr_cache_stats ();
+extern bool_t xdr_matrix_op ();
+extern bool_t xdr_stage_request ();
+extern bool_t xdr_stage_tile ();
+extern bool_t xdr_stage_range ();
+extern bool_t xdr_stage_status ();
+extern bool_t xdr_stage_rows ();
+extern bool_t xdr_stage_tile32 ();
+extern bool_t xdr_stage_rows32 ();
+extern bool_t xdr_handle_op ();
+extern bool_t xdr_handle_range ();
+extern bool_t xdr_handle_result ();
+extern bool_t xdr_expr_kind ();
+extern bool_t xdr_expr_node ();
+extern bool_t xdr_expr_request ();
+extern bool_t xdr_expr_result ();
+extern bool_t xdr_csr_matrix ();
+extern bool_t xdr_csr_pair ();
+extern bool_t xdr_csr_result ();
+extern bool_t xdr_sparse_vector ();
+extern bool_t xdr_vector_result ();
+extern bool_t xdr_sparse_dense_op ();
+extern bool_t xdr_krylov_precond ();
+extern bool_t xdr_krylov_request ();
+extern bool_t xdr_krylov_result ();
+extern bool_t xdr_qr_result ();
+extern bool_t xdr_qr_handles ();
+extern bool_t xdr_byte_order ();
+extern bool_t xdr_stage_tile_raw ();
+extern bool_t xdr_stage_rows_raw ();
+extern bool_t xdr_payload_codec ();
+extern bool_t xdr_stage_tile_packed ();
+extern bool_t xdr_packed_range ();
+extern bool_t xdr_stage_rows_packed ();
+extern bool_t xdr_shm_attach_result ();
+extern bool_t xdr_shm_operand ();
+extern bool_t xdr_shm_request ();
+extern bool_t xdr_shm_result ();
+extern bool_t xdr_gemm_request ();
+extern bool_t xdr_syrk_request ();
+extern bool_t xdr_proc_stats ();
+extern bool_t xdr_server_stats ();
 
 #endif /* K&R C */
 
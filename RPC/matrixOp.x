@@ -22,6 +22,460 @@ struct matrix_result {
     matrix result_matrix;
 };
 
+/* Single-precision matrix: half the bytes of struct matrix on the wire */
+struct matrix32 {
+    int rows;
+    int cols;
+    float data<MAX_SIZE>;
+};
+
+struct matrix32_pair {
+    matrix32 first;
+    matrix32 second;
+};
+
+struct matrix32_result {
+    int success;
+    string error_msg<100>;
+    matrix32 result_matrix;
+};
+
+/* LU factorization PA = LU: L (unit diagonal) and U packed into one matrix */
+struct lu_result {
+    int success;
+    string error_msg<100>;
+    matrix lu;
+    int pivots<MAX_SIZE>;   /* step j swapped row j with row pivots[j] */
+};
+
+/* Determinant of a square matrix */
+struct det_result {
+    int success;
+    string error_msg<100>;
+    double determinant;
+};
+
+/* Result cache counters */
+struct cache_stats {
+    unsigned hyper hits;
+    unsigned hyper misses;
+    unsigned hyper evictions;
+    unsigned hyper entries;
+    unsigned hyper bytes;
+    unsigned hyper budget;
+};
+
+/* Limits for staged (chunked) transfers of large matrices */
+const MAX_TILE = 65536;
+const MAX_STAGE_DIM = 8192;
+
+/* Operations that can be run on staged operands */
+enum matrix_op {
+    OP_ADD = 1,
+    OP_MULT = 2,
+    OP_INVERSE = 3,
+    OP_TRANSPOSE = 4,
+    OP_STORE = 5,           /* keep (staged) or copy (STORE_APPLY) the first operand */
+    OP_SOLVE = 6,           /* X with first * X = second */
+    OP_MULT32 = 7,          /* OP_MULT in float32 arithmetic */
+    OP_SOLVE_MIXED = 8,     /* OP_SOLVE factorized in float32, refined to double accuracy */
+    OP_LSTSQ = 9            /* least-squares X minimizing ||first * X - second|| by Householder QR */
+};
+
+/* Open a staging session: operand shapes and the operation to run on commit */
+struct stage_request {
+    matrix_op op;
+    int first_rows;
+    int first_cols;
+    int second_rows;
+    int second_cols;
+};
+
+/* Rectangular block of one staged operand (operand 0 = first, 1 = second) */
+struct stage_tile {
+    int session;
+    int operand;
+    int row;
+    int col;
+    int rows;
+    int cols;
+    double data<MAX_TILE>;
+};
+
+/* Row range of a committed result */
+struct stage_range {
+    int session;
+    int row;
+    int rows;
+};
+
+/* Outcome of a staging call; rows/cols give the result shape after commit */
+struct stage_status {
+    int success;
+    string error_msg<100>;
+    int session;
+    int rows;
+    int cols;
+};
+
+/* Row block of a committed result */
+struct stage_rows {
+    int success;
+    string error_msg<100>;
+    int row;
+    int rows;
+    int cols;
+    double data<MAX_TILE>;
+};
+
+/* stage_tile carrying float32 data; converted to double as it is stored */
+struct stage_tile32 {
+    int session;
+    int operand;
+    int row;
+    int col;
+    int rows;
+    int cols;
+    float data<MAX_TILE>;
+};
+
+/* Row block of a committed result rounded to float32 */
+struct stage_rows32 {
+    int success;
+    string error_msg<100>;
+    int row;
+    int rows;
+    int cols;
+    float data<MAX_TILE>;
+};
+
+/* Operation on matrices held in the server's store; second is ignored for unary operations */
+struct handle_op {
+    matrix_op op;
+    int first;
+    int second;
+};
+
+/* Row range of a stored matrix */
+struct handle_range {
+    int handle;
+    int row;
+    int rows;
+};
+
+/* Outcome of a store call: the handle and shape of the stored matrix */
+struct handle_result {
+    int success;
+    string error_msg<100>;
+    int handle;
+    int rows;
+    int cols;
+};
+
+/* Limits for expression evaluation */
+const MAX_EXPR_OPERANDS = 8;
+const MAX_EXPR_NODES = 32;
+
+/* Expression node kinds */
+enum expr_kind {
+    EXPR_OPERAND = 1,       /* operands[arg] of the request */
+    EXPR_HANDLE = 2,        /* stored matrix with handle arg */
+    EXPR_ADD = 3,           /* left + right */
+    EXPR_MULT = 4,          /* left * right */
+    EXPR_TRANSPOSE = 5,     /* left^T */
+    EXPR_INVERSE = 6        /* left^(-1) */
+};
+
+/* One node; left and right index earlier nodes, so the list is in evaluation order */
+struct expr_node {
+    expr_kind kind;
+    int arg;
+    int left;
+    int right;
+};
+
+/* Expression graph over inline operands and stored matrices; the last node is the result */
+struct expr_request {
+    matrix operands<MAX_EXPR_OPERANDS>;
+    expr_node nodes<MAX_EXPR_NODES>;
+    int keep;               /* nonzero: store the result and return its handle instead */
+};
+
+/* Result of an expression: the matrix, or its handle when keep was set */
+struct expr_result {
+    int success;
+    string error_msg<100>;
+    int handle;
+    matrix result_matrix;
+};
+
+/* Limits for sparse matrices: dimensions, row offsets and nonzeros per call */
+const MAX_SPARSE_DIM = 1048576;
+const MAX_ROW_PTR = 1048577;
+const MAX_NNZ = 1048576;
+
+/* Compressed sparse row matrix: row i's entries are col_idx/values[row_ptr[i] .. row_ptr[i+1]) */
+struct csr_matrix {
+    int rows;
+    int cols;
+    int row_ptr<MAX_ROW_PTR>;   /* rows + 1 offsets, starting at 0 */
+    int col_idx<MAX_NNZ>;
+    double values<MAX_NNZ>;
+};
+
+struct csr_pair {
+    csr_matrix first;
+    csr_matrix second;
+};
+
+struct csr_result {
+    int success;
+    string error_msg<100>;
+    csr_matrix result;
+};
+
+/* Sparse matrix and a dense vector with one entry per column */
+struct sparse_vector {
+    csr_matrix a;
+    double x<MAX_SPARSE_DIM>;
+};
+
+struct vector_result {
+    int success;
+    string error_msg<100>;
+    double y<MAX_SPARSE_DIM>;
+};
+
+/* Sparse matrix times a stored dense matrix */
+struct sparse_dense_op {
+    csr_matrix a;
+    int handle;
+};
+
+/*
+ * Krylov solvers (version 2) for A x = b with a square A, either a stored
+ * dense matrix or a sparse one sent along. They stop once
+ * ||b - A x|| <= tol * ||b|| or after max_iter iterations; residuals holds
+ * that relative norm before the first iteration and after each one.
+ */
+const MAX_KRYLOV_ITER = 10000;
+const MAX_KRYLOV_HISTORY = 10001;   /* MAX_KRYLOV_ITER + 1 */
+const MAX_KRYLOV_RESTART = 200;
+
+enum krylov_precond {
+    PRECOND_NONE = 0,
+    PRECOND_JACOBI = 1,     /* diagonal scaling */
+    PRECOND_ILU0 = 2        /* incomplete LU on A's sparsity pattern; sparse A only */
+};
+
+struct krylov_request {
+    int handle;                 /* stored dense A, or 0 to use sparse */
+    csr_matrix sparse;
+    double b<MAX_SPARSE_DIM>;
+    double x0<MAX_SPARSE_DIM>;  /* initial guess; empty starts from zero */
+    double tol;
+    int max_iter;
+    krylov_precond precond;
+    int restart;                /* GMRES: Krylov vectors per cycle, 0 for the default of 30 */
+};
+
+struct krylov_result {
+    int success;
+    string error_msg<100>;
+    int converged;
+    int iterations;
+    double x<MAX_SPARSE_DIM>;
+    double residuals<MAX_KRYLOV_HISTORY>;
+};
+
+/*
+ * Thin QR factorization (version 2) of an m x n A: Q is m x k with
+ * orthonormal columns and R is k x n upper triangular, k = min(m, n).
+ */
+struct qr_result {
+    int success;
+    string error_msg<100>;
+    matrix q;
+    matrix r;
+};
+
+/* STORE_QR: handles of the stored Q (rows x k) and R (k x cols) */
+struct qr_handles {
+    int success;
+    string error_msg<100>;
+    int q;
+    int r;
+    int rows;
+    int cols;
+    int k;
+};
+
+/*
+ * Raw payloads (version 2): rows * cols doubles copied byte for byte in the
+ * sender's native order, which the order field names; the receiver swaps
+ * only if its own order differs.
+ */
+const MAX_TILE_BYTES = 524288;  /* MAX_TILE doubles */
+
+enum byte_order {
+    ORDER_LITTLE_ENDIAN = 0,
+    ORDER_BIG_ENDIAN = 1
+};
+
+struct stage_tile_raw {
+    int session;
+    int operand;
+    int row;
+    int col;
+    int rows;
+    int cols;
+    byte_order order;
+    opaque data<MAX_TILE_BYTES>;
+};
+
+struct stage_rows_raw {
+    int success;
+    string error_msg<100>;
+    int row;
+    int rows;
+    int cols;
+    byte_order order;
+    opaque data<MAX_TILE_BYTES>;
+};
+
+/*
+ * Compressed payloads (version 2): raw tile bytes, byte-shuffled (byte b of
+ * every double grouped together, so exponents and zero bytes form runs) and
+ * deflated. Payloads under COMPRESS_MIN_BYTES, or that do not shrink, travel
+ * as plain raw bytes under CODEC_NONE, so data never exceeds MAX_TILE_BYTES.
+ */
+const COMPRESS_MIN_BYTES = 16384;
+
+enum payload_codec {
+    CODEC_NONE = 0,
+    CODEC_SHUFFLE_DEFLATE = 1
+};
+
+struct stage_tile_packed {
+    int session;
+    int operand;
+    int row;
+    int col;
+    int rows;
+    int cols;
+    byte_order order;
+    payload_codec codec;
+    opaque data<MAX_TILE_BYTES>;
+};
+
+/* Row range of a session (STAGE_READ_PACKED) or stored matrix (STORE_READ_PACKED) */
+struct packed_range {
+    int id;
+    int row;
+    int rows;
+    payload_codec accept;   /* the best codec the caller can decode */
+};
+
+struct stage_rows_packed {
+    int success;
+    string error_msg<100>;
+    int row;
+    int rows;
+    int cols;
+    byte_order order;
+    payload_codec codec;
+    opaque data<MAX_TILE_BYTES>;
+};
+
+/*
+ * Shared-memory transport (version 2) for clients on the server's host.
+ * The client maps a POSIX shared memory object named "/matrixOp-..."
+ * and the server attaches it by name; operands and results are then
+ * row-major doubles at byte offsets into it, never copied through RPC.
+ */
+const SHM_NAME_MAX = 64;
+
+struct shm_attach_result {
+    int success;
+    string error_msg<100>;
+    int segment;
+    unsigned hyper size;    /* bytes the server mapped */
+};
+
+struct shm_operand {
+    unsigned hyper offset;  /* multiple of 8 */
+    int rows;
+    int cols;
+};
+
+/* op on operands in a segment, the result written at out; second is ignored for unary ops */
+struct shm_request {
+    int segment;
+    matrix_op op;
+    shm_operand first;
+    shm_operand second;
+    unsigned hyper out;     /* must not overlap the operands */
+};
+
+/* Outcome of SHM_APPLY: the shape of the result written to the segment */
+struct shm_result {
+    int success;
+    string error_msg<100>;
+    int rows;
+    int cols;
+};
+
+/*
+ * BLAS-3 updates on stored matrices (version 2): op(X) is X, or X^T when
+ * the matching trans flag is set. The result is stored under a new handle.
+ */
+struct gemm_request {
+    int a;
+    int b;
+    int c;              /* accumulator; ignored (may be 0) when beta is 0 */
+    int trans_a;
+    int trans_b;
+    double alpha;
+    double beta;
+};
+
+/* alpha * A * A^T + beta * C, or alpha * A^T * A + beta * C with trans set */
+struct syrk_request {
+    int a;
+    int c;              /* symmetric accumulator, only its lower triangle is read; ignored when beta is 0 */
+    int trans;
+    double alpha;
+    double beta;
+};
+
+/*
+ * Server statistics per procedure. Latencies are log2 histograms in
+ * microseconds: bucket 0 counts calls under 1 us, bucket b calls in
+ * [2^(b-1), 2^b) us, and the last bucket everything above.
+ */
+const STATS_BUCKETS = 24;
+const MAX_STATS_PROCS = 64;
+
+struct proc_stats {
+    int proc;
+    string name<32>;
+    unsigned hyper calls;
+    unsigned hyper errors;          /* rejected calls and replies with success == 0 */
+    unsigned hyper bytes_in;        /* XDR-encoded arguments */
+    unsigned hyper bytes_out;       /* XDR-encoded results */
+    unsigned hyper decode_us[STATS_BUCKETS];
+    unsigned hyper compute_us[STATS_BUCKETS];
+    unsigned hyper encode_us[STATS_BUCKETS];    /* encoding and sending the reply */
+    unsigned hyper codec_raw_bytes;     /* compressed payloads: size before compression */
+    unsigned hyper codec_packed_bytes;  /* and after */
+    unsigned hyper codec_us;            /* time spent compressing and decompressing */
+};
+
+struct server_stats {
+    unsigned hyper elapsed_ms;      /* since start or the last reset */
+    proc_stats procs<MAX_STATS_PROCS>;  /* procedures called at least once */
+};
+
 /* Program definition */
 program MATRIX_OPERATIONS_PROG {
     version MATRIX_OPERATIONS_VERS {
@@ -39,5 +493,221 @@ program MATRIX_OPERATIONS_PROG {
         
         /* Test connection */
         int PING(void) = 5;
+        
+        /* Staged transfer: open a session for operands of any size up to MAX_STAGE_DIM */
+        stage_status STAGE_BEGIN(stage_request) = 6;
+        
+        /* Staged transfer: copy one tile into an operand in place */
+        stage_status STAGE_APPEND(stage_tile) = 7;
+        
+        /* Staged transfer: run the operation on the assembled operands */
+        stage_status STAGE_COMMIT(int) = 8;
+        
+        /* Staged transfer: read a row range of the result */
+        stage_rows STAGE_READ(stage_range) = 9;
+        
+        /* Staged transfer: release the session */
+        int STAGE_END(int) = 10;
+        
+        /* Store: keep a matrix on the server and return its handle */
+        handle_result STORE_PUT(matrix) = 11;
+        
+        /* Store: move a committed session's result into the store and end the session */
+        handle_result STORE_ADOPT(int) = 12;
+        
+        /* Store: run an operation on stored matrices, keeping the result as a new handle */
+        handle_result STORE_APPLY(handle_op) = 13;
+        
+        /* Store: read a row range of a stored matrix */
+        stage_rows STORE_READ(handle_range) = 14;
+        
+        /* Store: release a handle */
+        int STORE_FREE(int) = 15;
+        
+        /* Evaluate an expression graph in one call, fusing transposes and adds into GEMM */
+        expr_result EVALUATE(expr_request) = 16;
+        
+        /* LU factorization with partial pivoting: packed factors and pivot vector */
+        lu_result MATRIX_LU(matrix) = 17;
+        
+        /* Solve A X = B for every column of B (first = A, second = B) */
+        matrix_result MATRIX_SOLVE(matrix_pair) = 18;
+        
+        /* Determinant from the LU factors (0 for singular matrices) */
+        det_result MATRIX_DET(matrix) = 19;
+        
+        /* Result cache hit/miss counters and memory use */
+        cache_stats CACHE_STATS(void) = 20;
+        
+        /* Matrix multiplication in float32: C = A * B */
+        matrix32_result MATRIX_MULT32(matrix32_pair) = 21;
+        
+        /* Staged transfer: STAGE_APPEND with a float32 tile */
+        stage_status STAGE_APPEND32(stage_tile32) = 22;
+        
+        /* Staged transfer: STAGE_READ returning float32 rows */
+        stage_rows32 STAGE_READ32(stage_range) = 23;
+        
+        /* Sparse matrix-vector product: y = A x */
+        vector_result SPARSE_MV(sparse_vector) = 24;
+        
+        /* Sparse-sparse product: C = A * B in CSR */
+        csr_result SPARSE_MULT(csr_pair) = 25;
+        
+        /* Sparse transpose: B = A^T in CSR */
+        csr_result SPARSE_TRANSPOSE(csr_matrix) = 26;
+        
+        /* Sparse-dense product with the dense operand and result in the store */
+        handle_result SPARSE_MULT_DENSE(sparse_dense_op) = 27;
+        
+        /* Nonzeros of a stored dense matrix in CSR */
+        csr_result SPARSE_FROM_DENSE(int) = 28;
+        
+        /* Expand a sparse matrix into a new stored dense matrix */
+        handle_result SPARSE_TO_DENSE(csr_matrix) = 29;
     } = 1;
+    
+    /*
+     * Version 2: every version 1 procedure, plus bulk transfers that carry
+     * matrix data as raw IEEE-754 doubles instead of per-element XDR.
+     */
+    version MATRIX_OPERATIONS_VERS2 {
+        /* Matrix addition: C = A + B */
+        matrix_result MATRIX_ADD(matrix_pair) = 1;
+        
+        /* Matrix multiplication: C = A * B */
+        matrix_result MATRIX_MULT(matrix_pair) = 2;
+        
+        /* Matrix inverse: B = A^(-1) */
+        matrix_result MATRIX_INVERSE(matrix) = 3;
+        
+        /* Matrix transpose: B = A^T */
+        matrix_result MATRIX_TRANSPOSE(matrix) = 4;
+        
+        /* Test connection */
+        int PING(void) = 5;
+        
+        /* Staged transfer: open a session for operands of any size up to MAX_STAGE_DIM */
+        stage_status STAGE_BEGIN(stage_request) = 6;
+        
+        /* Staged transfer: copy one tile into an operand in place */
+        stage_status STAGE_APPEND(stage_tile) = 7;
+        
+        /* Staged transfer: run the operation on the assembled operands */
+        stage_status STAGE_COMMIT(int) = 8;
+        
+        /* Staged transfer: read a row range of the result */
+        stage_rows STAGE_READ(stage_range) = 9;
+        
+        /* Staged transfer: release the session */
+        int STAGE_END(int) = 10;
+        
+        /* Store: keep a matrix on the server and return its handle */
+        handle_result STORE_PUT(matrix) = 11;
+        
+        /* Store: move a committed session's result into the store and end the session */
+        handle_result STORE_ADOPT(int) = 12;
+        
+        /* Store: run an operation on stored matrices, keeping the result as a new handle */
+        handle_result STORE_APPLY(handle_op) = 13;
+        
+        /* Store: read a row range of a stored matrix */
+        stage_rows STORE_READ(handle_range) = 14;
+        
+        /* Store: release a handle */
+        int STORE_FREE(int) = 15;
+        
+        /* Evaluate an expression graph in one call, fusing transposes and adds into GEMM */
+        expr_result EVALUATE(expr_request) = 16;
+        
+        /* LU factorization with partial pivoting: packed factors and pivot vector */
+        lu_result MATRIX_LU(matrix) = 17;
+        
+        /* Solve A X = B for every column of B (first = A, second = B) */
+        matrix_result MATRIX_SOLVE(matrix_pair) = 18;
+        
+        /* Determinant from the LU factors (0 for singular matrices) */
+        det_result MATRIX_DET(matrix) = 19;
+        
+        /* Result cache hit/miss counters and memory use */
+        cache_stats CACHE_STATS(void) = 20;
+        
+        /* Matrix multiplication in float32: C = A * B */
+        matrix32_result MATRIX_MULT32(matrix32_pair) = 21;
+        
+        /* Staged transfer: STAGE_APPEND with a float32 tile */
+        stage_status STAGE_APPEND32(stage_tile32) = 22;
+        
+        /* Staged transfer: STAGE_READ returning float32 rows */
+        stage_rows32 STAGE_READ32(stage_range) = 23;
+        
+        /* Sparse matrix-vector product: y = A x */
+        vector_result SPARSE_MV(sparse_vector) = 24;
+        
+        /* Sparse-sparse product: C = A * B in CSR */
+        csr_result SPARSE_MULT(csr_pair) = 25;
+        
+        /* Sparse transpose: B = A^T in CSR */
+        csr_result SPARSE_TRANSPOSE(csr_matrix) = 26;
+        
+        /* Sparse-dense product with the dense operand and result in the store */
+        handle_result SPARSE_MULT_DENSE(sparse_dense_op) = 27;
+        
+        /* Nonzeros of a stored dense matrix in CSR */
+        csr_result SPARSE_FROM_DENSE(int) = 28;
+        
+        /* Expand a sparse matrix into a new stored dense matrix */
+        handle_result SPARSE_TO_DENSE(csr_matrix) = 29;
+        
+        /* Staged transfer: STAGE_APPEND with a raw tile */
+        stage_status STAGE_APPEND_RAW(stage_tile_raw) = 30;
+        
+        /* Staged transfer: STAGE_READ returning raw rows */
+        stage_rows_raw STAGE_READ_RAW(stage_range) = 31;
+        
+        /* Store: STORE_READ returning raw rows */
+        stage_rows_raw STORE_READ_RAW(handle_range) = 32;
+        
+        /* Per-procedure counters and latency histograms; nonzero argument resets them after the snapshot */
+        server_stats STATS(int) = 33;
+        
+        /* Store: C = alpha * op(A) * op(B) + beta * C in one call */
+        handle_result GEMM(gemm_request) = 34;
+        
+        /* Store: symmetric rank-k update, C = alpha * A * A^T + beta * C */
+        handle_result SYRK(syrk_request) = 35;
+        
+        /* Staged transfer: STAGE_APPEND with a possibly compressed raw tile */
+        stage_status STAGE_APPEND_PACKED(stage_tile_packed) = 36;
+        
+        /* Staged transfer: STAGE_READ, compressed when the caller accepts it and it pays off */
+        stage_rows_packed STAGE_READ_PACKED(packed_range) = 37;
+        
+        /* Store: STORE_READ, compressed when the caller accepts it and it pays off */
+        stage_rows_packed STORE_READ_PACKED(packed_range) = 38;
+        
+        /* Shared memory: map a segment the client created on this host */
+        shm_attach_result SHM_ATTACH(string<SHM_NAME_MAX>) = 39;
+        
+        /* Shared memory: unmap a segment; returns 0 if it is unknown */
+        int SHM_DETACH(int) = 40;
+        
+        /* Shared memory: run an operation from and into an attached segment */
+        shm_result SHM_APPLY(shm_request) = 41;
+        
+        /* Preconditioned conjugate gradients for symmetric positive definite A */
+        krylov_result SOLVE_CG(krylov_request) = 42;
+        
+        /* Restarted GMRES for general A, preconditioned on the right */
+        krylov_result SOLVE_GMRES(krylov_request) = 43;
+        
+        /* Thin Householder QR of a small matrix */
+        qr_result MATRIX_QR(matrix) = 44;
+        
+        /* Least squares: X minimizing ||first * X - second||, minimum norm when underdetermined */
+        matrix_result MATRIX_LSTSQ(matrix_pair) = 45;
+        
+        /* Store: thin Householder QR of a stored matrix into two new handles */
+        qr_handles STORE_QR(int) = 46;
+    } = 2;
 } = 0x20000001;
\ No newline at end of file
@@ -0,0 +1,67 @@
+/*
+ * matrixOp_arena.c - Per-thread bump allocator for request result and scratch buffers
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "matrixOp_arena.h"
+
+#define ARENA_ALIGN 64
+
+/* Overflow chunks keep their link in a full alignment unit so the payload stays aligned */
+#define CHUNK_HEADER ARENA_ALIGN
+
+static size_t align_up(size_t bytes) {
+    return (bytes + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+void arena_reset(request_arena *arena) {
+    while (arena->overflow) {
+        arena_chunk *next = arena->overflow->next;
+        free(arena->overflow);
+        arena->overflow = next;
+    }
+
+    if (arena->requested > arena->high_water) {
+        arena->high_water = arena->requested;
+    }
+
+    /* Replace the main block once a request did not fit, so the next one does */
+    if (arena->high_water > arena->capacity) {
+        char *grown = (char *)aligned_alloc(ARENA_ALIGN, arena->high_water);
+        if (grown) {
+            free(arena->base);
+            arena->base = grown;
+            arena->capacity = arena->high_water;
+        }
+    }
+
+    arena->used = 0;
+    arena->requested = 0;
+}
+
+void *arena_alloc(request_arena *arena, size_t bytes) {
+    if (bytes > SIZE_MAX - CHUNK_HEADER - ARENA_ALIGN) return NULL;
+    bytes = align_up(bytes ? bytes : 1);
+    arena->requested += bytes;
+
+    if (arena->capacity - arena->used >= bytes) {
+        void *p = arena->base + arena->used;
+        arena->used += bytes;
+        return p;
+    }
+
+    arena_chunk *chunk = (arena_chunk *)aligned_alloc(ARENA_ALIGN, CHUNK_HEADER + bytes);
+    if (!chunk) return NULL;
+    chunk->next = arena->overflow;
+    arena->overflow = chunk;
+    return (char *)chunk + CHUNK_HEADER;
+}
+
+void *arena_calloc(request_arena *arena, size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) return NULL;
+    void *p = arena_alloc(arena, count * size);
+    if (p) memset(p, 0, count * size);
+    return p;
+}
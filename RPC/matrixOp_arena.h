@@ -0,0 +1,39 @@
+/*
+ * matrixOp_arena.h - Per-thread bump allocator for request result and scratch buffers
+ */
+
+#ifndef MATRIXOP_ARENA_H
+#define MATRIXOP_ARENA_H
+
+#include <stddef.h>
+
+/* Extra block taken when a request outgrows the arena; freed on the next reset */
+typedef struct arena_chunk {
+    struct arena_chunk *next;
+} arena_chunk;
+
+/*
+ * One arena per server thread. Everything allocated while serving a request
+ * stays valid until that thread starts its next request, which is after the
+ * reply has been encoded and sent. The main block grows to the largest
+ * request seen, so a steady workload stops calling malloc altogether.
+ */
+typedef struct {
+    char *base;
+    size_t capacity;
+    size_t used;            /* bytes handed out from base */
+    size_t requested;       /* bytes asked for this request, including overflow */
+    size_t high_water;      /* largest request since the last resize */
+    arena_chunk *overflow;
+} request_arena;
+
+/* Start a new request: drop overflow chunks and grow the main block if needed */
+void arena_reset(request_arena *arena);
+
+/* 64-byte aligned, uninitialized memory; NULL if the system is out of memory */
+void *arena_alloc(request_arena *arena, size_t bytes);
+
+/* Same as arena_alloc, zero-filled */
+void *arena_calloc(request_arena *arena, size_t count, size_t size);
+
+#endif /* MATRIXOP_ARENA_H */
@@ -0,0 +1,199 @@
+/*
+ * matrixOp_async.c - Pipelined client: many requests in flight over a pool of connections
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "matrixOp_async.h"
+#include "matrixOp_transfer.h"
+
+struct async_call {
+    async_client *owner;
+    rpcproc_t proc;
+    xdrproc_t xargs;
+    void *args;
+    xdrproc_t xres;
+    void *res;
+    async_callback done_cb;     /* NULL for futures */
+    void *ctx;
+    enum clnt_stat status;
+    int done;
+    async_call *next;
+};
+
+typedef struct {
+    async_client *owner;
+    CLIENT *clnt;
+    pthread_t thread;
+} connection;
+
+/*
+ * lock guards the queue and the counters. A CLIENT handle is not safe to
+ * share, so each connection belongs to one thread, which takes calls off
+ * the queue in submission order.
+ */
+struct async_client {
+    pthread_mutex_t lock;
+    pthread_cond_t work;        /* queue gained a call, or stopping */
+    pthread_cond_t changed;     /* a call completed */
+    async_call *head;
+    async_call *tail;
+    int in_flight;              /* submitted and not yet completed */
+    int window;
+    int stopping;
+    int connections;
+    connection *conns;
+};
+
+static void *connection_loop(void *arg) {
+    async_client *ac = ((connection *)arg)->owner;
+    CLIENT *clnt = ((connection *)arg)->clnt;
+    struct timeval timeout = { ASYNC_CALL_TIMEOUT, 0 };
+
+    for (;;) {
+        pthread_mutex_lock(&ac->lock);
+        while (!ac->head && !ac->stopping) pthread_cond_wait(&ac->work, &ac->lock);
+        async_call *call = ac->head;
+        if (!call) {
+            pthread_mutex_unlock(&ac->lock);
+            return NULL;
+        }
+        ac->head = call->next;
+        if (!ac->head) ac->tail = NULL;
+        pthread_mutex_unlock(&ac->lock);
+
+        enum clnt_stat status = clnt_call(clnt, call->proc, call->xargs, (caddr_t)call->args,
+                                          call->xres, (caddr_t)call->res, timeout);
+
+        if (call->done_cb) {
+            call->done_cb(status == RPC_SUCCESS, status == RPC_SUCCESS ? NULL : clnt_sperrno(status),
+                          call->ctx);
+            free(call);
+            call = NULL;
+        }
+
+        pthread_mutex_lock(&ac->lock);
+        if (call) {
+            call->status = status;
+            call->done = 1;
+        }
+        ac->in_flight--;
+        pthread_cond_broadcast(&ac->changed);
+        pthread_mutex_unlock(&ac->lock);
+    }
+}
+
+/* Stop the first `started` threads and close every open connection */
+static void shut_down(async_client *ac, int started) {
+    pthread_mutex_lock(&ac->lock);
+    ac->stopping = 1;
+    pthread_cond_broadcast(&ac->work);
+    pthread_mutex_unlock(&ac->lock);
+
+    for (int i = 0; i < started; i++) pthread_join(ac->conns[i].thread, NULL);
+    for (int i = 0; i < ac->connections; i++) {
+        if (ac->conns[i].clnt) clnt_destroy(ac->conns[i].clnt);
+    }
+    pthread_cond_destroy(&ac->changed);
+    pthread_cond_destroy(&ac->work);
+    pthread_mutex_destroy(&ac->lock);
+    free(ac->conns);
+    free(ac);
+}
+
+async_client *async_create(const char *host, int connections, int window) {
+    if (connections < 1) return NULL;
+
+    async_client *ac = (async_client *)calloc(1, sizeof(async_client));
+    if (!ac) return NULL;
+    pthread_mutex_init(&ac->lock, NULL);
+    pthread_cond_init(&ac->work, NULL);
+    pthread_cond_init(&ac->changed, NULL);
+    ac->window = window < connections ? connections : window;
+    ac->conns = (connection *)calloc(connections, sizeof(connection));
+    if (!ac->conns) {
+        shut_down(ac, 0);
+        return NULL;
+    }
+    ac->connections = connections;
+
+    /* Connect everything first so a bad host fails before any thread starts */
+    for (int i = 0; i < connections; i++) {
+        ac->conns[i].owner = ac;
+        ac->conns[i].clnt = transfer_connect(host);
+        if (!ac->conns[i].clnt) {
+            shut_down(ac, 0);
+            return NULL;
+        }
+    }
+
+    for (int i = 0; i < connections; i++) {
+        if (pthread_create(&ac->conns[i].thread, NULL, connection_loop, &ac->conns[i]) != 0) {
+            shut_down(ac, i);
+            return NULL;
+        }
+    }
+    return ac;
+}
+
+static async_call *enqueue(async_client *ac, rpcproc_t proc, xdrproc_t xargs, void *args,
+                           xdrproc_t xres, void *res, async_callback done, void *ctx) {
+    async_call *call = (async_call *)calloc(1, sizeof(async_call));
+    if (!call) return NULL;
+    call->owner = ac;
+    call->proc = proc;
+    call->xargs = xargs;
+    call->args = args;
+    call->xres = xres;
+    call->res = res;
+    call->done_cb = done;
+    call->ctx = ctx;
+
+    pthread_mutex_lock(&ac->lock);
+    while (ac->in_flight >= ac->window) pthread_cond_wait(&ac->changed, &ac->lock);
+    ac->in_flight++;
+    if (ac->tail) ac->tail->next = call;
+    else ac->head = call;
+    ac->tail = call;
+    pthread_cond_signal(&ac->work);
+    pthread_mutex_unlock(&ac->lock);
+    return call;
+}
+
+async_call *async_submit(async_client *ac, rpcproc_t proc,
+                         xdrproc_t xargs, void *args, xdrproc_t xres, void *res) {
+    return enqueue(ac, proc, xargs, args, xres, res, NULL, NULL);
+}
+
+int async_submit_cb(async_client *ac, rpcproc_t proc,
+                    xdrproc_t xargs, void *args, xdrproc_t xres, void *res,
+                    async_callback done, void *ctx) {
+    /* The call may already be freed by the time enqueue returns */
+    return enqueue(ac, proc, xargs, args, xres, res, done, ctx) != NULL;
+}
+
+int async_wait(async_call *call, const char **error) {
+    async_client *ac = call->owner;
+    pthread_mutex_lock(&ac->lock);
+    while (!call->done) pthread_cond_wait(&ac->changed, &ac->lock);
+    pthread_mutex_unlock(&ac->lock);
+
+    enum clnt_stat status = call->status;
+    free(call);
+    if (status != RPC_SUCCESS) {
+        if (error) *error = clnt_sperrno(status);
+        return 0;
+    }
+    return 1;
+}
+
+void async_drain(async_client *ac) {
+    pthread_mutex_lock(&ac->lock);
+    while (ac->in_flight > 0) pthread_cond_wait(&ac->changed, &ac->lock);
+    pthread_mutex_unlock(&ac->lock);
+}
+
+void async_destroy(async_client *ac) {
+    async_drain(ac);
+    shut_down(ac, ac->connections);
+}
@@ -0,0 +1,58 @@
+/*
+ * matrixOp_async.h - Pipelined client: many requests in flight over a pool of connections
+ */
+
+#ifndef MATRIXOP_ASYNC_H
+#define MATRIXOP_ASYNC_H
+
+#include "matrixOp.h"
+
+/* Per-call timeout in seconds, as in the generated stubs */
+#define ASYNC_CALL_TIMEOUT 25
+
+typedef struct async_client async_client;
+typedef struct async_call async_call;
+
+/*
+ * Runs on a connection thread once the reply has been decoded into res
+ * (or the call failed; error is NULL on success). The call is released
+ * when the callback returns.
+ */
+typedef void (*async_callback)(int ok, const char *error, void *ctx);
+
+/*
+ * Open `connections` TCP connections to host, each served by its own
+ * thread, and allow up to `window` submitted calls that have not
+ * completed yet (at least one per connection). Returns NULL if any
+ * connection fails.
+ */
+async_client *async_create(const char *host, int connections, int window);
+
+/*
+ * Queue a call of procedure proc and return a future for it, blocking
+ * while the window is full. args must stay valid and res must stay
+ * zeroed and untouched until the call completes; the caller owns the
+ * decoded reply and releases it with xdr_free(xres, res).
+ */
+async_call *async_submit(async_client *ac, rpcproc_t proc,
+                         xdrproc_t xargs, void *args, xdrproc_t xres, void *res);
+
+/* Like async_submit, but completion is reported to done instead of a future */
+int async_submit_cb(async_client *ac, rpcproc_t proc,
+                    xdrproc_t xargs, void *args, xdrproc_t xres, void *res,
+                    async_callback done, void *ctx);
+
+/*
+ * Block until a submitted call completes and release the future.
+ * Returns 1 if the reply was received; otherwise *error (if not NULL)
+ * points at a static RPC error message.
+ */
+int async_wait(async_call *call, const char **error);
+
+/* Block until every submitted call has completed */
+void async_drain(async_client *ac);
+
+/* Drain, stop the connection threads and close the connections */
+void async_destroy(async_client *ac);
+
+#endif /* MATRIXOP_ASYNC_H */
@@ -0,0 +1,180 @@
+/*
+ * matrixOp_backend.c - Compute backends behind the server procedures
+ *
+ * The native backend wraps matrixOp_kernels.c. The OpenBLAS backend calls
+ * CBLAS for GEMM and transposes and the Fortran LAPACK getrf/getri for the
+ * inverse. LAPACK is column-major, so it factors the row-major array as
+ * A^T; since inv(A^T) = inv(A)^T, the array it returns is inv(A) row-major.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "matrixOp_kernels.h"
+#include "matrixOp_backend.h"
+
+#ifdef MATRIXOP_OPENBLAS
+#include <cblas.h>
+#endif
+
+/* ===== Native kernels ===== */
+
+static int native_gemm(int trans_a, int trans_b, int m, int n, int k,
+                       double alpha, const double *A, int lda,
+                       const double *B, int ldb,
+                       double beta, double *C, int ldc) {
+    /* Strassen-Winograd only covers the plain accumulating product */
+    if (!trans_a && !trans_b && alpha == 1.0 && beta == 1.0) {
+        return gemm_strassen(m, n, k, A, lda, B, ldb, C, ldc);
+    }
+    return gemm_blocked_scaled(trans_a, trans_b, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+/* Solve A X = I with the blocked LU factorization */
+static int native_inverse(int n, double *A, double *inv, int *pivots, double tol) {
+    if (!lu_factor_blocked(n, A, n, pivots, tol)) {
+        return 0;
+    }
+    memset(inv, 0, (size_t)n * n * sizeof(double));
+    for (int i = 0; i < n; i++) {
+        inv[(size_t)i * n + i] = 1.0;
+    }
+    lu_solve(n, A, n, pivots, n, inv, n);
+    return 1;
+}
+
+static const compute_backend native_backend = {
+    "native", native_gemm, native_inverse, transpose_blocked, transpose_square_inplace
+};
+
+/* ===== OpenBLAS ===== */
+
+#ifdef MATRIXOP_OPENBLAS
+void dgetrf_(const int *m, const int *n, double *a, const int *lda, int *ipiv, int *info);
+void dgetri_(const int *n, double *a, const int *lda, const int *ipiv,
+             double *work, const int *lwork, int *info);
+
+static int openblas_gemm(int trans_a, int trans_b, int m, int n, int k,
+                         double alpha, const double *A, int lda,
+                         const double *B, int ldb,
+                         double beta, double *C, int ldc) {
+    cblas_dgemm(CblasRowMajor, trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
+                m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+    return 1;
+}
+
+/* getri leaves the inverse in A, so inv serves as its workspace until the final copy */
+static int openblas_inverse(int n, double *A, double *inv, int *pivots, double tol) {
+    int info = 0, lwork = n < 64 ? n * n : 64 * n;
+    int ok;
+
+    dgetrf_(&n, &n, A, &n, pivots, &info);
+    ok = info >= 0;
+    /* getrf only flags exact zero pivots; apply the native kernel's tolerance */
+    for (int i = 0; ok && i < n; i++) {
+        if (fabs(A[(size_t)i * n + i]) < tol) ok = 0;
+    }
+    if (ok) {
+        dgetri_(&n, A, &n, pivots, inv, &lwork, &info);
+        ok = info == 0;
+    }
+    if (ok) memcpy(inv, A, (size_t)n * n * sizeof(double));
+    return ok;
+}
+
+static void openblas_transpose(int rows, int cols, const double *A, int lda, double *B, int ldb) {
+    cblas_domatcopy(CblasRowMajor, CblasTrans, rows, cols, 1.0, A, lda, B, ldb);
+}
+
+static void openblas_transpose_inplace(int n, double *A, int lda) {
+    cblas_dimatcopy(CblasRowMajor, CblasTrans, n, n, 1.0, A, lda, lda);
+}
+
+static const compute_backend openblas_backend = {
+    "openblas", openblas_gemm, openblas_inverse, openblas_transpose, openblas_transpose_inplace
+};
+#endif
+
+/* ===== Selection and logging ===== */
+
+static const compute_backend *const backends[] = {
+#ifdef MATRIXOP_OPENBLAS
+    &openblas_backend,
+#endif
+    &native_backend,
+};
+
+/* The first backend built in is the default; changed only at startup */
+static const compute_backend *current = backends[0];
+static int verbose;
+
+int backend_select(const char *name) {
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); i++) {
+        if (strcmp(backends[i]->name, name) == 0) {
+            current = backends[i];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+const char *backend_name(void) {
+    return current->name;
+}
+
+const char *backend_list(void) {
+#ifdef MATRIXOP_OPENBLAS
+    return "openblas, native";
+#else
+    return "native";
+#endif
+}
+
+void backend_set_verbose(int on) {
+    verbose = on;
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void log_call(const char *call, int m, int n, int k, double start) {
+    if (k) {
+        fprintf(stderr, "[%s] %s %dx%dx%d %.3f ms\n", current->name, call, m, n, k, now_ms() - start);
+    } else {
+        fprintf(stderr, "[%s] %s %dx%d %.3f ms\n", current->name, call, m, n, now_ms() - start);
+    }
+}
+
+int backend_gemm(int trans_a, int trans_b, int m, int n, int k,
+                 double alpha, const double *A, int lda,
+                 const double *B, int ldb,
+                 double beta, double *C, int ldc) {
+    double start = verbose ? now_ms() : 0.0;
+    int ok = current->gemm(trans_a, trans_b, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+    if (verbose) log_call("gemm", m, n, k, start);
+    return ok;
+}
+
+int backend_inverse(int n, double *A, double *inv, int *pivots, double tol) {
+    double start = verbose ? now_ms() : 0.0;
+    int ok = current->inverse(n, A, inv, pivots, tol);
+    if (verbose) log_call("inverse", n, n, 0, start);
+    return ok;
+}
+
+void backend_transpose(int rows, int cols, const double *A, int lda, double *B, int ldb) {
+    double start = verbose ? now_ms() : 0.0;
+    current->transpose(rows, cols, A, lda, B, ldb);
+    if (verbose) log_call("transpose", rows, cols, 0, start);
+}
+
+void backend_transpose_inplace(int n, double *A, int lda) {
+    double start = verbose ? now_ms() : 0.0;
+    current->transpose_inplace(n, A, lda);
+    if (verbose) log_call("transpose_inplace", n, n, 0, start);
+}
@@ -0,0 +1,48 @@
+/*
+ * matrixOp_backend.h - Compute backends behind the server procedures: native kernels or CBLAS/LAPACK
+ */
+
+#ifndef MATRIXOP_BACKEND_H
+#define MATRIXOP_BACKEND_H
+
+/*
+ * "native" (matrixOp_kernels.c) is always built in. "openblas" is built in
+ * with MATRIXOP_OPENBLAS (make BLAS=openblas) and is then the default.
+ */
+typedef struct {
+    const char *name;
+    /* C = alpha * op(A) * op(B) + beta * C on row-major arrays; 0 if out of memory */
+    int (*gemm)(int trans_a, int trans_b, int m, int n, int k,
+                double alpha, const double *A, int lda,
+                const double *B, int ldb,
+                double beta, double *C, int ldc);
+    /* inv = A^-1 for an n x n A, which is overwritten, using n pivots of caller scratch; 0 if a pivot falls below tol */
+    int (*inverse)(int n, double *A, double *inv, int *pivots, double tol);
+    /* B = A^T, A rows x cols */
+    void (*transpose)(int rows, int cols, const double *A, int lda, double *B, int ldb);
+    /* A = A^T for an n x n A */
+    void (*transpose_inplace)(int n, double *A, int lda);
+} compute_backend;
+
+/* Make the named backend serve all later calls; 0 if it is unknown or not built in */
+int backend_select(const char *name);
+
+/* Name of the backend serving calls */
+const char *backend_name(void);
+
+/* Comma-separated names of the backends built in */
+const char *backend_list(void);
+
+/* With verbose set, every backend call is logged to stderr with its backend, shape and time */
+void backend_set_verbose(int verbose);
+
+/* Calls routed to the selected backend */
+int backend_gemm(int trans_a, int trans_b, int m, int n, int k,
+                 double alpha, const double *A, int lda,
+                 const double *B, int ldb,
+                 double beta, double *C, int ldc);
+int backend_inverse(int n, double *A, double *inv, int *pivots, double tol);
+void backend_transpose(int rows, int cols, const double *A, int lda, double *B, int ldb);
+void backend_transpose_inplace(int n, double *A, int lda);
+
+#endif /* MATRIXOP_BACKEND_H */
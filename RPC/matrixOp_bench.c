@@ -0,0 +1,437 @@
+/*
+ * matrixOp_bench.c - Load generator: throughput and latency percentiles as JSON
+ *
+ * Each client thread owns one connection and issues requests back to back,
+ * drawing the operation from the weighted mix and the size from the size
+ * list. Operands up to MAX_SIZE elements go through the single-call
+ * procedures, bigger ones through the staged transfer. Requests started
+ * during the warm-up are not counted. With a list of concurrency levels,
+ * one run per level is reported, which gives a throughput curve.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdint.h>
+#include "matrixOp.h"
+#include "matrixOp_transfer.h"
+
+#define MAX_LIST 32
+
+typedef struct {
+    const char *name;
+    matrix_op op;
+    int binary;
+} bench_op;
+
+static const bench_op ops[] = {
+    { "add", OP_ADD, 1 },
+    { "mult", OP_MULT, 1 },
+    { "transpose", OP_TRANSPOSE, 0 },
+    { "inverse", OP_INVERSE, 0 },
+    { "solve", OP_SOLVE, 1 },          /* one right-hand side */
+};
+#define NUM_OPS (int)(sizeof(ops) / sizeof(ops[0]))
+
+/* Latencies of successful requests, in microseconds */
+typedef struct {
+    double *values;
+    size_t count;
+    size_t capacity;
+} latency_log;
+
+typedef struct {
+    latency_log latency[NUM_OPS];
+    uint64_t requests[NUM_OPS];
+    uint64_t errors[NUM_OPS];
+    uint64_t bytes;
+} bench_counts;
+
+typedef struct {
+    const char *host;
+    int udp;
+    int weights[NUM_OPS];
+    int total_weight;
+    int sizes[MAX_LIST];
+    int num_sizes;
+    int same_operands;
+    double warmup;
+    double duration;
+} bench_config;
+
+typedef struct {
+    const bench_config *config;
+    CLIENT *clnt;
+    unsigned int seed;
+    double **A;             /* per size: diagonally dominant n x n */
+    double **B;
+    uint64_t serial;
+    bench_counts counts;
+    char last_error[128];
+} bench_thread;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void log_latency(latency_log *log, double us) {
+    if (log->count == log->capacity) {
+        size_t capacity = log->capacity ? 2 * log->capacity : 4096;
+        double *grown = (double *)realloc(log->values, capacity * sizeof(double));
+        if (!grown) return;
+        log->values = grown;
+        log->capacity = capacity;
+    }
+    log->values[log->count++] = us;
+}
+
+static void keep_error(bench_thread *t, const char *msg) {
+    snprintf(t->last_error, sizeof(t->last_error), "%s", msg ? msg : "unknown failure");
+}
+
+static int discard_rows(int row, int rows, int cols, const double *data, void *ctx) {
+    (void)row; (void)rows; (void)cols; (void)data; (void)ctx;
+    return 1;
+}
+
+/* One request; payload bytes are the matrix elements sent and received */
+static int run_request(bench_thread *t, const bench_op *op, int size_index, uint64_t *bytes) {
+    int n = t->config->sizes[size_index];
+    double *A = t->A[size_index];
+    double *B = t->B[size_index];
+    int b_cols = op->op == OP_SOLVE ? 1 : n;
+    size_t result = (size_t)n * b_cols;
+
+    /* Vary the operand so the result cache does not answer */
+    if (!t->config->same_operands) A[0] = n + 1 + (double)(t->serial++ % 1000000) * 1e-9;
+    *bytes = sizeof(double) * ((size_t)n * n + (op->binary ? (size_t)n * b_cols : 0) + result);
+
+    if ((size_t)n * n <= MAX_SIZE) {
+        matrix a = { n, n, { n * n, A } };
+        matrix b = { n, b_cols, { n * b_cols, B } };
+        matrix_pair pair = { a, b };
+        matrix_result *r = NULL;
+        switch (op->op) {
+            case OP_ADD:       r = matrix_add_1(&pair, t->clnt); break;
+            case OP_MULT:      r = matrix_mult_1(&pair, t->clnt); break;
+            case OP_SOLVE:     r = matrix_solve_1(&pair, t->clnt); break;
+            case OP_INVERSE:   r = matrix_inverse_1(&a, t->clnt); break;
+            case OP_TRANSPOSE: r = matrix_transpose_1(&a, t->clnt); break;
+            default: break;
+        }
+        if (r == NULL) {
+            keep_error(t, clnt_sperror(t->clnt, op->name));
+            return 0;
+        }
+        int ok = r->success;
+        if (!ok) keep_error(t, r->error_msg);
+        xdr_free((xdrproc_t)xdr_matrix_result, (char *)r);
+        return ok;
+    }
+
+    const char *error = NULL;
+    int ok = transfer_run(t->clnt, op->op, n, n, A, n, b_cols, B, discard_rows, NULL, NULL, NULL, &error);
+    if (!ok) keep_error(t, error);
+    return ok;
+}
+
+static void *bench_main(void *arg) {
+    bench_thread *t = (bench_thread *)arg;
+    const bench_config *config = t->config;
+    double start = now_seconds();
+    double counted_from = start + config->warmup;
+    double end = counted_from + config->duration;
+
+    for (double begin = start; begin < end; ) {
+        int pick = rand_r(&t->seed) % config->total_weight;
+        int k = 0;
+        while (pick >= config->weights[k]) pick -= config->weights[k++];
+        int size_index = rand_r(&t->seed) % config->num_sizes;
+        uint64_t bytes;
+
+        int ok = run_request(t, &ops[k], size_index, &bytes);
+        double finish = now_seconds();
+        if (begin >= counted_from) {
+            t->counts.requests[k]++;
+            if (ok) {
+                t->counts.bytes += bytes;
+                log_latency(&t->counts.latency[k], (finish - begin) * 1e6);
+            } else {
+                t->counts.errors[k]++;
+            }
+        }
+        begin = finish;
+    }
+    return NULL;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, size_t count, double p) {
+    if (count == 0) return 0.0;
+    size_t rank = (size_t)(p * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+static void print_latency(latency_log *log) {
+    qsort(log->values, log->count, sizeof(double), compare_doubles);
+    printf("{\"p50\": %.1f, \"p99\": %.1f, \"p999\": %.1f, \"max\": %.1f}",
+           percentile(log->values, log->count, 0.50), percentile(log->values, log->count, 0.99),
+           percentile(log->values, log->count, 0.999),
+           log->count ? log->values[log->count - 1] : 0.0);
+}
+
+static void merge_log(latency_log *into, const latency_log *from) {
+    for (size_t i = 0; i < from->count; i++) log_latency(into, from->values[i]);
+}
+
+static CLIENT *bench_connect(const bench_config *config) {
+    if (config->udp) {
+        return clnt_create(config->host, MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS, "udp");
+    }
+    return transfer_connect(config->host);
+}
+
+/* Operands for every size; diagonal dominance keeps inverse and solve well posed */
+static int make_operands(bench_thread *t) {
+    const bench_config *config = t->config;
+    t->A = (double **)calloc(config->num_sizes, sizeof(double *));
+    t->B = (double **)calloc(config->num_sizes, sizeof(double *));
+    if (!t->A || !t->B) return 0;
+    for (int s = 0; s < config->num_sizes; s++) {
+        int n = config->sizes[s];
+        t->A[s] = (double *)malloc((size_t)n * n * sizeof(double));
+        t->B[s] = (double *)malloc((size_t)n * n * sizeof(double));
+        if (!t->A[s] || !t->B[s]) return 0;
+        for (size_t i = 0; i < (size_t)n * n; i++) {
+            t->A[s][i] = (double)rand_r(&t->seed) / RAND_MAX - 0.5;
+            t->B[s][i] = (double)rand_r(&t->seed) / RAND_MAX - 0.5;
+        }
+        for (int i = 0; i < n; i++) t->A[s][(size_t)i * n + i] += n;
+    }
+    return 1;
+}
+
+static void free_thread(bench_thread *t) {
+    for (int s = 0; t->A && s < t->config->num_sizes; s++) free(t->A[s]);
+    for (int s = 0; t->B && s < t->config->num_sizes; s++) free(t->B[s]);
+    free(t->A);
+    free(t->B);
+    for (int k = 0; k < NUM_OPS; k++) free(t->counts.latency[k].values);
+    if (t->clnt) clnt_destroy(t->clnt);
+}
+
+/* One run at the given concurrency, printed as a JSON object */
+static int run_level(const bench_config *config, int concurrency) {
+    bench_thread *threads = (bench_thread *)calloc(concurrency, sizeof(bench_thread));
+    pthread_t *tids = (pthread_t *)calloc(concurrency, sizeof(pthread_t));
+    int ok = threads && tids;
+    int started = 0;
+
+    for (int i = 0; ok && i < concurrency; i++) {
+        threads[i].config = config;
+        threads[i].seed = 1234u + i;
+        threads[i].clnt = bench_connect(config);
+        if (!threads[i].clnt) {
+            clnt_pcreateerror(config->host);
+            ok = 0;
+        } else if (!make_operands(&threads[i])) {
+            fprintf(stderr, "out of memory for operands\n");
+            ok = 0;
+        }
+    }
+    for (int i = 0; ok && i < concurrency; i++) {
+        if (pthread_create(&tids[i], NULL, bench_main, &threads[i]) != 0) {
+            fprintf(stderr, "cannot start client thread\n");
+            ok = 0;
+            break;
+        }
+        started++;
+    }
+    for (int i = 0; i < started; i++) pthread_join(tids[i], NULL);
+
+    if (ok) {
+        bench_counts total;
+        latency_log all = { NULL, 0, 0 };
+        memset(&total, 0, sizeof(total));
+        for (int i = 0; i < concurrency; i++) {
+            total.bytes += threads[i].counts.bytes;
+            for (int k = 0; k < NUM_OPS; k++) {
+                total.requests[k] += threads[i].counts.requests[k];
+                total.errors[k] += threads[i].counts.errors[k];
+                merge_log(&total.latency[k], &threads[i].counts.latency[k]);
+            }
+        }
+        uint64_t requests = 0, errors = 0;
+        for (int k = 0; k < NUM_OPS; k++) {
+            requests += total.requests[k];
+            errors += total.errors[k];
+            merge_log(&all, &total.latency[k]);
+        }
+
+        printf("    {\"concurrency\": %d, \"requests\": %llu, \"errors\": %llu, "
+               "\"ops_per_sec\": %.1f, \"bytes_per_sec\": %.0f,\n     \"latency_us\": ",
+               concurrency, (unsigned long long)requests, (unsigned long long)errors,
+               (requests - errors) / config->duration, total.bytes / config->duration);
+        print_latency(&all);
+        printf(",\n     \"operations\": {");
+        int first = 1;
+        for (int k = 0; k < NUM_OPS; k++) {
+            if (!config->weights[k]) continue;
+            printf("%s\n       \"%s\": {\"requests\": %llu, \"errors\": %llu, \"ops_per_sec\": %.1f, \"latency_us\": ",
+                   first ? "" : ",", ops[k].name, (unsigned long long)total.requests[k],
+                   (unsigned long long)total.errors[k],
+                   (total.requests[k] - total.errors[k]) / config->duration);
+            print_latency(&total.latency[k]);
+            printf("}");
+            first = 0;
+        }
+        printf("}}");
+
+        for (int i = 0; errors && i < concurrency; i++) {
+            if (threads[i].last_error[0]) {
+                fprintf(stderr, "last error: %s\n", threads[i].last_error);
+                break;
+            }
+        }
+        for (int k = 0; k < NUM_OPS; k++) free(total.latency[k].values);
+        free(all.values);
+    }
+
+    for (int i = 0; threads && i < concurrency; i++) free_thread(&threads[i]);
+    free(threads);
+    free(tids);
+    return ok;
+}
+
+/* Comma-separated positive integers; returns how many were read, 0 on a bad list */
+static int parse_list(const char *text, int *values) {
+    int count = 0;
+    char *copy = strdup(text), *save = NULL;
+    for (char *item = strtok_r(copy, ",", &save); item; item = strtok_r(NULL, ",", &save)) {
+        int v = atoi(item);
+        if (v <= 0 || count == MAX_LIST) {
+            count = 0;
+            break;
+        }
+        values[count++] = v;
+    }
+    free(copy);
+    return count;
+}
+
+/* "mult=3,add=1"; a name without a weight counts once */
+static int parse_mix(const char *text, bench_config *config) {
+    char *copy = strdup(text), *save = NULL;
+    int ok = 1;
+    for (char *item = strtok_r(copy, ",", &save); item && ok; item = strtok_r(NULL, ",", &save)) {
+        char *eq = strchr(item, '=');
+        int weight = 1;
+        if (eq) {
+            *eq = '\0';
+            weight = atoi(eq + 1);
+        }
+        ok = 0;
+        for (int k = 0; k < NUM_OPS; k++) {
+            if (strcmp(item, ops[k].name) == 0 && weight > 0) {
+                config->weights[k] += weight;
+                config->total_weight += weight;
+                ok = 1;
+            }
+        }
+    }
+    free(copy);
+    return ok && config->total_weight > 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [options] <server_address>\n", prog);
+    fprintf(stderr, "  -o mix       operations and weights, e.g. mult=3,add=1 (add, mult, transpose, inverse, solve; default mult)\n");
+    fprintf(stderr, "  -s sizes     square matrix sizes, picked uniformly (default 8)\n");
+    fprintf(stderr, "  -c levels    concurrent connections, one run per level (default 1)\n");
+    fprintf(stderr, "  -d seconds   measured duration of each run (default 10)\n");
+    fprintf(stderr, "  -w seconds   warm-up before measuring (default 1)\n");
+    fprintf(stderr, "  -u           use UDP (single-call sizes only, at most %d elements)\n", MAX_SIZE);
+    fprintf(stderr, "  -r           repeat identical operands, so cacheable results hit the result cache\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    bench_config config;
+    int levels[MAX_LIST] = { 1 };
+    int num_levels = 1;
+    const char *mix = "mult";
+    int opt;
+
+    memset(&config, 0, sizeof(config));
+    config.sizes[0] = 8;
+    config.num_sizes = 1;
+    config.duration = 10.0;
+    config.warmup = 1.0;
+
+    while ((opt = getopt(argc, argv, "o:s:c:d:w:ur")) != -1) {
+        switch (opt) {
+            case 'o': mix = optarg; break;
+            case 's':
+                config.num_sizes = parse_list(optarg, config.sizes);
+                if (!config.num_sizes) usage(argv[0]);
+                break;
+            case 'c':
+                num_levels = parse_list(optarg, levels);
+                if (!num_levels) usage(argv[0]);
+                break;
+            case 'd':
+                config.duration = atof(optarg);
+                if (config.duration <= 0) usage(argv[0]);
+                break;
+            case 'w':
+                config.warmup = atof(optarg);
+                if (config.warmup < 0) usage(argv[0]);
+                break;
+            case 'u': config.udp = 1; break;
+            case 'r': config.same_operands = 1; break;
+            default: usage(argv[0]);
+        }
+    }
+    if (optind != argc - 1 || !parse_mix(mix, &config)) usage(argv[0]);
+    config.host = argv[optind];
+
+    for (int s = 0; s < config.num_sizes; s++) {
+        int n = config.sizes[s];
+        if (n > MAX_STAGE_DIM || (config.udp && n * n > MAX_SIZE)) {
+            fprintf(stderr, "size %d is not supported over %s\n", n, config.udp ? "udp" : "tcp");
+            return 1;
+        }
+    }
+
+    printf("{\"server\": \"%s\", \"transport\": \"%s\", \"duration_s\": %.1f, \"warmup_s\": %.1f,\n",
+           config.host, config.udp ? "udp" : "tcp", config.duration, config.warmup);
+    printf(" \"mix\": {");
+    for (int k = 0, first = 1; k < NUM_OPS; k++) {
+        if (!config.weights[k]) continue;
+        printf("%s\"%s\": %d", first ? "" : ", ", ops[k].name, config.weights[k]);
+        first = 0;
+    }
+    printf("}, \"sizes\": [");
+    for (int s = 0; s < config.num_sizes; s++) printf("%s%d", s ? ", " : "", config.sizes[s]);
+    printf("], \"identical_operands\": %s,\n \"runs\": [\n", config.same_operands ? "true" : "false");
+
+    int ok = 1;
+    for (int l = 0; l < num_levels && ok; l++) {
+        if (l) printf(",\n");
+        fflush(stdout);
+        ok = run_level(&config, levels[l]);
+    }
+    printf("\n ]}\n");
+    return ok ? 0 : 1;
+}
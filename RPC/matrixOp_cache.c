@@ -0,0 +1,259 @@
+/*
+ * matrixOp_cache.c - Content-addressed cache of operation results, evicted LRU under a byte budget
+ *
+ * Keys are XXH64 over the operand bytes plus the operation and shapes, so a
+ * repeated request costs one pass over its operands and a copy of the
+ * result instead of the O(n^3) computation. Results are not verified
+ * against the operands, so a 64-bit hash collision would return a wrong
+ * result; at the cache sizes involved that is negligible.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "matrixOp_cache.h"
+
+#define CACHE_BUCKETS 1024
+
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+typedef struct cache_entry {
+    cache_key key;
+    int rows;
+    int cols;
+    double *data;
+    size_t bytes;
+    struct cache_entry *lru_prev;   /* towards most recently used */
+    struct cache_entry *lru_next;
+    struct cache_entry *hash_next;
+} cache_entry;
+
+/* cache_lock guards everything below */
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static cache_entry *buckets[CACHE_BUCKETS];
+static cache_entry *lru_head;
+static cache_entry *lru_tail;
+static size_t used_bytes;
+static size_t entry_count;
+static size_t budget_bytes = (size_t)CACHE_DEFAULT_BUDGET_MB << 20;
+static uint64_t hits, misses, evictions;
+
+static uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t read64(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t read32(const unsigned char *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint64_t xxh64_round(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static uint64_t xxh64_merge(uint64_t acc, uint64_t val) {
+    acc ^= xxh64_round(0, val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+/* XXH64 of a byte buffer */
+static uint64_t xxh64(const void *input, size_t len, uint64_t seed) {
+    const unsigned char *p = (const unsigned char *)input;
+    const unsigned char *end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+        uint64_t v2 = seed + PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME64_1;
+        const unsigned char *limit = end - 32;
+        do {
+            v1 = xxh64_round(v1, read64(p));
+            v2 = xxh64_round(v2, read64(p + 8));
+            v3 = xxh64_round(v3, read64(p + 16));
+            v4 = xxh64_round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh64_merge(h, v1);
+        h = xxh64_merge(h, v2);
+        h = xxh64_merge(h, v3);
+        h = xxh64_merge(h, v4);
+    } else {
+        h = seed + PRIME64_5;
+    }
+    h += (uint64_t)len;
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxh64_round(0, read64(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        h ^= (uint64_t)read32(p) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        h ^= (uint64_t)(*p) * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+static int key_equal(const cache_key *x, const cache_key *y) {
+    return x->hash == y->hash && x->op == y->op &&
+           x->a_rows == y->a_rows && x->a_cols == y->a_cols &&
+           x->b_rows == y->b_rows && x->b_cols == y->b_cols;
+}
+
+static cache_entry **bucket_of(const cache_key *key) {
+    return &buckets[key->hash % CACHE_BUCKETS];
+}
+
+static void lru_unlink(cache_entry *e) {
+    if (e->lru_prev) e->lru_prev->lru_next = e->lru_next;
+    else lru_head = e->lru_next;
+    if (e->lru_next) e->lru_next->lru_prev = e->lru_prev;
+    else lru_tail = e->lru_prev;
+    e->lru_prev = e->lru_next = NULL;
+}
+
+static void lru_push_front(cache_entry *e) {
+    e->lru_prev = NULL;
+    e->lru_next = lru_head;
+    if (lru_head) lru_head->lru_prev = e;
+    lru_head = e;
+    if (!lru_tail) lru_tail = e;
+}
+
+static void evict(cache_entry *e) {
+    cache_entry **link = bucket_of(&e->key);
+    while (*link != e) link = &(*link)->hash_next;
+    *link = e->hash_next;
+    lru_unlink(e);
+    used_bytes -= e->bytes;
+    entry_count--;
+    evictions++;
+    free(e->data);
+    free(e);
+}
+
+static cache_entry *find(const cache_key *key) {
+    cache_entry *e = *bucket_of(key);
+    while (e && !key_equal(&e->key, key)) e = e->hash_next;
+    return e;
+}
+
+void cache_set_budget(size_t bytes) {
+    pthread_mutex_lock(&cache_lock);
+    budget_bytes = bytes;
+    while (used_bytes > budget_bytes && lru_tail) evict(lru_tail);
+    pthread_mutex_unlock(&cache_lock);
+}
+
+int cache_key_init(cache_key *key, int op,
+                   int a_rows, int a_cols, const double *a,
+                   int b_rows, int b_cols, const double *b) {
+    pthread_mutex_lock(&cache_lock);
+    int enabled = budget_bytes > 0;
+    pthread_mutex_unlock(&cache_lock);
+    if (!enabled) return 0;
+
+    memset(key, 0, sizeof(*key));
+    key->op = op;
+    key->a_rows = a_rows;
+    key->a_cols = a_cols;
+    key->hash = xxh64(a, (size_t)a_rows * a_cols * sizeof(double), (uint64_t)op);
+    if (b) {
+        key->b_rows = b_rows;
+        key->b_cols = b_cols;
+        key->hash = xxh64(b, (size_t)b_rows * b_cols * sizeof(double), key->hash);
+    }
+    return 1;
+}
+
+int cache_lookup(const cache_key *key, int rows, int cols, double *out) {
+    pthread_mutex_lock(&cache_lock);
+    cache_entry *e = find(key);
+    int hit = e && e->rows == rows && e->cols == cols;
+    if (hit) {
+        memcpy(out, e->data, e->bytes);
+        lru_unlink(e);
+        lru_push_front(e);
+        hits++;
+    } else {
+        misses++;
+    }
+    pthread_mutex_unlock(&cache_lock);
+    return hit;
+}
+
+void cache_insert(const cache_key *key, int rows, int cols, const double *result) {
+    size_t bytes = (size_t)rows * cols * sizeof(double);
+
+    pthread_mutex_lock(&cache_lock);
+    int fits = bytes <= budget_bytes && !find(key);
+    pthread_mutex_unlock(&cache_lock);
+    if (!fits) return;
+
+    /* Copy outside the lock; another thread may insert the same key meanwhile */
+    cache_entry *e = (cache_entry *)calloc(1, sizeof(cache_entry));
+    double *data = (double *)malloc(bytes);
+    if (!e || !data) {
+        free(e);
+        free(data);
+        return;
+    }
+    memcpy(data, result, bytes);
+    e->key = *key;
+    e->rows = rows;
+    e->cols = cols;
+    e->data = data;
+    e->bytes = bytes;
+
+    pthread_mutex_lock(&cache_lock);
+    if (bytes > budget_bytes || find(key)) {
+        pthread_mutex_unlock(&cache_lock);
+        free(data);
+        free(e);
+        return;
+    }
+    while (used_bytes + bytes > budget_bytes && lru_tail) evict(lru_tail);
+    e->hash_next = *bucket_of(key);
+    *bucket_of(key) = e;
+    lru_push_front(e);
+    used_bytes += bytes;
+    entry_count++;
+    pthread_mutex_unlock(&cache_lock);
+}
+
+void cache_get_counters(cache_counters *counters) {
+    pthread_mutex_lock(&cache_lock);
+    counters->hits = hits;
+    counters->misses = misses;
+    counters->evictions = evictions;
+    counters->entries = entry_count;
+    counters->bytes = used_bytes;
+    counters->budget = budget_bytes;
+    pthread_mutex_unlock(&cache_lock);
+}
@@ -0,0 +1,52 @@
+/*
+ * matrixOp_cache.h - Content-addressed cache of operation results, evicted LRU under a byte budget
+ */
+
+#ifndef MATRIXOP_CACHE_H
+#define MATRIXOP_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Default memory budget for cached results */
+#define CACHE_DEFAULT_BUDGET_MB 256
+
+/* Identifies an operation by what it computes: operation, shapes and a hash of the operand bytes */
+typedef struct {
+    uint64_t hash;
+    int op;
+    int a_rows;
+    int a_cols;
+    int b_rows;
+    int b_cols;
+} cache_key;
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t entries;
+    size_t bytes;
+    size_t budget;
+} cache_counters;
+
+/* Cap on cached result bytes; 0 disables the cache and drops everything in it */
+void cache_set_budget(size_t bytes);
+
+/*
+ * Hash op and operands (b may be NULL for unary operations) into a key.
+ * Returns 0 without hashing when the cache is disabled.
+ */
+int cache_key_init(cache_key *key, int op,
+                   int a_rows, int a_cols, const double *a,
+                   int b_rows, int b_cols, const double *b);
+
+/* Copy a cached rows x cols result into out; returns 1 on a hit */
+int cache_lookup(const cache_key *key, int rows, int cols, double *out);
+
+/* Remember a result (copied); silently skipped when it cannot fit the budget */
+void cache_insert(const cache_key *key, int rows, int cols, const double *result);
+
+void cache_get_counters(cache_counters *counters);
+
+#endif /* MATRIXOP_CACHE_H */
@@ -5,7 +5,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <sys/time.h>
 #include "matrixOp.h"
+#include "matrixOp_transfer.h"
+#include "matrixOp_async.h"
+#include "matrixOp_distributed.h"
 
 /* Function to print a matrix */
 void print_matrix(const matrix *mat) {
@@ -29,8 +34,8 @@ matrix *input_matrix(const char *name) {
         return NULL;
     }
     
-    if (rows <= 0 || cols <= 0 || rows * cols > MAX_SIZE) {
-        printf("Invalid dimensions! Maximum size is %d elements.\n", MAX_SIZE);
+    if (rows <= 0 || cols <= 0 || rows > MAX_STAGE_DIM || cols > MAX_STAGE_DIM) {
+        printf("Invalid dimensions! Maximum is %d rows and %d columns.\n", MAX_STAGE_DIM, MAX_STAGE_DIM);
         return NULL;
     }
     
@@ -99,6 +104,477 @@ matrix_pair create_matrix_pair(matrix *first, matrix *second) {
     return pair;
 }
 
+/* Matrices above MAX_SIZE elements go through the staged transfer procedures */
+static int needs_staging(const matrix *a, const matrix *b) {
+    return a->data.data_len > MAX_SIZE || (b && b->data.data_len > MAX_SIZE);
+}
+
+/* Collect streamed result rows into a matrix */
+static int collect_rows(int row, int rows, int cols, const double *data, void *ctx) {
+    matrix *out = (matrix *)ctx;
+    memcpy(out->data.data_val + (size_t)row * cols, data, (size_t)rows * cols * sizeof(double));
+    return 1;
+}
+
+/* Run an operation through the staged procedures and print the result */
+static void run_staged_operation(CLIENT *clnt, matrix_op op, const matrix *a, const matrix *b, const char *name) {
+    int rows = (op == OP_TRANSPOSE || op == OP_LSTSQ) ? a->cols : a->rows;
+    int cols = (op == OP_MULT || op == OP_SOLVE || op == OP_SOLVE_MIXED || op == OP_LSTSQ) ? b->cols :
+               (op == OP_TRANSPOSE) ? a->rows : a->cols;
+    const char *error = NULL;
+    matrix out;
+    
+    out.rows = rows;
+    out.cols = cols;
+    out.data.data_len = rows * cols;
+    out.data.data_val = (double *)malloc((size_t)rows * cols * sizeof(double));
+    if (!out.data.data_val) {
+        printf("Memory allocation failed for result!\n");
+        return;
+    }
+    
+    if (transfer_run(clnt, op, a->rows, a->cols, a->data.data_val,
+                     b ? b->rows : 0, b ? b->cols : 0, b ? b->data.data_val : NULL,
+                     collect_rows, &out, NULL, NULL, &error)) {
+        printf("\n%s Result (staged transfer):\n", name);
+        print_matrix(&out);
+    } else {
+        printf("Error: %s\n", error);
+    }
+    free(out.data.data_val);
+}
+
+/* Verification state for the large-matrix demo: B is needed to spot-check result rows */
+typedef struct {
+    const double *A;
+    const double *B;
+    int n;
+    int rows_seen;
+    double max_error;
+} large_check;
+
+/* Consume result rows as they stream in: spot-check one element per row */
+static int check_large_rows(int row, int rows, int cols, const double *data, void *ctx) {
+    large_check *check = (large_check *)ctx;
+    
+    for (int i = 0; i < rows; i++) {
+        int r = row + i;
+        int c = (r * 7919) % cols;
+        double expected = 0.0;
+        for (int k = 0; k < check->n; k++) {
+            expected += check->A[(size_t)r * check->n + k] * check->B[(size_t)k * cols + c];
+        }
+        double err = fabs(expected - data[(size_t)i * cols + c]);
+        if (err > check->max_error) check->max_error = err;
+    }
+    check->rows_seen += rows;
+    return 1;
+}
+
+static double elapsed_since(const struct timeval *start) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (now.tv_sec - start->tv_sec) + (now.tv_usec - start->tv_usec) / 1e6;
+}
+
+/* Multiply two random n x n matrices through the staged procedures */
+void run_large_client(const char *server_address, int n) {
+    CLIENT *clnt;
+    const char *error = NULL;
+    struct timeval start;
+    
+    if (n <= 0 || n > MAX_STAGE_DIM) {
+        printf("Matrix size must be between 1 and %d\n", MAX_STAGE_DIM);
+        return;
+    }
+    
+    clnt = transfer_connect(server_address);
+    if (clnt == NULL) {
+        clnt_pcreateerror(server_address);
+        return;
+    }
+    
+    double *A = (double *)malloc((size_t)n * n * sizeof(double));
+    double *B = (double *)malloc((size_t)n * n * sizeof(double));
+    if (!A || !B) {
+        printf("Memory allocation failed for %dx%d operands!\n", n, n);
+        free(A);
+        free(B);
+        clnt_destroy(clnt);
+        return;
+    }
+    srand(42);
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        A[i] = (double)rand() / RAND_MAX - 0.5;
+        B[i] = (double)rand() / RAND_MAX - 0.5;
+    }
+    
+    large_check check = { A, B, n, 0, 0.0 };
+    rpcvers_t vers = MATRIX_OPERATIONS_VERS;
+    clnt_control(clnt, CLGET_VERS, (char *)&vers);
+    printf("Multiplying two %dx%d matrices on %s via staged transfer (interface version %u)\n",
+           n, n, server_address, (unsigned int)vers);
+    gettimeofday(&start, NULL);
+    
+    if (transfer_run(clnt, OP_MULT, n, n, A, n, n, B, check_large_rows, &check, NULL, NULL, &error)) {
+        double seconds = elapsed_since(&start);
+        double megabytes = 3.0 * n * n * sizeof(double) / (1024.0 * 1024.0);
+        printf("Received %d result rows in %.3f seconds (%.1f MB moved, %.1f MB/s)\n",
+               check.rows_seen, seconds, megabytes, megabytes / seconds);
+        printf("Max spot-check error: %.3e\n", check.max_error);
+    } else {
+        printf("Staged multiplication failed: %s\n", error);
+    }
+    
+    free(A);
+    free(B);
+    clnt_destroy(clnt);
+}
+
+/* Multiply two random n x n matrices in a segment shared with a server on this host */
+void run_shm_client(const char *server_address, int n) {
+    const char *error = NULL;
+    struct timeval start;
+    transfer_segment seg;
+    
+    if (n <= 0 || n > MAX_STAGE_DIM) {
+        printf("Matrix size must be between 1 and %d\n", MAX_STAGE_DIM);
+        return;
+    }
+    
+    CLIENT *clnt = transfer_connect(server_address);
+    if (clnt == NULL) {
+        clnt_pcreateerror(server_address);
+        return;
+    }
+    
+    size_t bytes = (size_t)n * n * sizeof(double);
+    if (!transfer_shm_create(clnt, 3 * bytes, &seg, &error)) {
+        printf("Shared memory unavailable: %s\n", error);
+        clnt_destroy(clnt);
+        return;
+    }
+    
+    /* Operands are generated in place: A, B and the result C follow each other in the segment */
+    double *A = (double *)seg.base;
+    double *B = A + (size_t)n * n;
+    double *C = B + (size_t)n * n;
+    srand(42);
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        A[i] = (double)rand() / RAND_MAX - 0.5;
+        B[i] = (double)rand() / RAND_MAX - 0.5;
+    }
+    
+    large_check check = { A, B, n, 0, 0.0 };
+    printf("Multiplying two %dx%d matrices on %s in shared memory\n", n, n, server_address);
+    gettimeofday(&start, NULL);
+    
+    if (transfer_shm_apply(clnt, &seg, OP_MULT, 0, n, n, bytes, n, n, 2 * bytes, NULL, NULL, &error)) {
+        double seconds = elapsed_since(&start);
+        check_large_rows(0, n, n, C, &check);
+        printf("Result of %d rows ready in %.3f seconds\n", check.rows_seen, seconds);
+        printf("Max spot-check error: %.3e\n", check.max_error);
+    } else {
+        printf("Shared memory multiplication failed: %s\n", error);
+    }
+    
+    transfer_shm_destroy(clnt, &seg);
+    clnt_destroy(clnt);
+}
+
+/* Multiply two random n x n matrices with tiles spread over comma-separated endpoints */
+void run_distributed_client(const char *endpoint_list, int n, int tile) {
+    const char *endpoints[DISTRIBUTED_MAX_ENDPOINTS];
+    char list[1024];
+    int count = 0;
+    struct timeval start;
+    
+    snprintf(list, sizeof(list), "%s", endpoint_list);
+    for (char *save = NULL, *e = strtok_r(list, ",", &save); e && count < DISTRIBUTED_MAX_ENDPOINTS;
+         e = strtok_r(NULL, ",", &save)) {
+        endpoints[count++] = e;
+    }
+    if (n <= 0 || count == 0) {
+        printf("Matrix size must be positive and at least one endpoint given\n");
+        return;
+    }
+    
+    double *A = (double *)malloc((size_t)n * n * sizeof(double));
+    double *B = (double *)malloc((size_t)n * n * sizeof(double));
+    double *C = (double *)malloc((size_t)n * n * sizeof(double));
+    if (!A || !B || !C) {
+        printf("Memory allocation failed for %dx%d operands!\n", n, n);
+        free(A); free(B); free(C);
+        return;
+    }
+    srand(42);
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        A[i] = (double)rand() / RAND_MAX - 0.5;
+        B[i] = (double)rand() / RAND_MAX - 0.5;
+    }
+    
+    printf("Multiplying two %dx%d matrices across %d endpoints\n", n, n, count);
+    distributed_options options = { tile, 0, 0 };
+    distributed_report report;
+    const char *error = NULL;
+    gettimeofday(&start, NULL);
+    
+    if (distributed_mult(endpoints, count, n, n, n, A, B, C, &options, &report, &error)) {
+        large_check check = { A, B, n, 0, 0.0 };
+        check_large_rows(0, n, n, C, &check);
+        printf("Finished %d tiles in %.3f seconds (%d retries, %d endpoints lost)\n",
+               report.tiles, elapsed_since(&start), report.retries, report.endpoints_lost);
+        for (int e = 0; e < count; e++) {
+            printf("  %-24s %d tiles\n", endpoints[e], report.tiles_done[e]);
+        }
+        printf("Max spot-check error: %.3e\n", check.max_error);
+    } else {
+        printf("Distributed multiplication failed: %s\n", error);
+    }
+    
+    free(A); free(B); free(C);
+}
+
+/* Row sums of a streamed result, for checking the chained product */
+typedef struct {
+    const double *expected;
+    double max_error;
+} row_sum_check;
+
+static int check_row_sums(int row, int rows, int cols, const double *data, void *ctx) {
+    row_sum_check *check = (row_sum_check *)ctx;
+    
+    for (int i = 0; i < rows; i++) {
+        double sum = 0.0;
+        for (int j = 0; j < cols; j++) sum += data[(size_t)i * cols + j];
+        double err = fabs(sum - check->expected[row + i]);
+        if (err > check->max_error) check->max_error = err;
+    }
+    return 1;
+}
+
+/*
+ * Compute A * P^steps with every intermediate kept on the server.
+ * P has rows summing to 1, so each row sum of the result equals A's.
+ */
+void run_chain_client(const char *server_address, int n, int steps) {
+    CLIENT *clnt;
+    const char *error = NULL;
+    struct timeval start;
+    int a_handle = 0, p_handle = 0, x_handle = 0;
+    
+    if (n <= 0 || n > MAX_STAGE_DIM || steps <= 0) {
+        printf("Matrix size must be between 1 and %d and steps positive\n", MAX_STAGE_DIM);
+        return;
+    }
+    
+    clnt = transfer_connect(server_address);
+    if (clnt == NULL) {
+        clnt_pcreateerror(server_address);
+        return;
+    }
+    
+    double *A = (double *)malloc((size_t)n * n * sizeof(double));
+    double *P = (double *)malloc((size_t)n * n * sizeof(double));
+    double *sums = (double *)calloc(n, sizeof(double));
+    if (!A || !P || !sums) {
+        printf("Memory allocation failed for %dx%d operands!\n", n, n);
+        free(A); free(P); free(sums);
+        clnt_destroy(clnt);
+        return;
+    }
+    srand(42);
+    for (int i = 0; i < n; i++) {
+        double total = 0.0;
+        for (int j = 0; j < n; j++) {
+            A[(size_t)i * n + j] = (double)rand() / RAND_MAX - 0.5;
+            sums[i] += A[(size_t)i * n + j];
+            P[(size_t)i * n + j] = (double)rand() / RAND_MAX;
+            total += P[(size_t)i * n + j];
+        }
+        for (int j = 0; j < n; j++) P[(size_t)i * n + j] /= total;
+    }
+    
+    printf("Computing A * P^%d for %dx%d matrices on %s via stored handles\n", steps, n, n, server_address);
+    gettimeofday(&start, NULL);
+    
+    if (!transfer_store(clnt, n, n, A, &a_handle, &error) ||
+        !transfer_store(clnt, n, n, P, &p_handle, &error)) {
+        printf("Upload failed: %s\n", error);
+        goto done;
+    }
+    printf("Uploaded operands in %.3f seconds\n", elapsed_since(&start));
+    
+    x_handle = a_handle;
+    for (int step = 0; step < steps; step++) {
+        int next;
+        if (!transfer_apply(clnt, OP_MULT, x_handle, p_handle, &next, NULL, NULL, &error)) {
+            printf("Step %d failed: %s\n", step + 1, error);
+            goto done;
+        }
+        /* Drop intermediates as soon as the next one exists */
+        if (x_handle != a_handle) store_free_1(&x_handle, clnt);
+        x_handle = next;
+    }
+    
+    row_sum_check check = { sums, 0.0 };
+    if (transfer_fetch(clnt, x_handle, n, n, check_row_sums, &check, &error)) {
+        double seconds = elapsed_since(&start);
+        double megabytes = 3.0 * n * n * sizeof(double) / (1024.0 * 1024.0);
+        printf("Finished %d products in %.3f seconds (%.1f MB moved instead of %.1f MB)\n",
+               steps, seconds, megabytes, megabytes * steps);
+        printf("Max row-sum error: %.3e\n", check.max_error);
+    } else {
+        printf("Fetch failed: %s\n", error);
+    }
+    
+done:
+    if (x_handle && x_handle != a_handle) store_free_1(&x_handle, clnt);
+    if (a_handle) store_free_1(&a_handle, clnt);
+    if (p_handle) store_free_1(&p_handle, clnt);
+    free(A); free(P); free(sums);
+    clnt_destroy(clnt);
+}
+
+#define PIPELINE_DIM 8
+#define PIPELINE_SCALES 8
+
+typedef struct {
+    matrix_result res;
+    double expected;            /* first element of the product */
+    int *failures;
+} pipeline_slot;
+
+static void pipeline_done(int ok, const char *error, void *ctx) {
+    pipeline_slot *slot = (pipeline_slot *)ctx;
+    if (!ok || !slot->res.success || slot->res.result_matrix.data.data_val[0] != slot->expected) {
+        if (__atomic_fetch_add(slot->failures, 1, __ATOMIC_RELAXED) == 0) {
+            printf("Request failed: %s\n", error ? error : slot->res.error_msg);
+        }
+    }
+    xdr_free((xdrproc_t)xdr_matrix_result, (char *)&slot->res);
+    free(slot);
+}
+
+/*
+ * Issue `count` independent 8x8 products, first one call at a time and
+ * then pipelined over `connections` connections with `window` in flight.
+ */
+void run_pipeline_client(const char *server_address, int count, int connections, int window) {
+    int n = PIPELINE_DIM;
+    double A[PIPELINE_DIM * PIPELINE_DIM];
+    double B[PIPELINE_SCALES][PIPELINE_DIM * PIPELINE_DIM];
+    matrix_pair pairs[PIPELINE_SCALES];
+    struct timeval start;
+    int failures = 0;
+    
+    if (count <= 0 || connections <= 0) {
+        printf("Request count and connections must be positive\n");
+        return;
+    }
+    
+    /* B is a multiple of the identity, so each product is a scaled A */
+    srand(42);
+    for (int i = 0; i < n * n; i++) A[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int s = 0; s < PIPELINE_SCALES; s++) {
+        memset(B[s], 0, sizeof(B[s]));
+        for (int i = 0; i < n; i++) B[s][i * n + i] = s + 1;
+        pairs[s] = (matrix_pair){ { n, n, { n * n, A } }, { n, n, { n * n, B[s] } } };
+    }
+    
+    CLIENT *clnt = transfer_connect(server_address);
+    if (clnt == NULL) {
+        clnt_pcreateerror(server_address);
+        return;
+    }
+    printf("Running %d %dx%d products on %s\n", count, n, n, server_address);
+    gettimeofday(&start, NULL);
+    for (int i = 0; i < count; i++) {
+        matrix_result *result = matrix_mult_1(&pairs[i % PIPELINE_SCALES], clnt);
+        if (result == NULL || !result->success) failures++;
+        else xdr_free((xdrproc_t)xdr_matrix_result, (char *)result);
+    }
+    double sync_seconds = elapsed_since(&start);
+    clnt_destroy(clnt);
+    printf("One at a time:  %.3f seconds (%.0f requests/s)\n", sync_seconds, count / sync_seconds);
+    
+    async_client *ac = async_create(server_address, connections, window);
+    if (ac == NULL) {
+        printf("Cannot open %d connections to %s\n", connections, server_address);
+        return;
+    }
+    gettimeofday(&start, NULL);
+    for (int i = 0; i < count; i++) {
+        pipeline_slot *slot = (pipeline_slot *)calloc(1, sizeof(pipeline_slot));
+        if (!slot) {
+            failures++;
+            break;
+        }
+        slot->expected = A[0] * (i % PIPELINE_SCALES + 1);
+        slot->failures = &failures;
+        if (!async_submit_cb(ac, MATRIX_MULT, (xdrproc_t)xdr_matrix_pair, &pairs[i % PIPELINE_SCALES],
+                             (xdrproc_t)xdr_matrix_result, &slot->res, pipeline_done, slot)) {
+            free(slot);
+            failures++;
+            break;
+        }
+    }
+    async_drain(ac);
+    double async_seconds = elapsed_since(&start);
+    async_destroy(ac);
+    printf("Pipelined:      %.3f seconds (%.0f requests/s, %d connections, window %d)\n",
+           async_seconds, count / async_seconds, connections, window);
+    printf("Failed requests: %d\n", failures);
+}
+
+/* Upper bound in microseconds of the histogram bucket holding the median */
+static double histogram_median(const u_quad_t *buckets, u_quad_t calls) {
+    u_quad_t seen = 0;
+    for (int b = 0; b < STATS_BUCKETS; b++) {
+        seen += buckets[b];
+        if (2 * seen >= calls) return (double)(1ULL << b);
+    }
+    return (double)(1ULL << (STATS_BUCKETS - 1));
+}
+
+/* Print the server's per-procedure statistics, optionally resetting them */
+void run_stats_client(const char *server_address, int reset) {
+    CLIENT *clnt = transfer_connect(server_address);
+    if (clnt == NULL) {
+        clnt_pcreateerror(server_address);
+        return;
+    }
+    
+    server_stats *stats = stats_2(&reset, clnt);
+    if (stats == NULL) {
+        clnt_perror(clnt, "stats");
+        clnt_destroy(clnt);
+        return;
+    }
+    
+    printf("Server statistics over the last %.1f seconds%s\n", stats->elapsed_ms / 1000.0,
+           reset ? " (now reset)" : "");
+    printf("%-20s %10s %8s %12s %12s   median us: %8s %8s %8s\n",
+           "procedure", "calls", "errors", "MB in", "MB out", "decode", "compute", "encode");
+    for (u_int i = 0; i < stats->procs.procs_len; i++) {
+        proc_stats *p = &stats->procs.procs_val[i];
+        printf("%-20s %10llu %8llu %12.2f %12.2f              %8.0f %8.0f %8.0f\n",
+               p->name, (unsigned long long)p->calls, (unsigned long long)p->errors,
+               p->bytes_in / 1048576.0, p->bytes_out / 1048576.0,
+               histogram_median(p->decode_us, p->calls), histogram_median(p->compute_us, p->calls),
+               histogram_median(p->encode_us, p->calls));
+    }
+    for (u_int i = 0; i < stats->procs.procs_len; i++) {
+        proc_stats *p = &stats->procs.procs_val[i];
+        if (!p->codec_raw_bytes) continue;
+        printf("%-20s compressed %.2f MB to %.2f MB (%.1fx) in %.1f ms\n", p->name,
+               p->codec_raw_bytes / 1048576.0, p->codec_packed_bytes / 1048576.0,
+               (double)p->codec_raw_bytes / p->codec_packed_bytes, p->codec_us / 1000.0);
+    }
+    xdr_free((xdrproc_t)xdr_server_stats, (char *)stats);
+    clnt_destroy(clnt);
+}
+
 void run_client_test(const char *server_address, int client_id) {
     CLIENT *clnt;
     matrix_result *result;
@@ -107,7 +583,7 @@ void run_client_test(const char *server_address, int client_id) {
     printf("\n=== Client %d Connecting to %s ===\n", client_id, server_address);
     
     /* Create client handle */
-    clnt = clnt_create(server_address, MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS, "tcp");
+    clnt = transfer_connect(server_address);
     if (clnt == NULL) {
         clnt_pcreateerror(server_address);
         printf("Client %d: Failed to connect to server at %s\n", client_id, server_address);
@@ -210,7 +686,7 @@ void run_interactive_client(const char *server_address) {
     printf("Connecting to server: %s\n", server_address);
     
     /* Create client handle */
-    clnt = clnt_create(server_address, MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS, "tcp");
+    clnt = transfer_connect(server_address);
     if (clnt == NULL) {
         clnt_pcreateerror(server_address);
         printf("Failed to connect to server at %s\n", server_address);
@@ -235,6 +711,11 @@ void run_interactive_client(const char *server_address) {
         printf("3. Matrix Transpose\n");
         printf("4. Matrix Inverse\n");
         printf("5. Test Connection\n");
+        printf("6. Compound Expression (A*B)^T + C^-1\n");
+        printf("7. Solve Linear System A X = B\n");
+        printf("8. Determinant\n");
+        printf("9. Solve A X = B (float32 factorization, refined)\n");
+        printf("10. Least Squares min ||A X - B||\n");
         printf("0. Exit\n");
         printf("Enter your choice: ");
         
@@ -254,7 +735,13 @@ void run_interactive_client(const char *server_address) {
                 printf("\n--- Matrix Addition ---\n");
                 matrix *A = input_matrix("A");
                 matrix *B = input_matrix("B");
-                if (A && B) {
+                if (A && B && needs_staging(A, B)) {
+                    run_staged_operation(clnt, OP_ADD, A, B, "Addition");
+                    free(A->data.data_val);
+					free(A);
+					free(B->data.data_val);
+					free(B);
+                } else if (A && B) {
                     matrix_pair pair = create_matrix_pair(A, B);
                     result = matrix_add_1(&pair, clnt);
                     if (result == NULL) {
@@ -277,7 +764,13 @@ void run_interactive_client(const char *server_address) {
                 printf("\n--- Matrix Multiplication ---\n");
                 matrix *A = input_matrix("A");
                 matrix *B = input_matrix("B");
-                if (A && B) {
+                if (A && B && needs_staging(A, B)) {
+                    run_staged_operation(clnt, OP_MULT, A, B, "Multiplication");
+                    free(A->data.data_val);
+					free(A);
+					free(B->data.data_val);
+					free(B);
+                } else if (A && B) {
                     matrix_pair pair = create_matrix_pair(A, B);
                     result = matrix_mult_1(&pair, clnt);
                     if (result == NULL) {
@@ -299,7 +792,10 @@ void run_interactive_client(const char *server_address) {
             case 3: {
                 printf("\n--- Matrix Transpose ---\n");
                 matrix *A = input_matrix("A");
-                if (A) {
+                if (A && needs_staging(A, NULL)) {
+                    run_staged_operation(clnt, OP_TRANSPOSE, A, NULL, "Transpose");
+                    free(A->data.data_val);
+                } else if (A) {
                     result = matrix_transpose_1(A, clnt);
                     if (result == NULL) {
                         printf("RPC call failed!\n");
@@ -317,7 +813,10 @@ void run_interactive_client(const char *server_address) {
             case 4: {
                 printf("\n--- Matrix Inverse ---\n");
                 matrix *A = input_matrix("A");
-                if (A) {
+                if (A && needs_staging(A, NULL)) {
+                    run_staged_operation(clnt, OP_INVERSE, A, NULL, "Inverse");
+                    free(A->data.data_val);
+                } else if (A) {
                     result = matrix_inverse_1(A, clnt);
                     if (result == NULL) {
                         printf("RPC call failed!\n");
@@ -342,6 +841,107 @@ void run_interactive_client(const char *server_address) {
                 break;
             }
             
+            case 6: {
+                printf("\n--- Compound Expression (A*B)^T + C^-1 ---\n");
+                matrix *A = input_matrix("A");
+                matrix *B = input_matrix("B");
+                matrix *C = input_matrix("C");
+                if (A && B && C) {
+                    /* One call: the server folds the transpose and the add into its GEMM */
+                    matrix operands[3] = { *A, *B, *C };
+                    expr_node nodes[] = {
+                        { EXPR_OPERAND, 0, 0, 0 },
+                        { EXPR_OPERAND, 1, 0, 0 },
+                        { EXPR_MULT, 0, 0, 1 },
+                        { EXPR_TRANSPOSE, 0, 2, 0 },
+                        { EXPR_OPERAND, 2, 0, 0 },
+                        { EXPR_INVERSE, 0, 4, 0 },
+                        { EXPR_ADD, 0, 3, 5 },
+                    };
+                    expr_request request = { { 3, operands }, { 7, nodes }, 0 };
+                    expr_result *expr = evaluate_1(&request, clnt);
+                    if (expr == NULL) {
+                        printf("RPC call failed!\n");
+                    } else if (expr->success) {
+                        printf("\nExpression Result:\n");
+                        print_matrix(&expr->result_matrix);
+                    } else {
+                        printf("Error: %s\n", expr->error_msg);
+                    }
+                }
+                if (A) { free(A->data.data_val); free(A); }
+                if (B) { free(B->data.data_val); free(B); }
+                if (C) { free(C->data.data_val); free(C); }
+                break;
+            }
+            
+            case 7: {
+                printf("\n--- Solve Linear System A X = B ---\n");
+                matrix *A = input_matrix("A");
+                matrix *B = input_matrix("B");
+                if (A && B && needs_staging(A, B)) {
+                    run_staged_operation(clnt, OP_SOLVE, A, B, "Solution");
+                } else if (A && B) {
+                    matrix_pair pair = create_matrix_pair(A, B);
+                    result = matrix_solve_1(&pair, clnt);
+                    if (result == NULL) {
+                        printf("RPC call failed!\n");
+                    } else if (result->success) {
+                        printf("\nSolution X:\n");
+                        print_matrix(&result->result_matrix);
+                    } else {
+                        printf("Error: %s\n", result->error_msg);
+                    }
+                }
+                if (A) { free(A->data.data_val); free(A); }
+                if (B) { free(B->data.data_val); free(B); }
+                break;
+            }
+            
+            case 8: {
+                printf("\n--- Determinant ---\n");
+                matrix *A = input_matrix("A");
+                if (A) {
+                    det_result *det = matrix_det_1(A, clnt);
+                    if (det == NULL) {
+                        printf("RPC call failed!\n");
+                    } else if (det->success) {
+                        printf("\nDeterminant: %.6g\n", det->determinant);
+                    } else {
+                        printf("Error: %s\n", det->error_msg);
+                    }
+                    free(A->data.data_val);
+                    free(A);
+                }
+                break;
+            }
+            
+            case 9: {
+                printf("\n--- Solve A X = B (mixed precision) ---\n");
+                matrix *A = input_matrix("A");
+                matrix *B = input_matrix("B");
+                if (A && B) {
+                    /* Always staged: the mixed-precision solve is an operation code */
+                    run_staged_operation(clnt, OP_SOLVE_MIXED, A, B, "Solution");
+                }
+                if (A) { free(A->data.data_val); free(A); }
+                if (B) { free(B->data.data_val); free(B); }
+                break;
+            }
+            
+            case 10: {
+                printf("\n--- Least Squares min ||A X - B|| ---\n");
+                matrix *A = input_matrix("A");
+                matrix *B = input_matrix("B");
+                if (A && B) {
+                    /* Staged like option 9: least squares is an operation code */
+                    run_staged_operation(clnt, OP_LSTSQ, A, B, "Solution");
+                }
+                if (A) { free(A->data.data_val); free(A); }
+                if (B) { free(B->data.data_val); free(B); }
+                break;
+            }
+            
             default:
                 printf("Invalid choice! Please try again.\n");
         }
@@ -357,9 +957,21 @@ int main(int argc, char *argv[]) {
         printf("Usage:\n");
         printf("  %s <server_address> test\n", argv[0]);
         printf("  %s <server_address> interactive\n", argv[0]);
+        printf("  %s <server_address> large <n>\n", argv[0]);
+        printf("  %s <server_address> shm <n>\n", argv[0]);
+        printf("  %s <server_address> chain <n> <steps>\n", argv[0]);
+        printf("  %s <server_address> pipeline <count> <connections> <window>\n", argv[0]);
+        printf("  %s <host[:port],host[:port],...> distributed <n> [tile]\n", argv[0]);
+        printf("  %s <server_address> stats [reset]\n", argv[0]);
         printf("\nExamples:\n");
         printf("  %s localhost test\n", argv[0]);
         printf("  %s 192.168.1.100 interactive\n", argv[0]);
+        printf("  %s localhost large 4096\n", argv[0]);
+        printf("  %s localhost shm 4096\n", argv[0]);
+        printf("  %s localhost chain 1024 8\n", argv[0]);
+        printf("  %s localhost pipeline 20000 8 64\n", argv[0]);
+        printf("  %s localhost:7001,localhost:7002 distributed 4096\n", argv[0]);
+        printf("  %s localhost stats\n", argv[0]);
         exit(1);
     }
     
@@ -371,9 +983,22 @@ int main(int argc, char *argv[]) {
         run_client_test(server_address, 1);
     } else if (strcmp(mode, "interactive") == 0) {
         run_interactive_client(server_address);
+    } else if (strcmp(mode, "large") == 0) {
+        run_large_client(server_address, argc > 3 ? atoi(argv[3]) : 1024);
+    } else if (strcmp(mode, "shm") == 0) {
+        run_shm_client(server_address, argc > 3 ? atoi(argv[3]) : 1024);
+    } else if (strcmp(mode, "chain") == 0) {
+        run_chain_client(server_address, argc > 3 ? atoi(argv[3]) : 1024, argc > 4 ? atoi(argv[4]) : 8);
+    } else if (strcmp(mode, "pipeline") == 0) {
+        run_pipeline_client(server_address, argc > 3 ? atoi(argv[3]) : 20000,
+                            argc > 4 ? atoi(argv[4]) : 8, argc > 5 ? atoi(argv[5]) : 64);
+    } else if (strcmp(mode, "distributed") == 0) {
+        run_distributed_client(server_address, argc > 3 ? atoi(argv[3]) : 2048, argc > 4 ? atoi(argv[4]) : 0);
+    } else if (strcmp(mode, "stats") == 0) {
+        run_stats_client(server_address, argc > 3 && strcmp(argv[3], "reset") == 0);
     } else {
         printf("Invalid mode: %s\n", mode);
-        printf("Use 'test' or 'interactive'\n");
+        printf("Use 'test', 'interactive', 'large', 'shm', 'chain', 'pipeline', 'distributed' or 'stats'\n");
         exit(1);
     }
     
@@ -12,7 +12,7 @@ static struct timeval TIMEOUT = { 25, 0 };
 matrix_result *
 matrix_add_1(matrix_pair *argp, CLIENT *clnt)
 {
-	static matrix_result clnt_res;
+	static __thread matrix_result clnt_res;
 
 	memset((char *)&clnt_res, 0, sizeof(clnt_res));
 	if (clnt_call (clnt, MATRIX_ADD,
@@ -27,7 +27,7 @@ matrix_add_1(matrix_pair *argp, CLIENT *clnt)
 matrix_result *
 matrix_mult_1(matrix_pair *argp, CLIENT *clnt)
 {
-	static matrix_result clnt_res;
+	static __thread matrix_result clnt_res;
 
 	memset((char *)&clnt_res, 0, sizeof(clnt_res));
 	if (clnt_call (clnt, MATRIX_MULT,
@@ -42,7 +42,7 @@ matrix_mult_1(matrix_pair *argp, CLIENT *clnt)
 matrix_result *
 matrix_inverse_1(matrix *argp, CLIENT *clnt)
 {
-	static matrix_result clnt_res;
+	static __thread matrix_result clnt_res;
 
 	memset((char *)&clnt_res, 0, sizeof(clnt_res));
 	if (clnt_call (clnt, MATRIX_INVERSE,
@@ -57,7 +57,7 @@ matrix_inverse_1(matrix *argp, CLIENT *clnt)
 matrix_result *
 matrix_transpose_1(matrix *argp, CLIENT *clnt)
 {
-	static matrix_result clnt_res;
+	static __thread matrix_result clnt_res;
 
 	memset((char *)&clnt_res, 0, sizeof(clnt_res));
 	if (clnt_call (clnt, MATRIX_TRANSPOSE,
@@ -72,7 +72,7 @@ matrix_transpose_1(matrix *argp, CLIENT *clnt)
 int *
 ping_1(void *argp, CLIENT *clnt)
 {
-	static int clnt_res;
+	static __thread int clnt_res;
 
 	memset((char *)&clnt_res, 0, sizeof(clnt_res));
 	if (clnt_call (clnt, PING,
@@ -83,3 +83,1053 @@ ping_1(void *argp, CLIENT *clnt)
 	}
 	return (&clnt_res);
 }
+
+stage_status *
+stage_begin_1(stage_request *argp, CLIENT *clnt)
+{
+	static __thread stage_status clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_BEGIN,
+		(xdrproc_t) xdr_stage_request, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_status, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_status *
+stage_append_1(stage_tile *argp, CLIENT *clnt)
+{
+	static __thread stage_status clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_APPEND,
+		(xdrproc_t) xdr_stage_tile, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_status, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_status *
+stage_commit_1(int *argp, CLIENT *clnt)
+{
+	static __thread stage_status clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_COMMIT,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_status, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_rows *
+stage_read_1(stage_range *argp, CLIENT *clnt)
+{
+	static __thread stage_rows clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_READ,
+		(xdrproc_t) xdr_stage_range, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_rows, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+int *
+stage_end_1(int *argp, CLIENT *clnt)
+{
+	static __thread int clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_END,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+handle_result *
+store_put_1(matrix *argp, CLIENT *clnt)
+{
+	static __thread handle_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_PUT,
+		(xdrproc_t) xdr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_handle_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+handle_result *
+store_adopt_1(int *argp, CLIENT *clnt)
+{
+	static __thread handle_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_ADOPT,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_handle_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+handle_result *
+store_apply_1(handle_op *argp, CLIENT *clnt)
+{
+	static __thread handle_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_APPLY,
+		(xdrproc_t) xdr_handle_op, (caddr_t) argp,
+		(xdrproc_t) xdr_handle_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_rows *
+store_read_1(handle_range *argp, CLIENT *clnt)
+{
+	static __thread stage_rows clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_READ,
+		(xdrproc_t) xdr_handle_range, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_rows, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+int *
+store_free_1(int *argp, CLIENT *clnt)
+{
+	static __thread int clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_FREE,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+expr_result *
+evaluate_1(expr_request *argp, CLIENT *clnt)
+{
+	static __thread expr_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, EVALUATE,
+		(xdrproc_t) xdr_expr_request, (caddr_t) argp,
+		(xdrproc_t) xdr_expr_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+lu_result *
+matrix_lu_1(matrix *argp, CLIENT *clnt)
+{
+	static __thread lu_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_LU,
+		(xdrproc_t) xdr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_lu_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+matrix_result *
+matrix_solve_1(matrix_pair *argp, CLIENT *clnt)
+{
+	static __thread matrix_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_SOLVE,
+		(xdrproc_t) xdr_matrix_pair, (caddr_t) argp,
+		(xdrproc_t) xdr_matrix_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+det_result *
+matrix_det_1(matrix *argp, CLIENT *clnt)
+{
+	static __thread det_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_DET,
+		(xdrproc_t) xdr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_det_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+cache_stats *
+cache_stats_1(void *argp, CLIENT *clnt)
+{
+	static __thread cache_stats clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, CACHE_STATS,
+		(xdrproc_t) xdr_void, (caddr_t) argp,
+		(xdrproc_t) xdr_cache_stats, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+matrix32_result *
+matrix_mult32_1(matrix32_pair *argp, CLIENT *clnt)
+{
+	static __thread matrix32_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_MULT32,
+		(xdrproc_t) xdr_matrix32_pair, (caddr_t) argp,
+		(xdrproc_t) xdr_matrix32_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_status *
+stage_append32_1(stage_tile32 *argp, CLIENT *clnt)
+{
+	static __thread stage_status clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_APPEND32,
+		(xdrproc_t) xdr_stage_tile32, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_status, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_rows32 *
+stage_read32_1(stage_range *argp, CLIENT *clnt)
+{
+	static __thread stage_rows32 clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_READ32,
+		(xdrproc_t) xdr_stage_range, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_rows32, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+vector_result *
+sparse_mv_1(sparse_vector *argp, CLIENT *clnt)
+{
+	static __thread vector_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SPARSE_MV,
+		(xdrproc_t) xdr_sparse_vector, (caddr_t) argp,
+		(xdrproc_t) xdr_vector_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+csr_result *
+sparse_mult_1(csr_pair *argp, CLIENT *clnt)
+{
+	static __thread csr_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SPARSE_MULT,
+		(xdrproc_t) xdr_csr_pair, (caddr_t) argp,
+		(xdrproc_t) xdr_csr_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+csr_result *
+sparse_transpose_1(csr_matrix *argp, CLIENT *clnt)
+{
+	static __thread csr_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SPARSE_TRANSPOSE,
+		(xdrproc_t) xdr_csr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_csr_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+handle_result *
+sparse_mult_dense_1(sparse_dense_op *argp, CLIENT *clnt)
+{
+	static __thread handle_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SPARSE_MULT_DENSE,
+		(xdrproc_t) xdr_sparse_dense_op, (caddr_t) argp,
+		(xdrproc_t) xdr_handle_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+csr_result *
+sparse_from_dense_1(int *argp, CLIENT *clnt)
+{
+	static __thread csr_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SPARSE_FROM_DENSE,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_csr_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+handle_result *
+sparse_to_dense_1(csr_matrix *argp, CLIENT *clnt)
+{
+	static __thread handle_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SPARSE_TO_DENSE,
+		(xdrproc_t) xdr_csr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_handle_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+matrix_result *
+matrix_add_2(matrix_pair *argp, CLIENT *clnt)
+{
+	static __thread matrix_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_ADD,
+		(xdrproc_t) xdr_matrix_pair, (caddr_t) argp,
+		(xdrproc_t) xdr_matrix_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+matrix_result *
+matrix_mult_2(matrix_pair *argp, CLIENT *clnt)
+{
+	static __thread matrix_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_MULT,
+		(xdrproc_t) xdr_matrix_pair, (caddr_t) argp,
+		(xdrproc_t) xdr_matrix_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+matrix_result *
+matrix_inverse_2(matrix *argp, CLIENT *clnt)
+{
+	static __thread matrix_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_INVERSE,
+		(xdrproc_t) xdr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_matrix_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+matrix_result *
+matrix_transpose_2(matrix *argp, CLIENT *clnt)
+{
+	static __thread matrix_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_TRANSPOSE,
+		(xdrproc_t) xdr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_matrix_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+int *
+ping_2(void *argp, CLIENT *clnt)
+{
+	static __thread int clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, PING,
+		(xdrproc_t) xdr_void, (caddr_t) argp,
+		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_status *
+stage_begin_2(stage_request *argp, CLIENT *clnt)
+{
+	static __thread stage_status clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_BEGIN,
+		(xdrproc_t) xdr_stage_request, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_status, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_status *
+stage_append_2(stage_tile *argp, CLIENT *clnt)
+{
+	static __thread stage_status clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_APPEND,
+		(xdrproc_t) xdr_stage_tile, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_status, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_status *
+stage_commit_2(int *argp, CLIENT *clnt)
+{
+	static __thread stage_status clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_COMMIT,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_status, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_rows *
+stage_read_2(stage_range *argp, CLIENT *clnt)
+{
+	static __thread stage_rows clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_READ,
+		(xdrproc_t) xdr_stage_range, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_rows, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+int *
+stage_end_2(int *argp, CLIENT *clnt)
+{
+	static __thread int clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_END,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+handle_result *
+store_put_2(matrix *argp, CLIENT *clnt)
+{
+	static __thread handle_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_PUT,
+		(xdrproc_t) xdr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_handle_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+handle_result *
+store_adopt_2(int *argp, CLIENT *clnt)
+{
+	static __thread handle_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_ADOPT,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_handle_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+handle_result *
+store_apply_2(handle_op *argp, CLIENT *clnt)
+{
+	static __thread handle_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_APPLY,
+		(xdrproc_t) xdr_handle_op, (caddr_t) argp,
+		(xdrproc_t) xdr_handle_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_rows *
+store_read_2(handle_range *argp, CLIENT *clnt)
+{
+	static __thread stage_rows clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_READ,
+		(xdrproc_t) xdr_handle_range, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_rows, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+int *
+store_free_2(int *argp, CLIENT *clnt)
+{
+	static __thread int clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_FREE,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+expr_result *
+evaluate_2(expr_request *argp, CLIENT *clnt)
+{
+	static __thread expr_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, EVALUATE,
+		(xdrproc_t) xdr_expr_request, (caddr_t) argp,
+		(xdrproc_t) xdr_expr_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+lu_result *
+matrix_lu_2(matrix *argp, CLIENT *clnt)
+{
+	static __thread lu_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_LU,
+		(xdrproc_t) xdr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_lu_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+matrix_result *
+matrix_solve_2(matrix_pair *argp, CLIENT *clnt)
+{
+	static __thread matrix_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_SOLVE,
+		(xdrproc_t) xdr_matrix_pair, (caddr_t) argp,
+		(xdrproc_t) xdr_matrix_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+det_result *
+matrix_det_2(matrix *argp, CLIENT *clnt)
+{
+	static __thread det_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_DET,
+		(xdrproc_t) xdr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_det_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+cache_stats *
+cache_stats_2(void *argp, CLIENT *clnt)
+{
+	static __thread cache_stats clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, CACHE_STATS,
+		(xdrproc_t) xdr_void, (caddr_t) argp,
+		(xdrproc_t) xdr_cache_stats, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+matrix32_result *
+matrix_mult32_2(matrix32_pair *argp, CLIENT *clnt)
+{
+	static __thread matrix32_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_MULT32,
+		(xdrproc_t) xdr_matrix32_pair, (caddr_t) argp,
+		(xdrproc_t) xdr_matrix32_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_status *
+stage_append32_2(stage_tile32 *argp, CLIENT *clnt)
+{
+	static __thread stage_status clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_APPEND32,
+		(xdrproc_t) xdr_stage_tile32, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_status, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_rows32 *
+stage_read32_2(stage_range *argp, CLIENT *clnt)
+{
+	static __thread stage_rows32 clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_READ32,
+		(xdrproc_t) xdr_stage_range, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_rows32, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+vector_result *
+sparse_mv_2(sparse_vector *argp, CLIENT *clnt)
+{
+	static __thread vector_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SPARSE_MV,
+		(xdrproc_t) xdr_sparse_vector, (caddr_t) argp,
+		(xdrproc_t) xdr_vector_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+csr_result *
+sparse_mult_2(csr_pair *argp, CLIENT *clnt)
+{
+	static __thread csr_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SPARSE_MULT,
+		(xdrproc_t) xdr_csr_pair, (caddr_t) argp,
+		(xdrproc_t) xdr_csr_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+csr_result *
+sparse_transpose_2(csr_matrix *argp, CLIENT *clnt)
+{
+	static __thread csr_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SPARSE_TRANSPOSE,
+		(xdrproc_t) xdr_csr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_csr_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+handle_result *
+sparse_mult_dense_2(sparse_dense_op *argp, CLIENT *clnt)
+{
+	static __thread handle_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SPARSE_MULT_DENSE,
+		(xdrproc_t) xdr_sparse_dense_op, (caddr_t) argp,
+		(xdrproc_t) xdr_handle_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+csr_result *
+sparse_from_dense_2(int *argp, CLIENT *clnt)
+{
+	static __thread csr_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SPARSE_FROM_DENSE,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_csr_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+handle_result *
+sparse_to_dense_2(csr_matrix *argp, CLIENT *clnt)
+{
+	static __thread handle_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SPARSE_TO_DENSE,
+		(xdrproc_t) xdr_csr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_handle_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_status *
+stage_append_raw_2(stage_tile_raw *argp, CLIENT *clnt)
+{
+	static __thread stage_status clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_APPEND_RAW,
+		(xdrproc_t) xdr_stage_tile_raw, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_status, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_rows_raw *
+stage_read_raw_2(stage_range *argp, CLIENT *clnt)
+{
+	static __thread stage_rows_raw clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_READ_RAW,
+		(xdrproc_t) xdr_stage_range, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_rows_raw, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_rows_raw *
+store_read_raw_2(handle_range *argp, CLIENT *clnt)
+{
+	static __thread stage_rows_raw clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_READ_RAW,
+		(xdrproc_t) xdr_handle_range, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_rows_raw, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+server_stats *
+stats_2(int *argp, CLIENT *clnt)
+{
+	static __thread server_stats clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STATS,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_server_stats, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+handle_result *
+gemm_2(gemm_request *argp, CLIENT *clnt)
+{
+	static __thread handle_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, GEMM,
+		(xdrproc_t) xdr_gemm_request, (caddr_t) argp,
+		(xdrproc_t) xdr_handle_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+handle_result *
+syrk_2(syrk_request *argp, CLIENT *clnt)
+{
+	static __thread handle_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SYRK,
+		(xdrproc_t) xdr_syrk_request, (caddr_t) argp,
+		(xdrproc_t) xdr_handle_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_status *
+stage_append_packed_2(stage_tile_packed *argp, CLIENT *clnt)
+{
+	static __thread stage_status clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_APPEND_PACKED,
+		(xdrproc_t) xdr_stage_tile_packed, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_status, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_rows_packed *
+stage_read_packed_2(packed_range *argp, CLIENT *clnt)
+{
+	static __thread stage_rows_packed clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STAGE_READ_PACKED,
+		(xdrproc_t) xdr_packed_range, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_rows_packed, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+stage_rows_packed *
+store_read_packed_2(packed_range *argp, CLIENT *clnt)
+{
+	static __thread stage_rows_packed clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_READ_PACKED,
+		(xdrproc_t) xdr_packed_range, (caddr_t) argp,
+		(xdrproc_t) xdr_stage_rows_packed, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+shm_attach_result *
+shm_attach_2(char **argp, CLIENT *clnt)
+{
+	static __thread shm_attach_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SHM_ATTACH,
+		(xdrproc_t) xdr_wrapstring, (caddr_t) argp,
+		(xdrproc_t) xdr_shm_attach_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+int *
+shm_detach_2(int *argp, CLIENT *clnt)
+{
+	static __thread int clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SHM_DETACH,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+shm_result *
+shm_apply_2(shm_request *argp, CLIENT *clnt)
+{
+	static __thread shm_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SHM_APPLY,
+		(xdrproc_t) xdr_shm_request, (caddr_t) argp,
+		(xdrproc_t) xdr_shm_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+krylov_result *
+solve_cg_2(krylov_request *argp, CLIENT *clnt)
+{
+	static __thread krylov_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SOLVE_CG,
+		(xdrproc_t) xdr_krylov_request, (caddr_t) argp,
+		(xdrproc_t) xdr_krylov_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+krylov_result *
+solve_gmres_2(krylov_request *argp, CLIENT *clnt)
+{
+	static __thread krylov_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SOLVE_GMRES,
+		(xdrproc_t) xdr_krylov_request, (caddr_t) argp,
+		(xdrproc_t) xdr_krylov_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+qr_result *
+matrix_qr_2(matrix *argp, CLIENT *clnt)
+{
+	static __thread qr_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_QR,
+		(xdrproc_t) xdr_matrix, (caddr_t) argp,
+		(xdrproc_t) xdr_qr_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+matrix_result *
+matrix_lstsq_2(matrix_pair *argp, CLIENT *clnt)
+{
+	static __thread matrix_result clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MATRIX_LSTSQ,
+		(xdrproc_t) xdr_matrix_pair, (caddr_t) argp,
+		(xdrproc_t) xdr_matrix_result, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+qr_handles *
+store_qr_2(int *argp, CLIENT *clnt)
+{
+	static __thread qr_handles clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, STORE_QR,
+		(xdrproc_t) xdr_int, (caddr_t) argp,
+		(xdrproc_t) xdr_qr_handles, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
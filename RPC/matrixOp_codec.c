@@ -0,0 +1,150 @@
+/*
+ * matrixOp_codec.c - Byte-shuffle + deflate compression of raw matrix payloads
+ *
+ * Shuffling groups byte b of every double into plane b. Sign and exponent
+ * planes of nearby values repeat, and zeros and small integers leave whole
+ * mantissa planes of zero bytes. Each plane is deflated on its own with the
+ * run-length strategy at level 1, or stored as it is when a sample from its
+ * start does not shrink: mantissa bytes of measured data are noise, and
+ * deflating them costs far more than it saves.
+ *
+ * Packed layout: eight 4-byte big-endian plane lengths, then the planes. A
+ * plane as long as the element count is stored uncompressed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include "matrixOp.h"
+#include "matrixOp_codec.h"
+
+#define PLANES sizeof(double)
+#define HEADER_BYTES (PLANES * 4)
+#define SAMPLE_BYTES 4096
+
+typedef struct {
+    unsigned char *data;
+    size_t capacity;
+} codec_buffer;
+
+/* The zlib streams are kept per thread and reset between planes */
+static __thread codec_buffer shuffled;
+static __thread z_stream deflater, inflater;
+static __thread int deflater_ready, inflater_ready;
+static __thread unsigned char sample_out[SAMPLE_BYTES];
+
+static unsigned char *scratch(size_t bytes) {
+    if (shuffled.capacity < bytes) {
+        unsigned char *grown = (unsigned char *)malloc(bytes);
+        if (!grown) return NULL;
+        free(shuffled.data);
+        shuffled.data = grown;
+        shuffled.capacity = bytes;
+    }
+    return shuffled.data;
+}
+
+static void shuffle(const unsigned char *src, size_t count, unsigned char *dst) {
+    for (size_t i = 0; i < count; i++) {
+        for (size_t b = 0; b < PLANES; b++) dst[b * count + i] = src[i * PLANES + b];
+    }
+}
+
+static void unshuffle(const unsigned char *src, size_t count, unsigned char *dst) {
+    for (size_t i = 0; i < count; i++) {
+        for (size_t b = 0; b < PLANES; b++) dst[i * PLANES + b] = src[b * count + i];
+    }
+}
+
+/* Raw deflate of in into at most capacity bytes of out; 0 if it does not fit */
+static size_t deflate_plane(const unsigned char *in, size_t len, unsigned char *out, size_t capacity) {
+    deflateReset(&deflater);
+    deflater.next_in = (unsigned char *)in;
+    deflater.avail_in = len;
+    deflater.next_out = out;
+    deflater.avail_out = capacity;
+    if (deflate(&deflater, Z_FINISH) != Z_STREAM_END) return 0;
+    return capacity - deflater.avail_out;
+}
+
+/* Worth deflating if its first SAMPLE_BYTES shrink by a quarter */
+static int plane_compresses(const unsigned char *plane, size_t count) {
+    size_t len = count < SAMPLE_BYTES ? count : SAMPLE_BYTES;
+    size_t packed = deflate_plane(plane, len, sample_out, sizeof(sample_out));
+    return packed && packed < len - len / 4;
+}
+
+static void put_length(unsigned char *at, size_t len) {
+    for (int i = 0; i < 4; i++) at[i] = (unsigned char)(len >> (24 - 8 * i));
+}
+
+static size_t get_length(const unsigned char *at) {
+    return ((size_t)at[0] << 24) | ((size_t)at[1] << 16) | ((size_t)at[2] << 8) | at[3];
+}
+
+size_t codec_pack(const void *raw, size_t bytes, void *out) {
+    if (bytes < COMPRESS_MIN_BYTES || bytes % sizeof(double)) return 0;
+    unsigned char *buffer = scratch(bytes);
+    if (!buffer) return 0;
+
+    if (!deflater_ready) {
+        /* Raw deflate: plane lengths are known, so no zlib header or checksum */
+        if (deflateInit2(&deflater, 1, Z_DEFLATED, -15, 8, Z_RLE) != Z_OK) return 0;
+        deflater_ready = 1;
+    }
+
+    size_t count = bytes / PLANES;
+    unsigned char *dst = (unsigned char *)out;
+    size_t used = HEADER_BYTES;
+    shuffle((const unsigned char *)raw, count, buffer);
+    for (size_t b = 0; b < PLANES; b++) {
+        const unsigned char *plane = buffer + b * count;
+        /* Noise planes go raw; only the total has to come in under bytes, which bounds out */
+        size_t room = bytes - used;
+        size_t len = 0;
+        if (room > 1 && plane_compresses(plane, count)) {
+            len = deflate_plane(plane, count, dst + used, (room - 1 < count - 1) ? room - 1 : count - 1);
+        }
+        if (!len) {
+            if (count >= room) return 0;
+            memcpy(dst + used, plane, count);
+            len = count;
+        }
+        put_length(dst + b * 4, len);
+        used += len;
+    }
+    return used;
+}
+
+int codec_unpack(const void *packed, size_t packed_bytes, void *raw, size_t bytes) {
+    if (bytes % sizeof(double) || packed_bytes < HEADER_BYTES) return 0;
+    unsigned char *buffer = scratch(bytes);
+    if (!buffer) return 0;
+
+    if (!inflater_ready) {
+        if (inflateInit2(&inflater, -15) != Z_OK) return 0;
+        inflater_ready = 1;
+    }
+
+    size_t count = bytes / PLANES;
+    const unsigned char *src = (const unsigned char *)packed;
+    size_t used = HEADER_BYTES;
+    for (size_t b = 0; b < PLANES; b++) {
+        size_t len = get_length(src + b * 4);
+        if (len > packed_bytes - used) return 0;
+        if (len == count) {
+            memcpy(buffer + b * count, src + used, count);
+        } else {
+            inflateReset(&inflater);
+            inflater.next_in = (unsigned char *)src + used;
+            inflater.avail_in = len;
+            inflater.next_out = buffer + b * count;
+            inflater.avail_out = count;
+            if (inflate(&inflater, Z_FINISH) != Z_STREAM_END || inflater.avail_out != 0) return 0;
+        }
+        used += len;
+    }
+    if (used != packed_bytes) return 0;
+    unshuffle(buffer, count, (unsigned char *)raw);
+    return 1;
+}
@@ -0,0 +1,20 @@
+/*
+ * matrixOp_codec.h - Byte-shuffle + deflate compression of raw matrix payloads
+ */
+
+#ifndef MATRIXOP_CODEC_H
+#define MATRIXOP_CODEC_H
+
+#include <stddef.h>
+
+/*
+ * Compress bytes of raw doubles into out, which has room for bytes. Returns
+ * the packed size, or 0 if the payload is under COMPRESS_MIN_BYTES or would
+ * not shrink; the caller then sends it as it is (CODEC_NONE).
+ */
+size_t codec_pack(const void *raw, size_t bytes, void *out);
+
+/* Undo codec_pack into raw, which must receive exactly bytes; 0 on corrupt input */
+int codec_unpack(const void *packed, size_t packed_bytes, void *raw, size_t bytes);
+
+#endif /* MATRIXOP_CODEC_H */
@@ -0,0 +1,398 @@
+/*
+ * matrixOp_distributed.c - One matrix product tiled across several matrixOp_server instances
+ *
+ * C is cut into a grid of tiles and k into panels, as in SUMMA: tile (i, j)
+ * is the sum over p of A(i, p) * B(p, j). Every endpoint gets a thread that
+ * pulls tiles off a shared list, so faster servers simply take more of them.
+ * Operand panels are uploaded once per endpoint and stay in its store, and
+ * a thread prefers tiles whose panels its server already holds.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "matrixOp_distributed.h"
+#include "matrixOp_transfer.h"
+
+/* Tiles aimed for per endpoint when options->tile is 0, so uneven speeds even out */
+#define TILES_PER_ENDPOINT 4
+
+enum { TILE_PENDING, TILE_RUNNING, TILE_DONE };
+
+typedef struct {
+    int row;            /* position in the tile grid */
+    int col;
+    int state;
+    int attempts;
+    double cost;        /* multiply-adds */
+} tile_task;
+
+/* lock guards the tile states and the counters below it */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    tile_task *tiles;
+    int num_tiles;
+    int remaining;      /* tiles not yet done */
+    int alive;          /* endpoint threads still running */
+    int failed;
+    char message[128];
+    distributed_report *report;
+
+    int m, k, n;
+    int tile_rows, tile_cols, depth;
+    int grid_rows, grid_cols, panels;
+    const double *A;
+    const double *B;
+    double *C;
+    int max_attempts;
+} coordinator;
+
+typedef struct {
+    coordinator *co;
+    int index;
+    const char *endpoint;
+    CLIENT *clnt;
+    int *a_panels;      /* grid_rows x panels handles on this server, 0 = not uploaded */
+    int *b_panels;      /* panels x grid_cols */
+    double *scratch;    /* one panel */
+    int stray;          /* partial tile sum left by a failed attempt */
+    int started;
+    pthread_t thread;
+} endpoint_worker;
+
+/* Result rows of one tile, placed into C as they arrive */
+typedef struct {
+    double *C;
+    int ldc;
+    int col;
+} tile_target;
+
+static __thread char error_buffer[128];
+
+static int min_int(int a, int b) {
+    return a < b ? a : b;
+}
+
+static void fail(coordinator *co, const char *msg) {
+    co->failed = 1;
+    snprintf(co->message, sizeof(co->message), "%s", msg);
+}
+
+static int place_rows(int row, int rows, int cols, const double *data, void *ctx) {
+    tile_target *t = (tile_target *)ctx;
+    for (int i = 0; i < rows; i++) {
+        memcpy(t->C + (size_t)(row + i) * t->ldc + t->col, data + (size_t)i * cols, cols * sizeof(double));
+    }
+    return 1;
+}
+
+/* rows x cols block of a row-major matrix with ld columns, packed contiguously */
+static void copy_block(const double *src, int ld, int row, int col, int rows, int cols, double *dst) {
+    for (int i = 0; i < rows; i++) {
+        memcpy(dst + (size_t)i * cols, src + (size_t)(row + i) * ld + col, cols * sizeof(double));
+    }
+}
+
+/* Handle of A(i, p) or B(p, j) on this worker's server, uploading it on first use */
+static int panel_handle(endpoint_worker *w, int is_b, int i, int p, int *handle, const char **error) {
+    coordinator *co = w->co;
+    int *slot = is_b ? &w->b_panels[p * co->grid_cols + i] : &w->a_panels[i * co->panels + p];
+    if (*slot) {
+        *handle = *slot;
+        return 1;
+    }
+
+    int k0 = p * co->depth;
+    int depth = min_int(co->depth, co->k - k0);
+    int ok;
+    if (is_b) {
+        int j0 = i * co->tile_cols;
+        int cols = min_int(co->tile_cols, co->n - j0);
+        copy_block(co->B, co->n, k0, j0, depth, cols, w->scratch);
+        ok = transfer_store(w->clnt, depth, cols, w->scratch, slot, error);
+    } else {
+        int i0 = i * co->tile_rows;
+        int rows = min_int(co->tile_rows, co->m - i0);
+        /* A row panel spanning all of k is already contiguous */
+        const double *src = co->A + (size_t)i0 * co->k;
+        if (depth != co->k) {
+            copy_block(co->A, co->k, i0, k0, rows, depth, w->scratch);
+            src = w->scratch;
+        }
+        ok = transfer_store(w->clnt, rows, depth, src, slot, error);
+    }
+    if (!ok) *slot = 0;
+    *handle = *slot;
+    return ok;
+}
+
+/* Compute one tile on this worker's server and write it into C */
+static int run_tile(endpoint_worker *w, const tile_task *t, const char **error) {
+    coordinator *co = w->co;
+    int sum = 0;
+    int ok = 1;
+
+    for (int p = 0; ok && p < co->panels; p++) {
+        int a, b, product;
+        ok = panel_handle(w, 0, t->row, p, &a, error) &&
+             panel_handle(w, 1, t->col, p, &b, error) &&
+             transfer_apply(w->clnt, OP_MULT, a, b, &product, NULL, NULL, error);
+        if (ok && sum) {
+            int next;
+            ok = transfer_apply(w->clnt, OP_ADD, sum, product, &next, NULL, NULL, error);
+            store_free_1(&product, w->clnt);
+            store_free_1(&sum, w->clnt);
+            sum = ok ? next : 0;
+        } else if (ok) {
+            sum = product;
+        }
+    }
+
+    if (ok) {
+        int i0 = t->row * co->tile_rows;
+        int j0 = t->col * co->tile_cols;
+        tile_target target = { co->C + (size_t)i0 * co->n, co->n, j0 };
+        ok = transfer_fetch(w->clnt, sum, min_int(co->tile_rows, co->m - i0),
+                            min_int(co->tile_cols, co->n - j0), place_rows, &target, error);
+    }
+    /* After a failure the connection may be dead; free the sum once reconnected */
+    if (ok) store_free_1(&sum, w->clnt);
+    else w->stray = sum;
+    return ok;
+}
+
+/* Costliest pending tile, weighted up for each operand panel already on this server; caller holds lock */
+static tile_task *pick_tile(endpoint_worker *w) {
+    coordinator *co = w->co;
+    tile_task *best = NULL;
+    double best_score = 0.0;
+
+    for (int i = 0; i < co->num_tiles; i++) {
+        tile_task *t = &co->tiles[i];
+        if (t->state != TILE_PENDING) continue;
+        int cached = 0;
+        for (int p = 0; p < co->panels; p++) {
+            cached += w->a_panels[t->row * co->panels + p] != 0;
+            cached += w->b_panels[p * co->grid_cols + t->col] != 0;
+        }
+        double score = t->cost * (1.0 + 0.5 * cached / co->panels);
+        if (!best || score > best_score) {
+            best = t;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+/* Forget uploaded panels and partial sums, freeing them if there is a connection */
+static void drop_panels(endpoint_worker *w) {
+    coordinator *co = w->co;
+    if (w->stray && w->clnt) store_free_1(&w->stray, w->clnt);
+    w->stray = 0;
+    int count = co->grid_rows * co->panels;
+    for (int i = 0; i < count; i++) {
+        if (w->a_panels[i] && w->clnt) store_free_1(&w->a_panels[i], w->clnt);
+        w->a_panels[i] = 0;
+    }
+    count = co->panels * co->grid_cols;
+    for (int i = 0; i < count; i++) {
+        if (w->b_panels[i] && w->clnt) store_free_1(&w->b_panels[i], w->clnt);
+        w->b_panels[i] = 0;
+    }
+}
+
+static void *endpoint_loop(void *arg) {
+    endpoint_worker *w = (endpoint_worker *)arg;
+    coordinator *co = w->co;
+
+    for (;;) {
+        pthread_mutex_lock(&co->lock);
+        tile_task *t = NULL;
+        while (!co->failed && co->remaining > 0 && !(t = pick_tile(w))) {
+            /* Tiles still running elsewhere may fail and come back */
+            pthread_cond_wait(&co->changed, &co->lock);
+        }
+        if (!t) {
+            pthread_mutex_unlock(&co->lock);
+            break;
+        }
+        t->state = TILE_RUNNING;
+        pthread_mutex_unlock(&co->lock);
+
+        const char *error = NULL;
+        int ok = run_tile(w, t, &error);
+
+        pthread_mutex_lock(&co->lock);
+        if (ok) {
+            t->state = TILE_DONE;
+            co->remaining--;
+            if (co->report) co->report->tiles_done[w->index]++;
+        } else {
+            t->state = TILE_PENDING;
+            t->attempts++;
+            if (co->report) co->report->retries++;
+            if (t->attempts >= co->max_attempts) {
+                char msg[128];
+                snprintf(msg, sizeof(msg), "%s: %s", w->endpoint, error ? error : "Error: Unknown failure");
+                fail(co, msg);
+            }
+        }
+        pthread_cond_broadcast(&co->changed);
+        pthread_mutex_unlock(&co->lock);
+        if (ok) continue;
+
+        /* Start over on a fresh connection; the old one may be broken mid-reply */
+        clnt_destroy(w->clnt);
+        w->clnt = transfer_connect(w->endpoint);
+        drop_panels(w);
+        if (!w->clnt) break;
+    }
+
+    pthread_mutex_lock(&co->lock);
+    co->alive--;
+    if (w->clnt == NULL) {
+        if (co->report) co->report->endpoints_lost++;
+        if (co->alive == 0 && co->remaining > 0 && !co->failed) {
+            fail(co, "Error: No endpoint left to run the remaining tiles");
+        }
+    }
+    pthread_cond_broadcast(&co->changed);
+    pthread_mutex_unlock(&co->lock);
+    return NULL;
+}
+
+static int ceil_div(int a, int b) {
+    return (a + b - 1) / b;
+}
+
+/* Tile edges and panel depth within the staging limits */
+static void plan_tiles(coordinator *co, int endpoints, const distributed_options *options) {
+    int tile = options ? options->tile : 0;
+    if (tile > 0) {
+        co->tile_rows = co->tile_cols = tile;
+    } else {
+        int grid = 1;
+        while (grid * grid < TILES_PER_ENDPOINT * endpoints) grid++;
+        co->tile_rows = ceil_div(co->m, grid);
+        co->tile_cols = ceil_div(co->n, grid);
+    }
+    co->tile_rows = min_int(co->tile_rows, MAX_STAGE_DIM);
+    co->tile_cols = min_int(co->tile_cols, MAX_STAGE_DIM);
+
+    int depth = options ? options->depth : 0;
+    if (depth <= 0 || depth > MAX_STAGE_DIM) {
+        /* Equal panels, as few as the staging limit allows */
+        depth = ceil_div(co->k, ceil_div(co->k, MAX_STAGE_DIM));
+    }
+    co->depth = min_int(depth, co->k);
+
+    co->grid_rows = ceil_div(co->m, co->tile_rows);
+    co->grid_cols = ceil_div(co->n, co->tile_cols);
+    co->panels = ceil_div(co->k, co->depth);
+}
+
+int distributed_mult(const char *const *endpoints, int count,
+                     int m, int k, int n, const double *A, const double *B, double *C,
+                     const distributed_options *options, distributed_report *report,
+                     const char **error) {
+    if (count < 1 || count > DISTRIBUTED_MAX_ENDPOINTS) {
+        *error = "Error: Between 1 and DISTRIBUTED_MAX_ENDPOINTS endpoints required";
+        return 0;
+    }
+    if (m <= 0 || k <= 0 || n <= 0) {
+        *error = "Error: Invalid matrix dimensions";
+        return 0;
+    }
+
+    coordinator co;
+    memset(&co, 0, sizeof(co));
+    co.m = m;
+    co.k = k;
+    co.n = n;
+    co.A = A;
+    co.B = B;
+    co.C = C;
+    co.report = report;
+    co.max_attempts = (options && options->max_attempts > 0) ? options->max_attempts
+                                                             : DISTRIBUTED_DEFAULT_ATTEMPTS;
+    plan_tiles(&co, count, options);
+    if (report) memset(report, 0, sizeof(*report));
+
+    co.num_tiles = co.grid_rows * co.grid_cols;
+    co.remaining = co.num_tiles;
+    co.tiles = (tile_task *)calloc(co.num_tiles, sizeof(tile_task));
+    endpoint_worker *workers = (endpoint_worker *)calloc(count, sizeof(endpoint_worker));
+    if (!co.tiles || !workers) {
+        free(co.tiles);
+        free(workers);
+        *error = "Error: Memory allocation failed";
+        return 0;
+    }
+    for (int i = 0; i < co.grid_rows; i++) {
+        for (int j = 0; j < co.grid_cols; j++) {
+            tile_task *t = &co.tiles[i * co.grid_cols + j];
+            t->row = i;
+            t->col = j;
+            t->cost = (double)min_int(co.tile_rows, m - i * co.tile_rows) *
+                      min_int(co.tile_cols, n - j * co.tile_cols) * k;
+        }
+    }
+    if (report) report->tiles = co.num_tiles;
+    pthread_mutex_init(&co.lock, NULL);
+    pthread_cond_init(&co.changed, NULL);
+
+    /* Connect everywhere first so alive is final before any thread can count itself out */
+    size_t scratch = (size_t)co.depth * (co.tile_rows > co.tile_cols ? co.tile_rows : co.tile_cols);
+    for (int e = 0; e < count; e++) {
+        endpoint_worker *w = &workers[e];
+        w->co = &co;
+        w->index = e;
+        w->endpoint = endpoints[e];
+        w->a_panels = (int *)calloc((size_t)co.grid_rows * co.panels, sizeof(int));
+        w->b_panels = (int *)calloc((size_t)co.panels * co.grid_cols, sizeof(int));
+        w->scratch = (double *)malloc(scratch * sizeof(double));
+        if (w->a_panels && w->b_panels && w->scratch) {
+            w->clnt = transfer_connect(endpoints[e]);
+        }
+        if (w->clnt) co.alive++;
+        else if (report) report->endpoints_lost++;
+    }
+    if (co.alive == 0) fail(&co, "Error: Cannot connect to any endpoint");
+
+    for (int e = 0; e < count && !co.failed; e++) {
+        endpoint_worker *w = &workers[e];
+        if (!w->clnt) continue;
+        w->started = pthread_create(&w->thread, NULL, endpoint_loop, w) == 0;
+        if (!w->started) {
+            pthread_mutex_lock(&co.lock);
+            if (--co.alive == 0) fail(&co, "Error: Cannot start endpoint threads");
+            pthread_cond_broadcast(&co.changed);
+            pthread_mutex_unlock(&co.lock);
+        }
+    }
+
+    for (int e = 0; e < count; e++) {
+        endpoint_worker *w = &workers[e];
+        if (w->started) pthread_join(w->thread, NULL);
+        if (w->clnt) {
+            drop_panels(w);
+            clnt_destroy(w->clnt);
+        }
+        free(w->a_panels);
+        free(w->b_panels);
+        free(w->scratch);
+    }
+
+    int ok = !co.failed && co.remaining == 0;
+    if (!ok) {
+        snprintf(error_buffer, sizeof(error_buffer), "%s", co.message);
+        *error = error_buffer;
+    }
+    pthread_cond_destroy(&co.changed);
+    pthread_mutex_destroy(&co.lock);
+    free(co.tiles);
+    free(workers);
+    return ok;
+}
@@ -0,0 +1,43 @@
+/*
+ * matrixOp_distributed.h - One matrix product tiled across several matrixOp_server instances
+ */
+
+#ifndef MATRIXOP_DISTRIBUTED_H
+#define MATRIXOP_DISTRIBUTED_H
+
+#include "matrixOp.h"
+
+#define DISTRIBUTED_MAX_ENDPOINTS 64
+
+/* Attempts per tile before the whole product fails */
+#define DISTRIBUTED_DEFAULT_ATTEMPTS 3
+
+typedef struct {
+    int tile;           /* edge of the C tiles; 0 picks about four tiles per endpoint */
+    int depth;          /* width of the inner-dimension panels; 0 = all of k when it fits MAX_STAGE_DIM */
+    int max_attempts;   /* 0 = DISTRIBUTED_DEFAULT_ATTEMPTS */
+} distributed_options;
+
+typedef struct {
+    int tiles;
+    int retries;            /* tile attempts that failed and were requeued */
+    int endpoints_lost;     /* unreachable at start or dropped after a failure */
+    int tiles_done[DISTRIBUTED_MAX_ENDPOINTS];
+} distributed_report;
+
+/*
+ * C = A * B with A m x k, B k x n and C m x n, all row-major. C is split
+ * into tiles; each endpoint ("host" or "host:port") pulls the costliest
+ * remaining tile, uploads the row panel of A and column panel of B it
+ * needs (kept on that server for later tiles), multiplies and sums the
+ * inner-dimension panels there, and the tile is written into C as it is
+ * fetched. A failed tile is requeued and the endpoint reconnected; an
+ * endpoint that cannot reconnect is dropped. options and report may be
+ * NULL. Returns 1 on success; on failure *error describes the last error.
+ */
+int distributed_mult(const char *const *endpoints, int count,
+                     int m, int k, int n, const double *A, const double *B, double *C,
+                     const distributed_options *options, distributed_report *report,
+                     const char **error);
+
+#endif /* MATRIXOP_DISTRIBUTED_H */
@@ -0,0 +1,1551 @@
+/*
+ * matrixOp_kernels.c - Dense compute kernels used by the matrix RPC server
+ *
+ * GEMM follows the usual three-level blocking: B is packed into KC x NC
+ * panels of NR-wide column strips, A into MC x KC panels of MR-tall row
+ * strips, and an MR x NR register-tiled microkernel walks the packed
+ * panels with unit stride. Edge tiles are zero-padded during packing so
+ * the microkernel always runs full width.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <immintrin.h>
+#include "matrixOp_kernels.h"
+
+/* Cache blocking (doubles): KC*NR of B stays in L1, MC*KC of A in L2 */
+#define GEMM_KC 256
+#define GEMM_MC 120
+#define GEMM_NC 2048
+
+/* Largest register tile of any microkernel, for the edge scratch tile */
+#define GEMM_MAX_MR 6
+#define GEMM_MAX_NR 16
+
+typedef void (*gemm_microkernel_fn)(int kc, const double *a, const double *b,
+                                    double *c, int ldc);
+
+typedef struct {
+    const char *name;
+    int mr;
+    int nr;
+    gemm_microkernel_fn kernel;
+} gemm_kernel;
+
+/* Scalar 4x4 microkernel: C[4x4] += A_panel * B_panel */
+static void microkernel_scalar_4x4(int kc, const double *a, const double *b,
+                                   double *c, int ldc) {
+    double acc[4][4] = {{0}};
+
+    for (int p = 0; p < kc; p++) {
+        for (int i = 0; i < 4; i++) {
+            double ai = a[i];
+            for (int j = 0; j < 4; j++) {
+                acc[i][j] += ai * b[j];
+            }
+        }
+        a += 4;
+        b += 4;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            c[i * ldc + j] += acc[i][j];
+        }
+    }
+}
+
+/* AVX2/FMA 6x8 microkernel: 12 ymm accumulators, two B vectors per k */
+__attribute__((target("avx2,fma")))
+static void microkernel_avx2_6x8(int kc, const double *a, const double *b,
+                                 double *c, int ldc) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+    __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+    for (int p = 0; p < kc; p++) {
+        __m256d b0 = _mm256_load_pd(b);
+        __m256d b1 = _mm256_load_pd(b + 4);
+        __m256d ai;
+
+        ai = _mm256_broadcast_sd(a + 0);
+        c00 = _mm256_fmadd_pd(ai, b0, c00); c01 = _mm256_fmadd_pd(ai, b1, c01);
+        ai = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_fmadd_pd(ai, b0, c10); c11 = _mm256_fmadd_pd(ai, b1, c11);
+        ai = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_fmadd_pd(ai, b0, c20); c21 = _mm256_fmadd_pd(ai, b1, c21);
+        ai = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_fmadd_pd(ai, b0, c30); c31 = _mm256_fmadd_pd(ai, b1, c31);
+        ai = _mm256_broadcast_sd(a + 4);
+        c40 = _mm256_fmadd_pd(ai, b0, c40); c41 = _mm256_fmadd_pd(ai, b1, c41);
+        ai = _mm256_broadcast_sd(a + 5);
+        c50 = _mm256_fmadd_pd(ai, b0, c50); c51 = _mm256_fmadd_pd(ai, b1, c51);
+
+        a += 6;
+        b += 8;
+    }
+
+#define ACC_ROW(r, lo, hi) \
+    _mm256_storeu_pd(c + (r) * ldc, _mm256_add_pd(_mm256_loadu_pd(c + (r) * ldc), lo)); \
+    _mm256_storeu_pd(c + (r) * ldc + 4, _mm256_add_pd(_mm256_loadu_pd(c + (r) * ldc + 4), hi))
+    ACC_ROW(0, c00, c01);
+    ACC_ROW(1, c10, c11);
+    ACC_ROW(2, c20, c21);
+    ACC_ROW(3, c30, c31);
+    ACC_ROW(4, c40, c41);
+    ACC_ROW(5, c50, c51);
+#undef ACC_ROW
+}
+
+/* AVX-512 6x16 microkernel: 12 zmm accumulators, two B vectors per k */
+__attribute__((target("avx512f")))
+static void microkernel_avx512_6x16(int kc, const double *a, const double *b,
+                                    double *c, int ldc) {
+    __m512d c00 = _mm512_setzero_pd(), c01 = _mm512_setzero_pd();
+    __m512d c10 = _mm512_setzero_pd(), c11 = _mm512_setzero_pd();
+    __m512d c20 = _mm512_setzero_pd(), c21 = _mm512_setzero_pd();
+    __m512d c30 = _mm512_setzero_pd(), c31 = _mm512_setzero_pd();
+    __m512d c40 = _mm512_setzero_pd(), c41 = _mm512_setzero_pd();
+    __m512d c50 = _mm512_setzero_pd(), c51 = _mm512_setzero_pd();
+
+    for (int p = 0; p < kc; p++) {
+        __m512d b0 = _mm512_load_pd(b);
+        __m512d b1 = _mm512_load_pd(b + 8);
+        __m512d ai;
+
+        ai = _mm512_set1_pd(a[0]);
+        c00 = _mm512_fmadd_pd(ai, b0, c00); c01 = _mm512_fmadd_pd(ai, b1, c01);
+        ai = _mm512_set1_pd(a[1]);
+        c10 = _mm512_fmadd_pd(ai, b0, c10); c11 = _mm512_fmadd_pd(ai, b1, c11);
+        ai = _mm512_set1_pd(a[2]);
+        c20 = _mm512_fmadd_pd(ai, b0, c20); c21 = _mm512_fmadd_pd(ai, b1, c21);
+        ai = _mm512_set1_pd(a[3]);
+        c30 = _mm512_fmadd_pd(ai, b0, c30); c31 = _mm512_fmadd_pd(ai, b1, c31);
+        ai = _mm512_set1_pd(a[4]);
+        c40 = _mm512_fmadd_pd(ai, b0, c40); c41 = _mm512_fmadd_pd(ai, b1, c41);
+        ai = _mm512_set1_pd(a[5]);
+        c50 = _mm512_fmadd_pd(ai, b0, c50); c51 = _mm512_fmadd_pd(ai, b1, c51);
+
+        a += 6;
+        b += 16;
+    }
+
+#define ACC_ROW(r, lo, hi) \
+    _mm512_storeu_pd(c + (r) * ldc, _mm512_add_pd(_mm512_loadu_pd(c + (r) * ldc), lo)); \
+    _mm512_storeu_pd(c + (r) * ldc + 8, _mm512_add_pd(_mm512_loadu_pd(c + (r) * ldc + 8), hi))
+    ACC_ROW(0, c00, c01);
+    ACC_ROW(1, c10, c11);
+    ACC_ROW(2, c20, c21);
+    ACC_ROW(3, c30, c31);
+    ACC_ROW(4, c40, c41);
+    ACC_ROW(5, c50, c51);
+#undef ACC_ROW
+}
+
+static const gemm_kernel kernel_scalar = { "scalar 4x4", 4, 4, microkernel_scalar_4x4 };
+static const gemm_kernel kernel_avx2 = { "avx2+fma 6x8", 6, 8, microkernel_avx2_6x8 };
+static const gemm_kernel kernel_avx512 = { "avx512f 6x16", 6, 16, microkernel_avx512_6x16 };
+
+/* Pick the widest microkernel this CPU supports */
+static const gemm_kernel *select_kernel(void) {
+    static const gemm_kernel *selected = NULL;
+
+    if (!selected) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            selected = &kernel_avx512;
+        } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            selected = &kernel_avx2;
+        } else {
+            selected = &kernel_scalar;
+        }
+    }
+    return selected;
+}
+
+const char *gemm_kernel_name(void) {
+    return select_kernel()->name;
+}
+
+/*
+ * Pack a kc x nc block of op(B) into nr-wide strips, each stored k-major.
+ * With trans set the block is read from B^T, so element (p, j) is B[j * ldb + p].
+ */
+static void pack_b(int kc, int nc, int nr, const double *B, int ldb, int trans, double *packed) {
+    for (int j = 0; j < nc; j += nr) {
+        int width = (nc - j < nr) ? nc - j : nr;
+        if (trans) {
+            /* Walk each source row contiguously and scatter it down the strip */
+            for (int jj = 0; jj < width; jj++) {
+                const double *src = B + (size_t)(j + jj) * ldb;
+                for (int p = 0; p < kc; p++) packed[(size_t)p * nr + jj] = src[p];
+            }
+            for (int jj = width; jj < nr; jj++) {
+                for (int p = 0; p < kc; p++) packed[(size_t)p * nr + jj] = 0.0;
+            }
+            packed += (size_t)kc * nr;
+            continue;
+        }
+        for (int p = 0; p < kc; p++) {
+            const double *src = B + (size_t)p * ldb + j;
+            int jj = 0;
+            for (; jj < width; jj++) *packed++ = src[jj];
+            for (; jj < nr; jj++) *packed++ = 0.0;
+        }
+    }
+}
+
+/*
+ * Pack an mc x kc block of alpha * op(A) into mr-tall strips, each stored
+ * k-major. With trans set element (i, p) is A[p * lda + i].
+ */
+static void pack_a(int mc, int kc, int mr, const double *A, int lda, int trans, double alpha,
+                   double *packed) {
+    for (int i = 0; i < mc; i += mr) {
+        int height = (mc - i < mr) ? mc - i : mr;
+        for (int p = 0; p < kc; p++) {
+            int ii = 0;
+            if (trans) {
+                const double *src = A + (size_t)p * lda + i;
+                for (; ii < height; ii++) *packed++ = alpha * src[ii];
+            } else {
+                for (; ii < height; ii++) *packed++ = alpha * A[(size_t)(i + ii) * lda + p];
+            }
+            for (; ii < mr; ii++) *packed++ = 0.0;
+        }
+    }
+}
+
+/* Run the microkernel over one packed MC x KC block of A against a KC x NC panel of B */
+static void macrokernel(const gemm_kernel *kern, int mc, int nc, int kc,
+                        const double *packed_a, const double *packed_b,
+                        double *C, int ldc) {
+    double edge[GEMM_MAX_MR * GEMM_MAX_NR];
+    int mr = kern->mr, nr = kern->nr;
+
+    for (int j = 0; j < nc; j += nr) {
+        int width = (nc - j < nr) ? nc - j : nr;
+        const double *b = packed_b + (size_t)j * kc;
+
+        for (int i = 0; i < mc; i += mr) {
+            int height = (mc - i < mr) ? mc - i : mr;
+            const double *a = packed_a + (size_t)i * kc;
+            double *c = C + (size_t)i * ldc + j;
+
+            if (height == mr && width == nr) {
+                kern->kernel(kc, a, b, c, ldc);
+            } else {
+                memset(edge, 0, sizeof(edge));
+                kern->kernel(kc, a, b, edge, nr);
+                for (int ii = 0; ii < height; ii++) {
+                    for (int jj = 0; jj < width; jj++) {
+                        c[(size_t)ii * ldc + jj] += edge[ii * nr + jj];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* Packing panels are reused by every later call on the same thread, in either precision */
+typedef struct {
+    void *data;
+    size_t capacity;        /* bytes */
+} pack_buffer;
+
+static __thread pack_buffer thread_pack_a;
+static __thread pack_buffer thread_pack_b;
+
+static void *packing_buffer(pack_buffer *buf, size_t bytes) {
+    if (buf->capacity < bytes) {
+        /* aligned_alloc wants a multiple of the alignment */
+        void *grown = aligned_alloc(64, (bytes + 63) & ~(size_t)63);
+        if (!grown) return NULL;
+        free(buf->data);
+        buf->data = grown;
+        buf->capacity = bytes;
+    }
+    return buf->data;
+}
+
+static int gemm_with_kernel(const gemm_kernel *kern, int trans_a, int trans_b,
+                            int m, int n, int k, double alpha,
+                            const double *A, int lda,
+                            const double *B, int ldb,
+                            double *C, int ldc) {
+    int mr = kern->mr, nr = kern->nr;
+
+    if (m <= 0 || n <= 0 || k <= 0) return 1;
+
+    /* Round panel sizes up to whole register tiles for the zero padding */
+    size_t a_size = (size_t)((GEMM_MC + mr - 1) / mr) * mr * GEMM_KC;
+    size_t b_size = (size_t)((GEMM_NC + nr - 1) / nr) * nr * GEMM_KC;
+    double *packed_a = (double *)packing_buffer(&thread_pack_a, a_size * sizeof(double));
+    double *packed_b = (double *)packing_buffer(&thread_pack_b, b_size * sizeof(double));
+    if (!packed_a || !packed_b) return 0;
+
+    for (int jc = 0; jc < n; jc += GEMM_NC) {
+        int nc = (n - jc < GEMM_NC) ? n - jc : GEMM_NC;
+
+        for (int pc = 0; pc < k; pc += GEMM_KC) {
+            int kc = (k - pc < GEMM_KC) ? k - pc : GEMM_KC;
+            const double *b_block = trans_b ? B + (size_t)jc * ldb + pc : B + (size_t)pc * ldb + jc;
+            pack_b(kc, nc, nr, b_block, ldb, trans_b, packed_b);
+
+            for (int ic = 0; ic < m; ic += GEMM_MC) {
+                int mc = (m - ic < GEMM_MC) ? m - ic : GEMM_MC;
+                const double *a_block = trans_a ? A + (size_t)pc * lda + ic : A + (size_t)ic * lda + pc;
+                pack_a(mc, kc, mr, a_block, lda, trans_a, alpha, packed_a);
+                macrokernel(kern, mc, nc, kc, packed_a, packed_b,
+                            C + (size_t)ic * ldc + jc, ldc);
+            }
+        }
+    }
+
+    return 1;
+}
+
+int gemm_blocked(int m, int n, int k,
+                 const double *A, int lda,
+                 const double *B, int ldb,
+                 double *C, int ldc) {
+    return gemm_with_kernel(select_kernel(), 0, 0, m, n, k, 1.0, A, lda, B, ldb, C, ldc);
+}
+
+int gemm_blocked_trans(int trans_a, int trans_b, int m, int n, int k,
+                       const double *A, int lda,
+                       const double *B, int ldb,
+                       double *C, int ldc) {
+    return gemm_with_kernel(select_kernel(), trans_a, trans_b, m, n, k, 1.0, A, lda, B, ldb, C, ldc);
+}
+
+/* C = beta * C; beta = 0 clears C without reading it, so NaNs there do not survive */
+static void scale_rows(int m, int n, double beta, double *C, int ldc) {
+    if (beta == 1.0) return;
+    for (int i = 0; i < m; i++) {
+        double *c = C + (size_t)i * ldc;
+        if (beta == 0.0) {
+            memset(c, 0, (size_t)n * sizeof(double));
+        } else {
+            for (int j = 0; j < n; j++) c[j] *= beta;
+        }
+    }
+}
+
+int gemm_blocked_scaled(int trans_a, int trans_b, int m, int n, int k,
+                        double alpha, const double *A, int lda,
+                        const double *B, int ldb,
+                        double beta, double *C, int ldc) {
+    scale_rows(m, n, beta, C, ldc);
+    if (alpha == 0.0) return 1;
+    return gemm_with_kernel(select_kernel(), trans_a, trans_b, m, n, k, alpha, A, lda, B, ldb, C, ldc);
+}
+
+/* Rows of C per SYRK block: the diagonal blocks are the only redundant work */
+#define SYRK_BLOCK 256
+
+int syrk_blocked(int trans, int n, int k, double alpha, const double *A, int lda,
+                 double beta, double *C, int ldc) {
+    /* Lower triangle block row by block row: C[i0:i1, 0:i1] = alpha * op(A)[i0:i1] op(A)[0:i1]^T */
+    for (int i0 = 0; i0 < n; i0 += SYRK_BLOCK) {
+        int rows = (n - i0 < SYRK_BLOCK) ? n - i0 : SYRK_BLOCK;
+        int cols = i0 + rows;
+        double *c = C + (size_t)i0 * ldc;
+        int ok = trans
+            ? gemm_blocked_scaled(1, 0, rows, cols, k, alpha, A + i0, lda, A, lda, beta, c, ldc)
+            : gemm_blocked_scaled(0, 1, rows, cols, k, alpha, A + (size_t)i0 * lda, lda, A, lda,
+                                  beta, c, ldc);
+        if (!ok) return 0;
+    }
+    /* Mirror into the upper triangle: transposed copies off the diagonal, element-wise on it */
+    for (int i0 = 0; i0 < n; i0 += SYRK_BLOCK) {
+        int rows = (n - i0 < SYRK_BLOCK) ? n - i0 : SYRK_BLOCK;
+        for (int j0 = 0; j0 < i0; j0 += SYRK_BLOCK) {
+            transpose_blocked(rows, SYRK_BLOCK, C + (size_t)i0 * ldc + j0, ldc,
+                              C + (size_t)j0 * ldc + i0, ldc);
+        }
+        for (int i = i0 + 1; i < i0 + rows; i++) {
+            for (int j = i0; j < i; j++) C[(size_t)j * ldc + i] = C[(size_t)i * ldc + j];
+        }
+    }
+    return 1;
+}
+
+/*
+ * Strassen-Winograd: 7 half-size products and 15 additions per level instead
+ * of 8 products. Only the even-sized core recurses; an odd last row, column
+ * or inner index is peeled off and added with thin GEMMs.
+ */
+static int strassen_crossover = STRASSEN_DEFAULT_CROSSOVER;
+
+static __thread pack_buffer thread_strassen;
+
+void gemm_set_strassen_crossover(int n) {
+    strassen_crossover = n;
+}
+
+static int strassen_recurses(int m, int n, int k) {
+    int limit = strassen_crossover;
+    return limit > 0 && m >= limit && n >= limit && k >= limit;
+}
+
+/* Doubles of scratch one product needs: S, T, U and V quadrants per level */
+static size_t strassen_scratch(int m, int n, int k) {
+    size_t total = 0;
+    while (strassen_recurses(m, n, k)) {
+        m /= 2; n /= 2; k /= 2;
+        total += (size_t)m * k + (size_t)k * n + 2 * (size_t)m * n;
+    }
+    return total;
+}
+
+/* Z = X + sign * Y */
+static void combine(int rows, int cols, const double *X, int ldx, double sign,
+                    const double *Y, int ldy, double *Z, int ldz) {
+    for (int i = 0; i < rows; i++) {
+        const double *x = X + (size_t)i * ldx, *y = Y + (size_t)i * ldy;
+        double *z = Z + (size_t)i * ldz;
+        for (int j = 0; j < cols; j++) z[j] = x[j] + sign * y[j];
+    }
+}
+
+/* C += X (+ Y when Y is given) */
+static void accumulate(int rows, int cols, const double *X, const double *Y, int ldx,
+                       double *C, int ldc) {
+    for (int i = 0; i < rows; i++) {
+        const double *x = X + (size_t)i * ldx;
+        double *c = C + (size_t)i * ldc;
+        if (Y) {
+            const double *y = Y + (size_t)i * ldx;
+            for (int j = 0; j < cols; j++) c[j] += x[j] + y[j];
+        } else {
+            for (int j = 0; j < cols; j++) c[j] += x[j];
+        }
+    }
+}
+
+static int strassen_rec(int m, int n, int k,
+                        const double *A, int lda,
+                        const double *B, int ldb,
+                        double *C, int ldc, double *scratch) {
+    if (!strassen_recurses(m, n, k)) {
+        return gemm_blocked(m, n, k, A, lda, B, ldb, C, ldc);
+    }
+
+    int mh = m / 2, nh = n / 2, kh = k / 2;
+    const double *A11 = A, *A12 = A + kh, *A21 = A + (size_t)mh * lda, *A22 = A21 + kh;
+    const double *B11 = B, *B12 = B + nh, *B21 = B + (size_t)kh * ldb, *B22 = B21 + nh;
+    double *C11 = C, *C12 = C + nh, *C21 = C + (size_t)mh * ldc, *C22 = C21 + nh;
+
+    double *S = scratch;                    /* mh x kh */
+    double *T = S + (size_t)mh * kh;        /* kh x nh */
+    double *U = T + (size_t)kh * nh;        /* mh x nh */
+    double *V = U + (size_t)mh * nh;        /* mh x nh */
+    double *next = V + (size_t)mh * nh;
+    size_t quarter = (size_t)mh * nh * sizeof(double);
+
+    /* C11 += P1 + P2, with U = P1 = A11 B11 kept for the other quadrants */
+    memset(U, 0, quarter);
+    if (!strassen_rec(mh, nh, kh, A11, lda, B11, ldb, U, nh, next)) return 0;
+    accumulate(mh, nh, U, NULL, nh, C11, ldc);
+    if (!strassen_rec(mh, nh, kh, A12, lda, B21, ldb, C11, ldc, next)) return 0;
+
+    /* V = P5 = (A21 + A22)(B12 - B11) */
+    combine(mh, kh, A21, lda, 1.0, A22, lda, S, kh);
+    combine(kh, nh, B12, ldb, -1.0, B11, ldb, T, nh);
+    memset(V, 0, quarter);
+    if (!strassen_rec(mh, nh, kh, S, kh, T, nh, V, nh, next)) return 0;
+
+    /* U += P6 = (S1 - A11)(B22 - T1), giving U2 = P1 + P6 */
+    combine(mh, kh, S, kh, -1.0, A11, lda, S, kh);
+    combine(kh, nh, B22, ldb, -1.0, T, nh, T, nh);
+    if (!strassen_rec(mh, nh, kh, S, kh, T, nh, U, nh, next)) return 0;
+
+    /* C12 += P3 = (A12 - S2) B22 and C21 -= P4 = A22 (T2 - B21) */
+    combine(mh, kh, A12, lda, -1.0, S, kh, S, kh);
+    if (!strassen_rec(mh, nh, kh, S, kh, B22, ldb, C12, ldc, next)) return 0;
+    combine(kh, nh, T, nh, -1.0, B21, ldb, T, nh);
+    combine(mh, kh, A22, lda, -2.0, A22, lda, S, kh);     /* S = -A22 */
+    if (!strassen_rec(mh, nh, kh, S, kh, T, nh, C21, ldc, next)) return 0;
+
+    accumulate(mh, nh, U, V, nh, C12, ldc);
+    accumulate(mh, nh, U, V, nh, C22, ldc);
+    accumulate(mh, nh, U, NULL, nh, C21, ldc);
+
+    /* P7 = (A11 - A21)(B22 - B12) goes to C21 and C22 */
+    combine(mh, kh, A11, lda, -1.0, A21, lda, S, kh);
+    combine(kh, nh, B22, ldb, -1.0, B12, ldb, T, nh);
+    memset(V, 0, quarter);
+    if (!strassen_rec(mh, nh, kh, S, kh, T, nh, V, nh, next)) return 0;
+    accumulate(mh, nh, V, NULL, nh, C21, ldc);
+    accumulate(mh, nh, V, NULL, nh, C22, ldc);
+
+    /* Peel what the even core left out */
+    int me = 2 * mh, ne = 2 * nh, ke = 2 * kh;
+    if (k > ke && !gemm_blocked(me, ne, k - ke, A + ke, lda, B + (size_t)ke * ldb, ldb, C, ldc)) return 0;
+    if (n > ne && !gemm_blocked(me, n - ne, k, A, lda, B + ne, ldb, C + ne, ldc)) return 0;
+    if (m > me && !gemm_blocked(m - me, n, k, A + (size_t)me * lda, lda, B, ldb,
+                                C + (size_t)me * ldc, ldc)) return 0;
+    return 1;
+}
+
+int gemm_strassen(int m, int n, int k,
+                  const double *A, int lda,
+                  const double *B, int ldb,
+                  double *C, int ldc) {
+    if (!strassen_recurses(m, n, k)) {
+        return gemm_blocked(m, n, k, A, lda, B, ldb, C, ldc);
+    }
+    double *scratch = (double *)packing_buffer(&thread_strassen,
+                                               strassen_scratch(m, n, k) * sizeof(double));
+    if (!scratch) return 0;
+    return strassen_rec(m, n, k, A, lda, B, ldb, C, ldc, scratch);
+}
+
+/* Column block width of the LU factorization: one GEMM-friendly panel */
+#define LU_BLOCK 64
+
+static __thread pack_buffer thread_lu_panel;
+
+static void swap_rows(double *A, int lda, int r1, int r2, int cols) {
+    double *x = A + (size_t)r1 * lda;
+    double *y = A + (size_t)r2 * lda;
+    for (int j = 0; j < cols; j++) {
+        double t = x[j];
+        x[j] = y[j];
+        y[j] = t;
+    }
+}
+
+/*
+ * Right-looking blocked LU. Each LU_BLOCK-wide panel is factored unblocked
+ * with row swaps applied across the full rows, then U12 is formed by a
+ * unit-lower triangular solve and the trailing matrix gets one GEMM update
+ * A22 -= L21 * U12, which is where nearly all of the flops go.
+ */
+int lu_factor_blocked(int n, double *A, int lda, int *pivots, double tol) {
+    for (int k = 0; k < n; k += LU_BLOCK) {
+        int b = (n - k < LU_BLOCK) ? n - k : LU_BLOCK;
+        int panel_end = k + b;
+
+        /* Panel: columns k..panel_end-1, all rows below k */
+        for (int j = k; j < panel_end; j++) {
+            int p = j;
+            double max_val = fabs(A[(size_t)j * lda + j]);
+            for (int i = j + 1; i < n; i++) {
+                double v = fabs(A[(size_t)i * lda + j]);
+                if (v > max_val) {
+                    max_val = v;
+                    p = i;
+                }
+            }
+            pivots[j] = p;
+            if (max_val < tol) return 0;
+            if (p != j) swap_rows(A, lda, j, p, n);
+
+            const double *pivot_row = A + (size_t)j * lda;
+            double inv_pivot = 1.0 / pivot_row[j];
+            for (int i = j + 1; i < n; i++) {
+                double *row = A + (size_t)i * lda;
+                double l = row[j] *= inv_pivot;
+                for (int c = j + 1; c < panel_end; c++) {
+                    row[c] -= l * pivot_row[c];
+                }
+            }
+        }
+
+        int rest = n - panel_end;
+        if (rest == 0) break;
+
+        /* U12 = L11^-1 * A12 (unit lower triangular, row operations) */
+        for (int j = k + 1; j < panel_end; j++) {
+            double *row = A + (size_t)j * lda + panel_end;
+            for (int r = k; r < j; r++) {
+                double l = A[(size_t)j * lda + r];
+                const double *u = A + (size_t)r * lda + panel_end;
+                for (int c = 0; c < rest; c++) row[c] -= l * u[c];
+            }
+        }
+
+        /* A22 += (-L21) * U12; the negated panel is packed contiguously for the GEMM */
+        double *neg_l21 = (double *)packing_buffer(&thread_lu_panel, (size_t)rest * b * sizeof(double));
+        if (!neg_l21) return 0;
+        for (int i = 0; i < rest; i++) {
+            const double *src = A + (size_t)(panel_end + i) * lda + k;
+            for (int c = 0; c < b; c++) neg_l21[(size_t)i * b + c] = -src[c];
+        }
+        if (!gemm_blocked(rest, rest, b, neg_l21, b,
+                          A + (size_t)k * lda + panel_end, lda,
+                          A + (size_t)panel_end * lda + panel_end, lda)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Below this many right-hand sides the GEMM's register tiles would mostly be padding */
+#define SOLVE_BLOCK_MIN_RHS 16
+
+/*
+ * Both substitutions LU_BLOCK rows at a time: the contribution of every
+ * row already solved is subtracted from a block with one GEMM against the
+ * negated off-diagonal part of L (or U), leaving only a small triangle to
+ * solve row by row. Returns 0, with B untouched, if scratch allocation fails.
+ */
+static int lu_solve_blocked(int n, const double *LU, int lda, int nrhs, double *B, int ldb) {
+    /* The factorization is done with the panel buffer, so the solve borrows it */
+    double *neg = (double *)packing_buffer(&thread_lu_panel, (size_t)LU_BLOCK * n * sizeof(double));
+    double zero = 0.0, sink = 0.0;
+
+    /* A 1x1 product reserves the GEMM's packing buffers, so nothing below can fail */
+    if (!neg || !gemm_blocked(1, 1, 1, &zero, 1, &zero, 1, &sink, 1)) return 0;
+
+    for (int k = 0; k < n; k += LU_BLOCK) {
+        int b = (n - k < LU_BLOCK) ? n - k : LU_BLOCK;
+        double *block = B + (size_t)k * ldb;
+
+        if (k > 0) {
+            for (int i = 0; i < b; i++) {
+                const double *src = LU + (size_t)(k + i) * lda;
+                for (int c = 0; c < k; c++) neg[(size_t)i * k + c] = -src[c];
+            }
+            gemm_blocked(b, nrhs, k, neg, k, B, ldb, block, ldb);
+        }
+        for (int i = 1; i < b; i++) {
+            double *row = block + (size_t)i * ldb;
+            for (int r = 0; r < i; r++) {
+                double l = LU[(size_t)(k + i) * lda + k + r];
+                const double *src = block + (size_t)r * ldb;
+                for (int c = 0; c < nrhs; c++) row[c] -= l * src[c];
+            }
+        }
+    }
+
+    for (int end = n; end > 0; ) {
+        int k = (end > LU_BLOCK) ? end - LU_BLOCK : 0;
+        int b = end - k, rest = n - end;
+        double *block = B + (size_t)k * ldb;
+
+        if (rest > 0) {
+            for (int i = 0; i < b; i++) {
+                const double *src = LU + (size_t)(k + i) * lda + end;
+                for (int c = 0; c < rest; c++) neg[(size_t)i * rest + c] = -src[c];
+            }
+            gemm_blocked(b, nrhs, rest, neg, rest, B + (size_t)end * ldb, ldb, block, ldb);
+        }
+        for (int i = b - 1; i >= 0; i--) {
+            double *row = block + (size_t)i * ldb;
+            for (int r = i + 1; r < b; r++) {
+                double u = LU[(size_t)(k + i) * lda + k + r];
+                const double *src = block + (size_t)r * ldb;
+                for (int c = 0; c < nrhs; c++) row[c] -= u * src[c];
+            }
+            double inv_diag = 1.0 / LU[(size_t)(k + i) * lda + k + i];
+            for (int c = 0; c < nrhs; c++) row[c] *= inv_diag;
+        }
+        end = k;
+    }
+    return 1;
+}
+
+void lu_solve(int n, const double *LU, int lda, const int *pivots,
+              int nrhs, double *B, int ldb) {
+    for (int j = 0; j < n; j++) {
+        if (pivots[j] != j) swap_rows(B, ldb, j, pivots[j], nrhs);
+    }
+    if (nrhs >= SOLVE_BLOCK_MIN_RHS && lu_solve_blocked(n, LU, lda, nrhs, B, ldb)) return;
+
+    /* Forward substitution with unit L */
+    for (int i = 1; i < n; i++) {
+        double *row = B + (size_t)i * ldb;
+        for (int r = 0; r < i; r++) {
+            double l = LU[(size_t)i * lda + r];
+            if (l == 0.0) continue;
+            const double *src = B + (size_t)r * ldb;
+            for (int c = 0; c < nrhs; c++) row[c] -= l * src[c];
+        }
+    }
+
+    /* Back substitution with U */
+    for (int i = n - 1; i >= 0; i--) {
+        double *row = B + (size_t)i * ldb;
+        for (int r = i + 1; r < n; r++) {
+            double u = LU[(size_t)i * lda + r];
+            if (u == 0.0) continue;
+            const double *src = B + (size_t)r * ldb;
+            for (int c = 0; c < nrhs; c++) row[c] -= u * src[c];
+        }
+        double inv_diag = 1.0 / LU[(size_t)i * lda + i];
+        for (int c = 0; c < nrhs; c++) row[c] *= inv_diag;
+    }
+}
+
+/* ===== Transpose ===== */
+
+/*
+ * Both transposes split the longer side in half until a block fits in L1,
+ * so the source and destination stay cache-resident at every level without
+ * tuning for a cache size. Split points are multiples of 4 to keep the
+ * register tiles aligned with the block edges.
+ */
+#define TRANSPOSE_LEAF 32
+
+typedef void (*transpose_tile_fn)(int rows, int cols, const double *A, int lda,
+                                  double *B, int ldb);
+typedef void (*transpose_swap_fn)(int rows, int cols, double *X, double *Y, int ld);
+
+/* B = A^T for one leaf block */
+static void transpose_tile_scalar(int rows, int cols, const double *A, int lda,
+                                  double *B, int ldb) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            B[(size_t)j * ldb + i] = A[(size_t)i * lda + j];
+        }
+    }
+}
+
+/* X (rows x cols) and Y (cols x rows) become Y^T and X^T */
+static void transpose_swap_scalar(int rows, int cols, double *X, double *Y, int ld) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            double t = X[(size_t)i * ld + j];
+            X[(size_t)i * ld + j] = Y[(size_t)j * ld + i];
+            Y[(size_t)j * ld + i] = t;
+        }
+    }
+}
+
+/* 2x2 blocks in SSE2 registers: for arrays aligned to 16 but not 32 bytes */
+static void transpose_tile_sse2(int rows, int cols, const double *A, int lda,
+                                double *B, int ldb) {
+    int full_rows = rows & ~1, full_cols = cols & ~1;
+
+    for (int i = 0; i < full_rows; i += 2) {
+        for (int j = 0; j < full_cols; j += 2) {
+            __m128d a0 = _mm_loadu_pd(A + (size_t)i * lda + j);
+            __m128d a1 = _mm_loadu_pd(A + (size_t)(i + 1) * lda + j);
+            _mm_storeu_pd(B + (size_t)j * ldb + i, _mm_unpacklo_pd(a0, a1));
+            _mm_storeu_pd(B + (size_t)(j + 1) * ldb + i, _mm_unpackhi_pd(a0, a1));
+        }
+    }
+    transpose_tile_scalar(full_rows, cols - full_cols, A + full_cols, lda,
+                          B + (size_t)full_cols * ldb, ldb);
+    transpose_tile_scalar(rows - full_rows, cols, A + (size_t)full_rows * lda, lda,
+                          B + full_rows, ldb);
+}
+
+static void transpose_swap_sse2(int rows, int cols, double *X, double *Y, int ld) {
+    int full_rows = rows & ~1, full_cols = cols & ~1;
+
+    for (int i = 0; i < full_rows; i += 2) {
+        for (int j = 0; j < full_cols; j += 2) {
+            double *xb = X + (size_t)i * ld + j, *yb = Y + (size_t)j * ld + i;
+            __m128d x0 = _mm_loadu_pd(xb), x1 = _mm_loadu_pd(xb + ld);
+            __m128d y0 = _mm_loadu_pd(yb), y1 = _mm_loadu_pd(yb + ld);
+            _mm_storeu_pd(xb, _mm_unpacklo_pd(y0, y1));
+            _mm_storeu_pd(xb + ld, _mm_unpackhi_pd(y0, y1));
+            _mm_storeu_pd(yb, _mm_unpacklo_pd(x0, x1));
+            _mm_storeu_pd(yb + ld, _mm_unpackhi_pd(x0, x1));
+        }
+    }
+    transpose_swap_scalar(full_rows, cols - full_cols, X + full_cols, Y + (size_t)full_cols * ld, ld);
+    transpose_swap_scalar(rows - full_rows, cols, X + (size_t)full_rows * ld, Y + full_rows, ld);
+}
+
+/* Transpose the 4x4 block at A into r: unpack pairs, then swap 128-bit halves */
+__attribute__((target("avx2")))
+static inline void transpose_4x4_avx2(const double *A, int lda, __m256d r[4]) {
+    __m256d a0 = _mm256_loadu_pd(A);
+    __m256d a1 = _mm256_loadu_pd(A + lda);
+    __m256d a2 = _mm256_loadu_pd(A + 2 * (size_t)lda);
+    __m256d a3 = _mm256_loadu_pd(A + 3 * (size_t)lda);
+    __m256d t0 = _mm256_unpacklo_pd(a0, a1);
+    __m256d t1 = _mm256_unpackhi_pd(a0, a1);
+    __m256d t2 = _mm256_unpacklo_pd(a2, a3);
+    __m256d t3 = _mm256_unpackhi_pd(a2, a3);
+    r[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+    r[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+    r[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+    r[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+__attribute__((target("avx2")))
+static inline void store_4x4_avx2(double *B, int ldb, const __m256d r[4]) {
+    for (int q = 0; q < 4; q++) _mm256_storeu_pd(B + (size_t)q * ldb, r[q]);
+}
+
+__attribute__((target("avx2")))
+static void transpose_tile_avx2(int rows, int cols, const double *A, int lda,
+                                double *B, int ldb) {
+    int full_rows = rows & ~3, full_cols = cols & ~3;
+    __m256d r[4];
+
+    for (int i = 0; i < full_rows; i += 4) {
+        for (int j = 0; j < full_cols; j += 4) {
+            transpose_4x4_avx2(A + (size_t)i * lda + j, lda, r);
+            store_4x4_avx2(B + (size_t)j * ldb + i, ldb, r);
+        }
+    }
+    transpose_tile_scalar(full_rows, cols - full_cols, A + full_cols, lda,
+                          B + (size_t)full_cols * ldb, ldb);
+    transpose_tile_scalar(rows - full_rows, cols, A + (size_t)full_rows * lda, lda,
+                          B + full_rows, ldb);
+}
+
+__attribute__((target("avx2")))
+static void transpose_swap_avx2(int rows, int cols, double *X, double *Y, int ld) {
+    int full_rows = rows & ~3, full_cols = cols & ~3;
+    __m256d x[4], y[4];
+
+    for (int i = 0; i < full_rows; i += 4) {
+        for (int j = 0; j < full_cols; j += 4) {
+            double *xb = X + (size_t)i * ld + j, *yb = Y + (size_t)j * ld + i;
+            transpose_4x4_avx2(xb, ld, x);
+            transpose_4x4_avx2(yb, ld, y);
+            store_4x4_avx2(xb, ld, y);
+            store_4x4_avx2(yb, ld, x);
+        }
+    }
+    transpose_swap_scalar(full_rows, cols - full_cols, X + full_cols, Y + (size_t)full_cols * ld, ld);
+    transpose_swap_scalar(rows - full_rows, cols, X + (size_t)full_rows * ld, Y + full_rows, ld);
+}
+
+/*
+ * Widest register tile whose rows all start on its vector alignment:
+ * split-line stores make a tile slower than scalar code. 0 = scalar,
+ * 2 = SSE2, 4 = AVX2.
+ */
+static int transpose_width(const void *A, int lda, const void *B, int ldb) {
+    static int avx2 = -1;
+    if (avx2 < 0) {
+        __builtin_cpu_init();
+        avx2 = __builtin_cpu_supports("avx2");
+    }
+    uintptr_t base = (uintptr_t)A | (uintptr_t)B;
+    if (avx2 && (base & 31) == 0 && lda % 4 == 0 && ldb % 4 == 0) return 4;
+    if ((base & 15) == 0 && lda % 2 == 0 && ldb % 2 == 0) return 2;
+    return 0;
+}
+
+/* Half of n, rounded up to a multiple of 4 */
+static int transpose_split(int n) {
+    return ((n / 2) + 3) & ~3;
+}
+
+static void transpose_rec(transpose_tile_fn tile, int rows, int cols,
+                          const double *A, int lda, double *B, int ldb) {
+    if (rows <= TRANSPOSE_LEAF && cols <= TRANSPOSE_LEAF) {
+        tile(rows, cols, A, lda, B, ldb);
+    } else if (rows >= cols) {
+        int h = transpose_split(rows);
+        transpose_rec(tile, h, cols, A, lda, B, ldb);
+        transpose_rec(tile, rows - h, cols, A + (size_t)h * lda, lda, B + h, ldb);
+    } else {
+        int h = transpose_split(cols);
+        transpose_rec(tile, rows, h, A, lda, B, ldb);
+        transpose_rec(tile, rows, cols - h, A + h, lda, B + (size_t)h * ldb, ldb);
+    }
+}
+
+static void transpose_swap_rec(transpose_swap_fn swap, int rows, int cols,
+                               double *X, double *Y, int ld) {
+    if (rows <= TRANSPOSE_LEAF && cols <= TRANSPOSE_LEAF) {
+        swap(rows, cols, X, Y, ld);
+    } else if (rows >= cols) {
+        int h = transpose_split(rows);
+        transpose_swap_rec(swap, h, cols, X, Y, ld);
+        transpose_swap_rec(swap, rows - h, cols, X + (size_t)h * ld, Y + h, ld);
+    } else {
+        int h = transpose_split(cols);
+        transpose_swap_rec(swap, rows, h, X, Y, ld);
+        transpose_swap_rec(swap, rows, cols - h, X + h, Y + (size_t)h * ld, ld);
+    }
+}
+
+/* Diagonal blocks transpose themselves; the off-diagonal pair is swapped */
+static void transpose_inplace_rec(transpose_swap_fn swap, int n, double *A, int lda) {
+    if (n <= TRANSPOSE_LEAF) {
+        for (int i = 1; i < n; i++) {
+            transpose_swap_scalar(1, i, A + (size_t)i * lda, A + i, lda);
+        }
+        return;
+    }
+    int h = transpose_split(n);
+    transpose_inplace_rec(swap, h, A, lda);
+    transpose_inplace_rec(swap, n - h, A + (size_t)h * lda + h, lda);
+    transpose_swap_rec(swap, h, n - h, A + h, A + (size_t)h * lda, lda);
+}
+
+void transpose_blocked(int rows, int cols, const double *A, int lda, double *B, int ldb) {
+    static const transpose_tile_fn tiles[] = { transpose_tile_scalar, NULL, transpose_tile_sse2,
+                                               NULL, transpose_tile_avx2 };
+    if (rows <= 0 || cols <= 0) return;
+    transpose_rec(tiles[transpose_width(A, lda, B, ldb)], rows, cols, A, lda, B, ldb);
+}
+
+void transpose_square_inplace(int n, double *A, int lda) {
+    static const transpose_swap_fn swaps[] = { transpose_swap_scalar, NULL, transpose_swap_sse2,
+                                               NULL, transpose_swap_avx2 };
+    if (n <= 1) return;
+    transpose_inplace_rec(swaps[transpose_width(A, lda, A, lda)], n, A, lda);
+}
+
+/* ===== Single precision ===== */
+
+/*
+ * The float32 GEMM reuses the blocking above with twice as many lanes per
+ * vector, so its register tiles are twice as wide as the double ones.
+ */
+#define SGEMM_MAX_NR 32
+
+typedef void (*sgemm_microkernel_fn)(int kc, const float *a, const float *b,
+                                     float *c, int ldc);
+
+typedef struct {
+    const char *name;
+    int mr;
+    int nr;
+    sgemm_microkernel_fn kernel;
+} sgemm_kernel;
+
+static void microkernel_scalar_4x4_f32(int kc, const float *a, const float *b,
+                                       float *c, int ldc) {
+    float acc[4][4] = {{0}};
+
+    for (int p = 0; p < kc; p++) {
+        for (int i = 0; i < 4; i++) {
+            float ai = a[i];
+            for (int j = 0; j < 4; j++) {
+                acc[i][j] += ai * b[j];
+            }
+        }
+        a += 4;
+        b += 4;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            c[i * ldc + j] += acc[i][j];
+        }
+    }
+}
+
+/* AVX2/FMA 6x16 microkernel: 12 ymm accumulators of eight floats */
+__attribute__((target("avx2,fma")))
+static void microkernel_avx2_6x16_f32(int kc, const float *a, const float *b,
+                                      float *c, int ldc) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+    for (int p = 0; p < kc; p++) {
+        __m256 b0 = _mm256_load_ps(b);
+        __m256 b1 = _mm256_load_ps(b + 8);
+        __m256 ai;
+
+        ai = _mm256_broadcast_ss(a + 0);
+        c00 = _mm256_fmadd_ps(ai, b0, c00); c01 = _mm256_fmadd_ps(ai, b1, c01);
+        ai = _mm256_broadcast_ss(a + 1);
+        c10 = _mm256_fmadd_ps(ai, b0, c10); c11 = _mm256_fmadd_ps(ai, b1, c11);
+        ai = _mm256_broadcast_ss(a + 2);
+        c20 = _mm256_fmadd_ps(ai, b0, c20); c21 = _mm256_fmadd_ps(ai, b1, c21);
+        ai = _mm256_broadcast_ss(a + 3);
+        c30 = _mm256_fmadd_ps(ai, b0, c30); c31 = _mm256_fmadd_ps(ai, b1, c31);
+        ai = _mm256_broadcast_ss(a + 4);
+        c40 = _mm256_fmadd_ps(ai, b0, c40); c41 = _mm256_fmadd_ps(ai, b1, c41);
+        ai = _mm256_broadcast_ss(a + 5);
+        c50 = _mm256_fmadd_ps(ai, b0, c50); c51 = _mm256_fmadd_ps(ai, b1, c51);
+
+        a += 6;
+        b += 16;
+    }
+
+#define ACC_ROW(r, lo, hi) \
+    _mm256_storeu_ps(c + (r) * ldc, _mm256_add_ps(_mm256_loadu_ps(c + (r) * ldc), lo)); \
+    _mm256_storeu_ps(c + (r) * ldc + 8, _mm256_add_ps(_mm256_loadu_ps(c + (r) * ldc + 8), hi))
+    ACC_ROW(0, c00, c01);
+    ACC_ROW(1, c10, c11);
+    ACC_ROW(2, c20, c21);
+    ACC_ROW(3, c30, c31);
+    ACC_ROW(4, c40, c41);
+    ACC_ROW(5, c50, c51);
+#undef ACC_ROW
+}
+
+/* AVX-512 6x32 microkernel: 12 zmm accumulators of sixteen floats */
+__attribute__((target("avx512f")))
+static void microkernel_avx512_6x32_f32(int kc, const float *a, const float *b,
+                                        float *c, int ldc) {
+    __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+    __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+    __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+    __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+    __m512 c40 = _mm512_setzero_ps(), c41 = _mm512_setzero_ps();
+    __m512 c50 = _mm512_setzero_ps(), c51 = _mm512_setzero_ps();
+
+    for (int p = 0; p < kc; p++) {
+        __m512 b0 = _mm512_load_ps(b);
+        __m512 b1 = _mm512_load_ps(b + 16);
+        __m512 ai;
+
+        ai = _mm512_set1_ps(a[0]);
+        c00 = _mm512_fmadd_ps(ai, b0, c00); c01 = _mm512_fmadd_ps(ai, b1, c01);
+        ai = _mm512_set1_ps(a[1]);
+        c10 = _mm512_fmadd_ps(ai, b0, c10); c11 = _mm512_fmadd_ps(ai, b1, c11);
+        ai = _mm512_set1_ps(a[2]);
+        c20 = _mm512_fmadd_ps(ai, b0, c20); c21 = _mm512_fmadd_ps(ai, b1, c21);
+        ai = _mm512_set1_ps(a[3]);
+        c30 = _mm512_fmadd_ps(ai, b0, c30); c31 = _mm512_fmadd_ps(ai, b1, c31);
+        ai = _mm512_set1_ps(a[4]);
+        c40 = _mm512_fmadd_ps(ai, b0, c40); c41 = _mm512_fmadd_ps(ai, b1, c41);
+        ai = _mm512_set1_ps(a[5]);
+        c50 = _mm512_fmadd_ps(ai, b0, c50); c51 = _mm512_fmadd_ps(ai, b1, c51);
+
+        a += 6;
+        b += 32;
+    }
+
+#define ACC_ROW(r, lo, hi) \
+    _mm512_storeu_ps(c + (r) * ldc, _mm512_add_ps(_mm512_loadu_ps(c + (r) * ldc), lo)); \
+    _mm512_storeu_ps(c + (r) * ldc + 16, _mm512_add_ps(_mm512_loadu_ps(c + (r) * ldc + 16), hi))
+    ACC_ROW(0, c00, c01);
+    ACC_ROW(1, c10, c11);
+    ACC_ROW(2, c20, c21);
+    ACC_ROW(3, c30, c31);
+    ACC_ROW(4, c40, c41);
+    ACC_ROW(5, c50, c51);
+#undef ACC_ROW
+}
+
+static const sgemm_kernel kernel_scalar_f32 = { "scalar 4x4", 4, 4, microkernel_scalar_4x4_f32 };
+static const sgemm_kernel kernel_avx2_f32 = { "avx2+fma 6x16", 6, 16, microkernel_avx2_6x16_f32 };
+static const sgemm_kernel kernel_avx512_f32 = { "avx512f 6x32", 6, 32, microkernel_avx512_6x32_f32 };
+
+/* Same instruction set as the double kernel select_kernel picked */
+static const sgemm_kernel *select_kernel_f32(void) {
+    const gemm_kernel *kern = select_kernel();
+
+    if (kern == &kernel_avx512) return &kernel_avx512_f32;
+    if (kern == &kernel_avx2) return &kernel_avx2_f32;
+    return &kernel_scalar_f32;
+}
+
+static void pack_b_f32(int kc, int nc, int nr, const float *B, int ldb, float *packed) {
+    for (int j = 0; j < nc; j += nr) {
+        int width = (nc - j < nr) ? nc - j : nr;
+        for (int p = 0; p < kc; p++) {
+            const float *src = B + (size_t)p * ldb + j;
+            int jj = 0;
+            for (; jj < width; jj++) *packed++ = src[jj];
+            for (; jj < nr; jj++) *packed++ = 0.0f;
+        }
+    }
+}
+
+static void pack_a_f32(int mc, int kc, int mr, const float *A, int lda, float *packed) {
+    for (int i = 0; i < mc; i += mr) {
+        int height = (mc - i < mr) ? mc - i : mr;
+        for (int p = 0; p < kc; p++) {
+            int ii = 0;
+            for (; ii < height; ii++) *packed++ = A[(size_t)(i + ii) * lda + p];
+            for (; ii < mr; ii++) *packed++ = 0.0f;
+        }
+    }
+}
+
+static void macrokernel_f32(const sgemm_kernel *kern, int mc, int nc, int kc,
+                            const float *packed_a, const float *packed_b,
+                            float *C, int ldc) {
+    float edge[GEMM_MAX_MR * SGEMM_MAX_NR];
+    int mr = kern->mr, nr = kern->nr;
+
+    for (int j = 0; j < nc; j += nr) {
+        int width = (nc - j < nr) ? nc - j : nr;
+        const float *b = packed_b + (size_t)j * kc;
+
+        for (int i = 0; i < mc; i += mr) {
+            int height = (mc - i < mr) ? mc - i : mr;
+            const float *a = packed_a + (size_t)i * kc;
+            float *c = C + (size_t)i * ldc + j;
+
+            if (height == mr && width == nr) {
+                kern->kernel(kc, a, b, c, ldc);
+            } else {
+                memset(edge, 0, sizeof(edge));
+                kern->kernel(kc, a, b, edge, nr);
+                for (int ii = 0; ii < height; ii++) {
+                    for (int jj = 0; jj < width; jj++) {
+                        c[(size_t)ii * ldc + jj] += edge[ii * nr + jj];
+                    }
+                }
+            }
+        }
+    }
+}
+
+int sgemm_blocked(int m, int n, int k,
+                  const float *A, int lda,
+                  const float *B, int ldb,
+                  float *C, int ldc) {
+    const sgemm_kernel *kern = select_kernel_f32();
+    int mr = kern->mr, nr = kern->nr;
+
+    if (m <= 0 || n <= 0 || k <= 0) return 1;
+
+    size_t a_size = (size_t)((GEMM_MC + mr - 1) / mr) * mr * GEMM_KC;
+    size_t b_size = (size_t)((GEMM_NC + nr - 1) / nr) * nr * GEMM_KC;
+    float *packed_a = (float *)packing_buffer(&thread_pack_a, a_size * sizeof(float));
+    float *packed_b = (float *)packing_buffer(&thread_pack_b, b_size * sizeof(float));
+    if (!packed_a || !packed_b) return 0;
+
+    for (int jc = 0; jc < n; jc += GEMM_NC) {
+        int nc = (n - jc < GEMM_NC) ? n - jc : GEMM_NC;
+
+        for (int pc = 0; pc < k; pc += GEMM_KC) {
+            int kc = (k - pc < GEMM_KC) ? k - pc : GEMM_KC;
+            pack_b_f32(kc, nc, nr, B + (size_t)pc * ldb + jc, ldb, packed_b);
+
+            for (int ic = 0; ic < m; ic += GEMM_MC) {
+                int mc = (m - ic < GEMM_MC) ? m - ic : GEMM_MC;
+                pack_a_f32(mc, kc, mr, A + (size_t)ic * lda + pc, lda, packed_a);
+                macrokernel_f32(kern, mc, nc, kc, packed_a, packed_b,
+                                C + (size_t)ic * ldc + jc, ldc);
+            }
+        }
+    }
+
+    return 1;
+}
+
+static void swap_rows_f32(float *A, int lda, int r1, int r2, int cols) {
+    float *x = A + (size_t)r1 * lda;
+    float *y = A + (size_t)r2 * lda;
+    for (int j = 0; j < cols; j++) {
+        float t = x[j];
+        x[j] = y[j];
+        y[j] = t;
+    }
+}
+
+/* lu_factor_blocked in float32, with the trailing updates through sgemm_blocked */
+int lu_factor_blocked_f32(int n, float *A, int lda, int *pivots, float tol) {
+    for (int k = 0; k < n; k += LU_BLOCK) {
+        int b = (n - k < LU_BLOCK) ? n - k : LU_BLOCK;
+        int panel_end = k + b;
+
+        for (int j = k; j < panel_end; j++) {
+            int p = j;
+            float max_val = fabsf(A[(size_t)j * lda + j]);
+            for (int i = j + 1; i < n; i++) {
+                float v = fabsf(A[(size_t)i * lda + j]);
+                if (v > max_val) {
+                    max_val = v;
+                    p = i;
+                }
+            }
+            pivots[j] = p;
+            if (max_val < tol) return 0;
+            if (p != j) swap_rows_f32(A, lda, j, p, n);
+
+            const float *pivot_row = A + (size_t)j * lda;
+            float inv_pivot = 1.0f / pivot_row[j];
+            for (int i = j + 1; i < n; i++) {
+                float *row = A + (size_t)i * lda;
+                float l = row[j] *= inv_pivot;
+                for (int c = j + 1; c < panel_end; c++) {
+                    row[c] -= l * pivot_row[c];
+                }
+            }
+        }
+
+        int rest = n - panel_end;
+        if (rest == 0) break;
+
+        for (int j = k + 1; j < panel_end; j++) {
+            float *row = A + (size_t)j * lda + panel_end;
+            for (int r = k; r < j; r++) {
+                float l = A[(size_t)j * lda + r];
+                const float *u = A + (size_t)r * lda + panel_end;
+                for (int c = 0; c < rest; c++) row[c] -= l * u[c];
+            }
+        }
+
+        float *neg_l21 = (float *)packing_buffer(&thread_lu_panel, (size_t)rest * b * sizeof(float));
+        if (!neg_l21) return 0;
+        for (int i = 0; i < rest; i++) {
+            const float *src = A + (size_t)(panel_end + i) * lda + k;
+            for (int c = 0; c < b; c++) neg_l21[(size_t)i * b + c] = -src[c];
+        }
+        if (!sgemm_blocked(rest, rest, b, neg_l21, b,
+                           A + (size_t)k * lda + panel_end, lda,
+                           A + (size_t)panel_end * lda + panel_end, lda)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int lu_solve_blocked_f32(int n, const float *LU, int lda, int nrhs, float *B, int ldb) {
+    float *neg = (float *)packing_buffer(&thread_lu_panel, (size_t)LU_BLOCK * n * sizeof(float));
+    float zero = 0.0f, sink = 0.0f;
+
+    if (!neg || !sgemm_blocked(1, 1, 1, &zero, 1, &zero, 1, &sink, 1)) return 0;
+
+    for (int k = 0; k < n; k += LU_BLOCK) {
+        int b = (n - k < LU_BLOCK) ? n - k : LU_BLOCK;
+        float *block = B + (size_t)k * ldb;
+
+        if (k > 0) {
+            for (int i = 0; i < b; i++) {
+                const float *src = LU + (size_t)(k + i) * lda;
+                for (int c = 0; c < k; c++) neg[(size_t)i * k + c] = -src[c];
+            }
+            sgemm_blocked(b, nrhs, k, neg, k, B, ldb, block, ldb);
+        }
+        for (int i = 1; i < b; i++) {
+            float *row = block + (size_t)i * ldb;
+            for (int r = 0; r < i; r++) {
+                float l = LU[(size_t)(k + i) * lda + k + r];
+                const float *src = block + (size_t)r * ldb;
+                for (int c = 0; c < nrhs; c++) row[c] -= l * src[c];
+            }
+        }
+    }
+
+    for (int end = n; end > 0; ) {
+        int k = (end > LU_BLOCK) ? end - LU_BLOCK : 0;
+        int b = end - k, rest = n - end;
+        float *block = B + (size_t)k * ldb;
+
+        if (rest > 0) {
+            for (int i = 0; i < b; i++) {
+                const float *src = LU + (size_t)(k + i) * lda + end;
+                for (int c = 0; c < rest; c++) neg[(size_t)i * rest + c] = -src[c];
+            }
+            sgemm_blocked(b, nrhs, rest, neg, rest, B + (size_t)end * ldb, ldb, block, ldb);
+        }
+        for (int i = b - 1; i >= 0; i--) {
+            float *row = block + (size_t)i * ldb;
+            for (int r = i + 1; r < b; r++) {
+                float u = LU[(size_t)(k + i) * lda + k + r];
+                const float *src = block + (size_t)r * ldb;
+                for (int c = 0; c < nrhs; c++) row[c] -= u * src[c];
+            }
+            float inv_diag = 1.0f / LU[(size_t)(k + i) * lda + k + i];
+            for (int c = 0; c < nrhs; c++) row[c] *= inv_diag;
+        }
+        end = k;
+    }
+    return 1;
+}
+
+void lu_solve_f32(int n, const float *LU, int lda, const int *pivots,
+                  int nrhs, float *B, int ldb) {
+    for (int j = 0; j < n; j++) {
+        if (pivots[j] != j) swap_rows_f32(B, ldb, j, pivots[j], nrhs);
+    }
+    if (nrhs >= SOLVE_BLOCK_MIN_RHS && lu_solve_blocked_f32(n, LU, lda, nrhs, B, ldb)) return;
+
+    for (int i = 1; i < n; i++) {
+        float *row = B + (size_t)i * ldb;
+        for (int r = 0; r < i; r++) {
+            float l = LU[(size_t)i * lda + r];
+            if (l == 0.0f) continue;
+            const float *src = B + (size_t)r * ldb;
+            for (int c = 0; c < nrhs; c++) row[c] -= l * src[c];
+        }
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+        float *row = B + (size_t)i * ldb;
+        for (int r = i + 1; r < n; r++) {
+            float u = LU[(size_t)i * lda + r];
+            if (u == 0.0f) continue;
+            const float *src = B + (size_t)r * ldb;
+            for (int c = 0; c < nrhs; c++) row[c] -= u * src[c];
+        }
+        float inv_diag = 1.0f / LU[(size_t)i * lda + i];
+        for (int c = 0; c < nrhs; c++) row[c] *= inv_diag;
+    }
+}
+
+/* ===== GEMV ===== */
+
+static void gemv_scalar(int m, int n, const double *A, int lda, const double *x, double *y) {
+    for (int i = 0; i < m; i++) {
+        const double *row = A + (size_t)i * lda;
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+        int j = 0;
+        for (; j + 4 <= n; j += 4) {
+            s0 += row[j] * x[j];
+            s1 += row[j + 1] * x[j + 1];
+            s2 += row[j + 2] * x[j + 2];
+            s3 += row[j + 3] * x[j + 3];
+        }
+        for (; j < n; j++) s0 += row[j] * x[j];
+        y[i] = (s0 + s1) + (s2 + s3);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static double hsum_avx2(__m256d v) {
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+__attribute__((target("avx2,fma")))
+static void gemv_avx2(int m, int n, const double *A, int lda, const double *x, double *y) {
+    int i = 0;
+    for (; i + 4 <= m; i += 4) {
+        const double *r0 = A + (size_t)i * lda, *r1 = r0 + lda, *r2 = r1 + lda, *r3 = r2 + lda;
+        __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+        int j = 0;
+        for (; j + 4 <= n; j += 4) {
+            __m256d xv = _mm256_loadu_pd(x + j);
+            s0 = _mm256_fmadd_pd(_mm256_loadu_pd(r0 + j), xv, s0);
+            s1 = _mm256_fmadd_pd(_mm256_loadu_pd(r1 + j), xv, s1);
+            s2 = _mm256_fmadd_pd(_mm256_loadu_pd(r2 + j), xv, s2);
+            s3 = _mm256_fmadd_pd(_mm256_loadu_pd(r3 + j), xv, s3);
+        }
+        double t0 = hsum_avx2(s0), t1 = hsum_avx2(s1), t2 = hsum_avx2(s2), t3 = hsum_avx2(s3);
+        for (; j < n; j++) {
+            t0 += r0[j] * x[j];
+            t1 += r1[j] * x[j];
+            t2 += r2[j] * x[j];
+            t3 += r3[j] * x[j];
+        }
+        y[i] = t0;
+        y[i + 1] = t1;
+        y[i + 2] = t2;
+        y[i + 3] = t3;
+    }
+    gemv_scalar(m - i, n, A + (size_t)i * lda, lda, x, y + i);
+}
+
+void gemv(int m, int n, const double *A, int lda, const double *x, double *y) {
+    static int avx2 = -1;
+    if (avx2 < 0) {
+        __builtin_cpu_init();
+        avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    if (avx2) gemv_avx2(m, n, A, lda, x, y);
+    else gemv_scalar(m, n, A, lda, x, y);
+}
+
+/* ===== Householder QR ===== */
+
+#define QR_BLOCK 96
+#define QR_INNER 8
+
+static __thread pack_buffer thread_qr, thread_qr_inner;
+
+/*
+ * Unblocked QR of a rows x cols panel (LAPACK geqr2). Column c gets the
+ * reflector that zeroes it below the diagonal, which is then applied to the
+ * panel's remaining columns; w holds cols doubles.
+ */
+static void qr_panel(int rows, int cols, double *P, int lda, double *tau, double *w) {
+    for (int c = 0; c < cols; c++) {
+        double *top = P + (size_t)c * lda + c;
+        double alpha = *top, tail = 0.0;
+        for (int i = c + 1; i < rows; i++) {
+            double v = P[(size_t)i * lda + c];
+            tail += v * v;
+        }
+        if (tail == 0.0) {
+            tau[c] = 0.0;
+            continue;
+        }
+        double beta = -copysign(sqrt(alpha * alpha + tail), alpha);
+        tau[c] = (beta - alpha) / beta;
+        double inv = 1.0 / (alpha - beta);
+        for (int i = c + 1; i < rows; i++) P[(size_t)i * lda + c] *= inv;
+        *top = beta;
+
+        /* w = v^T P[c:, c+1:], then P[c:, c+1:] -= tau v w, walking rows */
+        int rest = cols - c - 1;
+        if (rest == 0) continue;
+        memcpy(w, top + 1, (size_t)rest * sizeof(double));
+        for (int i = c + 1; i < rows; i++) {
+            double v = P[(size_t)i * lda + c];
+            const double *row = P + (size_t)i * lda + c + 1;
+            for (int j = 0; j < rest; j++) w[j] += v * row[j];
+        }
+        for (int j = 0; j < rest; j++) top[1 + j] -= tau[c] * w[j];
+        for (int i = c + 1; i < rows; i++) {
+            double f = tau[c] * P[(size_t)i * lda + c];
+            double *row = P + (size_t)i * lda + c + 1;
+            for (int j = 0; j < rest; j++) row[j] -= f * w[j];
+        }
+    }
+}
+
+/*
+ * Copy jb reflectors stored below the diagonal of P into an explicit
+ * rows x jb V (unit diagonal, zeros above; P may be V itself) and form the upper triangular T
+ * with H_1 ... H_jb = I - V T V^T (LAPACK larft, forward, columnwise).
+ */
+static int qr_block_reflector(int rows, int jb, const double *P, int lda, const double *tau,
+                              double *V, double *T, double *G) {
+    for (int i = 0; i < rows; i++) {
+        for (int c = 0; c < jb; c++) {
+            V[(size_t)i * jb + c] = i == c ? 1.0 : (i < c ? 0.0 : P[(size_t)i * lda + c]);
+        }
+    }
+    /* G = V^T V; column i above the diagonal gives V[:, 0:i]^T v_i */
+    if (!gemm_blocked_scaled(1, 0, jb, jb, rows, 1.0, V, jb, V, jb, 0.0, G, jb)) return 0;
+    for (int i = 0; i < jb; i++) {
+        for (int r = 0; r < i; r++) {
+            double s = 0.0;
+            for (int c = r; c < i; c++) s += T[(size_t)r * jb + c] * G[(size_t)c * jb + i];
+            T[(size_t)r * jb + i] = -tau[i] * s;
+        }
+        T[(size_t)i * jb + i] = tau[i];
+        for (int r = i + 1; r < jb; r++) T[(size_t)r * jb + i] = 0.0;
+    }
+    return 1;
+}
+
+/* C = (I - V op(T) V^T) C for a rows x ncols C, with op(T) = T^T when trans is set */
+static int qr_apply_block(int trans, int rows, int jb, const double *V, const double *T,
+                          int ncols, double *C, int ldc, double *W, double *W2) {
+    return gemm_blocked_scaled(1, 0, jb, ncols, rows, 1.0, V, jb, C, ldc, 0.0, W, ncols) &&
+           gemm_blocked_scaled(trans, 0, jb, ncols, jb, 1.0, T, jb, W, ncols, 0.0, W2, ncols) &&
+           gemm_blocked_scaled(0, 0, rows, ncols, jb, -1.0, V, jb, W2, ncols, 1.0, C, ldc);
+}
+
+/* Scratch for one block: V, T, G, W and W2, in that order */
+static double *qr_scratch(pack_buffer *buffer, int rows, int jb, int ncols) {
+    size_t wide = (size_t)jb * (ncols > jb ? ncols : jb);
+    return (double *)packing_buffer(buffer, ((size_t)rows * jb + 2 * (size_t)jb * jb + 2 * wide) * sizeof(double));
+}
+
+/*
+ * Blocked QR with nb-column blocks. A panel wider than QR_INNER is copied
+ * out contiguously (in place its rows sit lda apart) and factored the same
+ * way with QR_INNER-column blocks, so most panel flops run in GEMMs too.
+ */
+static int qr_factor_level(int m, int n, double *A, int lda, double *tau, int nb, pack_buffer *buffer) {
+    int kmax = m < n ? m : n;
+    for (int j = 0; j < kmax; j += nb) {
+        int jb = (kmax - j < nb) ? kmax - j : nb;
+        int rows = m - j, rest = n - j - jb;
+        double *V = qr_scratch(buffer, rows, jb, rest);
+        if (!V) return 0;
+        double *T = V + (size_t)rows * jb, *G = T + (size_t)jb * jb, *W = G + (size_t)jb * jb;
+        double *W2 = W + (size_t)jb * (rest > jb ? rest : jb);
+
+        double *panel = A + (size_t)j * lda + j;
+        const double *P = panel;
+        int ldp = lda;
+        if (jb > QR_INNER) {
+            for (int i = 0; i < rows; i++) memcpy(V + (size_t)i * jb, panel + (size_t)i * lda, (size_t)jb * sizeof(double));
+            if (!qr_factor_level(rows, jb, V, jb, tau + j, QR_INNER, &thread_qr_inner)) return 0;
+            for (int i = 0; i < rows; i++) memcpy(panel + (size_t)i * lda, V + (size_t)i * jb, (size_t)jb * sizeof(double));
+            P = V;
+            ldp = jb;
+        } else {
+            qr_panel(rows, jb, panel, lda, tau + j, W);
+        }
+        if (rest == 0) continue;
+        if (!qr_block_reflector(rows, jb, P, ldp, tau + j, V, T, G) ||
+            !qr_apply_block(1, rows, jb, V, T, rest, panel + jb, lda, W, W2)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int qr_factor_blocked(int m, int n, double *A, int lda, double *tau) {
+    return qr_factor_level(m, n, A, lda, tau, QR_BLOCK, &thread_qr);
+}
+
+int qr_apply_q(int trans, int m, int k, const double *QR, int lda, const double *tau,
+               int nrhs, double *B, int ldb) {
+    /* Q^T = H_k ... H_1 takes the blocks first to last, Q last to first */
+    int blocks = (k + QR_BLOCK - 1) / QR_BLOCK;
+    for (int b = 0; b < blocks; b++) {
+        int j = (trans ? b : blocks - 1 - b) * QR_BLOCK;
+        int jb = (k - j < QR_BLOCK) ? k - j : QR_BLOCK;
+        int rows = m - j;
+        double *V = qr_scratch(&thread_qr, rows, jb, nrhs);
+        if (!V) return 0;
+        double *T = V + (size_t)rows * jb, *G = T + (size_t)jb * jb, *W = G + (size_t)jb * jb;
+        double *W2 = W + (size_t)jb * (nrhs > jb ? nrhs : jb);
+        if (!qr_block_reflector(rows, jb, QR + (size_t)j * lda + j, lda, tau + j, V, T, G) ||
+            !qr_apply_block(trans, rows, jb, V, T, nrhs, B + (size_t)j * ldb, ldb, W, W2)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Full rank: every |R_ii| above tol times the largest */
+static int qr_full_rank(int k, const double *R, int ldr, double tol) {
+    double largest = 0.0;
+    for (int i = 0; i < k; i++) largest = fmax(largest, fabs(R[(size_t)i * ldr + i]));
+    for (int i = 0; i < k; i++) {
+        if (!(fabs(R[(size_t)i * ldr + i]) > tol * largest)) return 0;
+    }
+    return 1;
+}
+
+size_t lstsq_qr_scratch(int m, int n, int nrhs) {
+    int k = m < n ? m : n;
+    return (size_t)k + (size_t)(m > n ? m : n) * (m < n ? m : nrhs);
+}
+
+int lstsq_qr(int m, int n, double *A, int lda, int nrhs, const double *B, int ldb,
+             double *X, int ldx, double *scratch, double tol) {
+    int k = m < n ? m : n;
+    double *tau = scratch;
+    double *work = scratch + k;
+    int ok = 1;
+
+    if (m >= n) {
+        /* R X = (Q^T B)[0:n], back substitution row by row */
+        for (int i = 0; i < m; i++) memcpy(work + (size_t)i * nrhs, B + (size_t)i * ldb, (size_t)nrhs * sizeof(double));
+        ok = qr_factor_blocked(m, n, A, lda, tau) && qr_full_rank(n, A, lda, tol) &&
+             qr_apply_q(1, m, n, A, lda, tau, nrhs, work, nrhs);
+        for (int i = n - 1; ok && i >= 0; i--) {
+            double *row = work + (size_t)i * nrhs;
+            for (int r = i + 1; r < n; r++) {
+                double u = A[(size_t)i * lda + r];
+                const double *src = work + (size_t)r * nrhs;
+                for (int c = 0; c < nrhs; c++) row[c] -= u * src[c];
+            }
+            double inv = 1.0 / A[(size_t)i * lda + i];
+            for (int c = 0; c < nrhs; c++) row[c] *= inv;
+            memcpy(X + (size_t)i * ldx, row, (size_t)nrhs * sizeof(double));
+        }
+    } else {
+        /* A^T = Q R, so A = R^T Q^T: solve R^T Z = B forward, then X = Q [Z; 0] */
+        transpose_blocked(m, n, A, lda, work, m);
+        ok = qr_factor_blocked(n, m, work, m, tau) && qr_full_rank(m, work, m, tol);
+        for (int i = 0; ok && i < n; i++) {
+            double *row = X + (size_t)i * ldx;
+            if (i >= m) {
+                memset(row, 0, (size_t)nrhs * sizeof(double));
+                continue;
+            }
+            memcpy(row, B + (size_t)i * ldb, (size_t)nrhs * sizeof(double));
+            for (int r = 0; r < i; r++) {
+                double l = work[(size_t)r * m + i];
+                const double *src = X + (size_t)r * ldx;
+                for (int c = 0; c < nrhs; c++) row[c] -= l * src[c];
+            }
+            double inv = 1.0 / work[(size_t)i * m + i];
+            for (int c = 0; c < nrhs; c++) row[c] *= inv;
+        }
+        ok = ok && qr_apply_q(0, n, m, work, m, tau, nrhs, X, ldx);
+    }
+    return ok;
+}
@@ -0,0 +1,150 @@
+/*
+ * matrixOp_kernels.h - Dense compute kernels used by the matrix RPC server
+ */
+
+#ifndef MATRIXOP_KERNELS_H
+#define MATRIXOP_KERNELS_H
+
+#include <stddef.h>
+
+/*
+ * Blocked matrix multiplication on row-major data: C += A * B
+ * A is m x k (leading dimension lda), B is k x n (ldb), C is m x n (ldc).
+ * Picks an AVX-512 or AVX2/FMA microkernel at runtime, scalar otherwise.
+ * Packing buffers are allocated on a thread's first call and reused after that.
+ * Returns 0 if the packing buffers could not be allocated.
+ */
+int gemm_blocked(int m, int n, int k,
+                 const double *A, int lda,
+                 const double *B, int ldb,
+                 double *C, int ldc);
+
+/*
+ * C += op(A) * op(B), where op transposes its operand when the flag is set.
+ * op(A) is m x k and op(B) is k x n; lda and ldb describe the stored (untransposed)
+ * arrays. Transposes are absorbed while packing, so they cost no extra pass.
+ */
+int gemm_blocked_trans(int trans_a, int trans_b, int m, int n, int k,
+                       const double *A, int lda,
+                       const double *B, int ldb,
+                       double *C, int ldc);
+
+/*
+ * C = alpha * op(A) * op(B) + beta * C, the BLAS dgemm on row-major arrays.
+ * alpha is folded into the packing of A and transposes are absorbed the
+ * same way, so neither costs an extra pass; beta = 0 overwrites C.
+ */
+int gemm_blocked_scaled(int trans_a, int trans_b, int m, int n, int k,
+                        double alpha, const double *A, int lda,
+                        const double *B, int ldb,
+                        double beta, double *C, int ldc);
+
+/*
+ * C = alpha * A * A^T + beta * C with A n x k, or alpha * A^T * A + beta * C
+ * with A k x n when trans is set. Only the lower triangle is computed (about
+ * half the GEMM flops) and is then mirrored, so C comes back symmetric;
+ * beta reads only the lower triangle of C.
+ */
+int syrk_blocked(int trans, int n, int k, double alpha, const double *A, int lda,
+                 double beta, double *C, int ldc);
+
+/* Smallest dimension gemm_strassen splits by default */
+#define STRASSEN_DEFAULT_CROSSOVER 1024
+
+/*
+ * C += A * B like gemm_blocked, but products whose dimensions all reach the
+ * crossover are split Strassen-Winograd style (7 half-size products instead
+ * of 8) until they drop below it. Scratch is kept per thread and reused.
+ * Rounding error grows slightly with each level of recursion.
+ */
+int gemm_strassen(int m, int n, int k,
+                  const double *A, int lda,
+                  const double *B, int ldb,
+                  double *C, int ldc);
+
+/* Set the gemm_strassen crossover for all threads; 0 turns splitting off */
+void gemm_set_strassen_crossover(int n);
+
+/*
+ * In-place LU factorization with partial pivoting, PA = LU, on an n x n
+ * row-major matrix: L (unit diagonal) and U are packed into A, and row j
+ * was swapped with row pivots[j] at step j (LAPACK getrf convention).
+ * Blocked and right-looking, so the trailing updates run through the GEMM.
+ * Returns 0 if a pivot falls below tol (singular) or scratch allocation fails.
+ */
+int lu_factor_blocked(int n, double *A, int lda, int *pivots, double tol);
+
+/*
+ * Solve A X = B in place for nrhs right-hand sides (B is n x nrhs) using
+ * lu_factor_blocked output. Many right-hand sides (an inverse) are solved
+ * in row blocks with GEMM updates.
+ */
+void lu_solve(int n, const double *LU, int lda, const int *pivots,
+              int nrhs, double *B, int ldb);
+
+/*
+ * Householder QR of an m x n row-major A (LAPACK geqrf layout): R in the
+ * upper triangle, and below the diagonal the reflectors H_j = I - tau_j v v^T
+ * (v[j] = 1 implied), min(m, n) of them with their taus in tau. Each
+ * QR_BLOCK-column panel's reflectors are accumulated into a compact WY
+ * block I - V T V^T, applied to the trailing columns with three GEMMs.
+ * Returns 0 if scratch allocation fails.
+ */
+int qr_factor_blocked(int m, int n, double *A, int lda, double *tau);
+
+/*
+ * B = Q^T B (trans set) or Q B for the m x nrhs B, where Q = H_1 ... H_k is
+ * the product of the first k reflectors left by qr_factor_blocked in QR.
+ */
+int qr_apply_q(int trans, int m, int k, const double *QR, int lda, const double *tau,
+               int nrhs, double *B, int ldb);
+
+/* Doubles of caller scratch lstsq_qr needs: the taus and a copy of B or A^T */
+size_t lstsq_qr_scratch(int m, int n, int nrhs);
+
+/*
+ * X (n x nrhs) minimizing ||A X - B|| for an m x n A, which is destroyed,
+ * and an m x nrhs B. For m >= n, X = R^-1 (Q^T B) from the QR of A; for
+ * m < n, the minimum-norm solution X = Q R^-T B from the QR of A^T.
+ * scratch holds lstsq_qr_scratch(m, n, nrhs) doubles. Returns 0 if a
+ * diagonal entry of R falls below tol times the largest (rank deficient)
+ * or the QR's own scratch allocation fails.
+ */
+int lstsq_qr(int m, int n, double *A, int lda, int nrhs, const double *B, int ldb,
+             double *X, int ldx, double *scratch, double tol);
+
+/*
+ * B = A^T, with A rows x cols (leading dimension lda) and B cols x rows (ldb).
+ * Recursively halves the longer side until blocks fit in L1 (cache-oblivious),
+ * then transposes 4x4 blocks in AVX2 registers (32-byte aligned rows) or
+ * 2x2 blocks in SSE2 registers (16-byte aligned rows).
+ */
+void transpose_blocked(int rows, int cols, const double *A, int lda, double *B, int ldb);
+
+/* A = A^T for an n x n matrix without a second buffer */
+void transpose_square_inplace(int n, double *A, int lda);
+
+/*
+ * y = A x for an m x n row-major A. Four rows share each load of x, with an
+ * AVX2/FMA path picked at runtime; the kernel is bound by reading A once.
+ */
+void gemv(int m, int n, const double *A, int lda, const double *x, double *y);
+
+/*
+ * Single-precision counterparts: half the memory traffic and twice the SIMD
+ * lanes of the double kernels, with about 7 significant digits.
+ */
+int sgemm_blocked(int m, int n, int k,
+                  const float *A, int lda,
+                  const float *B, int ldb,
+                  float *C, int ldc);
+
+int lu_factor_blocked_f32(int n, float *A, int lda, int *pivots, float tol);
+
+void lu_solve_f32(int n, const float *LU, int lda, const int *pivots,
+                  int nrhs, float *B, int ldb);
+
+/* Name of the microkernel gemm_blocked dispatches to on this CPU */
+const char *gemm_kernel_name(void);
+
+#endif /* MATRIXOP_KERNELS_H */
@@ -0,0 +1,357 @@
+/*
+ * matrixOp_krylov.c - Preconditioned Krylov solvers (CG, GMRES) on dense or CSR operators
+ *
+ * Each iteration costs one product with A (GEMV or SpMV), one application
+ * of the preconditioner and a few vector updates, so a system that
+ * converges in tens of iterations is solved in O(n^2) (dense) or O(nnz)
+ * work per iteration instead of an O(n^3) factorization.
+ *
+ * ILU(0) factors A into L U keeping only the entries of A's own sparsity
+ * pattern (IKJ order on rows sorted by column); applying it is a forward
+ * and a backward sweep over that pattern.
+ *
+ * The preconditioner, the work vectors and the GMRES basis all come from
+ * the caller's request arena, so a solve allocates nothing of its own.
+ */
+
+#include <string.h>
+#include <math.h>
+#include "matrixOp_arena.h"
+#include "matrixOp_kernels.h"
+#include "matrixOp_sparse.h"
+#include "matrixOp_krylov.h"
+
+typedef struct {
+    krylov_precond kind;
+    int n;
+    double *inv_diag;       /* Jacobi */
+    int *ptr;               /* ILU(0): L (unit diagonal) and U on A's pattern, rows sorted */
+    int *idx;
+    int *diag;              /* position of a_ii in row i */
+    double *val;
+} preconditioner;
+
+static const char *no_memory = "Error: Memory allocation failed";
+
+static void apply_operator(const krylov_operator *A, const double *x, double *y) {
+    if (A->dense) {
+        gemv(A->n, A->n, A->dense, A->lda, x, y);
+    } else {
+        csr_spmv(A->n, A->ptr, A->idx, A->val, x, y);
+    }
+}
+
+static double dot(int n, const double *x, const double *y) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += x[i] * y[i];
+        s1 += x[i + 1] * y[i + 1];
+        s2 += x[i + 2] * y[i + 2];
+        s3 += x[i + 3] * y[i + 3];
+    }
+    for (; i < n; i++) s0 += x[i] * y[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+/* y += a * x */
+static void axpy(int n, double a, const double *x, double *y) {
+    for (int i = 0; i < n; i++) y[i] += a * x[i];
+}
+
+static void scale(int n, double a, double *x) {
+    for (int i = 0; i < n; i++) x[i] *= a;
+}
+
+/* ===== Preconditioners ===== */
+
+static const char *jacobi_setup(preconditioner *m, const krylov_operator *A, request_arena *scratch) {
+    int n = A->n;
+    m->inv_diag = (double *)arena_alloc(scratch, (size_t)n * sizeof(double));
+    if (!m->inv_diag) return no_memory;
+    for (int i = 0; i < n; i++) {
+        double d = 0.0;
+        if (A->dense) {
+            d = A->dense[(size_t)i * A->lda + i];
+        } else {
+            for (int p = A->ptr[i]; p < A->ptr[i + 1]; p++) {
+                if (A->idx[p] == i) d += A->val[p];
+            }
+        }
+        if (d == 0.0) return "Error: Jacobi needs a nonzero diagonal";
+        m->inv_diag[i] = 1.0 / d;
+    }
+    return NULL;
+}
+
+/* Sorted, duplicate-free copy of A's rows: transposing twice sorts every row by column */
+static const char *ilu0_pattern(preconditioner *m, const krylov_operator *A, request_arena *scratch) {
+    int n = A->n;
+    size_t nnz = (size_t)A->ptr[n];
+    int *t_ptr = (int *)arena_alloc(scratch, ((size_t)n + 1) * sizeof(int));
+    int *t_idx = (int *)arena_alloc(scratch, (nnz ? nnz : 1) * sizeof(int));
+    double *t_val = (double *)arena_alloc(scratch, (nnz ? nnz : 1) * sizeof(double));
+    m->ptr = (int *)arena_alloc(scratch, ((size_t)n + 1) * sizeof(int));
+    m->idx = (int *)arena_alloc(scratch, (nnz ? nnz : 1) * sizeof(int));
+    m->val = (double *)arena_alloc(scratch, (nnz ? nnz : 1) * sizeof(double));
+    m->diag = (int *)arena_alloc(scratch, (size_t)n * sizeof(int));
+    if (!t_ptr || !t_idx || !t_val || !m->ptr || !m->idx || !m->val || !m->diag) {
+        return no_memory;
+    }
+    csr_transpose(n, n, A->ptr, A->idx, A->val, t_ptr, t_idx, t_val);
+    csr_transpose(n, n, t_ptr, t_idx, t_val, m->ptr, m->idx, m->val);
+
+    /* Sum duplicate entries, now adjacent, and find each diagonal */
+    int out = 0, start = 0;
+    for (int i = 0; i < n; i++) {
+        int end = m->ptr[i + 1];
+        m->ptr[i] = out;
+        m->diag[i] = -1;
+        for (int p = start; p < end; p++) {
+            if (out > m->ptr[i] && m->idx[out - 1] == m->idx[p]) {
+                m->val[out - 1] += m->val[p];
+                continue;
+            }
+            if (m->idx[p] == i) m->diag[i] = out;
+            m->idx[out] = m->idx[p];
+            m->val[out] = m->val[p];
+            out++;
+        }
+        start = end;
+        if (m->diag[i] < 0) return "Error: ILU(0) needs every diagonal entry in A's pattern";
+    }
+    m->ptr[n] = out;
+    return NULL;
+}
+
+static const char *ilu0_setup(preconditioner *m, const krylov_operator *A, request_arena *scratch) {
+    if (A->dense) return "Error: ILU(0) needs a sparse operand";
+    const char *error = ilu0_pattern(m, A, scratch);
+    if (error) return error;
+
+    int n = A->n;
+    int *marker = (int *)arena_alloc(scratch, (size_t)n * sizeof(int));
+    if (!marker) return no_memory;
+    for (int i = 0; i < n; i++) marker[i] = -1;
+
+    for (int i = 0; i < n; i++) {
+        for (int p = m->ptr[i]; p < m->ptr[i + 1]; p++) marker[m->idx[p]] = p;
+        /* Entries left of the diagonal, in column order: eliminate with row k of U */
+        for (int p = m->ptr[i]; p < m->diag[i]; p++) {
+            int k = m->idx[p];
+            double l = m->val[p] /= m->val[m->diag[k]];
+            for (int q = m->diag[k] + 1; q < m->ptr[k + 1]; q++) {
+                int at = marker[m->idx[q]];
+                if (at >= 0) m->val[at] -= l * m->val[q];
+            }
+        }
+        for (int p = m->ptr[i]; p < m->ptr[i + 1]; p++) marker[m->idx[p]] = -1;
+        if (m->val[m->diag[i]] == 0.0) return "Error: Zero pivot in ILU(0)";
+    }
+    return NULL;
+}
+
+static const char *precond_setup(preconditioner *m, const krylov_operator *A, krylov_precond kind,
+                                 request_arena *scratch) {
+    memset(m, 0, sizeof(*m));
+    m->kind = kind;
+    m->n = A->n;
+    switch (kind) {
+        case PRECOND_NONE:
+            return NULL;
+        case PRECOND_JACOBI:
+            return jacobi_setup(m, A, scratch);
+        case PRECOND_ILU0:
+            return ilu0_setup(m, A, scratch);
+    }
+    return "Error: Unknown preconditioner";
+}
+
+/* z = M^-1 r */
+static void precond_apply(const preconditioner *m, const double *r, double *z) {
+    int n = m->n;
+    switch (m->kind) {
+        case PRECOND_JACOBI:
+            for (int i = 0; i < n; i++) z[i] = m->inv_diag[i] * r[i];
+            return;
+        case PRECOND_ILU0:
+            for (int i = 0; i < n; i++) {
+                double s = r[i];
+                for (int p = m->ptr[i]; p < m->diag[i]; p++) s -= m->val[p] * z[m->idx[p]];
+                z[i] = s;
+            }
+            for (int i = n - 1; i >= 0; i--) {
+                double s = z[i];
+                for (int p = m->diag[i] + 1; p < m->ptr[i + 1]; p++) s -= m->val[p] * z[m->idx[p]];
+                z[i] = s / m->val[m->diag[i]];
+            }
+            return;
+        default:
+            memcpy(z, r, (size_t)n * sizeof(double));
+            return;
+    }
+}
+
+/* r = b - A x; returns ||r|| */
+static double residual(const krylov_operator *A, const double *b, const double *x, double *r) {
+    apply_operator(A, x, r);
+    for (int i = 0; i < A->n; i++) r[i] = b[i] - r[i];
+    return sqrt(dot(A->n, r, r));
+}
+
+/* ===== CG ===== */
+
+const char *krylov_cg(const krylov_operator *A, krylov_precond precond,
+                      const double *b, double *x, double tol, int max_iter,
+                      double *residuals, int *iterations, int *converged,
+                      request_arena *scratch) {
+    int n = A->n;
+    preconditioner m;
+    *iterations = 0;
+    *converged = 0;
+
+    const char *error = precond_setup(&m, A, precond, scratch);
+    double *r = error ? NULL : (double *)arena_alloc(scratch, 4 * (size_t)n * sizeof(double));
+    if (!error && !r) error = no_memory;
+    if (error) return error;
+    double *z = r + n, *p = z + n, *q = p + n;
+
+    double b_norm = sqrt(dot(n, b, b));
+    if (b_norm == 0.0) {
+        memset(x, 0, (size_t)n * sizeof(double));
+        residuals[0] = 0.0;
+        *converged = 1;
+        goto done;
+    }
+    residuals[0] = residual(A, b, x, r) / b_norm;
+    if (residuals[0] <= tol) {
+        *converged = 1;
+        goto done;
+    }
+
+    precond_apply(&m, r, z);
+    memcpy(p, z, (size_t)n * sizeof(double));
+    double rz = dot(n, r, z);
+    for (int it = 1; it <= max_iter; it++) {
+        apply_operator(A, p, q);
+        double pq = dot(n, p, q);
+        if (!(pq > 0.0)) {
+            error = "Error: Matrix is not positive definite; use GMRES";
+            break;
+        }
+        double alpha = rz / pq;
+        axpy(n, alpha, p, x);
+        axpy(n, -alpha, q, r);
+        residuals[it] = sqrt(dot(n, r, r)) / b_norm;
+        *iterations = it;
+        if (residuals[it] <= tol) {
+            *converged = 1;
+            break;
+        }
+        precond_apply(&m, r, z);
+        double rz_next = dot(n, r, z);
+        double beta = rz_next / rz;
+        rz = rz_next;
+        for (int i = 0; i < n; i++) p[i] = z[i] + beta * p[i];
+    }
+
+done:
+    return error;
+}
+
+/* ===== GMRES ===== */
+
+const char *krylov_gmres(const krylov_operator *A, krylov_precond precond, int restart,
+                         const double *b, double *x, double tol, int max_iter,
+                         double *residuals, int *iterations, int *converged,
+                         request_arena *scratch) {
+    int n = A->n;
+    int m = restart > 0 ? restart : KRYLOV_DEFAULT_RESTART;
+    if (m > n) m = n;
+    preconditioner pc;
+    *iterations = 0;
+    *converged = 0;
+
+    /* Krylov basis V (m + 1 vectors), two work vectors, Hessenberg H and the Givens rotations */
+    const char *error = precond_setup(&pc, A, precond, scratch);
+    double *V = error ? NULL : (double *)arena_alloc(scratch, ((size_t)m + 3) * n * sizeof(double));
+    double *H = error ? NULL : (double *)arena_alloc(scratch, ((size_t)m + 1) * m * sizeof(double));
+    double *rot = error ? NULL : (double *)arena_alloc(scratch, (4 * (size_t)m + 1) * sizeof(double));
+    if (!error && (!V || !H || !rot)) error = no_memory;
+    if (error) return error;
+    double *w = V + ((size_t)m + 1) * n, *z = w + n;
+    double *cs = rot, *sn = cs + m, *y = sn + m, *g = y + m;
+
+    double b_norm = sqrt(dot(n, b, b));
+    if (b_norm == 0.0) {
+        memset(x, 0, (size_t)n * sizeof(double));
+        residuals[0] = 0.0;
+        *converged = 1;
+        goto done;
+    }
+    double beta = residual(A, b, x, V);
+    residuals[0] = beta / b_norm;
+    int it = 0;
+    while (residuals[it] > tol && it < max_iter) {
+        scale(n, 1.0 / beta, V);
+        memset(g, 0, ((size_t)m + 1) * sizeof(double));
+        g[0] = beta;
+
+        /* Arnoldi with modified Gram-Schmidt, reducing H to triangular form as it grows */
+        int j = 0;
+        while (j < m && it < max_iter) {
+            double *next = V + ((size_t)j + 1) * n;
+            precond_apply(&pc, V + (size_t)j * n, w);
+            apply_operator(A, w, next);
+            for (int i = 0; i <= j; i++) {
+                double h = dot(n, next, V + (size_t)i * n);
+                H[(size_t)i * m + j] = h;
+                axpy(n, -h, V + (size_t)i * n, next);
+            }
+            double h_next = sqrt(dot(n, next, next));
+            for (int i = 0; i < j; i++) {
+                double a = H[(size_t)i * m + j], c = H[((size_t)i + 1) * m + j];
+                H[(size_t)i * m + j] = cs[i] * a + sn[i] * c;
+                H[((size_t)i + 1) * m + j] = -sn[i] * a + cs[i] * c;
+            }
+            double diag = H[(size_t)j * m + j], radius = hypot(diag, h_next);
+            cs[j] = radius > 0.0 ? diag / radius : 1.0;
+            sn[j] = radius > 0.0 ? h_next / radius : 0.0;
+            H[(size_t)j * m + j] = radius;
+            g[j + 1] = -sn[j] * g[j];
+            g[j] *= cs[j];
+            j++;
+            it++;
+            residuals[it] = fabs(g[j]) / b_norm;
+            /* h_next == 0: the Krylov space holds the solution */
+            if (residuals[it] <= tol || h_next == 0.0) break;
+            scale(n, 1.0 / h_next, next);
+        }
+
+        /* y = H^-1 g, then x += M^-1 V y */
+        for (int i = j - 1; i >= 0; i--) {
+            double s = g[i];
+            for (int l = i + 1; l < j; l++) s -= H[(size_t)i * m + l] * y[l];
+            if (H[(size_t)i * m + i] == 0.0) {
+                error = "Error: GMRES broke down; the matrix is singular";
+                goto done;
+            }
+            y[i] = s / H[(size_t)i * m + i];
+        }
+        memset(w, 0, (size_t)n * sizeof(double));
+        for (int i = 0; i < j; i++) axpy(n, y[i], V + (size_t)i * n, w);
+        precond_apply(&pc, w, z);
+        axpy(n, 1.0, z, x);
+
+        /* Restart from the true residual, which also corrects the recurrence's drift */
+        if (residuals[it] > tol && it < max_iter) {
+            beta = residual(A, b, x, V);
+            residuals[it] = beta / b_norm;
+        }
+    }
+    *iterations = it;
+    *converged = residuals[it] <= tol;
+
+done:
+    return error;
+}
@@ -0,0 +1,44 @@
+/*
+ * matrixOp_krylov.h - Preconditioned Krylov solvers (CG, GMRES) on dense or CSR operators
+ */
+
+#ifndef MATRIXOP_KRYLOV_H
+#define MATRIXOP_KRYLOV_H
+
+#include "matrixOp.h"
+#include "matrixOp_arena.h"
+
+/* Default GMRES cycle length */
+#define KRYLOV_DEFAULT_RESTART 30
+
+/* Square n x n operator: a row-major dense array when dense is set, CSR otherwise */
+typedef struct {
+    int n;
+    const double *dense;
+    int lda;
+    const int *ptr;
+    const int *idx;
+    const double *val;
+} krylov_operator;
+
+/*
+ * Solve A x = b starting from the x passed in. residuals receives
+ * ||b - A x|| / ||b|| before the first iteration and after each one, so
+ * it needs max_iter + 1 entries; *iterations tells how many were run.
+ * *converged is set once the relative residual drops to tol. The
+ * preconditioner and work vectors are taken from scratch. Returns NULL,
+ * or an error message for a preconditioner that cannot be built, an A that
+ * is not positive definite (CG), or a failed allocation.
+ */
+const char *krylov_cg(const krylov_operator *A, krylov_precond precond,
+                      const double *b, double *x, double tol, int max_iter,
+                      double *residuals, int *iterations, int *converged,
+                      request_arena *scratch);
+
+/* Restarted GMRES(restart), preconditioned on the right so residuals are those of A x = b */
+const char *krylov_gmres(const krylov_operator *A, krylov_precond precond, int restart,
+                         const double *b, double *x, double tol, int max_iter,
+                         double *residuals, int *iterations, int *converged,
+                         request_arena *scratch);
+
+#endif /* MATRIXOP_KRYLOV_H */
@@ -6,21 +6,69 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <float.h>
+#include <time.h>
+#include <stdint.h>
+#include <pthread.h>
 #include "matrixOp.h"
+#include "matrixOp_kernels.h"
+#include "matrixOp_backend.h"
+#include "matrixOp_arena.h"
+#include "matrixOp_store.h"
+#include "matrixOp_cache.h"
+#include "matrixOp_sparse.h"
+#include "matrixOp_stats.h"
+#include "matrixOp_codec.h"
+#include "matrixOp_shm.h"
+#include "matrixOp_krylov.h"
+#include "matrixOp_stage.h"
 
 #define EPSILON 1e-10
 
-/* Helper function to create a matrix */
-static matrix *create_matrix(int rows, int cols) {
-    matrix *mat = (matrix *)malloc(sizeof(matrix));
-    if (!mat) return NULL;
+/* Refinement steps a mixed-precision solve may take before falling back to double LU */
+#define REFINE_MAX_STEPS 30
+
+/*
+ * Result and scratch buffers live in a per-thread arena. The dispatcher
+ * encodes and sends the reply before the thread picks up its next request,
+ * so resetting the arena at the start of each request releases the previous
+ * reply's buffers and reuses them without touching malloc.
+ */
+static __thread request_arena arena;
+
+static void begin_request(void) {
+    arena_reset(&arena);
+}
+
+/* Helper function to create a zeroed matrix in the request arena */
+static int create_matrix(matrix *mat, int rows, int cols) {
+    mat->data.data_val = (double *)arena_calloc(&arena, (size_t)rows * cols, sizeof(double));
+    if (!mat->data.data_val) return 0;
     
     mat->rows = rows;
     mat->cols = cols;
     mat->data.data_len = rows * cols;
-    mat->data.data_val = (double *)calloc(rows * cols, sizeof(double)); // Use calloc to initialize to 0
-    
-    return mat;
+    return 1;
+}
+
+/* A positive shape whose payload holds exactly rows * cols elements; kernels read operands unchecked */
+static int matrix_shape_valid(const matrix *m) {
+    return m->rows > 0 && m->cols > 0 && (size_t)m->rows * m->cols == m->data.data_len;
+}
+
+static int matrix32_shape_valid(const matrix32 *m) {
+    return m->rows > 0 && m->cols > 0 && (size_t)m->rows * m->cols == m->data.data_len;
+}
+
+/* Only operations well above the O(n^2) cost of hashing their operands are cached */
+static int cacheable(matrix_op op) {
+    return op == OP_MULT || op == OP_INVERSE || op == OP_SOLVE ||
+           op == OP_MULT32 || op == OP_SOLVE_MIXED || op == OP_LSTSQ;
+}
+
+static int binary_op(matrix_op op) {
+    return op == OP_ADD || op == OP_MULT || op == OP_SOLVE ||
+           op == OP_MULT32 || op == OP_SOLVE_MIXED || op == OP_LSTSQ;
 }
 
 /* Get element from matrix */
@@ -40,7 +88,7 @@ static void set_element(matrix *mat, int i, int j, double value) {
 
 /* Matrix addition: C = A + B */
 matrix_result *matrix_add_1_svc(matrix_pair *pair, struct svc_req *req) {
-    static matrix_result result;
+    static __thread matrix_result result;
     matrix *a = &pair->first;
     matrix *b = &pair->second;
     
@@ -48,16 +96,21 @@ matrix_result *matrix_add_1_svc(matrix_pair *pair, struct svc_req *req) {
     memset(&result, 0, sizeof(result));
     result.success = 0;
     result.error_msg = "";
+    begin_request();
     
     /* Check if matrices have same dimensions */
     if (a->rows != b->rows || a->cols != b->cols) {
         result.error_msg = "Error: Matrices must have same dimensions for addition";
         return &result;
     }
+    if (!matrix_shape_valid(a) || !matrix_shape_valid(b)) {
+        result.error_msg = "Error: Matrix data does not match its dimensions";
+        return &result;
+    }
     
     /* Create result matrix */
-    matrix *result_mat = create_matrix(a->rows, a->cols);
-    if (!result_mat) {
+    matrix *result_mat = &result.result_matrix;
+    if (!create_matrix(result_mat, a->rows, a->cols)) {
         result.error_msg = "Error: Memory allocation failed";
         return &result;
     }
@@ -71,14 +124,13 @@ matrix_result *matrix_add_1_svc(matrix_pair *pair, struct svc_req *req) {
     }
     
     result.success = 1;
-    result.result_matrix = *result_mat; // Copy the structure
     
     return &result;
 }
 
 /* Matrix multiplication: C = A * B */
 matrix_result *matrix_mult_1_svc(matrix_pair *pair, struct svc_req *req) {
-    static matrix_result result;
+    static __thread matrix_result result;
     matrix *a = &pair->first;
     matrix *b = &pair->second;
     
@@ -86,6 +138,7 @@ matrix_result *matrix_mult_1_svc(matrix_pair *pair, struct svc_req *req) {
     memset(&result, 0, sizeof(result));
     result.success = 0;
     result.error_msg = "";
+    begin_request();
     
     /* Check if matrices can be multiplied */
     if (a->cols != b->rows) {
@@ -93,135 +146,206 @@ matrix_result *matrix_mult_1_svc(matrix_pair *pair, struct svc_req *req) {
         return &result;
     }
     
+    /* The kernel reads operands directly, so their payload must match the shape */
+    if (!matrix_shape_valid(a) || !matrix_shape_valid(b)) {
+        result.error_msg = "Error: Matrix data does not match its dimensions";
+        return &result;
+    }
+    
     /* Create result matrix */
-    matrix *result_mat = create_matrix(a->rows, b->cols);
-    if (!result_mat) {
+    matrix *result_mat = &result.result_matrix;
+    if (!create_matrix(result_mat, a->rows, b->cols)) {
         result.error_msg = "Error: Memory allocation failed";
         return &result;
     }
     
-    /* Perform multiplication */
-    for (int i = 0; i < a->rows; i++) {
-        for (int j = 0; j < b->cols; j++) {
-            double sum = 0.0;
-            for (int k = 0; k < a->cols; k++) {
-                sum += get_element(a, i, k) * get_element(b, k, j);
-            }
-            set_element(result_mat, i, j, sum);
-        }
+    /* Repeated operands are answered from the result cache */
+    cache_key key;
+    int cached = cache_key_init(&key, OP_MULT, a->rows, a->cols, a->data.data_val,
+                                b->rows, b->cols, b->data.data_val);
+    if (cached && cache_lookup(&key, a->rows, b->cols, result_mat->data.data_val)) {
+        result.success = 1;
+        return &result;
+    }
+    
+    /* Perform multiplication (result starts zeroed, kernel accumulates) */
+    if (!backend_gemm(0, 0, a->rows, b->cols, a->cols,
+                      1.0, a->data.data_val, a->cols,
+                      b->data.data_val, b->cols,
+                      1.0, result_mat->data.data_val, b->cols)) {
+        memset(result_mat, 0, sizeof(*result_mat));
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
     }
+    if (cached) cache_insert(&key, a->rows, b->cols, result_mat->data.data_val);
     
     result.success = 1;
-    result.result_matrix = *result_mat;
     
     return &result;
 }
 
+/* Single-precision multiplication: C = A * B in float32 */
+matrix32_result *matrix_mult32_1_svc(matrix32_pair *pair, struct svc_req *req) {
+    static __thread matrix32_result result;
+    matrix32 *a = &pair->first;
+    matrix32 *b = &pair->second;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    if (a->cols != b->rows) {
+        result.error_msg = "Error: Incompatible dimensions for multiplication";
+        return &result;
+    }
+    if (!matrix32_shape_valid(a) || !matrix32_shape_valid(b)) {
+        result.error_msg = "Error: Matrix data does not match its dimensions";
+        return &result;
+    }
+    
+    size_t count = (size_t)a->rows * b->cols;
+    float *c = (float *)arena_calloc(&arena, count ? count : 1, sizeof(float));
+    if (!c || !sgemm_blocked(a->rows, b->cols, a->cols,
+                             a->data.data_val, a->cols,
+                             b->data.data_val, b->cols, c, b->cols)) {
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
+    }
+    
+    result.success = 1;
+    result.result_matrix.rows = a->rows;
+    result.result_matrix.cols = b->cols;
+    result.result_matrix.data.data_len = count;
+    result.result_matrix.data.data_val = c;
+    return &result;
+}
+
 /* Matrix transpose: B = A^T */
 matrix_result *matrix_transpose_1_svc(matrix *a, struct svc_req *req) {
-    static matrix_result result;
+    static __thread matrix_result result;
     
     /* Initialize result */
     memset(&result, 0, sizeof(result));
     result.success = 0;
     result.error_msg = "";
+    begin_request();
+    
+    if (!matrix_shape_valid(a)) {
+        result.error_msg = "Error: Matrix data does not match its dimensions";
+        return &result;
+    }
     
     /* Create result matrix */
-    matrix *result_mat = create_matrix(a->cols, a->rows);
-    if (!result_mat) {
+    matrix *result_mat = &result.result_matrix;
+    if (!create_matrix(result_mat, a->cols, a->rows)) {
         result.error_msg = "Error: Memory allocation failed";
         return &result;
     }
     
-    /* Perform transpose */
-    for (int i = 0; i < a->rows; i++) {
-        for (int j = 0; j < a->cols; j++) {
-            set_element(result_mat, j, i, get_element(a, i, j));
-        }
-    }
+    backend_transpose(a->rows, a->cols, a->data.data_val, a->cols,
+                      result_mat->data.data_val, a->rows);
     
     result.success = 1;
-    result.result_matrix = *result_mat;
     
     return &result;
 }
 
-/* Better matrix inverse using LU decomposition */
-static int matrix_inverse_lu(double *A, double *inv, int n) {
-    int i, j, k;
-    
-    // Initialize inverse as identity matrix
-    for (i = 0; i < n; i++) {
-        for (j = 0; j < n; j++) {
-            inv[i * n + j] = (i == j) ? 1.0 : 0.0;
+/* Largest |element| of each column of a row-major rows x cols array */
+static void column_norms(int rows, int cols, const double *m, double *norms) {
+    for (int j = 0; j < cols; j++) norms[j] = 0.0;
+    for (int i = 0; i < rows; i++) {
+        const double *row = m + (size_t)i * cols;
+        for (int j = 0; j < cols; j++) {
+            if (fabs(row[j]) > norms[j]) norms[j] = fabs(row[j]);
         }
     }
+}
+
+/*
+ * Mixed-precision solve of A X = B, as in LAPACK dsgesv: factor a float32
+ * copy of A, then repeatedly form the residual R = A X - B in double and
+ * subtract the float32 solution of A D = R until every column's residual
+ * is at the level of a double backward-stable solve. Matrices that
+ * overflow float32, are singular in float32 or stop converging are solved
+ * by the double LU instead.
+ */
+static const char *solve_mixed(int n, const double *a, int nrhs, const double *b, double *x) {
+    size_t nn = (size_t)n * n, nb = (size_t)n * nrhs;
+    float *lu = (float *)arena_alloc(&arena, nn * sizeof(float));
+    float *step = (float *)arena_alloc(&arena, nb * sizeof(float));
+    double *r = (double *)arena_alloc(&arena, nb * sizeof(double));
+    double *norms = (double *)arena_alloc(&arena, 2 * (size_t)nrhs * sizeof(double));
+    int *pivots = (int *)arena_alloc(&arena, (size_t)n * sizeof(int));
+    if (!lu || !step || !r || !norms || !pivots) {
+        return "Error: Memory allocation failed";
+    }
     
-    // LU decomposition with partial pivoting
-    for (k = 0; k < n; k++) {
-        // Find pivot
-        int pivot = k;
-        double max_val = fabs(A[k * n + k]);
-        for (i = k + 1; i < n; i++) {
-            if (fabs(A[i * n + k]) > max_val) {
-                max_val = fabs(A[i * n + k]);
-                pivot = i;
-            }
-        }
-        
-        if (max_val < EPSILON) {
-            return 0; // Matrix is singular
+    double a_norm = 0.0;
+    int fits = 1;
+    for (int i = 0; i < n; i++) {
+        double row_sum = 0.0;
+        for (int j = 0; j < n; j++) {
+            double v = a[(size_t)i * n + j];
+            if (fabs(v) > FLT_MAX) fits = 0;
+            row_sum += fabs(v);
+            lu[(size_t)i * n + j] = (float)v;
         }
+        if (row_sum > a_norm) a_norm = row_sum;
+    }
+    
+    if (fits && lu_factor_blocked_f32(n, lu, n, pivots, (float)EPSILON)) {
+        double threshold = a_norm * DBL_EPSILON * sqrt((double)n);
+        double *x_norms = norms, *r_norms = norms + nrhs;
         
-        // Swap rows if needed
-        if (pivot != k) {
-            for (j = 0; j < n; j++) {
-                double temp = A[k * n + j];
-                A[k * n + j] = A[pivot * n + j];
-                A[pivot * n + j] = temp;
-                
-                temp = inv[k * n + j];
-                inv[k * n + j] = inv[pivot * n + j];
-                inv[pivot * n + j] = temp;
-            }
-        }
+        for (size_t i = 0; i < nb; i++) step[i] = (float)b[i];
+        lu_solve_f32(n, lu, n, pivots, nrhs, step, nrhs);
+        for (size_t i = 0; i < nb; i++) x[i] = step[i];
         
-        // Eliminate below
-        for (i = k + 1; i < n; i++) {
-            double factor = A[i * n + k] / A[k * n + k];
-            for (j = k; j < n; j++) {
-                A[i * n + j] -= factor * A[k * n + j];
+        for (int iter = 0; iter <= REFINE_MAX_STEPS; iter++) {
+            /* r = A x - B, accumulated onto -B by the double GEMM */
+            for (size_t i = 0; i < nb; i++) r[i] = -b[i];
+            if (!gemm_blocked(n, nrhs, n, a, n, x, nrhs, r, nrhs)) {
+                return "Error: Memory allocation failed";
             }
-            for (j = 0; j < n; j++) {
-                inv[i * n + j] -= factor * inv[k * n + j];
+            
+            column_norms(n, nrhs, x, x_norms);
+            column_norms(n, nrhs, r, r_norms);
+            int converged = 1;
+            for (int j = 0; j < nrhs && converged; j++) {
+                converged = r_norms[j] <= x_norms[j] * threshold;
             }
+            if (converged) return NULL;
+            if (iter == REFINE_MAX_STEPS) break;
+            
+            for (size_t i = 0; i < nb; i++) step[i] = (float)r[i];
+            lu_solve_f32(n, lu, n, pivots, nrhs, step, nrhs);
+            for (size_t i = 0; i < nb; i++) x[i] -= step[i];
         }
     }
     
-    // Back substitution
-    for (k = n - 1; k >= 0; k--) {
-        for (j = 0; j < n; j++) {
-            inv[k * n + j] /= A[k * n + k];
-        }
-        
-        for (i = 0; i < k; i++) {
-            for (j = 0; j < n; j++) {
-                inv[i * n + j] -= A[i * n + k] * inv[k * n + j];
-            }
-        }
+    /* Double-precision fallback */
+    double *work = (double *)arena_alloc(&arena, nn * sizeof(double));
+    if (!work) {
+        return "Error: Memory allocation failed";
     }
-    
-    return 1;
+    memcpy(work, a, nn * sizeof(double));
+    if (!lu_factor_blocked(n, work, n, pivots, EPSILON)) {
+        return "Error: Matrix is singular and cannot be solved";
+    }
+    memcpy(x, b, nb * sizeof(double));
+    lu_solve(n, work, n, pivots, nrhs, x, nrhs);
+    return NULL;
 }
 
 /* Matrix inverse: B = A^(-1) */
 matrix_result *matrix_inverse_1_svc(matrix *a, struct svc_req *req) {
-    static matrix_result result;
+    static __thread matrix_result result;
     
     /* Initialize result */
     memset(&result, 0, sizeof(result));
     result.success = 0;
     result.error_msg = "";
+    begin_request();
     
     /* Check if matrix is square */
     if (a->rows != a->cols) {
@@ -230,17 +354,30 @@ matrix_result *matrix_inverse_1_svc(matrix *a, struct svc_req *req) {
     }
     
     int n = a->rows;
+    if (!matrix_shape_valid(a)) {
+        result.error_msg = "Error: Matrix data does not match its dimensions";
+        return &result;
+    }
     
     /* Create result matrix */
-    matrix *result_mat = create_matrix(n, n);
-    if (!result_mat) {
+    matrix *result_mat = &result.result_matrix;
+    if (!create_matrix(result_mat, n, n)) {
         result.error_msg = "Error: Memory allocation failed";
         return &result;
     }
     
+    cache_key key;
+    int cached = cache_key_init(&key, OP_INVERSE, n, n, a->data.data_val, 0, 0, NULL);
+    if (cached && cache_lookup(&key, n, n, result_mat->data.data_val)) {
+        result.success = 1;
+        return &result;
+    }
+    
     /* Create working copy of the matrix */
-    double *A_copy = (double *)malloc(n * n * sizeof(double));
-    if (!A_copy) {
+    double *A_copy = (double *)arena_alloc(&arena, (size_t)n * n * sizeof(double));
+    int *pivots = (int *)arena_alloc(&arena, (size_t)n * sizeof(int));
+    if (!A_copy || !pivots) {
+        memset(result_mat, 0, sizeof(*result_mat));
         result.error_msg = "Error: Memory allocation failed";
         return &result;
     }
@@ -251,15 +388,157 @@ matrix_result *matrix_inverse_1_svc(matrix *a, struct svc_req *req) {
     }
     
     /* Perform matrix inversion */
-    if (matrix_inverse_lu(A_copy, result_mat->data.data_val, n)) {
+    if (backend_inverse(n, A_copy, result_mat->data.data_val, pivots, EPSILON)) {
+        if (cached) cache_insert(&key, n, n, result_mat->data.data_val);
         result.success = 1;
-        result.result_matrix = *result_mat;
     } else {
+        memset(result_mat, 0, sizeof(*result_mat));
         result.error_msg = "Error: Matrix is singular and cannot be inverted";
     }
     
-    free(A_copy);
+    return &result;
+}
+
+/* Copy a square operand into the arena for factorization; NULL with *error set otherwise */
+static double *square_workspace(const matrix *a, const char **error) {
+    if (a->rows <= 0 || a->rows != a->cols) {
+        *error = "Error: Only square matrices can be factorized";
+        return NULL;
+    }
+    if (!matrix_shape_valid(a)) {
+        *error = "Error: Matrix data does not match its dimensions";
+        return NULL;
+    }
+    double *work = (double *)arena_alloc(&arena, a->data.data_len * sizeof(double));
+    if (!work) {
+        *error = "Error: Memory allocation failed";
+        return NULL;
+    }
+    memcpy(work, a->data.data_val, a->data.data_len * sizeof(double));
+    return work;
+}
+
+/* LU factorization: PA = LU with packed factors and the pivot vector */
+lu_result *matrix_lu_1_svc(matrix *a, struct svc_req *req) {
+    static __thread lu_result result;
+    const char *error = NULL;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    double *work = square_workspace(a, &error);
+    if (!work) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    int n = a->rows;
+    int *pivots = (int *)arena_alloc(&arena, (size_t)n * sizeof(int));
+    if (!pivots) {
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
+    }
+    if (!lu_factor_blocked(n, work, n, pivots, EPSILON)) {
+        result.error_msg = "Error: Matrix is singular and cannot be factorized";
+        return &result;
+    }
+    
+    result.success = 1;
+    result.lu.rows = n;
+    result.lu.cols = n;
+    result.lu.data.data_len = n * n;
+    result.lu.data.data_val = work;
+    result.pivots.pivots_len = n;
+    result.pivots.pivots_val = pivots;
+    return &result;
+}
+
+/* Solve A X = B directly: one factorization and two triangular solves, no explicit inverse */
+matrix_result *matrix_solve_1_svc(matrix_pair *pair, struct svc_req *req) {
+    static __thread matrix_result result;
+    matrix *a = &pair->first;
+    matrix *b = &pair->second;
+    const char *error = NULL;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    double *work = square_workspace(a, &error);
+    if (!work) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    if (b->rows != a->rows || b->cols <= 0) {
+        result.error_msg = "Error: Right-hand side must have as many rows as A";
+        return &result;
+    }
+    if (!matrix_shape_valid(b)) {
+        result.error_msg = "Error: Matrix data does not match its dimensions";
+        return &result;
+    }
+    
+    int n = a->rows;
+    int *pivots = (int *)arena_alloc(&arena, (size_t)n * sizeof(int));
+    matrix *x = &result.result_matrix;
+    if (!pivots || !create_matrix(x, b->rows, b->cols)) {
+        memset(x, 0, sizeof(*x));
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
+    }
+    cache_key key;
+    int cached = cache_key_init(&key, OP_SOLVE, n, n, a->data.data_val,
+                                b->rows, b->cols, b->data.data_val);
+    if (cached && cache_lookup(&key, b->rows, b->cols, x->data.data_val)) {
+        result.success = 1;
+        return &result;
+    }
+    
+    if (!lu_factor_blocked(n, work, n, pivots, EPSILON)) {
+        memset(x, 0, sizeof(*x));
+        result.error_msg = "Error: Matrix is singular and cannot be solved";
+        return &result;
+    }
+    
+    memcpy(x->data.data_val, b->data.data_val, b->data.data_len * sizeof(double));
+    lu_solve(n, work, n, pivots, b->cols, x->data.data_val, b->cols);
+    if (cached) cache_insert(&key, b->rows, b->cols, x->data.data_val);
+    result.success = 1;
+    return &result;
+}
+
+/* Determinant: product of U's diagonal, negated once per row swap */
+det_result *matrix_det_1_svc(matrix *a, struct svc_req *req) {
+    static __thread det_result result;
+    const char *error = NULL;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    double *work = square_workspace(a, &error);
+    if (!work) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    int n = a->rows;
+    int *pivots = (int *)arena_alloc(&arena, (size_t)n * sizeof(int));
+    if (!pivots) {
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
+    }
     
+    result.success = 1;
+    if (!lu_factor_blocked(n, work, n, pivots, EPSILON)) {
+        result.determinant = 0.0;
+        return &result;
+    }
+    double det = 1.0;
+    for (int i = 0; i < n; i++) {
+        det *= work[(size_t)i * n + i];
+        if (pivots[i] != i) det = -det;
+    }
+    result.determinant = det;
     return &result;
 }
 
@@ -267,4 +546,1996 @@ matrix_result *matrix_inverse_1_svc(matrix *a, struct svc_req *req) {
 int *ping_1_svc(void *argp, struct svc_req *req) {
     static int result = 1;
     return &result;
-}
\ No newline at end of file
+}
+
+/* ===== Staged (chunked) transfers for matrices larger than MAX_SIZE ===== */
+
+static int stage_dims_valid(int rows, int cols) {
+    return rows > 0 && cols > 0 && rows <= MAX_STAGE_DIM && cols <= MAX_STAGE_DIM;
+}
+
+/* Shape of op's result, or an error message if the operands cannot be combined */
+static const char *result_shape(matrix_op op, int a_rows, int a_cols, int b_rows, int b_cols,
+                                int *rows, int *cols) {
+    switch (op) {
+        case OP_ADD:
+            if (a_rows != b_rows || a_cols != b_cols) {
+                return "Error: Matrices must have same dimensions for addition";
+            }
+            *rows = a_rows;
+            *cols = a_cols;
+            return NULL;
+        case OP_MULT:
+        case OP_MULT32:
+            if (a_cols != b_rows) {
+                return "Error: Incompatible dimensions for multiplication";
+            }
+            *rows = a_rows;
+            *cols = b_cols;
+            return NULL;
+        case OP_INVERSE:
+            if (a_rows != a_cols) {
+                return "Error: Only square matrices can be inverted";
+            }
+            *rows = a_rows;
+            *cols = a_cols;
+            return NULL;
+        case OP_TRANSPOSE:
+            *rows = a_cols;
+            *cols = a_rows;
+            return NULL;
+        case OP_STORE:
+            *rows = a_rows;
+            *cols = a_cols;
+            return NULL;
+        case OP_SOLVE:
+        case OP_SOLVE_MIXED:
+            if (a_rows != a_cols) {
+                return "Error: Only square matrices can be factorized";
+            }
+            if (b_rows != a_rows) {
+                return "Error: Right-hand side must have as many rows as A";
+            }
+            *rows = b_rows;
+            *cols = b_cols;
+            return NULL;
+        case OP_LSTSQ:
+            if (b_rows != a_rows) {
+                return "Error: Right-hand side must have as many rows as A";
+            }
+            *rows = a_cols;
+            *cols = b_cols;
+            return NULL;
+    }
+    return "Error: Unknown operation";
+}
+
+/*
+ * Run op on row-major operands into out, which must be zeroed. The double
+ * inverse, solve and least squares factorize in work, a buffer holding a copy
+ * of a (or a itself when the operand may be destroyed). Returns NULL or an
+ * error message.
+ */
+static const char *run_operation(matrix_op op, int a_rows, int a_cols, const double *a,
+                                 int b_cols, const double *b, double *out, double *work) {
+    size_t count = (size_t)a_rows * a_cols;
+    
+    switch (op) {
+        case OP_ADD:
+            for (size_t i = 0; i < count; i++) {
+                out[i] = a[i] + b[i];
+            }
+            return NULL;
+        case OP_MULT:
+            if (!backend_gemm(0, 0, a_rows, b_cols, a_cols, 1.0, a, a_cols, b, b_cols, 1.0, out, b_cols)) {
+                return "Error: Memory allocation failed";
+            }
+            return NULL;
+        case OP_TRANSPOSE:
+            backend_transpose(a_rows, a_cols, a, a_cols, out, a_rows);
+            return NULL;
+        case OP_INVERSE: {
+            int *pivots = (int *)arena_alloc(&arena, (size_t)a_rows * sizeof(int));
+            if (!pivots) {
+                return "Error: Memory allocation failed";
+            }
+            if (!backend_inverse(a_rows, work, out, pivots, EPSILON)) {
+                return "Error: Matrix is singular and cannot be inverted";
+            }
+            return NULL;
+        }
+        case OP_STORE:
+            memcpy(out, a, count * sizeof(double));
+            return NULL;
+        case OP_SOLVE: {
+            int *pivots = (int *)arena_alloc(&arena, (size_t)a_rows * sizeof(int));
+            if (!pivots) {
+                return "Error: Memory allocation failed";
+            }
+            if (!lu_factor_blocked(a_rows, work, a_rows, pivots, EPSILON)) {
+                return "Error: Matrix is singular and cannot be solved";
+            }
+            memcpy(out, b, (size_t)a_rows * b_cols * sizeof(double));
+            lu_solve(a_rows, work, a_rows, pivots, b_cols, out, b_cols);
+            return NULL;
+        }
+        case OP_MULT32: {
+            size_t b_count = (size_t)a_cols * b_cols, c_count = (size_t)a_rows * b_cols;
+            float *a32 = (float *)arena_alloc(&arena, count * sizeof(float));
+            float *b32 = (float *)arena_alloc(&arena, b_count * sizeof(float));
+            float *c32 = (float *)arena_calloc(&arena, c_count, sizeof(float));
+            if (!a32 || !b32 || !c32) {
+                return "Error: Memory allocation failed";
+            }
+            for (size_t i = 0; i < count; i++) a32[i] = (float)a[i];
+            for (size_t i = 0; i < b_count; i++) b32[i] = (float)b[i];
+            if (!sgemm_blocked(a_rows, b_cols, a_cols, a32, a_cols, b32, b_cols, c32, b_cols)) {
+                return "Error: Memory allocation failed";
+            }
+            for (size_t i = 0; i < c_count; i++) out[i] = c32[i];
+            return NULL;
+        }
+        case OP_SOLVE_MIXED:
+            return solve_mixed(a_rows, a, b_cols, b, out);
+        case OP_LSTSQ: {
+            double *scratch = (double *)arena_alloc(&arena, lstsq_qr_scratch(a_rows, a_cols, b_cols) * sizeof(double));
+            if (!scratch) {
+                return "Error: Memory allocation failed";
+            }
+            if (!lstsq_qr(a_rows, a_cols, work, a_cols, b_cols, b, b_cols, out, b_cols, scratch, EPSILON)) {
+                return "Error: Matrix is rank deficient or allocation failed";
+            }
+            return NULL;
+        }
+    }
+    return "Error: Unknown operation";
+}
+
+/* Clip a requested row range to the source and to MAX_TILE elements per reply */
+static const char *clip_rows(int src_rows, int src_cols, int row, int *rows) {
+    if (row < 0 || row >= src_rows || *rows <= 0) {
+        return "Error: Row range outside the result";
+    }
+    if (*rows > src_rows - row) *rows = src_rows - row;
+    if (*rows > MAX_TILE / src_cols) *rows = MAX_TILE / src_cols;
+    return NULL;
+}
+
+/* Copy up to range rows of a row-major source into a reply, clipped to MAX_TILE elements */
+static const char *copy_rows(stage_rows *reply, const double *src, int src_rows, int src_cols,
+                             int row, int rows) {
+    const char *error = clip_rows(src_rows, src_cols, row, &rows);
+    if (error) return error;
+    
+    /* The reply is encoded after the source is unlocked, so copy it into the arena */
+    double *buffer = (double *)arena_alloc(&arena, (size_t)rows * src_cols * sizeof(double));
+    if (!buffer) {
+        return "Error: Memory allocation failed";
+    }
+    memcpy(buffer, src + (size_t)row * src_cols, (size_t)rows * src_cols * sizeof(double));
+    
+    reply->success = 1;
+    reply->row = row;
+    reply->rows = rows;
+    reply->cols = src_cols;
+    reply->data.data_len = rows * src_cols;
+    reply->data.data_val = buffer;
+    return NULL;
+}
+
+/* Open a session and allocate operand buffers for the requested shapes */
+stage_status *stage_begin_1_svc(stage_request *args, struct svc_req *req) {
+    static __thread stage_status result;
+    int operands = binary_op(args->op) ? 2 : 1;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    
+    if (args->op < OP_ADD || args->op > OP_LSTSQ) {
+        result.error_msg = "Error: Unknown operation";
+        return &result;
+    }
+    if (!stage_dims_valid(args->first_rows, args->first_cols) ||
+        (operands == 2 && !stage_dims_valid(args->second_rows, args->second_cols))) {
+        result.error_msg = "Error: Staged dimensions must be between 1 and MAX_STAGE_DIM";
+        return &result;
+    }
+    
+    /* Check shapes up front so clients do not upload operands that cannot be combined */
+    const char *shape_error = result_shape(args->op, args->first_rows, args->first_cols,
+                                           args->second_rows, args->second_cols,
+                                           &result.rows, &result.cols);
+    if (shape_error) {
+        result.error_msg = (char *)shape_error;
+        return &result;
+    }
+    
+    stage_session *s = stage_allocate(req->rq_xprt->xp_fd);
+    if (!s) {
+        result.error_msg = "Error: Too many open transfer sessions";
+        return &result;
+    }
+    
+    s->op = args->op;
+    s->rows[0] = args->first_rows;
+    s->cols[0] = args->first_cols;
+    if (operands == 2) {
+        s->rows[1] = args->second_rows;
+        s->cols[1] = args->second_cols;
+    }
+    for (int k = 0; k < operands; k++) {
+        if (!stage_operand_alloc(s, k)) {
+            stage_free(s);
+            result.error_msg = "Error: Memory allocation failed";
+            return &result;
+        }
+    }
+    s->result_rows = result.rows;
+    s->result_cols = result.cols;
+    
+    result.success = 1;
+    result.session = s->id;
+    stage_unlock(s);
+    return &result;
+}
+
+/*
+ * Find the session a tile belongs to and check the tile fits its operand.
+ * Returns the session locked, or NULL with result->error_msg set.
+ */
+static stage_session *stage_tile_target(stage_status *result, int session, int operand,
+                                        int row, int col, int rows, int cols, u_int len) {
+    memset(result, 0, sizeof(*result));
+    result->error_msg = "";
+    result->session = session;
+    
+    stage_session *s = stage_lookup(session);
+    if (!s) {
+        result->error_msg = "Error: Unknown transfer session";
+        return NULL;
+    }
+    if (s->committed) {
+        result->error_msg = "Error: Session already committed";
+        stage_unlock(s);
+        return NULL;
+    }
+    if (operand < 0 || operand > 1 || !s->data[operand]) {
+        result->error_msg = "Error: Invalid operand index";
+        stage_unlock(s);
+        return NULL;
+    }
+    if (row < 0 || col < 0 || rows <= 0 || cols <= 0 ||
+        rows > s->rows[operand] - row || cols > s->cols[operand] - col ||
+        (size_t)rows * cols != len) {
+        result->error_msg = "Error: Tile lies outside the operand";
+        stage_unlock(s);
+        return NULL;
+    }
+    return s;
+}
+
+/* Account for a copied tile and release its session; a re-sent or overlapping tile counts once */
+static stage_status *stage_tile_done(stage_status *result, stage_session *s, int operand,
+                                     int row, int col, int rows, int cols) {
+    stage_cover(s, operand, row, col, rows, cols);
+    result->success = 1;
+    result->rows = s->rows[operand];
+    result->cols = s->cols[operand];
+    stage_unlock(s);
+    return result;
+}
+
+/* Copy one tile into its operand buffer in place */
+stage_status *stage_append_1_svc(stage_tile *tile, struct svc_req *req) {
+    static __thread stage_status result;
+    int k = tile->operand;
+    
+    stage_session *s = stage_tile_target(&result, tile->session, k, tile->row, tile->col,
+                                         tile->rows, tile->cols, tile->data.data_len);
+    if (!s) return &result;
+    
+    for (int i = 0; i < tile->rows; i++) {
+        memcpy(s->data[k] + (size_t)(tile->row + i) * s->cols[k] + tile->col,
+               tile->data.data_val + (size_t)i * tile->cols,
+               tile->cols * sizeof(double));
+    }
+    return stage_tile_done(&result, s, k, tile->row, tile->col, tile->rows, tile->cols);
+}
+
+/* Widen a float32 tile into its operand buffer */
+stage_status *stage_append32_1_svc(stage_tile32 *tile, struct svc_req *req) {
+    static __thread stage_status result;
+    int k = tile->operand;
+    
+    stage_session *s = stage_tile_target(&result, tile->session, k, tile->row, tile->col,
+                                         tile->rows, tile->cols, tile->data.data_len);
+    if (!s) return &result;
+    
+    for (int i = 0; i < tile->rows; i++) {
+        double *dst = s->data[k] + (size_t)(tile->row + i) * s->cols[k] + tile->col;
+        const float *src = tile->data.data_val + (size_t)i * tile->cols;
+        for (int j = 0; j < tile->cols; j++) dst[j] = src[j];
+    }
+    return stage_tile_done(&result, s, k, tile->row, tile->col, tile->rows, tile->cols);
+}
+
+/* Run the session's operation; operands are released once the result exists */
+stage_status *stage_commit_1_svc(int *session, struct svc_req *req) {
+    static __thread stage_status result;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    result.session = *session;
+    begin_request();
+    
+    stage_session *s = stage_lookup(*session);
+    if (!s) {
+        result.error_msg = "Error: Unknown transfer session";
+        return &result;
+    }
+    result.rows = s->result_rows;
+    result.cols = s->result_cols;
+    if (s->committed) {
+        result.success = 1;
+        stage_unlock(s);
+        return &result;
+    }
+    
+    /* filled counts distinct elements, so this holds only when every element has arrived */
+    for (int k = 0; k < 2; k++) {
+        if (s->data[k] && s->filled[k] < (size_t)s->rows[k] * s->cols[k]) {
+            result.error_msg = "Error: Operand data incomplete";
+            stage_unlock(s);
+            return &result;
+        }
+    }
+    
+    /* Keeping the operand, or transposing a square one in place, needs no new buffer */
+    if (s->op == OP_STORE || (s->op == OP_TRANSPOSE && s->rows[0] == s->cols[0])) {
+        if (s->op == OP_TRANSPOSE) backend_transpose_inplace(s->rows[0], s->data[0], s->cols[0]);
+        s->result = s->data[0];
+        s->data[0] = NULL;
+        stage_operands_free(s);
+        s->committed = 1;
+        result.success = 1;
+        stage_unlock(s);
+        return &result;
+    }
+    
+    size_t count = (size_t)s->result_rows * s->result_cols;
+    double *out = (double *)calloc(count, sizeof(double));
+    if (!out) {
+        result.error_msg = "Error: Memory allocation failed";
+        stage_unlock(s);
+        return &result;
+    }
+    
+    /* Hash before computing: the inverse and solve destroy the first operand */
+    cache_key key;
+    int cached = cacheable(s->op) &&
+                 cache_key_init(&key, s->op, s->rows[0], s->cols[0], s->data[0],
+                                s->rows[1], s->cols[1], s->data[1]);
+    if (!cached || !cache_lookup(&key, s->result_rows, s->result_cols, out)) {
+        /* The operand buffer doubles as the factorization workspace */
+        const char *error = run_operation(s->op, s->rows[0], s->cols[0], s->data[0],
+                                          s->cols[1], s->data[1], out, s->data[0]);
+        if (error) {
+            free(out);
+            result.error_msg = (char *)error;
+            stage_unlock(s);
+            return &result;
+        }
+        if (cached) cache_insert(&key, s->result_rows, s->result_cols, out);
+    }
+    
+    stage_operands_free(s);
+    s->result = out;
+    s->committed = 1;
+    
+    result.success = 1;
+    stage_unlock(s);
+    return &result;
+}
+
+/* Return a row range of the result, clipped to MAX_TILE elements per reply */
+stage_rows *stage_read_1_svc(stage_range *range, struct svc_req *req) {
+    static __thread stage_rows result;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    stage_session *s = stage_lookup(range->session);
+    if (!s) {
+        result.error_msg = "Error: Unknown transfer session";
+        return &result;
+    }
+    if (!s->committed) {
+        result.error_msg = "Error: Session has not been committed";
+        stage_unlock(s);
+        return &result;
+    }
+    const char *error = copy_rows(&result, s->result, s->result_rows, s->result_cols,
+                                  range->row, range->rows);
+    if (error) {
+        result.error_msg = (char *)error;
+    }
+    stage_unlock(s);
+    return &result;
+}
+
+/* Return a row range of the result rounded to float32, clipped to MAX_TILE elements */
+stage_rows32 *stage_read32_1_svc(stage_range *range, struct svc_req *req) {
+    static __thread stage_rows32 result;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    stage_session *s = stage_lookup(range->session);
+    if (!s) {
+        result.error_msg = "Error: Unknown transfer session";
+        return &result;
+    }
+    if (!s->committed) {
+        result.error_msg = "Error: Session has not been committed";
+        stage_unlock(s);
+        return &result;
+    }
+    
+    int row = range->row, rows = range->rows, cols = s->result_cols;
+    const char *error = clip_rows(s->result_rows, cols, row, &rows);
+    if (error) {
+        result.error_msg = (char *)error;
+        stage_unlock(s);
+        return &result;
+    }
+    
+    size_t count = (size_t)rows * cols;
+    float *buffer = (float *)arena_alloc(&arena, count * sizeof(float));
+    if (!buffer) {
+        result.error_msg = "Error: Memory allocation failed";
+        stage_unlock(s);
+        return &result;
+    }
+    const double *src = s->result + (size_t)row * cols;
+    for (size_t i = 0; i < count; i++) buffer[i] = (float)src[i];
+    stage_unlock(s);
+    
+    result.success = 1;
+    result.row = row;
+    result.rows = rows;
+    result.cols = cols;
+    result.data.data_len = count;
+    result.data.data_val = buffer;
+    return &result;
+}
+
+/* Release a session and its buffers */
+int *stage_end_1_svc(int *session, struct svc_req *req) {
+    static __thread int result;
+    stage_session *s = stage_lookup(*session);
+    
+    result = 0;
+    if (s) {
+        stage_free(s);
+        result = 1;
+    }
+    return &result;
+}
+
+/* ===== Server-resident matrices addressed by handle ===== */
+
+/* Keep a small matrix on the server */
+handle_result *store_put_1_svc(matrix *a, struct svc_req *req) {
+    static __thread handle_result result;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    
+    if (!matrix_shape_valid(a)) {
+        result.error_msg = "Error: Matrix data does not match its dimensions";
+        return &result;
+    }
+    
+    double *data = (double *)malloc(a->data.data_len * sizeof(double));
+    if (!data) {
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
+    }
+    memcpy(data, a->data.data_val, a->data.data_len * sizeof(double));
+    
+    result.handle = store_insert(a->rows, a->cols, data);
+    if (!result.handle) {
+        free(data);
+        result.error_msg = "Error: Store memory budget exceeded";
+        return &result;
+    }
+    result.success = 1;
+    result.rows = a->rows;
+    result.cols = a->cols;
+    return &result;
+}
+
+/* Hand a committed session's result to the store without copying it */
+handle_result *store_adopt_1_svc(int *session, struct svc_req *req) {
+    static __thread handle_result result;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    
+    stage_session *s = stage_lookup(*session);
+    if (!s) {
+        result.error_msg = "Error: Unknown transfer session";
+        return &result;
+    }
+    if (!s->committed) {
+        result.error_msg = "Error: Session has not been committed";
+        stage_unlock(s);
+        return &result;
+    }
+    
+    result.handle = store_insert(s->result_rows, s->result_cols, s->result);
+    if (!result.handle) {
+        /* The session keeps its result, so the client can still read it */
+        result.error_msg = "Error: Store memory budget exceeded";
+        stage_unlock(s);
+        return &result;
+    }
+    result.success = 1;
+    result.rows = s->result_rows;
+    result.cols = s->result_cols;
+    s->result = NULL;
+    stage_free(s);
+    return &result;
+}
+
+/* Run an operation on stored operands; only the new handle goes back over the wire */
+handle_result *store_apply_1_svc(handle_op *args, struct svc_req *req) {
+    static __thread handle_result result;
+    int binary = binary_op(args->op);
+    store_entry *a = NULL, *b = NULL;
+    double *out = NULL;
+    const char *error = NULL;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    a = store_acquire(args->first);
+    if (binary) b = store_acquire(args->second);
+    if (!a || (binary && !b)) {
+        error = "Error: Unknown or evicted handle";
+        goto done;
+    }
+    
+    error = result_shape(args->op, a->rows, a->cols, b ? b->rows : 0, b ? b->cols : 0,
+                         &result.rows, &result.cols);
+    if (error) goto done;
+    
+    out = (double *)calloc((size_t)result.rows * result.cols, sizeof(double));
+    if (!out) {
+        error = "Error: Memory allocation failed";
+        goto done;
+    }
+    
+    cache_key key;
+    int cached = cacheable(args->op) &&
+                 cache_key_init(&key, args->op, a->rows, a->cols, a->data,
+                                b ? b->rows : 0, b ? b->cols : 0, b ? b->data : NULL);
+    if (!cached || !cache_lookup(&key, result.rows, result.cols, out)) {
+        /* Stored data is shared, so the inverse and solves factorize a scratch copy */
+        double *work = NULL;
+        if (args->op == OP_INVERSE || args->op == OP_SOLVE || args->op == OP_LSTSQ) {
+            work = (double *)arena_alloc(&arena, a->bytes);
+            if (!work) {
+                error = "Error: Memory allocation failed";
+                goto done;
+            }
+            memcpy(work, a->data, a->bytes);
+        }
+        
+        error = run_operation(args->op, a->rows, a->cols, a->data,
+                              b ? b->cols : 0, b ? b->data : NULL, out, work);
+        if (error) goto done;
+        if (cached) cache_insert(&key, result.rows, result.cols, out);
+    }
+    
+    /* Unpin first so the operands themselves may be evicted to make room */
+    store_release(a);
+    a = NULL;
+    if (b) store_release(b);
+    b = NULL;
+    
+    result.handle = store_insert(result.rows, result.cols, out);
+    if (!result.handle) {
+        error = "Error: Store memory budget exceeded";
+        goto done;
+    }
+    out = NULL;
+    result.success = 1;
+    
+done:
+    if (a) store_release(a);
+    if (b) store_release(b);
+    free(out);
+    if (error) {
+        result.error_msg = (char *)error;
+        result.rows = result.cols = 0;
+    }
+    return &result;
+}
+
+/* Return a row range of a stored matrix, clipped to MAX_TILE elements per reply */
+stage_rows *store_read_1_svc(handle_range *range, struct svc_req *req) {
+    static __thread stage_rows result;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    store_entry *e = store_acquire(range->handle);
+    if (!e) {
+        result.error_msg = "Error: Unknown or evicted handle";
+        return &result;
+    }
+    const char *error = copy_rows(&result, e->data, e->rows, e->cols, range->row, range->rows);
+    if (error) {
+        result.error_msg = (char *)error;
+    }
+    store_release(e);
+    return &result;
+}
+
+/* Release a stored matrix */
+int *store_free_1_svc(int *handle, struct svc_req *req) {
+    static __thread int result;
+    
+    result = store_remove(*handle);
+    return &result;
+}
+
+/* ===== Expression evaluation ===== */
+
+/*
+ * A node's value. Transposes are never materialized: trans says data holds
+ * the value's transpose, i.e. a cols x rows row-major array.
+ */
+typedef struct {
+    const double *data;
+    int rows;
+    int cols;
+    int trans;
+} expr_value;
+
+/* Leading dimension of the array behind a value */
+static int value_ld(const expr_value *v) {
+    return v->trans ? v->rows : v->cols;
+}
+
+static double value_at(const expr_value *v, int i, int j) {
+    return v->trans ? v->data[(size_t)j * v->rows + i] : v->data[(size_t)i * v->cols + j];
+}
+
+/* Write a value out in plain row-major order */
+static void materialize(const expr_value *v, double *out) {
+    if (!v->trans) {
+        memcpy(out, v->data, (size_t)v->rows * v->cols * sizeof(double));
+        return;
+    }
+    backend_transpose(v->cols, v->rows, v->data, v->rows, out, v->cols);
+}
+
+/*
+ * out += L * R, or out += (L * R)^T = R^T * L^T when transpose_result is set.
+ * Operand transposes are passed to the GEMM as flags, never materialized.
+ */
+static int accumulate_product(const expr_value *l, const expr_value *r, int transpose_result,
+                              double *out, int ldc) {
+    if (transpose_result) {
+        return backend_gemm(!r->trans, !l->trans, r->cols, l->rows, r->rows,
+                            1.0, r->data, value_ld(r), l->data, value_ld(l), 1.0, out, ldc);
+    }
+    return backend_gemm(l->trans, r->trans, l->rows, r->cols, l->cols,
+                        1.0, l->data, value_ld(l), r->data, value_ld(r), 1.0, out, ldc);
+}
+
+/* Per-node bookkeeping for one evaluation */
+typedef struct {
+    expr_value value;
+    int uses;           /* consumers reachable from the result */
+    int fused;          /* evaluated inside its consumer's GEMM, never on its own */
+} expr_slot;
+
+/*
+ * If node idx is a product (possibly under transposes) used only by its
+ * consumer, return the MULT node and how many transposes wrap it.
+ */
+static int fusable_product(const expr_node *nodes, const expr_slot *slots, int idx, int *parity) {
+    *parity = 0;
+    while (nodes[idx].kind == EXPR_TRANSPOSE && slots[idx].uses == 1) {
+        *parity ^= 1;
+        idx = nodes[idx].left;
+    }
+    if (nodes[idx].kind == EXPR_MULT && slots[idx].uses == 1) return idx;
+    return -1;
+}
+
+/* Mark a fused product and the transposes above it so the main loop skips them */
+static void mark_fused(const expr_node *nodes, expr_slot *slots, int idx) {
+    while (nodes[idx].kind == EXPR_TRANSPOSE) {
+        slots[idx].fused = 1;
+        idx = nodes[idx].left;
+    }
+    slots[idx].fused = 1;
+}
+
+/* Check node references and shapes; pins stored operands into pinned[] */
+static const char *expr_validate(const expr_request *req, expr_slot *slots,
+                                 store_entry **pinned, int *pinned_count) {
+    int count = req->nodes.nodes_len;
+    const expr_node *nodes = req->nodes.nodes_val;
+    
+    if (count == 0) return "Error: Expression has no nodes";
+    
+    for (int i = 0; i < count; i++) {
+        const expr_node *node = &nodes[i];
+        expr_value *v = &slots[i].value;
+        int binary = (node->kind == EXPR_ADD || node->kind == EXPR_MULT);
+        int unary = (node->kind == EXPR_TRANSPOSE || node->kind == EXPR_INVERSE);
+        
+        if ((binary || unary) && (node->left < 0 || node->left >= i)) {
+            return "Error: Expression node refers to a later node";
+        }
+        if (binary && (node->right < 0 || node->right >= i)) {
+            return "Error: Expression node refers to a later node";
+        }
+        const expr_value *l = (binary || unary) ? &slots[node->left].value : NULL;
+        const expr_value *r = binary ? &slots[node->right].value : NULL;
+        
+        switch (node->kind) {
+            case EXPR_OPERAND: {
+                if (node->arg < 0 || node->arg >= (int)req->operands.operands_len) {
+                    return "Error: Expression refers to a missing operand";
+                }
+                const matrix *m = &req->operands.operands_val[node->arg];
+                if (!matrix_shape_valid(m)) {
+                    return "Error: Matrix data does not match its dimensions";
+                }
+                v->data = m->data.data_val;
+                v->rows = m->rows;
+                v->cols = m->cols;
+                break;
+            }
+            case EXPR_HANDLE: {
+                store_entry *e = store_acquire(node->arg);
+                if (!e) return "Error: Unknown or evicted handle";
+                pinned[(*pinned_count)++] = e;
+                v->data = e->data;
+                v->rows = e->rows;
+                v->cols = e->cols;
+                break;
+            }
+            case EXPR_ADD:
+                if (l->rows != r->rows || l->cols != r->cols) {
+                    return "Error: Matrices must have same dimensions for addition";
+                }
+                v->rows = l->rows;
+                v->cols = l->cols;
+                break;
+            case EXPR_MULT:
+                if (l->cols != r->rows) {
+                    return "Error: Incompatible dimensions for multiplication";
+                }
+                v->rows = l->rows;
+                v->cols = r->cols;
+                break;
+            case EXPR_TRANSPOSE:
+                v->rows = l->cols;
+                v->cols = l->rows;
+                break;
+            case EXPR_INVERSE:
+                if (l->rows != l->cols) {
+                    return "Error: Only square matrices can be inverted";
+                }
+                v->rows = l->rows;
+                v->cols = l->cols;
+                break;
+            default:
+                return "Error: Unknown expression node";
+        }
+        if (v->rows > MAX_STAGE_DIM || v->cols > MAX_STAGE_DIM) {
+            return "Error: Expression result exceeds MAX_STAGE_DIM";
+        }
+    }
+    
+    /* Count uses among nodes that feed the result; unreachable nodes are never computed */
+    slots[count - 1].uses = 1;
+    for (int i = count - 1; i >= 0; i--) {
+        if (slots[i].uses == 0) continue;
+        switch (nodes[i].kind) {
+            case EXPR_ADD:
+            case EXPR_MULT:
+                slots[nodes[i].right].uses++;
+                /* fall through */
+            case EXPR_TRANSPOSE:
+            case EXPR_INVERSE:
+                slots[nodes[i].left].uses++;
+                break;
+            default:
+                break;
+        }
+    }
+    return NULL;
+}
+
+/* Evaluate reachable nodes in order; values live in the request arena */
+static const char *expr_evaluate(const expr_node *nodes, int count, expr_slot *slots) {
+    /* A single-use product feeding an add accumulates straight into the sum */
+    for (int i = 0; i < count; i++) {
+        int parity;
+        if (slots[i].uses == 0 || nodes[i].kind != EXPR_ADD) continue;
+        if (fusable_product(nodes, slots, nodes[i].left, &parity) >= 0) {
+            mark_fused(nodes, slots, nodes[i].left);
+        }
+        if (nodes[i].right != nodes[i].left &&
+            fusable_product(nodes, slots, nodes[i].right, &parity) >= 0) {
+            mark_fused(nodes, slots, nodes[i].right);
+        }
+    }
+    
+    for (int i = 0; i < count; i++) {
+        const expr_node *node = &nodes[i];
+        expr_value *v = &slots[i].value;
+        if (slots[i].uses == 0 || slots[i].fused) continue;
+        
+        size_t elements = (size_t)v->rows * v->cols;
+        double *out;
+        
+        switch (node->kind) {
+            case EXPR_OPERAND:
+            case EXPR_HANDLE:
+                break;
+                
+            case EXPR_TRANSPOSE: {
+                const expr_value *l = &slots[node->left].value;
+                v->data = l->data;
+                v->trans = !l->trans;
+                break;
+            }
+            
+            case EXPR_MULT: {
+                out = (double *)arena_calloc(&arena, elements, sizeof(double));
+                if (!out) return "Error: Memory allocation failed";
+                if (!accumulate_product(&slots[node->left].value, &slots[node->right].value, 0,
+                                        out, v->cols)) {
+                    return "Error: Memory allocation failed";
+                }
+                v->data = out;
+                v->trans = 0;
+                break;
+            }
+            
+            case EXPR_ADD: {
+                int children[2] = { node->left, node->right };
+                int products[2], parity[2];
+                const expr_value *plain[2];
+                int plain_count = 0;
+                
+                for (int c = 0; c < 2; c++) {
+                    products[c] = -1;
+                    if (slots[children[c]].fused) {
+                        products[c] = fusable_product(nodes, slots, children[c], &parity[c]);
+                    } else {
+                        plain[plain_count++] = &slots[children[c]].value;
+                    }
+                }
+                
+                out = (double *)arena_alloc(&arena, elements * sizeof(double));
+                if (!out) return "Error: Memory allocation failed";
+                
+                if (plain_count == 2) {
+                    for (int r = 0; r < v->rows; r++) {
+                        for (int c = 0; c < v->cols; c++) {
+                            out[(size_t)r * v->cols + c] = value_at(plain[0], r, c) + value_at(plain[1], r, c);
+                        }
+                    }
+                } else if (plain_count == 1) {
+                    materialize(plain[0], out);
+                } else {
+                    memset(out, 0, elements * sizeof(double));
+                }
+                
+                /* GEMM epilogue fusion: the products accumulate onto the partial sum */
+                for (int c = 0; c < 2; c++) {
+                    if (products[c] < 0) continue;
+                    const expr_node *mult = &nodes[products[c]];
+                    if (!accumulate_product(&slots[mult->left].value, &slots[mult->right].value,
+                                            parity[c], out, v->cols)) {
+                        return "Error: Memory allocation failed";
+                    }
+                }
+                v->data = out;
+                v->trans = 0;
+                break;
+            }
+            
+            case EXPR_INVERSE: {
+                /* inv(X^T) = inv(X)^T, so invert the stored array and keep the flag */
+                const expr_value *l = &slots[node->left].value;
+                double *work = (double *)arena_alloc(&arena, elements * sizeof(double));
+                int *pivots = (int *)arena_alloc(&arena, (size_t)v->rows * sizeof(int));
+                out = (double *)arena_alloc(&arena, elements * sizeof(double));
+                if (!work || !pivots || !out) return "Error: Memory allocation failed";
+                memcpy(work, l->data, elements * sizeof(double));
+                if (!backend_inverse(v->rows, work, out, pivots, EPSILON)) {
+                    return "Error: Matrix is singular and cannot be inverted";
+                }
+                v->data = out;
+                v->trans = l->trans;
+                break;
+            }
+            
+            default:
+                return "Error: Unknown expression node";
+        }
+    }
+    return NULL;
+}
+
+/* Evaluate an expression graph and return (or store) only its final value */
+expr_result *evaluate_1_svc(expr_request *args, struct svc_req *req) {
+    static __thread expr_result result;
+    expr_slot slots[MAX_EXPR_NODES];
+    store_entry *pinned[MAX_EXPR_NODES];
+    int pinned_count = 0;
+    int count = args->nodes.nodes_len;
+    const char *error;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    memset(slots, 0, sizeof(slots));
+    
+    error = expr_validate(args, slots, pinned, &pinned_count);
+    if (!error) error = expr_evaluate(args->nodes.nodes_val, count, slots);
+    
+    if (!error) {
+        const expr_value *value = &slots[count - 1].value;
+        size_t elements = (size_t)value->rows * value->cols;
+        
+        if (args->keep) {
+            double *data = (double *)malloc(elements * sizeof(double));
+            if (!data) {
+                error = "Error: Memory allocation failed";
+            } else {
+                materialize(value, data);
+                result.handle = store_insert(value->rows, value->cols, data);
+                if (!result.handle) {
+                    free(data);
+                    error = "Error: Store memory budget exceeded";
+                }
+            }
+        } else if (elements > MAX_SIZE) {
+            error = "Error: Result exceeds MAX_SIZE; set keep and fetch the handle";
+        } else if (!create_matrix(&result.result_matrix, value->rows, value->cols)) {
+            error = "Error: Memory allocation failed";
+        } else {
+            materialize(value, result.result_matrix.data.data_val);
+        }
+    }
+    
+    for (int i = 0; i < pinned_count; i++) {
+        store_release(pinned[i]);
+    }
+    
+    if (error) {
+        result.error_msg = (char *)error;
+        result.handle = 0;
+        memset(&result.result_matrix, 0, sizeof(result.result_matrix));
+    } else {
+        result.success = 1;
+    }
+    return &result;
+}
+
+/* Result cache counters */
+cache_stats *cache_stats_1_svc(void *argp, struct svc_req *req) {
+    static __thread cache_stats result;
+    cache_counters counters;
+    
+    cache_get_counters(&counters);
+    result.hits = counters.hits;
+    result.misses = counters.misses;
+    result.evictions = counters.evictions;
+    result.entries = counters.entries;
+    result.bytes = counters.bytes;
+    result.budget = counters.budget;
+    return &result;
+}
+
+/* ===== Sparse matrices (CSR) ===== */
+
+/* Validate a CSR argument; returns NULL or an error message */
+static const char *csr_validate(const csr_matrix *m) {
+    if (m->rows > MAX_SPARSE_DIM || m->cols > MAX_SPARSE_DIM) {
+        return "Error: Sparse dimensions must not exceed MAX_SPARSE_DIM";
+    }
+    return csr_check(m->rows, m->cols, m->row_ptr.row_ptr_val, m->row_ptr.row_ptr_len,
+                     m->col_idx.col_idx_val, m->col_idx.col_idx_len, m->values.values_len);
+}
+
+/* Allocate a rows x cols CSR result with nnz entries in the request arena */
+static int create_csr(csr_matrix *m, int rows, int cols, size_t nnz) {
+    m->row_ptr.row_ptr_val = (int *)arena_alloc(&arena, (size_t)(rows + 1) * sizeof(int));
+    m->col_idx.col_idx_val = (int *)arena_alloc(&arena, nnz * sizeof(int));
+    m->values.values_val = (double *)arena_alloc(&arena, nnz * sizeof(double));
+    if (!m->row_ptr.row_ptr_val || !m->col_idx.col_idx_val || !m->values.values_val) {
+        memset(m, 0, sizeof(*m));
+        return 0;
+    }
+    m->rows = rows;
+    m->cols = cols;
+    m->row_ptr.row_ptr_len = rows + 1;
+    m->col_idx.col_idx_len = nnz;
+    m->values.values_len = nnz;
+    return 1;
+}
+
+/* Sparse matrix-vector product: y = A x */
+vector_result *sparse_mv_1_svc(sparse_vector *args, struct svc_req *req) {
+    static __thread vector_result result;
+    csr_matrix *a = &args->a;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    const char *error = csr_validate(a);
+    if (error) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    if (args->x.x_len != (u_int)a->cols) {
+        result.error_msg = "Error: Vector length must equal the column count";
+        return &result;
+    }
+    double *y = (double *)arena_alloc(&arena, (size_t)a->rows * sizeof(double));
+    if (!y) {
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
+    }
+    
+    csr_spmv(a->rows, a->row_ptr.row_ptr_val, a->col_idx.col_idx_val, a->values.values_val,
+             args->x.x_val, y);
+    result.success = 1;
+    result.y.y_len = a->rows;
+    result.y.y_val = y;
+    return &result;
+}
+
+/* Sparse-sparse product: only structurally nonzero products are formed */
+csr_result *sparse_mult_1_svc(csr_pair *pair, struct svc_req *req) {
+    static __thread csr_result result;
+    csr_matrix *a = &pair->first;
+    csr_matrix *b = &pair->second;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    const char *error = csr_validate(a);
+    if (!error) error = csr_validate(b);
+    if (error) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    if (a->cols != b->rows) {
+        result.error_msg = "Error: Incompatible dimensions for multiplication";
+        return &result;
+    }
+    
+    int *c_ptr = (int *)arena_alloc(&arena, (size_t)(a->rows + 1) * sizeof(int));
+    int *marker = (int *)arena_alloc(&arena, (size_t)b->cols * sizeof(int));
+    double *acc = (double *)arena_alloc(&arena, (size_t)b->cols * sizeof(double));
+    if (!c_ptr || !marker || !acc) {
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
+    }
+    long long nnz = csr_spgemm_count(a->rows, a->row_ptr.row_ptr_val, a->col_idx.col_idx_val,
+                                     b->row_ptr.row_ptr_val, b->col_idx.col_idx_val, b->cols,
+                                     c_ptr, marker, MAX_NNZ);
+    if (nnz < 0) {
+        result.error_msg = "Error: Product has more than MAX_NNZ nonzeros";
+        return &result;
+    }
+    
+    csr_matrix *c = &result.result;
+    if (!create_csr(c, a->rows, b->cols, (size_t)nnz)) {
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
+    }
+    memcpy(c->row_ptr.row_ptr_val, c_ptr, (size_t)(a->rows + 1) * sizeof(int));
+    csr_spgemm_fill(a->rows, a->row_ptr.row_ptr_val, a->col_idx.col_idx_val, a->values.values_val,
+                    b->row_ptr.row_ptr_val, b->col_idx.col_idx_val, b->values.values_val, b->cols,
+                    c->row_ptr.row_ptr_val, c->col_idx.col_idx_val, c->values.values_val,
+                    acc, marker);
+    result.success = 1;
+    return &result;
+}
+
+/* Sparse transpose */
+csr_result *sparse_transpose_1_svc(csr_matrix *a, struct svc_req *req) {
+    static __thread csr_result result;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    const char *error = csr_validate(a);
+    if (error) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    csr_matrix *t = &result.result;
+    if (!create_csr(t, a->cols, a->rows, a->values.values_len)) {
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
+    }
+    csr_transpose(a->rows, a->cols, a->row_ptr.row_ptr_val, a->col_idx.col_idx_val,
+                  a->values.values_val,
+                  t->row_ptr.row_ptr_val, t->col_idx.col_idx_val, t->values.values_val);
+    result.success = 1;
+    return &result;
+}
+
+/* Sparse times stored dense: the product is stored and only its handle returned */
+handle_result *sparse_mult_dense_1_svc(sparse_dense_op *args, struct svc_req *req) {
+    static __thread handle_result result;
+    csr_matrix *a = &args->a;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    
+    const char *error = csr_validate(a);
+    if (error) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    store_entry *b = store_acquire(args->handle);
+    if (!b) {
+        result.error_msg = "Error: Unknown or evicted handle";
+        return &result;
+    }
+    if (a->cols != b->rows) {
+        store_release(b);
+        result.error_msg = "Error: Incompatible dimensions for multiplication";
+        return &result;
+    }
+    
+    int rows = a->rows, cols = b->cols;
+    double *out = (double *)calloc((size_t)rows * cols, sizeof(double));
+    if (!out) {
+        store_release(b);
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
+    }
+    csr_spmm_dense(rows, a->row_ptr.row_ptr_val, a->col_idx.col_idx_val, a->values.values_val,
+                   cols, b->data, cols, out, cols);
+    store_release(b);
+    
+    result.handle = store_insert(rows, cols, out);
+    if (!result.handle) {
+        free(out);
+        result.error_msg = "Error: Store memory budget exceeded";
+        return &result;
+    }
+    result.success = 1;
+    result.rows = rows;
+    result.cols = cols;
+    return &result;
+}
+
+/* Compress a stored dense matrix to CSR */
+csr_result *sparse_from_dense_1_svc(int *handle, struct svc_req *req) {
+    static __thread csr_result result;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    store_entry *e = store_acquire(*handle);
+    if (!e) {
+        result.error_msg = "Error: Unknown or evicted handle";
+        return &result;
+    }
+    if (e->rows > MAX_SPARSE_DIM || e->cols > MAX_SPARSE_DIM) {
+        store_release(e);
+        result.error_msg = "Error: Sparse dimensions must not exceed MAX_SPARSE_DIM";
+        return &result;
+    }
+    
+    int *ptr = (int *)arena_alloc(&arena, (size_t)(e->rows + 1) * sizeof(int));
+    long long nnz = ptr ? csr_count_dense(e->rows, e->cols, e->data, ptr, MAX_NNZ) : 0;
+    csr_matrix *m = &result.result;
+    if (!ptr || nnz < 0 || !create_csr(m, e->rows, e->cols, (size_t)nnz)) {
+        store_release(e);
+        result.error_msg = (ptr && nnz < 0) ? "Error: Matrix has more than MAX_NNZ nonzeros"
+                                            : "Error: Memory allocation failed";
+        return &result;
+    }
+    memcpy(m->row_ptr.row_ptr_val, ptr, (size_t)(e->rows + 1) * sizeof(int));
+    csr_from_dense(e->rows, e->cols, e->data, ptr, m->col_idx.col_idx_val, m->values.values_val);
+    store_release(e);
+    result.success = 1;
+    return &result;
+}
+
+/* Expand a sparse matrix into the store, where it can be used by STORE_APPLY or fetched */
+handle_result *sparse_to_dense_1_svc(csr_matrix *a, struct svc_req *req) {
+    static __thread handle_result result;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    
+    const char *error = csr_validate(a);
+    if (error) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    if (!stage_dims_valid(a->rows, a->cols)) {
+        result.error_msg = "Error: Dense dimensions must be between 1 and MAX_STAGE_DIM";
+        return &result;
+    }
+    double *out = (double *)calloc((size_t)a->rows * a->cols, sizeof(double));
+    if (!out) {
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
+    }
+    csr_to_dense(a->rows, a->cols, a->row_ptr.row_ptr_val, a->col_idx.col_idx_val,
+                 a->values.values_val, out);
+    
+    result.handle = store_insert(a->rows, a->cols, out);
+    if (!result.handle) {
+        free(out);
+        result.error_msg = "Error: Store memory budget exceeded";
+        return &result;
+    }
+    result.success = 1;
+    result.rows = a->rows;
+    result.cols = a->cols;
+    return &result;
+}
+
+/* ===== Version 2: raw bulk payloads ===== */
+
+/* Version 2 serves every version 1 procedure unchanged */
+#define SAME_AS_V1(name) \
+    extern __typeof__(name##_1_svc) name##_2_svc __attribute__((alias(#name "_1_svc")))
+
+SAME_AS_V1(matrix_add);
+SAME_AS_V1(matrix_mult);
+SAME_AS_V1(matrix_inverse);
+SAME_AS_V1(matrix_transpose);
+SAME_AS_V1(ping);
+SAME_AS_V1(stage_begin);
+SAME_AS_V1(stage_append);
+SAME_AS_V1(stage_commit);
+SAME_AS_V1(stage_read);
+SAME_AS_V1(stage_end);
+SAME_AS_V1(store_put);
+SAME_AS_V1(store_adopt);
+SAME_AS_V1(store_apply);
+SAME_AS_V1(store_read);
+SAME_AS_V1(store_free);
+SAME_AS_V1(evaluate);
+SAME_AS_V1(matrix_lu);
+SAME_AS_V1(matrix_solve);
+SAME_AS_V1(matrix_det);
+SAME_AS_V1(cache_stats);
+SAME_AS_V1(matrix_mult32);
+SAME_AS_V1(stage_append32);
+SAME_AS_V1(stage_read32);
+SAME_AS_V1(sparse_mv);
+SAME_AS_V1(sparse_mult);
+SAME_AS_V1(sparse_transpose);
+SAME_AS_V1(sparse_mult_dense);
+SAME_AS_V1(sparse_from_dense);
+SAME_AS_V1(sparse_to_dense);
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define NATIVE_ORDER ORDER_LITTLE_ENDIAN
+#else
+#define NATIVE_ORDER ORDER_BIG_ENDIAN
+#endif
+
+/* Copy count doubles between raw buffers, reversing their bytes when swap is set */
+static void copy_doubles(void *dst, const void *src, size_t count, int swap) {
+    if (!swap) {
+        memcpy(dst, src, count * sizeof(double));
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        uint64_t bits;
+        memcpy(&bits, (const char *)src + i * sizeof(bits), sizeof(bits));
+        bits = __builtin_bswap64(bits);
+        memcpy((char *)dst + i * sizeof(bits), &bits, sizeof(bits));
+    }
+}
+
+/* Copy one raw tile into its operand buffer, swapping bytes only if the client's order differs */
+stage_status *stage_append_raw_2_svc(stage_tile_raw *tile, struct svc_req *req) {
+    static __thread stage_status result;
+    int k = tile->operand;
+    u_int bytes = tile->data.data_len;
+    
+    /* A payload that is not whole doubles can never match the tile */
+    u_int count = (bytes % sizeof(double)) ? (u_int)-1 : bytes / sizeof(double);
+    stage_session *s = stage_tile_target(&result, tile->session, k, tile->row, tile->col,
+                                         tile->rows, tile->cols, count);
+    if (!s) return &result;
+    
+    int swap = tile->order != NATIVE_ORDER;
+    size_t row_bytes = (size_t)tile->cols * sizeof(double);
+    double *dst = s->data[k] + (size_t)tile->row * s->cols[k] + tile->col;
+    if (tile->cols == s->cols[k]) {
+        copy_doubles(dst, tile->data.data_val, count, swap);
+    } else {
+        for (int i = 0; i < tile->rows; i++) {
+            copy_doubles(dst + (size_t)i * s->cols[k], tile->data.data_val + i * row_bytes,
+                         tile->cols, swap);
+        }
+    }
+    return stage_tile_done(&result, s, k, tile->row, tile->col, tile->rows, tile->cols);
+}
+
+/* Raw counterpart of copy_rows: the reply carries the rows in the server's byte order */
+static const char *copy_rows_raw(stage_rows_raw *reply, const double *src, int src_rows, int src_cols,
+                                 int row, int rows) {
+    const char *error = clip_rows(src_rows, src_cols, row, &rows);
+    if (error) return error;
+    
+    size_t bytes = (size_t)rows * src_cols * sizeof(double);
+    char *buffer = (char *)arena_alloc(&arena, bytes);
+    if (!buffer) {
+        return "Error: Memory allocation failed";
+    }
+    memcpy(buffer, src + (size_t)row * src_cols, bytes);
+    
+    reply->success = 1;
+    reply->row = row;
+    reply->rows = rows;
+    reply->cols = src_cols;
+    reply->order = NATIVE_ORDER;
+    reply->data.data_len = bytes;
+    reply->data.data_val = buffer;
+    return NULL;
+}
+
+stage_rows_raw *stage_read_raw_2_svc(stage_range *range, struct svc_req *req) {
+    static __thread stage_rows_raw result;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    stage_session *s = stage_lookup(range->session);
+    if (!s) {
+        result.error_msg = "Error: Unknown transfer session";
+        return &result;
+    }
+    if (!s->committed) {
+        result.error_msg = "Error: Session has not been committed";
+        stage_unlock(s);
+        return &result;
+    }
+    const char *error = copy_rows_raw(&result, s->result, s->result_rows, s->result_cols,
+                                      range->row, range->rows);
+    if (error) {
+        result.error_msg = (char *)error;
+    }
+    stage_unlock(s);
+    return &result;
+}
+
+stage_rows_raw *store_read_raw_2_svc(handle_range *range, struct svc_req *req) {
+    static __thread stage_rows_raw result;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    store_entry *e = store_acquire(range->handle);
+    if (!e) {
+        result.error_msg = "Error: Unknown or evicted handle";
+        return &result;
+    }
+    const char *error = copy_rows_raw(&result, e->data, e->rows, e->cols, range->row, range->rows);
+    if (error) {
+        result.error_msg = (char *)error;
+    }
+    store_release(e);
+    return &result;
+}
+
+/* Per-procedure counters and latency histograms */
+server_stats *stats_2_svc(int *reset, struct svc_req *req) {
+    static __thread server_stats result;
+    memset(&result, 0, sizeof(result));
+    begin_request();
+    
+    proc_stats *procs = (proc_stats *)arena_calloc(&arena, STATS_MAX_PROC + 1, sizeof(proc_stats));
+    if (!procs) return &result;
+    stats_snapshot(&result, procs, *reset);
+    return &result;
+}
+
+/* Pin the accumulator of a BLAS-3 update when beta makes it matter */
+static const char *acquire_accumulator(int handle, double beta, int rows, int cols, store_entry **c) {
+    if (beta == 0.0) return NULL;
+    *c = store_acquire(handle);
+    if (!*c) {
+        return "Error: Unknown or evicted handle";
+    }
+    if ((*c)->rows != rows || (*c)->cols != cols) {
+        return "Error: Accumulator shape must match the result";
+    }
+    return NULL;
+}
+
+/* Store alpha * product + beta * C under a new handle; transposes are passed to the GEMM as flags */
+handle_result *gemm_2_svc(gemm_request *args, struct svc_req *req) {
+    static __thread handle_result result;
+    store_entry *a = NULL, *b = NULL, *c = NULL;
+    double *out = NULL;
+    const char *error = NULL;
+    int m = 0, n = 0;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    a = store_acquire(args->a);
+    b = store_acquire(args->b);
+    if (!a || !b) {
+        error = "Error: Unknown or evicted handle";
+        goto done;
+    }
+    
+    m = args->trans_a ? a->cols : a->rows;
+    n = args->trans_b ? b->rows : b->cols;
+    int k = args->trans_a ? a->rows : a->cols;
+    if ((args->trans_b ? b->cols : b->rows) != k) {
+        error = "Error: Incompatible dimensions for multiplication";
+        goto done;
+    }
+    error = acquire_accumulator(args->c, args->beta, m, n, &c);
+    if (error) goto done;
+    
+    out = (double *)malloc((size_t)m * n * sizeof(double));
+    if (!out) {
+        error = "Error: Memory allocation failed";
+        goto done;
+    }
+    if (c) memcpy(out, c->data, c->bytes);
+    if (!backend_gemm(args->trans_a, args->trans_b, m, n, k,
+                      args->alpha, a->data, a->cols, b->data, b->cols,
+                      args->beta, out, n)) {
+        error = "Error: Memory allocation failed";
+        goto done;
+    }
+    
+done:
+    if (a) store_release(a);
+    if (b) store_release(b);
+    if (c) store_release(c);
+    if (!error) {
+        result.handle = store_insert(m, n, out);
+        if (result.handle) out = NULL;
+        else error = "Error: Store memory budget exceeded";
+    }
+    free(out);
+    if (error) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    result.success = 1;
+    result.rows = m;
+    result.cols = n;
+    return &result;
+}
+
+/* Store a symmetric rank-k update under a new handle; only half of it is computed */
+handle_result *syrk_2_svc(syrk_request *args, struct svc_req *req) {
+    static __thread handle_result result;
+    store_entry *a = NULL, *c = NULL;
+    double *out = NULL;
+    const char *error = NULL;
+    int n = 0;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    a = store_acquire(args->a);
+    if (!a) {
+        error = "Error: Unknown or evicted handle";
+        goto done;
+    }
+    
+    n = args->trans ? a->cols : a->rows;
+    int k = args->trans ? a->rows : a->cols;
+    error = acquire_accumulator(args->c, args->beta, n, n, &c);
+    if (error) goto done;
+    
+    out = (double *)malloc((size_t)n * n * sizeof(double));
+    if (!out) {
+        error = "Error: Memory allocation failed";
+        goto done;
+    }
+    if (c) memcpy(out, c->data, c->bytes);
+    if (!syrk_blocked(args->trans, n, k, args->alpha, a->data, a->cols, args->beta, out, n)) {
+        error = "Error: Memory allocation failed";
+        goto done;
+    }
+    
+done:
+    if (a) store_release(a);
+    if (c) store_release(c);
+    if (!error) {
+        result.handle = store_insert(n, n, out);
+        if (result.handle) out = NULL;
+        else error = "Error: Store memory budget exceeded";
+    }
+    free(out);
+    if (error) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    result.success = 1;
+    result.rows = n;
+    result.cols = n;
+    return &result;
+}
+
+/* Inflate a compressed tile into the arena, then stage it like a raw one */
+stage_status *stage_append_packed_2_svc(stage_tile_packed *tile, struct svc_req *req) {
+    static __thread stage_status result;
+    stage_tile_raw raw = { tile->session, tile->operand, tile->row, tile->col,
+                           tile->rows, tile->cols, tile->order,
+                           { tile->data.data_len, tile->data.data_val } };
+    begin_request();
+    
+    if (tile->codec == CODEC_SHUFFLE_DEFLATE) {
+        memset(&result, 0, sizeof(result));
+        result.error_msg = "";
+        result.session = tile->session;
+        if (tile->rows <= 0 || tile->cols <= 0 || tile->rows > MAX_TILE / tile->cols) {
+            result.error_msg = "Error: Tile lies outside the operand";
+            return &result;
+        }
+        u_int bytes = (u_int)(tile->rows * tile->cols) * sizeof(double);
+        char *buffer = (char *)arena_alloc(&arena, bytes);
+        if (!buffer) {
+            result.error_msg = "Error: Memory allocation failed";
+            return &result;
+        }
+        double start = stats_clock_us();
+        if (!codec_unpack(tile->data.data_val, tile->data.data_len, buffer, bytes)) {
+            result.error_msg = "Error: Corrupt compressed payload";
+            return &result;
+        }
+        stats_record_codec(bytes, tile->data.data_len, stats_clock_us() - start);
+        raw.data.data_len = bytes;
+        raw.data.data_val = buffer;
+    } else if (tile->codec != CODEC_NONE) {
+        memset(&result, 0, sizeof(result));
+        result.error_msg = "Error: Unknown payload codec";
+        result.session = tile->session;
+        return &result;
+    }
+    return stage_append_raw_2_svc(&raw, req);
+}
+
+/* Move a raw read into the packed reply, compressing it when the caller accepts that and it pays */
+static stage_rows_packed *pack_rows(stage_rows_packed *result, const stage_rows_raw *raw, payload_codec accept) {
+    memset(result, 0, sizeof(*result));
+    result->success = raw->success;
+    result->error_msg = raw->error_msg;
+    result->row = raw->row;
+    result->rows = raw->rows;
+    result->cols = raw->cols;
+    result->order = raw->order;
+    result->codec = CODEC_NONE;
+    result->data.data_len = raw->data.data_len;
+    result->data.data_val = raw->data.data_val;
+    if (!raw->success || accept != CODEC_SHUFFLE_DEFLATE) return result;
+    
+    u_int bytes = raw->data.data_len;
+    char *packed = bytes >= COMPRESS_MIN_BYTES ? (char *)arena_alloc(&arena, bytes) : NULL;
+    if (!packed) return result;
+    double start = stats_clock_us();
+    size_t packed_bytes = codec_pack(raw->data.data_val, bytes, packed);
+    if (packed_bytes) {
+        stats_record_codec(bytes, packed_bytes, stats_clock_us() - start);
+        result->codec = CODEC_SHUFFLE_DEFLATE;
+        result->data.data_len = (u_int)packed_bytes;
+        result->data.data_val = packed;
+    }
+    return result;
+}
+
+stage_rows_packed *stage_read_packed_2_svc(packed_range *range, struct svc_req *req) {
+    static __thread stage_rows_packed result;
+    stage_range raw_range = { range->id, range->row, range->rows };
+    return pack_rows(&result, stage_read_raw_2_svc(&raw_range, req), range->accept);
+}
+
+stage_rows_packed *store_read_packed_2_svc(packed_range *range, struct svc_req *req) {
+    static __thread stage_rows_packed result;
+    handle_range raw_range = { range->id, range->row, range->rows };
+    return pack_rows(&result, store_read_raw_2_svc(&raw_range, req), range->accept);
+}
+
+/* Map a segment the client created on this host */
+shm_attach_result *shm_attach_2_svc(char **name, struct svc_req *req) {
+    static __thread shm_attach_result result;
+    const char *error = NULL;
+    size_t size = 0;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    result.segment = segment_attach(*name, &size, &error);
+    if (!result.segment) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    result.success = 1;
+    result.size = size;
+    return &result;
+}
+
+int *shm_detach_2_svc(int *segment, struct svc_req *req) {
+    static __thread int result;
+    begin_request();
+    result = segment_detach(*segment);
+    return &result;
+}
+
+/* Bytes of a rows x cols operand at offset if it lies wholly and aligned in size bytes, else 0 */
+static size_t shm_span(size_t size, u_quad_t offset, int rows, int cols) {
+    if (!stage_dims_valid(rows, cols) || offset % sizeof(double) || offset > size) return 0;
+    size_t bytes = (size_t)rows * cols * sizeof(double);
+    return bytes <= size - offset ? bytes : 0;
+}
+
+static int shm_overlap(u_quad_t a, size_t a_bytes, u_quad_t b, size_t b_bytes) {
+    return a < b + b_bytes && b < a + a_bytes;
+}
+
+/* Everything shm_apply touches in the segment, run under segment_guard */
+typedef struct {
+    matrix_op op;
+    int a_rows, a_cols, b_cols;
+    const double *a, *b;
+    double *out, *work;
+    size_t a_bytes, out_bytes;
+} shm_call;
+
+static const char *shm_compute(void *ctx) {
+    shm_call *c = (shm_call *)ctx;
+    if (c->work) memcpy(c->work, c->a, c->a_bytes);
+    memset(c->out, 0, c->out_bytes);
+    return run_operation(c->op, c->a_rows, c->a_cols, c->a, c->b_cols, c->b, c->out, c->work);
+}
+
+/* Compute straight from the client's operands into its result area; nothing is copied over RPC */
+shm_result *shm_apply_2_svc(shm_request *args, struct svc_req *req) {
+    static __thread shm_result result;
+    int binary = binary_op(args->op);
+    const shm_operand *a = &args->first, *b = &args->second;
+    const char *error = NULL;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    shm_segment *seg = segment_acquire(args->segment);
+    if (!seg) {
+        result.error_msg = "Error: Unknown shared memory segment";
+        return &result;
+    }
+    
+    /* Bounds use the size now, not at attach: the client may have truncated the object */
+    int rows = 0, cols = 0;
+    size_t size = segment_size(seg);
+    size_t a_bytes = shm_span(size, a->offset, a->rows, a->cols);
+    size_t b_bytes = binary ? shm_span(size, b->offset, b->rows, b->cols) : 0;
+    if (!a_bytes || (binary && !b_bytes)) {
+        error = "Error: Operand outside the shared memory segment";
+        goto done;
+    }
+    error = result_shape(args->op, a->rows, a->cols, binary ? b->rows : 0, binary ? b->cols : 0, &rows, &cols);
+    if (error) goto done;
+    size_t out_bytes = shm_span(size, args->out, rows, cols);
+    if (!out_bytes) {
+        error = "Error: Result outside the shared memory segment";
+        goto done;
+    }
+    if (shm_overlap(args->out, out_bytes, a->offset, a_bytes) ||
+        (binary && shm_overlap(args->out, out_bytes, b->offset, b_bytes))) {
+        error = "Error: Result overlaps an operand";
+        goto done;
+    }
+    
+    shm_call call = { args->op, a->rows, a->cols, binary ? b->cols : 0,
+                      (const double *)(seg->base + a->offset),
+                      binary ? (const double *)(seg->base + b->offset) : NULL,
+                      (double *)(seg->base + args->out), NULL, a_bytes, out_bytes };
+    
+    /* The client's operands stay intact, so the inverse and solves factorize a scratch copy */
+    if (args->op == OP_INVERSE || args->op == OP_SOLVE || args->op == OP_LSTSQ) {
+        call.work = (double *)arena_alloc(&arena, a_bytes);
+        if (!call.work) {
+            error = "Error: Memory allocation failed";
+            goto done;
+        }
+    }
+    /* It can still shrink after the check above; a fault then becomes this call's error */
+    error = segment_guard(shm_compute, &call);
+    if (error) goto done;
+    
+    result.success = 1;
+    result.rows = rows;
+    result.cols = cols;
+    
+done:
+    segment_release(seg);
+    if (error) result.error_msg = (char *)error;
+    return &result;
+}
+
+/* Validate a Krylov request, run CG or GMRES on its dense or sparse A and fill the reply */
+static krylov_result *krylov_solve(krylov_result *result, krylov_request *args, int gmres) {
+    store_entry *dense = NULL;
+    krylov_operator op;
+    const char *error = NULL;
+    
+    memset(result, 0, sizeof(*result));
+    result->error_msg = "";
+    begin_request();
+    
+    memset(&op, 0, sizeof(op));
+    if (args->handle) {
+        dense = store_acquire(args->handle);
+        if (!dense) {
+            result->error_msg = "Error: Unknown or evicted handle";
+            return result;
+        }
+        op.n = dense->rows;
+        op.dense = dense->data;
+        op.lda = dense->cols;
+        if (dense->rows != dense->cols) error = "Error: Only square systems can be solved";
+    } else {
+        csr_matrix *a = &args->sparse;
+        error = csr_validate(a);
+        if (!error && a->rows != a->cols) error = "Error: Only square systems can be solved";
+        op.n = a->rows;
+        op.ptr = a->row_ptr.row_ptr_val;
+        op.idx = a->col_idx.col_idx_val;
+        op.val = a->values.values_val;
+    }
+    int n = op.n;
+    if (!error && (n <= 0 || args->b.b_len != (u_int)n)) {
+        error = "Error: Right-hand side length must equal the matrix order";
+    } else if (!error && args->x0.x0_len != 0 && args->x0.x0_len != (u_int)n) {
+        error = "Error: Initial guess length must equal the matrix order";
+    } else if (!error && (!(args->tol > 0.0) || args->max_iter < 1 || args->max_iter > MAX_KRYLOV_ITER)) {
+        error = "Error: Need tol > 0 and 1 <= max_iter <= MAX_KRYLOV_ITER";
+    } else if (!error && (args->restart < 0 || args->restart > MAX_KRYLOV_RESTART)) {
+        error = "Error: GMRES restart must be between 0 and MAX_KRYLOV_RESTART";
+    }
+    if (error) goto done;
+    
+    double *x = (double *)arena_calloc(&arena, (size_t)n, sizeof(double));
+    double *history = (double *)arena_alloc(&arena, ((size_t)args->max_iter + 1) * sizeof(double));
+    if (!x || !history) {
+        error = "Error: Memory allocation failed";
+        goto done;
+    }
+    if (args->x0.x0_len) memcpy(x, args->x0.x0_val, (size_t)n * sizeof(double));
+    
+    int iterations = 0, converged = 0;
+    if (gmres) {
+        error = krylov_gmres(&op, args->precond, args->restart, args->b.b_val, x, args->tol,
+                             args->max_iter, history, &iterations, &converged, &arena);
+    } else {
+        error = krylov_cg(&op, args->precond, args->b.b_val, x, args->tol,
+                          args->max_iter, history, &iterations, &converged, &arena);
+    }
+    if (error) goto done;
+    
+    result->success = 1;
+    result->converged = converged;
+    result->iterations = iterations;
+    result->x.x_len = n;
+    result->x.x_val = x;
+    result->residuals.residuals_len = iterations + 1;
+    result->residuals.residuals_val = history;
+    
+done:
+    if (dense) store_release(dense);
+    if (error) result->error_msg = (char *)error;
+    return result;
+}
+
+krylov_result *solve_cg_2_svc(krylov_request *args, struct svc_req *req) {
+    static __thread krylov_result result;
+    return krylov_solve(&result, args, 0);
+}
+
+krylov_result *solve_gmres_2_svc(krylov_request *args, struct svc_req *req) {
+    static __thread krylov_result result;
+    return krylov_solve(&result, args, 1);
+}
+
+/* ===== Householder QR and least squares ===== */
+
+/*
+ * Thin QR of a row-major m x n A into zeroed q (m x k) and r (k x n),
+ * k = min(m, n). work holds a copy of A and is overwritten by the factors.
+ */
+static const char *thin_qr(int m, int n, double *work, double *q, double *r) {
+    int k = m < n ? m : n;
+    double *tau = (double *)arena_alloc(&arena, (size_t)k * sizeof(double));
+    if (!tau || !qr_factor_blocked(m, n, work, n, tau)) {
+        return "Error: Memory allocation failed";
+    }
+    for (int i = 0; i < k; i++) {
+        memcpy(r + (size_t)i * n + i, work + (size_t)i * n + i, (size_t)(n - i) * sizeof(double));
+        q[(size_t)i * k + i] = 1.0;
+    }
+    /* Q's first k columns: Q applied to the leading columns of the identity */
+    if (!qr_apply_q(0, m, k, work, n, tau, k, q, k)) {
+        return "Error: Memory allocation failed";
+    }
+    return NULL;
+}
+
+qr_result *matrix_qr_2_svc(matrix *a, struct svc_req *req) {
+    static __thread qr_result result;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    if (!matrix_shape_valid(a)) {
+        result.error_msg = "Error: Matrix data does not match its dimensions";
+        return &result;
+    }
+    int m = a->rows, n = a->cols, k = m < n ? m : n;
+    double *work = (double *)arena_alloc(&arena, a->data.data_len * sizeof(double));
+    const char *error = "Error: Memory allocation failed";
+    if (work && create_matrix(&result.q, m, k) && create_matrix(&result.r, k, n)) {
+        memcpy(work, a->data.data_val, a->data.data_len * sizeof(double));
+        error = thin_qr(m, n, work, result.q.data.data_val, result.r.data.data_val);
+    }
+    if (error) {
+        memset(&result.q, 0, sizeof(result.q));
+        memset(&result.r, 0, sizeof(result.r));
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    result.success = 1;
+    return &result;
+}
+
+/* Least squares in one call, instead of forming and inverting A^T A */
+matrix_result *matrix_lstsq_2_svc(matrix_pair *pair, struct svc_req *req) {
+    static __thread matrix_result result;
+    matrix *a = &pair->first;
+    matrix *b = &pair->second;
+    int rows = 0, cols = 0;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    if (!matrix_shape_valid(a) || !matrix_shape_valid(b)) {
+        result.error_msg = "Error: Matrix data does not match its dimensions";
+        return &result;
+    }
+    const char *error = result_shape(OP_LSTSQ, a->rows, a->cols, b->rows, b->cols, &rows, &cols);
+    if (error) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    
+    matrix *x = &result.result_matrix;
+    double *work = (double *)arena_alloc(&arena, a->data.data_len * sizeof(double));
+    if (!work || !create_matrix(x, rows, cols)) {
+        memset(x, 0, sizeof(*x));
+        result.error_msg = "Error: Memory allocation failed";
+        return &result;
+    }
+    cache_key key;
+    int cached = cache_key_init(&key, OP_LSTSQ, a->rows, a->cols, a->data.data_val,
+                                b->rows, b->cols, b->data.data_val);
+    if (cached && cache_lookup(&key, rows, cols, x->data.data_val)) {
+        result.success = 1;
+        return &result;
+    }
+    
+    memcpy(work, a->data.data_val, a->data.data_len * sizeof(double));
+    error = run_operation(OP_LSTSQ, a->rows, a->cols, a->data.data_val,
+                          b->cols, b->data.data_val, x->data.data_val, work);
+    if (error) {
+        memset(x, 0, sizeof(*x));
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    if (cached) cache_insert(&key, rows, cols, x->data.data_val);
+    result.success = 1;
+    return &result;
+}
+
+/* Store Q and R of a stored matrix under two new handles */
+qr_handles *store_qr_2_svc(int *handle, struct svc_req *req) {
+    static __thread qr_handles result;
+    store_entry *a = NULL;
+    double *q = NULL, *r = NULL;
+    const char *error = NULL;
+    int m = 0, n = 0, k = 0;
+    
+    memset(&result, 0, sizeof(result));
+    result.error_msg = "";
+    begin_request();
+    
+    a = store_acquire(*handle);
+    if (!a) {
+        error = "Error: Unknown or evicted handle";
+        goto done;
+    }
+    
+    m = a->rows;
+    n = a->cols;
+    k = m < n ? m : n;
+    q = (double *)calloc((size_t)m * k, sizeof(double));
+    r = (double *)calloc((size_t)k * n, sizeof(double));
+    double *work = (double *)arena_alloc(&arena, a->bytes);
+    if (!q || !r || !work) {
+        error = "Error: Memory allocation failed";
+        goto done;
+    }
+    memcpy(work, a->data, a->bytes);
+    error = thin_qr(m, n, work, q, r);
+    
+done:
+    if (a) store_release(a);
+    if (!error) {
+        result.q = store_insert(m, k, q);
+        if (result.q) q = NULL;
+        result.r = result.q ? store_insert(k, n, r) : 0;
+        if (result.r) {
+            r = NULL;
+        } else {
+            /* The store owns Q's buffer once inserted */
+            if (result.q) store_remove(result.q);
+            result.q = 0;
+            error = "Error: Store memory budget exceeded";
+        }
+    }
+    free(q);
+    free(r);
+    if (error) {
+        result.error_msg = (char *)error;
+        return &result;
+    }
+    result.success = 1;
+    result.rows = m;
+    result.cols = n;
+    result.k = k;
+    return &result;
+}
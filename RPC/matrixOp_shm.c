@@ -0,0 +1,159 @@
+/*
+ * matrixOp_shm.c - Shared memory segments of co-located clients, mapped into the server
+ *
+ * A segment stays mapped from SHM_ATTACH to SHM_DETACH, so repeated calls
+ * on it pay neither mmap nor page faults again. Only names under
+ * SHM_NAME_PREFIX are opened, which keeps clients away from unrelated
+ * shared memory on the host.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <setjmp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "matrixOp_shm.h"
+
+/* segment_lock guards the list, the count and the pins */
+static pthread_mutex_t segment_lock = PTHREAD_MUTEX_INITIALIZER;
+static shm_segment *segments;
+static int attached;
+static int next_id = 1;
+
+static shm_segment *find(int id) {
+    shm_segment *s = segments;
+    while (s && s->id != id) s = s->next;
+    return s;
+}
+
+static void unmap(shm_segment *s) {
+    munmap(s->base, s->size);
+    close(s->fd);
+    free(s);
+}
+
+int segment_attach(const char *name, size_t *size, const char **error) {
+    size_t prefix = strlen(SHM_NAME_PREFIX);
+    if (strncmp(name, SHM_NAME_PREFIX, prefix) != 0 || strchr(name + prefix, '/') || !name[prefix]) {
+        *error = "Error: Not a matrixOp shared memory name";
+        return 0;
+    }
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        *error = "Error: Shared memory segment not found on the server host";
+        return 0;
+    }
+    struct stat st;
+    void *base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (base == MAP_FAILED) {
+        close(fd);
+        *error = "Error: Cannot map shared memory segment";
+        return 0;
+    }
+
+    shm_segment *s = (shm_segment *)calloc(1, sizeof(shm_segment));
+    if (!s) {
+        munmap(base, (size_t)st.st_size);
+        close(fd);
+        *error = "Error: Memory allocation failed";
+        return 0;
+    }
+    s->base = (unsigned char *)base;
+    s->size = (size_t)st.st_size;
+    s->fd = fd;
+
+    pthread_mutex_lock(&segment_lock);
+    if (attached >= SHM_MAX_SEGMENTS) {
+        pthread_mutex_unlock(&segment_lock);
+        unmap(s);
+        *error = "Error: Too many shared memory segments attached";
+        return 0;
+    }
+    s->id = next_id++;
+    if (next_id <= 0) next_id = 1;
+    s->next = segments;
+    segments = s;
+    attached++;
+    pthread_mutex_unlock(&segment_lock);
+
+    *size = s->size;
+    return s->id;
+}
+
+shm_segment *segment_acquire(int id) {
+    pthread_mutex_lock(&segment_lock);
+    shm_segment *s = find(id);
+    if (s) s->pins++;
+    pthread_mutex_unlock(&segment_lock);
+    return s;
+}
+
+void segment_release(shm_segment *segment) {
+    pthread_mutex_lock(&segment_lock);
+    int last = --segment->pins == 0 && segment->removed;
+    pthread_mutex_unlock(&segment_lock);
+    if (last) unmap(segment);
+}
+
+int segment_detach(int id) {
+    pthread_mutex_lock(&segment_lock);
+    shm_segment **link = &segments;
+    while (*link && (*link)->id != id) link = &(*link)->next;
+    shm_segment *s = *link;
+    int found = s != NULL, idle = 0;
+    if (s) {
+        *link = s->next;
+        attached--;
+        s->removed = 1;
+        idle = s->pins == 0;
+    }
+    pthread_mutex_unlock(&segment_lock);
+    if (idle) unmap(s);
+    return found;
+}
+
+size_t segment_size(const shm_segment *segment) {
+    struct stat st;
+    if (fstat(segment->fd, &st) != 0 || st.st_size < 0) return 0;
+    return (size_t)st.st_size < segment->size ? (size_t)st.st_size : segment->size;
+}
+
+/* SIGBUS handling: each thread arms its own jump target around a guarded call */
+static pthread_once_t guard_once = PTHREAD_ONCE_INIT;
+static __thread sigjmp_buf guard_jump;
+static __thread volatile sig_atomic_t guarded;
+
+static void on_sigbus(int sig) {
+    if (guarded) {
+        guarded = 0;
+        siglongjmp(guard_jump, 1);
+    }
+    /* A fault outside a guarded call: the retried access takes the default action */
+    signal(sig, SIG_DFL);
+}
+
+static void install_guard(void) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_sigbus;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGBUS, &sa, NULL);
+}
+
+const char *segment_guard(const char *(*fn)(void *ctx), void *ctx) {
+    pthread_once(&guard_once, install_guard);
+    if (sigsetjmp(guard_jump, 1)) {
+        return "Error: Shared memory segment shrank during the call";
+    }
+    guarded = 1;
+    const char *error = fn(ctx);
+    guarded = 0;
+    return error;
+}
@@ -0,0 +1,56 @@
+/*
+ * matrixOp_shm.h - Shared memory segments of co-located clients, mapped into the server
+ */
+
+#ifndef MATRIXOP_SHM_H
+#define MATRIXOP_SHM_H
+
+#include <stddef.h>
+
+/* Segment names clients create and the server agrees to attach */
+#define SHM_NAME_PREFIX "/matrixOp-"
+
+/* Cap on segments attached at once */
+#define SHM_MAX_SEGMENTS 256
+
+typedef struct shm_segment {
+    int id;
+    unsigned char *base;    /* MAP_SHARED mapping; the client writes it between calls */
+    size_t size;            /* mapped bytes */
+    int fd;                 /* kept open so the current size can be re-checked */
+    int pins;               /* calls currently computing in it */
+    int removed;            /* detached while pinned; unmapped on last unpin */
+    struct shm_segment *next;
+} shm_segment;
+
+/*
+ * Map the named segment read-write and return its id, with its size in
+ * *size. Returns 0 with *error set if the name is not one of ours, does
+ * not exist on this host, or too many segments are attached.
+ */
+int segment_attach(const char *name, size_t *size, const char **error);
+
+/* Pin an attached segment while a call computes in it; NULL if unknown */
+shm_segment *segment_acquire(int id);
+
+/* Unpin a segment returned by segment_acquire */
+void segment_release(shm_segment *segment);
+
+/* Unmap a segment once no call uses it; returns 0 if it is unknown */
+int segment_detach(int id);
+
+/*
+ * Bytes of the mapping still backed by the object: the client may have
+ * shrunk it with ftruncate since attach, and touching pages past the new
+ * end raises SIGBUS. 0 if the size cannot be read.
+ */
+size_t segment_size(const shm_segment *segment);
+
+/*
+ * Return fn(ctx), or an error if the segment shrinks under it: a SIGBUS
+ * on the calling thread while fn runs unwinds back here. Whatever fn had
+ * allocated outside the request arena at that point is leaked.
+ */
+const char *segment_guard(const char *(*fn)(void *ctx), void *ctx);
+
+#endif /* MATRIXOP_SHM_H */
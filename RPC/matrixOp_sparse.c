@@ -0,0 +1,172 @@
+/*
+ * matrixOp_sparse.c - Compressed sparse row (CSR) kernels used by the matrix RPC server
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "matrixOp_sparse.h"
+
+const char *csr_check(int rows, int cols, const int *ptr, int ptr_len,
+                      const int *idx, int idx_len, int val_len) {
+    if (rows <= 0 || cols <= 0) {
+        return "Error: Sparse dimensions must be positive";
+    }
+    if (ptr_len != rows + 1 || idx_len != val_len) {
+        return "Error: Sparse arrays do not match the dimensions";
+    }
+    if (ptr[0] != 0 || ptr[rows] != idx_len) {
+        return "Error: Row offsets must run from 0 to the nonzero count";
+    }
+    for (int i = 0; i < rows; i++) {
+        if (ptr[i + 1] < ptr[i]) {
+            return "Error: Row offsets must not decrease";
+        }
+    }
+    for (int p = 0; p < idx_len; p++) {
+        if ((unsigned int)idx[p] >= (unsigned int)cols) {
+            return "Error: Column index out of range";
+        }
+    }
+    return NULL;
+}
+
+void csr_spmv(int rows, const int *ptr, const int *idx, const double *val,
+              const double *x, double *y) {
+    for (int i = 0; i < rows; i++) {
+        double sum = 0.0;
+        for (int p = ptr[i]; p < ptr[i + 1]; p++) {
+            sum += val[p] * x[idx[p]];
+        }
+        y[i] = sum;
+    }
+}
+
+void csr_spmm_dense(int rows, const int *ptr, const int *idx, const double *val,
+                    int n, const double *B, int ldb, double *C, int ldc) {
+    for (int i = 0; i < rows; i++) {
+        double *c = C + (size_t)i * ldc;
+        for (int p = ptr[i]; p < ptr[i + 1]; p++) {
+            double a = val[p];
+            const double *b = B + (size_t)idx[p] * ldb;
+            for (int j = 0; j < n; j++) c[j] += a * b[j];
+        }
+    }
+}
+
+void csr_transpose(int rows, int cols, const int *ptr, const int *idx, const double *val,
+                   int *t_ptr, int *t_idx, double *t_val) {
+    /* Count entries per column, prefix-sum into offsets, then scatter in row order */
+    memset(t_ptr, 0, (size_t)(cols + 1) * sizeof(int));
+    for (int p = 0; p < ptr[rows]; p++) t_ptr[idx[p] + 1]++;
+    for (int j = 0; j < cols; j++) t_ptr[j + 1] += t_ptr[j];
+
+    int *next = t_ptr;      /* advanced per column below, then shifted back */
+    for (int i = 0; i < rows; i++) {
+        for (int p = ptr[i]; p < ptr[i + 1]; p++) {
+            int dst = next[idx[p]]++;
+            t_idx[dst] = i;
+            t_val[dst] = val[p];
+        }
+    }
+    for (int j = cols; j > 0; j--) t_ptr[j] = t_ptr[j - 1];
+    t_ptr[0] = 0;
+}
+
+long long csr_spgemm_count(int rows, const int *a_ptr, const int *a_idx,
+                           const int *b_ptr, const int *b_idx, int b_cols,
+                           int *c_ptr, int *marker, long long max_nnz) {
+    long long total = 0;
+
+    for (int j = 0; j < b_cols; j++) marker[j] = -1;
+    c_ptr[0] = 0;
+    for (int i = 0; i < rows; i++) {
+        for (int p = a_ptr[i]; p < a_ptr[i + 1]; p++) {
+            int k = a_idx[p];
+            for (int q = b_ptr[k]; q < b_ptr[k + 1]; q++) {
+                int j = b_idx[q];
+                if (marker[j] != i) {
+                    marker[j] = i;
+                    total++;
+                }
+            }
+        }
+        if (total > max_nnz) return -1;
+        c_ptr[i + 1] = (int)total;
+    }
+    return total;
+}
+
+static int compare_int(const void *x, const void *y) {
+    int a = *(const int *)x, b = *(const int *)y;
+    return (a > b) - (a < b);
+}
+
+void csr_spgemm_fill(int rows, const int *a_ptr, const int *a_idx, const double *a_val,
+                     const int *b_ptr, const int *b_idx, const double *b_val, int b_cols,
+                     const int *c_ptr, int *c_idx, double *c_val,
+                     double *acc, int *marker) {
+    for (int j = 0; j < b_cols; j++) marker[j] = -1;
+    for (int i = 0; i < rows; i++) {
+        int *cols = c_idx + c_ptr[i];
+        int len = 0;
+
+        /* Scatter row i of A*B into the accumulator, listing each new column once */
+        for (int p = a_ptr[i]; p < a_ptr[i + 1]; p++) {
+            int k = a_idx[p];
+            double a = a_val[p];
+            for (int q = b_ptr[k]; q < b_ptr[k + 1]; q++) {
+                int j = b_idx[q];
+                if (marker[j] != i) {
+                    marker[j] = i;
+                    acc[j] = a * b_val[q];
+                    cols[len++] = j;
+                } else {
+                    acc[j] += a * b_val[q];
+                }
+            }
+        }
+
+        /* Gather in column order */
+        qsort(cols, len, sizeof(int), compare_int);
+        double *vals = c_val + c_ptr[i];
+        for (int p = 0; p < len; p++) vals[p] = acc[cols[p]];
+    }
+}
+
+long long csr_count_dense(int rows, int cols, const double *data, int *ptr, long long max_nnz) {
+    long long total = 0;
+
+    ptr[0] = 0;
+    for (int i = 0; i < rows; i++) {
+        const double *row = data + (size_t)i * cols;
+        for (int j = 0; j < cols; j++) {
+            if (row[j] != 0.0) total++;
+        }
+        if (total > max_nnz) return -1;
+        ptr[i + 1] = (int)total;
+    }
+    return total;
+}
+
+void csr_from_dense(int rows, int cols, const double *data, const int *ptr,
+                    int *idx, double *val) {
+    for (int i = 0; i < rows; i++) {
+        const double *row = data + (size_t)i * cols;
+        int p = ptr[i];
+        for (int j = 0; j < cols; j++) {
+            if (row[j] != 0.0) {
+                idx[p] = j;
+                val[p] = row[j];
+                p++;
+            }
+        }
+    }
+}
+
+void csr_to_dense(int rows, int cols, const int *ptr, const int *idx, const double *val,
+                  double *out) {
+    for (int i = 0; i < rows; i++) {
+        double *row = out + (size_t)i * cols;
+        for (int p = ptr[i]; p < ptr[i + 1]; p++) row[idx[p]] += val[p];
+    }
+}
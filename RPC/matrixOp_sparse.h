@@ -0,0 +1,65 @@
+/*
+ * matrixOp_sparse.h - Compressed sparse row (CSR) kernels used by the matrix RPC server
+ *
+ * A CSR matrix stores row i's nonzeros at positions ptr[i] .. ptr[i+1]-1 of
+ * idx (column) and val (value). Every kernel walks its output row by row and
+ * rows never depend on each other, so each one can be split over row ranges.
+ */
+
+#ifndef MATRIXOP_SPARSE_H
+#define MATRIXOP_SPARSE_H
+
+/*
+ * Check that ptr, idx and val describe a rows x cols CSR matrix with nnz
+ * entries: ptr starts at 0, never decreases and ends at nnz, and every
+ * column index is in range. Returns NULL or an error message.
+ */
+const char *csr_check(int rows, int cols, const int *ptr, int ptr_len,
+                      const int *idx, int idx_len, int val_len);
+
+/* y = A x */
+void csr_spmv(int rows, const int *ptr, const int *idx, const double *val,
+              const double *x, double *y);
+
+/*
+ * C += A * B for a dense row-major B with n columns: each nonzero a_ik adds
+ * a_ik times row k of B to row i of C, so B and C are read in unit stride.
+ */
+void csr_spmm_dense(int rows, const int *ptr, const int *idx, const double *val,
+                    int n, const double *B, int ldb, double *C, int ldc);
+
+/* A^T in CSR; t_ptr has cols + 1 entries. Each output row comes out sorted by column */
+void csr_transpose(int rows, int cols, const int *ptr, const int *idx, const double *val,
+                   int *t_ptr, int *t_idx, double *t_val);
+
+/*
+ * Symbolic pass of C = A * B (Gustavson): fill c_ptr (rows + 1 entries)
+ * with the row offsets of C. marker is a b_cols workspace. Returns C's
+ * nonzero count, or -1 once it would exceed max_nnz.
+ */
+long long csr_spgemm_count(int rows, const int *a_ptr, const int *a_idx,
+                           const int *b_ptr, const int *b_idx, int b_cols,
+                           int *c_ptr, int *marker, long long max_nnz);
+
+/*
+ * Numeric pass of C = A * B into the structure from csr_spgemm_count, with
+ * a dense accumulator and marker of b_cols entries each. Columns within
+ * each row of C come out sorted.
+ */
+void csr_spgemm_fill(int rows, const int *a_ptr, const int *a_idx, const double *a_val,
+                     const int *b_ptr, const int *b_idx, const double *b_val, int b_cols,
+                     const int *c_ptr, int *c_idx, double *c_val,
+                     double *acc, int *marker);
+
+/* Fill ptr for the nonzeros of a dense row-major matrix; returns their count, or -1 above max_nnz */
+long long csr_count_dense(int rows, int cols, const double *data, int *ptr, long long max_nnz);
+
+/* Copy the nonzeros of a dense matrix into the structure from csr_count_dense */
+void csr_from_dense(int rows, int cols, const double *data, const int *ptr,
+                    int *idx, double *val);
+
+/* Add A into a zeroed dense row-major rows x cols matrix (duplicate entries sum) */
+void csr_to_dense(int rows, int cols, const int *ptr, const int *idx, const double *val,
+                  double *out);
+
+#endif /* MATRIXOP_SPARSE_H */
@@ -0,0 +1,169 @@
+/*
+ * matrixOp_stage.c - Table of staged (chunked) transfer sessions
+ *
+ * A session belongs to the TCP connection that opened it. Clients that
+ * crash or never call STAGE_END leave their session behind, so a full
+ * table first reclaims sessions whose connection is gone: the peer hung
+ * up, or the descriptor is closed or now names a connection to another peer.
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <poll.h>
+#include <pthread.h>
+#include "matrixOp_stage.h"
+
+/*
+ * Locking: stage_table_lock guards slot ids and next_stage_id; each slot's
+ * mutex guards its contents. A slot's id only changes while both are held,
+ * and the table lock is never held while blocking on a slot.
+ */
+static stage_session *stage_sessions;
+static pthread_mutex_t *stage_slot_locks;
+static int stage_capacity;
+static pthread_mutex_t stage_table_lock = PTHREAD_MUTEX_INITIALIZER;
+static int next_stage_id = 1;
+
+int stage_set_capacity(int sessions) {
+    stage_session *table = (stage_session *)calloc(sessions, sizeof(stage_session));
+    pthread_mutex_t *locks = (pthread_mutex_t *)malloc(sessions * sizeof(pthread_mutex_t));
+    if (!table || !locks) {
+        free(table);
+        free(locks);
+        return 0;
+    }
+    for (int i = 0; i < sessions; i++) pthread_mutex_init(&locks[i], NULL);
+    stage_sessions = table;
+    stage_slot_locks = locks;
+    stage_capacity = sessions;
+    return 1;
+}
+
+static void stage_release(stage_session *s) {
+    stage_operands_free(s);
+    free(s->result);
+    memset(s, 0, sizeof(*s));
+}
+
+/* Still connected: the descriptor reaches the same peer as at STAGE_BEGIN, which has not hung up */
+static int owner_alive(const stage_session *s) {
+    struct sockaddr_storage peer;
+    socklen_t len = sizeof(peer);
+    if (s->owner_fd < 0) return 1;
+    if (getpeername(s->owner_fd, (struct sockaddr *)&peer, &len) != 0 ||
+        len != s->owner_peer_len || memcmp(&peer, &s->owner_peer, len) != 0) {
+        return 0;
+    }
+    /* A closed client leaves the server's end open until a worker reads the EOF */
+    struct pollfd p = { s->owner_fd, POLLRDHUP, 0 };
+    return !(poll(&p, 1, 0) > 0 && (p.revents & (POLLRDHUP | POLLHUP | POLLERR)));
+}
+
+stage_session *stage_lookup(int id) {
+    int slot = -1;
+    
+    if (id <= 0) return NULL;
+    pthread_mutex_lock(&stage_table_lock);
+    for (int i = 0; i < stage_capacity; i++) {
+        if (stage_sessions[i].id == id) {
+            slot = i;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&stage_table_lock);
+    if (slot < 0) return NULL;
+    
+    pthread_mutex_lock(&stage_slot_locks[slot]);
+    if (stage_sessions[slot].id != id) {
+        /* Ended while we were waiting */
+        pthread_mutex_unlock(&stage_slot_locks[slot]);
+        return NULL;
+    }
+    stage_sessions[slot].last_used = time(NULL);
+    return &stage_sessions[slot];
+}
+
+void stage_unlock(stage_session *s) {
+    pthread_mutex_unlock(&stage_slot_locks[s - stage_sessions]);
+}
+
+stage_session *stage_allocate(int fd) {
+    time_t now = time(NULL);
+    stage_session *claimed = NULL;
+    
+    pthread_mutex_lock(&stage_table_lock);
+    for (int pass = 0; pass < 3 && !claimed; pass++) {
+        for (int i = 0; i < stage_capacity; i++) {
+            stage_session *s = &stage_sessions[i];
+            if (s->id != 0 && pass == 0) continue;
+            /* Slots in use are locked by their call, so trylock also skips them */
+            if (pthread_mutex_trylock(&stage_slot_locks[i]) != 0) continue;
+            int usable = pass == 0 || (s->id != 0 && (pass == 1 ? !owner_alive(s)
+                                                                : now - s->last_used > STAGE_IDLE_TIMEOUT));
+            if (!usable) {
+                pthread_mutex_unlock(&stage_slot_locks[i]);
+                continue;
+            }
+            if (s->id != 0) stage_release(s);
+            s->id = next_stage_id++;
+            if (next_stage_id <= 0) next_stage_id = 1;
+            s->last_used = now;
+            claimed = s;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&stage_table_lock);
+    if (!claimed) return NULL;
+    
+    claimed->owner_peer_len = sizeof(claimed->owner_peer);
+    claimed->owner_fd = getpeername(fd, (struct sockaddr *)&claimed->owner_peer, &claimed->owner_peer_len) == 0
+                        ? fd : -1;
+    return claimed;
+}
+
+void stage_free(stage_session *s) {
+    pthread_mutex_lock(&stage_table_lock);
+    stage_release(s);
+    pthread_mutex_unlock(&stage_table_lock);
+    stage_unlock(s);
+}
+
+int stage_operand_alloc(stage_session *s, int operand) {
+    size_t count = (size_t)s->rows[operand] * s->cols[operand];
+    s->data[operand] = (double *)calloc(count, sizeof(double));
+    s->covered[operand] = (uint64_t *)calloc((count + 63) / 64, sizeof(uint64_t));
+    s->filled[operand] = 0;
+    return s->data[operand] && s->covered[operand];
+}
+
+void stage_operands_free(stage_session *s) {
+    for (int k = 0; k < 2; k++) {
+        free(s->data[k]);
+        free(s->covered[k]);
+        s->data[k] = NULL;
+        s->covered[k] = NULL;
+    }
+}
+
+/* Set bits [start, start + count) and return how many were clear */
+static size_t cover_range(uint64_t *bits, size_t start, size_t count) {
+    size_t added = 0;
+    while (count > 0) {
+        size_t word = start / 64, shift = start % 64;
+        size_t span = 64 - shift < count ? 64 - shift : count;
+        uint64_t mask = (span == 64 ? ~(uint64_t)0 : (((uint64_t)1 << span) - 1)) << shift;
+        added += __builtin_popcountll(mask & ~bits[word]);
+        bits[word] |= mask;
+        start += span;
+        count -= span;
+    }
+    return added;
+}
+
+void stage_cover(stage_session *s, int operand, int row, int col, int rows, int cols) {
+    size_t stride = (size_t)s->cols[operand];
+    for (int i = 0; i < rows; i++) {
+        s->filled[operand] += cover_range(s->covered[operand], (size_t)(row + i) * stride + col, cols);
+    }
+}
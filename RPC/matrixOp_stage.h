@@ -0,0 +1,66 @@
+/*
+ * matrixOp_stage.h - Table of staged (chunked) transfer sessions
+ */
+
+#ifndef MATRIXOP_STAGE_H
+#define MATRIXOP_STAGE_H
+
+#include <stdint.h>
+#include <time.h>
+#include <sys/socket.h>
+#include "matrixOp.h"
+
+/* Default session count: STAGE_SESSIONS_PER_WORKER per worker thread, at least STAGE_MIN_SESSIONS */
+#define STAGE_MIN_SESSIONS 64
+#define STAGE_SESSIONS_PER_WORKER 8
+
+/* Seconds after which an idle session may be reclaimed even if its connection is open */
+#define STAGE_IDLE_TIMEOUT 300
+
+/* A staging session: operands are assembled tile by tile, then replaced by the result */
+typedef struct {
+    int id;                 /* 0 = free slot */
+    matrix_op op;
+    int rows[2];            /* operand shapes */
+    int cols[2];
+    double *data[2];        /* operand buffers, freed on commit */
+    uint64_t *covered[2];   /* one bit per operand element received */
+    size_t filled[2];       /* distinct elements received per operand */
+    int committed;
+    int result_rows;
+    int result_cols;
+    double *result;
+    time_t last_used;
+    int owner_fd;           /* TCP connection that opened it, or -1 if unknown (UDP) */
+    struct sockaddr_storage owner_peer;
+    socklen_t owner_peer_len;
+} stage_session;
+
+/* Size the table; call once before serving. Returns 0 if it cannot be allocated */
+int stage_set_capacity(int sessions);
+
+/* Find a session and lock it; the caller must call stage_unlock when done */
+stage_session *stage_lookup(int id);
+
+void stage_unlock(stage_session *s);
+
+/*
+ * Claim a slot for a session opened on connection fd and return it locked.
+ * When none is free, a session whose connection has closed is reclaimed,
+ * then one idle for STAGE_IDLE_TIMEOUT. NULL if all are in use.
+ */
+stage_session *stage_allocate(int fd);
+
+/* Give a locked slot back to the table */
+void stage_free(stage_session *s);
+
+/* Allocate a zeroed buffer and coverage map for the operand's shape; 0 if out of memory */
+int stage_operand_alloc(stage_session *s, int operand);
+
+/* Release both operands' buffers and coverage maps */
+void stage_operands_free(stage_session *s);
+
+/* Mark a tile of the operand received; elements already received are not counted again */
+void stage_cover(stage_session *s, int operand, int row, int col, int rows, int cols);
+
+#endif /* MATRIXOP_STAGE_H */
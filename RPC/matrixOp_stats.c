@@ -0,0 +1,270 @@
+/*
+ * matrixOp_stats.c - Per-procedure call counters and latency histograms
+ *
+ * Every thread that serves requests records into its own shard; only the
+ * owner writes a shard, and STATS sums them all. Counters are updated with
+ * relaxed atomic stores so a concurrent snapshot never reads torn values.
+ * A reset does not touch the shards: it remembers the current totals as a
+ * baseline that later snapshots subtract.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include "matrixOp_stats.h"
+
+enum { PHASE_DECODE, PHASE_COMPUTE, PHASE_ENCODE, PHASES };
+
+typedef struct {
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+    uint64_t latency[PHASES][STATS_BUCKETS];
+    uint64_t codec_raw;
+    uint64_t codec_packed;
+    uint64_t codec_us;
+} proc_counters;
+
+typedef struct stats_shard {
+    proc_counters procs[STATS_MAX_PROC + 1];
+    struct stats_shard *next;
+} stats_shard;
+
+/* registry_lock guards the shard list, the baseline and the reset time */
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static stats_shard *shards;
+static proc_counters baseline[STATS_MAX_PROC + 1];
+static double reset_time;
+
+static __thread stats_shard *own_shard;
+
+double stats_clock_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+__attribute__((constructor)) static void stats_start(void) {
+    reset_time = stats_clock_us();
+}
+
+/* The request being dispatched on this thread */
+typedef struct {
+    const struct xp_ops *real_ops;
+    struct xp_ops timed_ops;
+    rpcproc_t proc;
+    double start;
+    double args_done;
+    double reply_start;
+    double reply_done;
+    int failed;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+    uint64_t codec_raw;
+    uint64_t codec_packed;
+    double codec_us;
+} request_timing;
+
+static __thread request_timing current;
+
+/* Procedures whose result does not start with a success flag */
+static int reports_success(rpcproc_t proc) {
+    return proc != NULLPROC && proc != PING && proc != CACHE_STATS && proc != STATS;
+}
+
+static const char *proc_names[STATS_MAX_PROC + 1] = {
+    [NULLPROC] = "null",
+    [MATRIX_ADD] = "matrix_add",
+    [MATRIX_MULT] = "matrix_mult",
+    [MATRIX_INVERSE] = "matrix_inverse",
+    [MATRIX_TRANSPOSE] = "matrix_transpose",
+    [PING] = "ping",
+    [STAGE_BEGIN] = "stage_begin",
+    [STAGE_APPEND] = "stage_append",
+    [STAGE_COMMIT] = "stage_commit",
+    [STAGE_READ] = "stage_read",
+    [STAGE_END] = "stage_end",
+    [STORE_PUT] = "store_put",
+    [STORE_ADOPT] = "store_adopt",
+    [STORE_APPLY] = "store_apply",
+    [STORE_READ] = "store_read",
+    [STORE_FREE] = "store_free",
+    [EVALUATE] = "evaluate",
+    [MATRIX_LU] = "matrix_lu",
+    [MATRIX_SOLVE] = "matrix_solve",
+    [MATRIX_DET] = "matrix_det",
+    [CACHE_STATS] = "cache_stats",
+    [MATRIX_MULT32] = "matrix_mult32",
+    [STAGE_APPEND32] = "stage_append32",
+    [STAGE_READ32] = "stage_read32",
+    [SPARSE_MV] = "sparse_mv",
+    [SPARSE_MULT] = "sparse_mult",
+    [SPARSE_TRANSPOSE] = "sparse_transpose",
+    [SPARSE_MULT_DENSE] = "sparse_mult_dense",
+    [SPARSE_FROM_DENSE] = "sparse_from_dense",
+    [SPARSE_TO_DENSE] = "sparse_to_dense",
+    [STAGE_APPEND_RAW] = "stage_append_raw",
+    [STAGE_READ_RAW] = "stage_read_raw",
+    [STORE_READ_RAW] = "store_read_raw",
+    [STATS] = "stats",
+    [GEMM] = "gemm",
+    [SYRK] = "syrk",
+    [STAGE_APPEND_PACKED] = "stage_append_packed",
+    [STAGE_READ_PACKED] = "stage_read_packed",
+    [STORE_READ_PACKED] = "store_read_packed",
+    [SHM_ATTACH] = "shm_attach",
+    [SHM_DETACH] = "shm_detach",
+    [SHM_APPLY] = "shm_apply",
+    [SOLVE_CG] = "solve_cg",
+    [SOLVE_GMRES] = "solve_gmres",
+    [MATRIX_QR] = "matrix_qr",
+    [MATRIX_LSTSQ] = "matrix_lstsq",
+    [STORE_QR] = "store_qr",
+};
+
+static int bucket_of(double us) {
+    int b = 0;
+    while (b < STATS_BUCKETS - 1 && us >= (double)((uint64_t)1 << b)) b++;
+    return b;
+}
+
+/* Only the owning thread writes a shard; the store is atomic for readers */
+static void bump(uint64_t *counter, uint64_t by) {
+    __atomic_store_n(counter, *counter + by, __ATOMIC_RELAXED);
+}
+
+static stats_shard *shard(void) {
+    if (!own_shard) {
+        stats_shard *s = (stats_shard *)calloc(1, sizeof(stats_shard));
+        if (!s) return NULL;
+        pthread_mutex_lock(&registry_lock);
+        s->next = shards;
+        shards = s;
+        pthread_mutex_unlock(&registry_lock);
+        own_shard = s;
+    }
+    return own_shard;
+}
+
+static bool_t timed_getargs(SVCXPRT *transp, xdrproc_t xargs, void *argsp) {
+    bool_t ok = current.real_ops->xp_getargs(transp, xargs, argsp);
+    current.args_done = stats_clock_us();
+    if (ok) current.bytes_in = xdr_sizeof(xargs, argsp);
+    else current.failed = 1;
+    return ok;
+}
+
+static bool_t timed_reply(SVCXPRT *transp, struct rpc_msg *msg) {
+    current.reply_start = stats_clock_us();
+    if (msg->rm_reply.rp_stat != MSG_ACCEPTED || msg->acpted_rply.ar_stat != SUCCESS) {
+        current.failed = 1;
+    } else if (msg->acpted_rply.ar_results.where) {
+        void *where = msg->acpted_rply.ar_results.where;
+        current.bytes_out = xdr_sizeof(msg->acpted_rply.ar_results.proc, where);
+        if (reports_success(current.proc) && *(int *)where == 0) current.failed = 1;
+    }
+    bool_t ok = current.real_ops->xp_reply(transp, msg);
+    current.reply_done = stats_clock_us();
+    return ok;
+}
+
+void stats_record_codec(size_t raw_bytes, size_t packed_bytes, double elapsed_us) {
+    current.codec_raw += raw_bytes;
+    current.codec_packed += packed_bytes;
+    current.codec_us += elapsed_us;
+}
+
+void stats_dispatch(struct svc_req *rqstp, SVCXPRT *transp, stats_dispatch_fn dispatch) {
+    const struct xp_ops *real_ops = transp->xp_ops;
+
+    /* The transport belongs to this thread until dispatch returns, so its ops can be swapped */
+    memset(&current, 0, sizeof(current));
+    current.real_ops = real_ops;
+    current.timed_ops = *real_ops;
+    current.timed_ops.xp_getargs = timed_getargs;
+    current.timed_ops.xp_reply = timed_reply;
+    current.proc = rqstp->rq_proc;
+    current.start = stats_clock_us();
+    current.args_done = current.start;
+    transp->xp_ops = &current.timed_ops;
+
+    dispatch(rqstp, transp);
+
+    transp->xp_ops = real_ops;
+    stats_shard *s = shard();
+    if (!s || current.proc > STATS_MAX_PROC) return;
+
+    /* No reply (e.g. a batched call) leaves compute running to the end */
+    double end = stats_clock_us();
+    if (!current.reply_start) current.reply_start = current.reply_done = end;
+
+    proc_counters *c = &s->procs[current.proc];
+    bump(&c->calls, 1);
+    if (current.failed) bump(&c->errors, 1);
+    bump(&c->bytes_in, current.bytes_in);
+    bump(&c->bytes_out, current.bytes_out);
+    if (current.codec_raw) {
+        bump(&c->codec_raw, current.codec_raw);
+        bump(&c->codec_packed, current.codec_packed);
+        bump(&c->codec_us, (uint64_t)current.codec_us);
+    }
+    bump(&c->latency[PHASE_DECODE][bucket_of(current.args_done - current.start)], 1);
+    bump(&c->latency[PHASE_COMPUTE][bucket_of(current.reply_start - current.args_done)], 1);
+    bump(&c->latency[PHASE_ENCODE][bucket_of(current.reply_done - current.reply_start)], 1);
+}
+
+static void add_counters(proc_counters *into, const proc_counters *from) {
+    const uint64_t *src = (const uint64_t *)from;
+    uint64_t *dst = (uint64_t *)into;
+    for (size_t i = 0; i < sizeof(proc_counters) / sizeof(uint64_t); i++) {
+        dst[i] += __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+    }
+}
+
+void stats_snapshot(server_stats *out, proc_stats *procs, int reset) {
+    static proc_counters totals[STATS_MAX_PROC + 1];
+    double now = stats_clock_us();
+
+    pthread_mutex_lock(&registry_lock);
+    memset(totals, 0, sizeof(totals));
+    for (stats_shard *s = shards; s; s = s->next) {
+        for (int p = 0; p <= STATS_MAX_PROC; p++) add_counters(&totals[p], &s->procs[p]);
+    }
+
+    int count = 0;
+    for (int p = 0; p <= STATS_MAX_PROC; p++) {
+        const uint64_t *total = (const uint64_t *)&totals[p];
+        uint64_t *base = (uint64_t *)&baseline[p];
+        proc_counters delta;
+        uint64_t *d = (uint64_t *)&delta;
+        for (size_t i = 0; i < sizeof(proc_counters) / sizeof(uint64_t); i++) {
+            d[i] = total[i] - base[i];
+            if (reset) base[i] = total[i];
+        }
+        if (delta.calls == 0) continue;
+
+        proc_stats *ps = &procs[count++];
+        ps->proc = p;
+        ps->name = (char *)(proc_names[p] ? proc_names[p] : "unknown");
+        ps->calls = delta.calls;
+        ps->errors = delta.errors;
+        ps->bytes_in = delta.bytes_in;
+        ps->bytes_out = delta.bytes_out;
+        memcpy(ps->decode_us, delta.latency[PHASE_DECODE], sizeof(ps->decode_us));
+        memcpy(ps->compute_us, delta.latency[PHASE_COMPUTE], sizeof(ps->compute_us));
+        memcpy(ps->encode_us, delta.latency[PHASE_ENCODE], sizeof(ps->encode_us));
+        ps->codec_raw_bytes = delta.codec_raw;
+        ps->codec_packed_bytes = delta.codec_packed;
+        ps->codec_us = delta.codec_us;
+    }
+
+    out->elapsed_ms = (uint64_t)((now - reset_time) / 1000.0);
+    if (reset) reset_time = now;
+    pthread_mutex_unlock(&registry_lock);
+
+    out->procs.procs_len = count;
+    out->procs.procs_val = procs;
+}
@@ -0,0 +1,36 @@
+/*
+ * matrixOp_stats.h - Per-procedure call counters and latency histograms
+ */
+
+#ifndef MATRIXOP_STATS_H
+#define MATRIXOP_STATS_H
+
+#include "matrixOp.h"
+
+/* Highest procedure number tracked; calls above it are not counted */
+#define STATS_MAX_PROC (MAX_STATS_PROCS - 1)
+
+typedef void (*stats_dispatch_fn)(struct svc_req *rqstp, SVCXPRT *transp);
+
+/*
+ * Run a generated dispatcher and record the call: decode time is spent in
+ * svc_getargs, encode time in the reply, compute time in between. Counters
+ * live in a shard owned by the calling thread, so recording takes no lock.
+ */
+void stats_dispatch(struct svc_req *rqstp, SVCXPRT *transp, stats_dispatch_fn dispatch);
+
+/* Monotonic clock in microseconds */
+double stats_clock_us(void);
+
+/* Account a payload compressed or decompressed while serving the current call */
+void stats_record_codec(size_t raw_bytes, size_t packed_bytes, double elapsed_us);
+
+/*
+ * Fill out with the counters accumulated since start or the last reset,
+ * for procedures called at least once. procs needs room for
+ * STATS_MAX_PROC + 1 entries and backs out->procs. With reset set,
+ * counting starts over after this snapshot.
+ */
+void stats_snapshot(server_stats *out, proc_stats *procs, int reset);
+
+#endif /* MATRIXOP_STATS_H */
@@ -0,0 +1,151 @@
+/*
+ * matrixOp_store.c - Server-resident matrices addressed by handle, evicted LRU under a memory budget
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "matrixOp_store.h"
+
+#define STORE_BUCKETS 1024
+
+/*
+ * store_lock guards the hash table, the LRU list and the byte count.
+ * Matrix data is immutable once stored, so pinned entries are read
+ * without the lock.
+ */
+static pthread_mutex_t store_lock = PTHREAD_MUTEX_INITIALIZER;
+static store_entry *buckets[STORE_BUCKETS];
+static store_entry *lru_head;   /* most recently used */
+static store_entry *lru_tail;
+static size_t used_bytes;
+static size_t budget_bytes = (size_t)STORE_DEFAULT_BUDGET_MB << 20;
+static int next_handle = 1;
+
+static store_entry **bucket_of(int handle) {
+    return &buckets[(unsigned int)handle % STORE_BUCKETS];
+}
+
+static void lru_unlink(store_entry *e) {
+    if (e->lru_prev) e->lru_prev->lru_next = e->lru_next;
+    else lru_head = e->lru_next;
+    if (e->lru_next) e->lru_next->lru_prev = e->lru_prev;
+    else lru_tail = e->lru_prev;
+    e->lru_prev = e->lru_next = NULL;
+}
+
+static void lru_push_front(store_entry *e) {
+    e->lru_prev = NULL;
+    e->lru_next = lru_head;
+    if (lru_head) lru_head->lru_prev = e;
+    lru_head = e;
+    if (!lru_tail) lru_tail = e;
+}
+
+static void destroy(store_entry *e) {
+    used_bytes -= e->bytes;
+    free(e->data);
+    free(e);
+}
+
+/* Take an entry out of the table and LRU list; its memory goes once nobody reads it */
+static void detach(store_entry *e) {
+    store_entry **link = bucket_of(e->handle);
+    while (*link != e) link = &(*link)->hash_next;
+    *link = e->hash_next;
+    lru_unlink(e);
+
+    if (e->pins > 0) {
+        e->removed = 1;
+    } else {
+        destroy(e);
+    }
+}
+
+static store_entry *find(int handle) {
+    store_entry *e = *bucket_of(handle);
+    while (e && e->handle != handle) e = e->hash_next;
+    return e;
+}
+
+/* Evict idle matrices from the cold end until bytes more fit; caller holds store_lock */
+static int make_room(size_t bytes) {
+    store_entry *e = lru_tail;
+    while (used_bytes + bytes > budget_bytes && e) {
+        store_entry *prev = e->lru_prev;
+        if (e->pins == 0) detach(e);
+        e = prev;
+    }
+    return used_bytes + bytes <= budget_bytes;
+}
+
+void store_set_budget(size_t bytes) {
+    pthread_mutex_lock(&store_lock);
+    budget_bytes = bytes;
+    make_room(0);
+    pthread_mutex_unlock(&store_lock);
+}
+
+int store_insert(int rows, int cols, double *data) {
+    size_t bytes = (size_t)rows * cols * sizeof(double);
+    store_entry *e = (store_entry *)calloc(1, sizeof(store_entry));
+    if (!e) return 0;
+
+    pthread_mutex_lock(&store_lock);
+    if (bytes > budget_bytes || !make_room(bytes)) {
+        pthread_mutex_unlock(&store_lock);
+        free(e);
+        return 0;
+    }
+
+    /* Handles are positive and never reused while the counter has not wrapped */
+    do {
+        e->handle = next_handle++;
+        if (next_handle <= 0) next_handle = 1;
+    } while (find(e->handle));
+
+    e->rows = rows;
+    e->cols = cols;
+    e->data = data;
+    e->bytes = bytes;
+    e->hash_next = *bucket_of(e->handle);
+    *bucket_of(e->handle) = e;
+    lru_push_front(e);
+    used_bytes += bytes;
+
+    int handle = e->handle;
+    pthread_mutex_unlock(&store_lock);
+    return handle;
+}
+
+store_entry *store_acquire(int handle) {
+    if (handle <= 0) return NULL;
+
+    pthread_mutex_lock(&store_lock);
+    store_entry *e = find(handle);
+    if (e) {
+        e->pins++;
+        lru_unlink(e);
+        lru_push_front(e);
+    }
+    pthread_mutex_unlock(&store_lock);
+    return e;
+}
+
+void store_release(store_entry *entry) {
+    pthread_mutex_lock(&store_lock);
+    entry->pins--;
+    if (entry->pins == 0 && entry->removed) {
+        destroy(entry);
+    }
+    pthread_mutex_unlock(&store_lock);
+}
+
+int store_remove(int handle) {
+    if (handle <= 0) return 0;
+
+    pthread_mutex_lock(&store_lock);
+    store_entry *e = find(handle);
+    if (e) detach(e);
+    pthread_mutex_unlock(&store_lock);
+    return e != NULL;
+}
@@ -0,0 +1,45 @@
+/*
+ * matrixOp_store.h - Server-resident matrices addressed by handle, evicted LRU under a memory budget
+ */
+
+#ifndef MATRIXOP_STORE_H
+#define MATRIXOP_STORE_H
+
+#include <stddef.h>
+
+/* Default memory budget for stored matrix data */
+#define STORE_DEFAULT_BUDGET_MB 512
+
+typedef struct store_entry {
+    int handle;
+    int rows;
+    int cols;
+    double *data;           /* rows x cols, row-major; read-only while stored */
+    size_t bytes;
+    int pins;               /* operations currently reading data */
+    int removed;            /* freed or evicted while pinned; released on last unpin */
+    struct store_entry *lru_prev;   /* towards most recently used */
+    struct store_entry *lru_next;
+    struct store_entry *hash_next;
+} store_entry;
+
+/* Cap on the bytes of matrix data the store keeps */
+void store_set_budget(size_t bytes);
+
+/*
+ * Take ownership of a malloc'd rows x cols buffer and return its new handle.
+ * Least recently used matrices that are not in use are evicted to make room.
+ * Returns 0 (and leaves data with the caller) if it cannot fit in the budget.
+ */
+int store_insert(int rows, int cols, double *data);
+
+/* Pin a stored matrix so it survives eviction while in use; NULL if unknown or evicted */
+store_entry *store_acquire(int handle);
+
+/* Unpin a matrix returned by store_acquire */
+void store_release(store_entry *entry);
+
+/* Release a handle; returns 0 if it is unknown or was already evicted */
+int store_remove(int handle);
+
+#endif /* MATRIXOP_STORE_H */
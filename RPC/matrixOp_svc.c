@@ -16,7 +16,7 @@
 #define SIG_PF void(*)(int)
 #endif
 
-static void
+void
 matrix_operations_prog_1(struct svc_req *rqstp, register SVCXPRT *transp)
 {
 	union {
@@ -24,6 +24,29 @@ matrix_operations_prog_1(struct svc_req *rqstp, register SVCXPRT *transp)
 		matrix_pair matrix_mult_1_arg;
 		matrix matrix_inverse_1_arg;
 		matrix matrix_transpose_1_arg;
+		stage_request stage_begin_1_arg;
+		stage_tile stage_append_1_arg;
+		int stage_commit_1_arg;
+		stage_range stage_read_1_arg;
+		int stage_end_1_arg;
+		matrix store_put_1_arg;
+		int store_adopt_1_arg;
+		handle_op store_apply_1_arg;
+		handle_range store_read_1_arg;
+		int store_free_1_arg;
+		expr_request evaluate_1_arg;
+		matrix matrix_lu_1_arg;
+		matrix_pair matrix_solve_1_arg;
+		matrix matrix_det_1_arg;
+		matrix32_pair matrix_mult32_1_arg;
+		stage_tile32 stage_append32_1_arg;
+		stage_range stage_read32_1_arg;
+		sparse_vector sparse_mv_1_arg;
+		csr_pair sparse_mult_1_arg;
+		csr_matrix sparse_transpose_1_arg;
+		sparse_dense_op sparse_mult_dense_1_arg;
+		int sparse_from_dense_1_arg;
+		csr_matrix sparse_to_dense_1_arg;
 	} argument;
 	char *result;
 	xdrproc_t _xdr_argument, _xdr_result;
@@ -64,6 +87,150 @@ matrix_operations_prog_1(struct svc_req *rqstp, register SVCXPRT *transp)
 		local = (char *(*)(char *, struct svc_req *)) ping_1_svc;
 		break;
 
+	case STAGE_BEGIN:
+		_xdr_argument = (xdrproc_t) xdr_stage_request;
+		_xdr_result = (xdrproc_t) xdr_stage_status;
+		local = (char *(*)(char *, struct svc_req *)) stage_begin_1_svc;
+		break;
+
+	case STAGE_APPEND:
+		_xdr_argument = (xdrproc_t) xdr_stage_tile;
+		_xdr_result = (xdrproc_t) xdr_stage_status;
+		local = (char *(*)(char *, struct svc_req *)) stage_append_1_svc;
+		break;
+
+	case STAGE_COMMIT:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_stage_status;
+		local = (char *(*)(char *, struct svc_req *)) stage_commit_1_svc;
+		break;
+
+	case STAGE_READ:
+		_xdr_argument = (xdrproc_t) xdr_stage_range;
+		_xdr_result = (xdrproc_t) xdr_stage_rows;
+		local = (char *(*)(char *, struct svc_req *)) stage_read_1_svc;
+		break;
+
+	case STAGE_END:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_int;
+		local = (char *(*)(char *, struct svc_req *)) stage_end_1_svc;
+		break;
+
+	case STORE_PUT:
+		_xdr_argument = (xdrproc_t) xdr_matrix;
+		_xdr_result = (xdrproc_t) xdr_handle_result;
+		local = (char *(*)(char *, struct svc_req *)) store_put_1_svc;
+		break;
+
+	case STORE_ADOPT:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_handle_result;
+		local = (char *(*)(char *, struct svc_req *)) store_adopt_1_svc;
+		break;
+
+	case STORE_APPLY:
+		_xdr_argument = (xdrproc_t) xdr_handle_op;
+		_xdr_result = (xdrproc_t) xdr_handle_result;
+		local = (char *(*)(char *, struct svc_req *)) store_apply_1_svc;
+		break;
+
+	case STORE_READ:
+		_xdr_argument = (xdrproc_t) xdr_handle_range;
+		_xdr_result = (xdrproc_t) xdr_stage_rows;
+		local = (char *(*)(char *, struct svc_req *)) store_read_1_svc;
+		break;
+
+	case STORE_FREE:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_int;
+		local = (char *(*)(char *, struct svc_req *)) store_free_1_svc;
+		break;
+
+	case EVALUATE:
+		_xdr_argument = (xdrproc_t) xdr_expr_request;
+		_xdr_result = (xdrproc_t) xdr_expr_result;
+		local = (char *(*)(char *, struct svc_req *)) evaluate_1_svc;
+		break;
+
+	case MATRIX_LU:
+		_xdr_argument = (xdrproc_t) xdr_matrix;
+		_xdr_result = (xdrproc_t) xdr_lu_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_lu_1_svc;
+		break;
+
+	case MATRIX_SOLVE:
+		_xdr_argument = (xdrproc_t) xdr_matrix_pair;
+		_xdr_result = (xdrproc_t) xdr_matrix_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_solve_1_svc;
+		break;
+
+	case MATRIX_DET:
+		_xdr_argument = (xdrproc_t) xdr_matrix;
+		_xdr_result = (xdrproc_t) xdr_det_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_det_1_svc;
+		break;
+
+	case CACHE_STATS:
+		_xdr_argument = (xdrproc_t) xdr_void;
+		_xdr_result = (xdrproc_t) xdr_cache_stats;
+		local = (char *(*)(char *, struct svc_req *)) cache_stats_1_svc;
+		break;
+
+	case MATRIX_MULT32:
+		_xdr_argument = (xdrproc_t) xdr_matrix32_pair;
+		_xdr_result = (xdrproc_t) xdr_matrix32_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_mult32_1_svc;
+		break;
+
+	case STAGE_APPEND32:
+		_xdr_argument = (xdrproc_t) xdr_stage_tile32;
+		_xdr_result = (xdrproc_t) xdr_stage_status;
+		local = (char *(*)(char *, struct svc_req *)) stage_append32_1_svc;
+		break;
+
+	case STAGE_READ32:
+		_xdr_argument = (xdrproc_t) xdr_stage_range;
+		_xdr_result = (xdrproc_t) xdr_stage_rows32;
+		local = (char *(*)(char *, struct svc_req *)) stage_read32_1_svc;
+		break;
+
+	case SPARSE_MV:
+		_xdr_argument = (xdrproc_t) xdr_sparse_vector;
+		_xdr_result = (xdrproc_t) xdr_vector_result;
+		local = (char *(*)(char *, struct svc_req *)) sparse_mv_1_svc;
+		break;
+
+	case SPARSE_MULT:
+		_xdr_argument = (xdrproc_t) xdr_csr_pair;
+		_xdr_result = (xdrproc_t) xdr_csr_result;
+		local = (char *(*)(char *, struct svc_req *)) sparse_mult_1_svc;
+		break;
+
+	case SPARSE_TRANSPOSE:
+		_xdr_argument = (xdrproc_t) xdr_csr_matrix;
+		_xdr_result = (xdrproc_t) xdr_csr_result;
+		local = (char *(*)(char *, struct svc_req *)) sparse_transpose_1_svc;
+		break;
+
+	case SPARSE_MULT_DENSE:
+		_xdr_argument = (xdrproc_t) xdr_sparse_dense_op;
+		_xdr_result = (xdrproc_t) xdr_handle_result;
+		local = (char *(*)(char *, struct svc_req *)) sparse_mult_dense_1_svc;
+		break;
+
+	case SPARSE_FROM_DENSE:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_csr_result;
+		local = (char *(*)(char *, struct svc_req *)) sparse_from_dense_1_svc;
+		break;
+
+	case SPARSE_TO_DENSE:
+		_xdr_argument = (xdrproc_t) xdr_csr_matrix;
+		_xdr_result = (xdrproc_t) xdr_handle_result;
+		local = (char *(*)(char *, struct svc_req *)) sparse_to_dense_1_svc;
+		break;
+
 	default:
 		svcerr_noproc (transp);
 		return;
@@ -84,35 +251,356 @@ matrix_operations_prog_1(struct svc_req *rqstp, register SVCXPRT *transp)
 	return;
 }
 
-int
-main (int argc, char **argv)
+void
+matrix_operations_prog_2(struct svc_req *rqstp, register SVCXPRT *transp)
 {
-	register SVCXPRT *transp;
+	union {
+		matrix_pair matrix_add_2_arg;
+		matrix_pair matrix_mult_2_arg;
+		matrix matrix_inverse_2_arg;
+		matrix matrix_transpose_2_arg;
+		stage_request stage_begin_2_arg;
+		stage_tile stage_append_2_arg;
+		int stage_commit_2_arg;
+		stage_range stage_read_2_arg;
+		int stage_end_2_arg;
+		matrix store_put_2_arg;
+		int store_adopt_2_arg;
+		handle_op store_apply_2_arg;
+		handle_range store_read_2_arg;
+		int store_free_2_arg;
+		expr_request evaluate_2_arg;
+		matrix matrix_lu_2_arg;
+		matrix_pair matrix_solve_2_arg;
+		matrix matrix_det_2_arg;
+		matrix32_pair matrix_mult32_2_arg;
+		stage_tile32 stage_append32_2_arg;
+		stage_range stage_read32_2_arg;
+		sparse_vector sparse_mv_2_arg;
+		csr_pair sparse_mult_2_arg;
+		csr_matrix sparse_transpose_2_arg;
+		sparse_dense_op sparse_mult_dense_2_arg;
+		int sparse_from_dense_2_arg;
+		csr_matrix sparse_to_dense_2_arg;
+		stage_tile_raw stage_append_raw_2_arg;
+		stage_range stage_read_raw_2_arg;
+		handle_range store_read_raw_2_arg;
+		int stats_2_arg;
+		gemm_request gemm_2_arg;
+		syrk_request syrk_2_arg;
+		stage_tile_packed stage_append_packed_2_arg;
+		packed_range stage_read_packed_2_arg;
+		packed_range store_read_packed_2_arg;
+		char *shm_attach_2_arg;
+		int shm_detach_2_arg;
+		shm_request shm_apply_2_arg;
+		krylov_request solve_cg_2_arg;
+		krylov_request solve_gmres_2_arg;
+		matrix matrix_qr_2_arg;
+		matrix_pair matrix_lstsq_2_arg;
+		int store_qr_2_arg;
+	} argument;
+	char *result;
+	xdrproc_t _xdr_argument, _xdr_result;
+	char *(*local)(char *, struct svc_req *);
+
+	switch (rqstp->rq_proc) {
+	case NULLPROC:
+		(void) svc_sendreply (transp, (xdrproc_t) xdr_void, (char *)NULL);
+		return;
+
+	case MATRIX_ADD:
+		_xdr_argument = (xdrproc_t) xdr_matrix_pair;
+		_xdr_result = (xdrproc_t) xdr_matrix_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_add_2_svc;
+		break;
+
+	case MATRIX_MULT:
+		_xdr_argument = (xdrproc_t) xdr_matrix_pair;
+		_xdr_result = (xdrproc_t) xdr_matrix_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_mult_2_svc;
+		break;
+
+	case MATRIX_INVERSE:
+		_xdr_argument = (xdrproc_t) xdr_matrix;
+		_xdr_result = (xdrproc_t) xdr_matrix_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_inverse_2_svc;
+		break;
+
+	case MATRIX_TRANSPOSE:
+		_xdr_argument = (xdrproc_t) xdr_matrix;
+		_xdr_result = (xdrproc_t) xdr_matrix_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_transpose_2_svc;
+		break;
+
+	case PING:
+		_xdr_argument = (xdrproc_t) xdr_void;
+		_xdr_result = (xdrproc_t) xdr_int;
+		local = (char *(*)(char *, struct svc_req *)) ping_2_svc;
+		break;
+
+	case STAGE_BEGIN:
+		_xdr_argument = (xdrproc_t) xdr_stage_request;
+		_xdr_result = (xdrproc_t) xdr_stage_status;
+		local = (char *(*)(char *, struct svc_req *)) stage_begin_2_svc;
+		break;
+
+	case STAGE_APPEND:
+		_xdr_argument = (xdrproc_t) xdr_stage_tile;
+		_xdr_result = (xdrproc_t) xdr_stage_status;
+		local = (char *(*)(char *, struct svc_req *)) stage_append_2_svc;
+		break;
+
+	case STAGE_COMMIT:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_stage_status;
+		local = (char *(*)(char *, struct svc_req *)) stage_commit_2_svc;
+		break;
+
+	case STAGE_READ:
+		_xdr_argument = (xdrproc_t) xdr_stage_range;
+		_xdr_result = (xdrproc_t) xdr_stage_rows;
+		local = (char *(*)(char *, struct svc_req *)) stage_read_2_svc;
+		break;
+
+	case STAGE_END:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_int;
+		local = (char *(*)(char *, struct svc_req *)) stage_end_2_svc;
+		break;
+
+	case STORE_PUT:
+		_xdr_argument = (xdrproc_t) xdr_matrix;
+		_xdr_result = (xdrproc_t) xdr_handle_result;
+		local = (char *(*)(char *, struct svc_req *)) store_put_2_svc;
+		break;
+
+	case STORE_ADOPT:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_handle_result;
+		local = (char *(*)(char *, struct svc_req *)) store_adopt_2_svc;
+		break;
+
+	case STORE_APPLY:
+		_xdr_argument = (xdrproc_t) xdr_handle_op;
+		_xdr_result = (xdrproc_t) xdr_handle_result;
+		local = (char *(*)(char *, struct svc_req *)) store_apply_2_svc;
+		break;
+
+	case STORE_READ:
+		_xdr_argument = (xdrproc_t) xdr_handle_range;
+		_xdr_result = (xdrproc_t) xdr_stage_rows;
+		local = (char *(*)(char *, struct svc_req *)) store_read_2_svc;
+		break;
+
+	case STORE_FREE:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_int;
+		local = (char *(*)(char *, struct svc_req *)) store_free_2_svc;
+		break;
+
+	case EVALUATE:
+		_xdr_argument = (xdrproc_t) xdr_expr_request;
+		_xdr_result = (xdrproc_t) xdr_expr_result;
+		local = (char *(*)(char *, struct svc_req *)) evaluate_2_svc;
+		break;
+
+	case MATRIX_LU:
+		_xdr_argument = (xdrproc_t) xdr_matrix;
+		_xdr_result = (xdrproc_t) xdr_lu_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_lu_2_svc;
+		break;
+
+	case MATRIX_SOLVE:
+		_xdr_argument = (xdrproc_t) xdr_matrix_pair;
+		_xdr_result = (xdrproc_t) xdr_matrix_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_solve_2_svc;
+		break;
+
+	case MATRIX_DET:
+		_xdr_argument = (xdrproc_t) xdr_matrix;
+		_xdr_result = (xdrproc_t) xdr_det_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_det_2_svc;
+		break;
+
+	case CACHE_STATS:
+		_xdr_argument = (xdrproc_t) xdr_void;
+		_xdr_result = (xdrproc_t) xdr_cache_stats;
+		local = (char *(*)(char *, struct svc_req *)) cache_stats_2_svc;
+		break;
+
+	case MATRIX_MULT32:
+		_xdr_argument = (xdrproc_t) xdr_matrix32_pair;
+		_xdr_result = (xdrproc_t) xdr_matrix32_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_mult32_2_svc;
+		break;
+
+	case STAGE_APPEND32:
+		_xdr_argument = (xdrproc_t) xdr_stage_tile32;
+		_xdr_result = (xdrproc_t) xdr_stage_status;
+		local = (char *(*)(char *, struct svc_req *)) stage_append32_2_svc;
+		break;
+
+	case STAGE_READ32:
+		_xdr_argument = (xdrproc_t) xdr_stage_range;
+		_xdr_result = (xdrproc_t) xdr_stage_rows32;
+		local = (char *(*)(char *, struct svc_req *)) stage_read32_2_svc;
+		break;
+
+	case SPARSE_MV:
+		_xdr_argument = (xdrproc_t) xdr_sparse_vector;
+		_xdr_result = (xdrproc_t) xdr_vector_result;
+		local = (char *(*)(char *, struct svc_req *)) sparse_mv_2_svc;
+		break;
+
+	case SPARSE_MULT:
+		_xdr_argument = (xdrproc_t) xdr_csr_pair;
+		_xdr_result = (xdrproc_t) xdr_csr_result;
+		local = (char *(*)(char *, struct svc_req *)) sparse_mult_2_svc;
+		break;
+
+	case SPARSE_TRANSPOSE:
+		_xdr_argument = (xdrproc_t) xdr_csr_matrix;
+		_xdr_result = (xdrproc_t) xdr_csr_result;
+		local = (char *(*)(char *, struct svc_req *)) sparse_transpose_2_svc;
+		break;
+
+	case SPARSE_MULT_DENSE:
+		_xdr_argument = (xdrproc_t) xdr_sparse_dense_op;
+		_xdr_result = (xdrproc_t) xdr_handle_result;
+		local = (char *(*)(char *, struct svc_req *)) sparse_mult_dense_2_svc;
+		break;
+
+	case SPARSE_FROM_DENSE:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_csr_result;
+		local = (char *(*)(char *, struct svc_req *)) sparse_from_dense_2_svc;
+		break;
+
+	case SPARSE_TO_DENSE:
+		_xdr_argument = (xdrproc_t) xdr_csr_matrix;
+		_xdr_result = (xdrproc_t) xdr_handle_result;
+		local = (char *(*)(char *, struct svc_req *)) sparse_to_dense_2_svc;
+		break;
+
+	case STAGE_APPEND_RAW:
+		_xdr_argument = (xdrproc_t) xdr_stage_tile_raw;
+		_xdr_result = (xdrproc_t) xdr_stage_status;
+		local = (char *(*)(char *, struct svc_req *)) stage_append_raw_2_svc;
+		break;
+
+	case STAGE_READ_RAW:
+		_xdr_argument = (xdrproc_t) xdr_stage_range;
+		_xdr_result = (xdrproc_t) xdr_stage_rows_raw;
+		local = (char *(*)(char *, struct svc_req *)) stage_read_raw_2_svc;
+		break;
+
+	case STORE_READ_RAW:
+		_xdr_argument = (xdrproc_t) xdr_handle_range;
+		_xdr_result = (xdrproc_t) xdr_stage_rows_raw;
+		local = (char *(*)(char *, struct svc_req *)) store_read_raw_2_svc;
+		break;
+
+	case STATS:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_server_stats;
+		local = (char *(*)(char *, struct svc_req *)) stats_2_svc;
+		break;
+
+	case GEMM:
+		_xdr_argument = (xdrproc_t) xdr_gemm_request;
+		_xdr_result = (xdrproc_t) xdr_handle_result;
+		local = (char *(*)(char *, struct svc_req *)) gemm_2_svc;
+		break;
+
+	case SYRK:
+		_xdr_argument = (xdrproc_t) xdr_syrk_request;
+		_xdr_result = (xdrproc_t) xdr_handle_result;
+		local = (char *(*)(char *, struct svc_req *)) syrk_2_svc;
+		break;
+
+	case STAGE_APPEND_PACKED:
+		_xdr_argument = (xdrproc_t) xdr_stage_tile_packed;
+		_xdr_result = (xdrproc_t) xdr_stage_status;
+		local = (char *(*)(char *, struct svc_req *)) stage_append_packed_2_svc;
+		break;
+
+	case STAGE_READ_PACKED:
+		_xdr_argument = (xdrproc_t) xdr_packed_range;
+		_xdr_result = (xdrproc_t) xdr_stage_rows_packed;
+		local = (char *(*)(char *, struct svc_req *)) stage_read_packed_2_svc;
+		break;
+
+	case STORE_READ_PACKED:
+		_xdr_argument = (xdrproc_t) xdr_packed_range;
+		_xdr_result = (xdrproc_t) xdr_stage_rows_packed;
+		local = (char *(*)(char *, struct svc_req *)) store_read_packed_2_svc;
+		break;
+
+	case SHM_ATTACH:
+		_xdr_argument = (xdrproc_t) xdr_wrapstring;
+		_xdr_result = (xdrproc_t) xdr_shm_attach_result;
+		local = (char *(*)(char *, struct svc_req *)) shm_attach_2_svc;
+		break;
+
+	case SHM_DETACH:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_int;
+		local = (char *(*)(char *, struct svc_req *)) shm_detach_2_svc;
+		break;
+
+	case SHM_APPLY:
+		_xdr_argument = (xdrproc_t) xdr_shm_request;
+		_xdr_result = (xdrproc_t) xdr_shm_result;
+		local = (char *(*)(char *, struct svc_req *)) shm_apply_2_svc;
+		break;
+
+	case SOLVE_CG:
+		_xdr_argument = (xdrproc_t) xdr_krylov_request;
+		_xdr_result = (xdrproc_t) xdr_krylov_result;
+		local = (char *(*)(char *, struct svc_req *)) solve_cg_2_svc;
+		break;
+
+	case SOLVE_GMRES:
+		_xdr_argument = (xdrproc_t) xdr_krylov_request;
+		_xdr_result = (xdrproc_t) xdr_krylov_result;
+		local = (char *(*)(char *, struct svc_req *)) solve_gmres_2_svc;
+		break;
+
+	case MATRIX_QR:
+		_xdr_argument = (xdrproc_t) xdr_matrix;
+		_xdr_result = (xdrproc_t) xdr_qr_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_qr_2_svc;
+		break;
 
-	pmap_unset (MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS);
+	case MATRIX_LSTSQ:
+		_xdr_argument = (xdrproc_t) xdr_matrix_pair;
+		_xdr_result = (xdrproc_t) xdr_matrix_result;
+		local = (char *(*)(char *, struct svc_req *)) matrix_lstsq_2_svc;
+		break;
 
-	transp = svcudp_create(RPC_ANYSOCK);
-	if (transp == NULL) {
-		fprintf (stderr, "%s", "cannot create udp service.");
-		exit(1);
+	case STORE_QR:
+		_xdr_argument = (xdrproc_t) xdr_int;
+		_xdr_result = (xdrproc_t) xdr_qr_handles;
+		local = (char *(*)(char *, struct svc_req *)) store_qr_2_svc;
+		break;
+
+	default:
+		svcerr_noproc (transp);
+		return;
 	}
-	if (!svc_register(transp, MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS, matrix_operations_prog_1, IPPROTO_UDP)) {
-		fprintf (stderr, "%s", "unable to register (MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS, udp).");
-		exit(1);
+	memset ((char *)&argument, 0, sizeof (argument));
+	if (!svc_getargs (transp, (xdrproc_t) _xdr_argument, (caddr_t) &argument)) {
+		svcerr_decode (transp);
+		return;
 	}
-
-	transp = svctcp_create(RPC_ANYSOCK, 0, 0);
-	if (transp == NULL) {
-		fprintf (stderr, "%s", "cannot create tcp service.");
-		exit(1);
+	result = (*local)((char *)&argument, rqstp);
+	if (result != NULL && !svc_sendreply(transp, (xdrproc_t) _xdr_result, result)) {
+		svcerr_systemerr (transp);
 	}
-	if (!svc_register(transp, MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS, matrix_operations_prog_1, IPPROTO_TCP)) {
-		fprintf (stderr, "%s", "unable to register (MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS, tcp).");
-		exit(1);
+	if (!svc_freeargs (transp, (xdrproc_t) _xdr_argument, (caddr_t) &argument)) {
+		fprintf (stderr, "%s", "unable to free arguments");
+		exit (1);
 	}
-
-	svc_run ();
-	fprintf (stderr, "%s", "svc_run returned");
-	exit (1);
-	/* NOTREACHED */
+	return;
 }
@@ -0,0 +1,455 @@
+/*
+ * matrixOp_svc_main.c - Server entry point: transport registration and request loop
+ *
+ * By default the server runs the stock single-threaded svc_run(). With -t N
+ * the main thread accepts TCP connections and polls them itself, handing
+ * each readable connection to one of N worker threads. The worker decodes
+ * the request, runs the procedure and sends the reply. A connection is taken
+ * out of the poll set while a worker owns it, so one transport is never read
+ * and written by two threads at once, while different clients are served in
+ * parallel. The UDP socket is one transport, so UDP requests stay serial.
+ * Either way every call passes through stats_dispatch, which feeds the
+ * STATS procedure.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <rpc/pmap_clnt.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "matrixOp.h"
+#include "matrixOp_store.h"
+#include "matrixOp_cache.h"
+#include "matrixOp_stats.h"
+#include "matrixOp_kernels.h"
+#include "matrixOp_backend.h"
+#include "matrixOp_stage.h"
+
+/* Generated by rpcgen -m in matrixOp_svc.c */
+extern void matrix_operations_prog_1(struct svc_req *rqstp, SVCXPRT *transp);
+extern void matrix_operations_prog_2(struct svc_req *rqstp, SVCXPRT *transp);
+
+#define MAX_WORKERS 256
+
+/* Record buffer per accepted connection; svc_fd_create would otherwise use 4000 bytes */
+#define CONN_BUFSIZE 65536
+
+/* Generated dispatchers wrapped to record per-procedure statistics */
+static void dispatch_prog_1(struct svc_req *rqstp, SVCXPRT *transp) {
+    stats_dispatch(rqstp, transp, matrix_operations_prog_1);
+}
+
+static void dispatch_prog_2(struct svc_req *rqstp, SVCXPRT *transp) {
+    stats_dispatch(rqstp, transp, matrix_operations_prog_2);
+}
+
+/* Queue of connection fds waiting for a worker */
+typedef struct {
+    int *fds;
+    int capacity;
+    int head;
+    int count;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+} fd_queue;
+
+static fd_queue queue;
+
+/*
+ * Connection table, indexed by fd and guarded by conn_lock. Only the main
+ * thread creates and destroys transports, so svc_pollfd and the libtirpc
+ * transport table are never written by a worker: when a worker finds a
+ * connection closed, its destroy merely marks the slot CONN_DEAD and the
+ * main thread destroys the transport on its next pass.
+ */
+enum { CONN_FREE, CONN_IDLE, CONN_BUSY, CONN_DEAD };
+static char *conn_state;
+static SVCXPRT **conn_xprt;
+static int conn_size;
+static pthread_mutex_t conn_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* The main thread's poll set: the wake pipe, the listener and up to conn_size transports */
+static struct pollfd *poll_set;
+
+/* Workers write here when they hand a connection back to the poll loop */
+static int wake_pipe[2];
+
+/* The TCP listener is serviced inline; the UDP socket is polled like a connection */
+static int listener_fd = -1;
+static SVCXPRT *udp_xprt;
+
+/* Connection transports all share one ops table; ours differs only in xp_destroy */
+static struct xp_ops deferred_ops;
+static void (*vc_destroy)(SVCXPRT *xprt);
+
+static int queue_init(fd_queue *q, int capacity) {
+    q->fds = (int *)malloc(capacity * sizeof(int));
+    if (!q->fds) return 0;
+    q->capacity = capacity;
+    q->head = 0;
+    q->count = 0;
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->ready, NULL);
+    return 1;
+}
+
+/* Make room for capacity fds; 0 if out of memory, leaving the queue as it was */
+static int queue_reserve(fd_queue *q, int capacity) {
+    pthread_mutex_lock(&q->lock);
+    if (capacity > q->capacity) {
+        int *grown = (int *)malloc(capacity * sizeof(int));
+        if (!grown) {
+            pthread_mutex_unlock(&q->lock);
+            return 0;
+        }
+        for (int i = 0; i < q->count; i++) {
+            grown[i] = q->fds[(q->head + i) % q->capacity];
+        }
+        free(q->fds);
+        q->fds = grown;
+        q->head = 0;
+        q->capacity = capacity;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return 1;
+}
+
+/* Each fd is queued at most once (it is busy until a worker releases it), and conn_add reserved its slot */
+static void queue_push(fd_queue *q, int fd) {
+    pthread_mutex_lock(&q->lock);
+    q->fds[(q->head + q->count) % q->capacity] = fd;
+    q->count++;
+    pthread_cond_signal(&q->ready);
+    pthread_mutex_unlock(&q->lock);
+}
+
+static int queue_pop(fd_queue *q) {
+    pthread_mutex_lock(&q->lock);
+    while (q->count == 0) {
+        pthread_cond_wait(&q->ready, &q->lock);
+    }
+    int fd = q->fds[q->head];
+    q->head = (q->head + 1) % q->capacity;
+    q->count--;
+    pthread_mutex_unlock(&q->lock);
+    return fd;
+}
+
+/*
+ * Track a new transport as idle; main thread only. Everything sized by the
+ * table (the work queue and the poll set) grows here, so nothing allocates
+ * once a connection is tracked. Returns 0 if out of memory.
+ */
+static int conn_add(int fd, SVCXPRT *xprt) {
+    pthread_mutex_lock(&conn_lock);
+    if (fd >= conn_size) {
+        int size = conn_size ? conn_size : 64;
+        while (size <= fd) size *= 2;
+        /* Each buffer keeps its old contents if a later one fails; only conn_size commits the growth */
+        char *state = (char *)realloc(conn_state, size);
+        if (state) conn_state = state;
+        SVCXPRT **xprts = state ? (SVCXPRT **)realloc(conn_xprt, size * sizeof(SVCXPRT *)) : NULL;
+        if (xprts) conn_xprt = xprts;
+        struct pollfd *pfds = xprts ? (struct pollfd *)realloc(poll_set, (size + 2) * sizeof(struct pollfd)) : NULL;
+        if (pfds) poll_set = pfds;
+        if (!pfds || !queue_reserve(&queue, size)) {
+            pthread_mutex_unlock(&conn_lock);
+            return 0;
+        }
+        memset(conn_state + conn_size, CONN_FREE, size - conn_size);
+        memset(conn_xprt + conn_size, 0, (size - conn_size) * sizeof(SVCXPRT *));
+        conn_size = size;
+    }
+    conn_state[fd] = CONN_IDLE;
+    conn_xprt[fd] = xprt;
+    pthread_mutex_unlock(&conn_lock);
+    return 1;
+}
+
+/* Called by svc_getreq_common on a worker once the peer has gone */
+static void defer_destroy(SVCXPRT *xprt) {
+    pthread_mutex_lock(&conn_lock);
+    conn_state[xprt->xp_fd] = CONN_DEAD;
+    pthread_mutex_unlock(&conn_lock);
+}
+
+/* Accept on the listener and register the connection with deferred destruction */
+static void accept_connection(void) {
+    int fd = accept(listener_fd, NULL, NULL);
+    if (fd < 0) return;
+    /* As libtirpc's own rendezvous does; replies would otherwise wait on delayed ACKs */
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    SVCXPRT *xprt = svc_fd_create(fd, CONN_BUFSIZE, CONN_BUFSIZE);
+    if (xprt == NULL) {
+        close(fd);
+        return;
+    }
+    if (vc_destroy == NULL) {
+        deferred_ops = *xprt->xp_ops;
+        vc_destroy = deferred_ops.xp_destroy;
+        deferred_ops.xp_destroy = defer_destroy;
+    }
+    xprt->xp_ops = &deferred_ops;
+    if (!conn_add(fd, xprt)) {
+        /* Out of memory: drop the client rather than track it */
+        vc_destroy(xprt);
+    }
+}
+
+/* Destroy the transports workers marked dead; this unregisters and closes them */
+static void reap_connections(void) {
+    for (int fd = 0;; fd++) {
+        SVCXPRT *dead = NULL;
+        pthread_mutex_lock(&conn_lock);
+        while (fd < conn_size && conn_state[fd] != CONN_DEAD) fd++;
+        if (fd < conn_size) {
+            dead = conn_xprt[fd];
+            conn_state[fd] = CONN_FREE;
+            conn_xprt[fd] = NULL;
+        }
+        pthread_mutex_unlock(&conn_lock);
+        /* Outside conn_lock: destroy takes libtirpc's lock, which workers hold when calling defer_destroy */
+        if (dead == NULL) return;
+        vc_destroy(dead);
+    }
+}
+
+/* Worker: receive, dispatch and reply on one connection, then give it back */
+static void *worker_main(void *arg) {
+    (void)arg;
+    for (;;) {
+        int fd = queue_pop(&queue);
+
+        svc_getreq_common(fd);
+
+        pthread_mutex_lock(&conn_lock);
+        if (conn_state[fd] == CONN_BUSY) conn_state[fd] = CONN_IDLE;
+        pthread_mutex_unlock(&conn_lock);
+        if (write(wake_pipe[1], "", 1) < 0 && errno != EAGAIN) {
+            perror("wake pipe");
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Poll the listener, the wake pipe and every idle transport; hand readable
+ * ones to workers. The UDP socket is a single transport shared by all
+ * datagram clients, so it too is owned by one worker at a time: with -t N,
+ * UDP requests are still served one after another. Use TCP for parallelism.
+ */
+static void run_pool(int num_workers) {
+    if (pipe2(wake_pipe, O_NONBLOCK | O_CLOEXEC) < 0 || !queue_init(&queue, 64) ||
+        !conn_add(udp_xprt->xp_fd, udp_xprt)) {
+        fprintf(stderr, "%s", "cannot set up worker pool.");
+        exit(1);
+    }
+
+    for (int i = 0; i < num_workers; i++) {
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, worker_main, NULL) != 0) {
+            fprintf(stderr, "%s", "cannot start worker thread.");
+            exit(1);
+        }
+        pthread_detach(tid);
+    }
+
+    for (;;) {
+        reap_connections();
+
+        pthread_mutex_lock(&conn_lock);
+        struct pollfd *pfds = poll_set;
+        int n = 0;
+        pfds[n++] = (struct pollfd){ wake_pipe[0], POLLIN, 0 };
+        pfds[n++] = (struct pollfd){ listener_fd, POLLIN, 0 };
+        for (int fd = 0; fd < conn_size; fd++) {
+            if (conn_state[fd] == CONN_IDLE) {
+                pfds[n++] = (struct pollfd){ fd, POLLIN | POLLPRI | POLLRDNORM | POLLRDBAND, 0 };
+            }
+        }
+        pthread_mutex_unlock(&conn_lock);
+
+        if (poll(pfds, n, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            exit(1);
+        }
+
+        if (pfds[0].revents & POLLIN) {
+            char drain[64];
+            while (read(wake_pipe[0], drain, sizeof(drain)) > 0);
+        }
+        for (int i = 2; i < n; i++) {
+            if (pfds[i].revents == 0 || (pfds[i].revents & POLLNVAL)) continue;
+            pthread_mutex_lock(&conn_lock);
+            conn_state[pfds[i].fd] = CONN_BUSY;
+            pthread_mutex_unlock(&conn_lock);
+            queue_push(&queue, pfds[i].fd);
+        }
+        /* Last: tracking a new connection may move poll_set */
+        if (pfds[1].revents & POLLIN) accept_connection();
+    }
+}
+
+/* Socket bound to a fixed port on all interfaces, for instances that bypass the portmapper */
+static int bound_socket(int type, int port) {
+    struct sockaddr_in addr;
+    int one = 1;
+    int fd = socket(AF_INET, type, 0);
+    if (fd < 0) return -1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    /* svctcp_create only listens on sockets it binds itself */
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        (type == SOCK_STREAM && listen(fd, SOMAXCONN) < 0)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-t threads] [-S sessions] [-m megabytes] [-c megabytes] [-p port] [-s size] [-b backend] [-v]\n", prog);
+    fprintf(stderr, "  -t threads    serve requests on a pool of worker threads (0 = single-threaded svc_run)\n");
+    fprintf(stderr, "  -S sessions   staged transfers open at once (default %d per thread, at least %d)\n",
+            STAGE_SESSIONS_PER_WORKER, STAGE_MIN_SESSIONS);
+    fprintf(stderr, "  -m megabytes  memory budget for stored matrices (default %d)\n", STORE_DEFAULT_BUDGET_MB);
+    fprintf(stderr, "  -c megabytes  memory budget for cached results (default %d, 0 = off)\n", CACHE_DEFAULT_BUDGET_MB);
+    fprintf(stderr, "  -p port       listen on this UDP/TCP port without registering with the portmapper\n");
+    fprintf(stderr, "  -s size       smallest dimension multiplied Strassen-Winograd style (default %d, 0 = off)\n",
+            STRASSEN_DEFAULT_CROSSOVER);
+    fprintf(stderr, "  -b backend    compute backend for GEMM, inverse and transpose: %s (default %s)\n",
+            backend_list(), backend_name());
+    fprintf(stderr, "  -v            log every backend call to stderr\n");
+    exit(1);
+}
+
+int main(int argc, char **argv) {
+    SVCXPRT *transp;
+    int num_workers = 0;
+    long store_mb = STORE_DEFAULT_BUDGET_MB;
+    long cache_mb = CACHE_DEFAULT_BUDGET_MB;
+    int port = 0;
+    int crossover = STRASSEN_DEFAULT_CROSSOVER;
+    int sessions = 0;
+    int opt;
+    
+    while ((opt = getopt(argc, argv, "t:S:m:c:p:s:b:v")) != -1) {
+        switch (opt) {
+            case 't':
+                num_workers = atoi(optarg);
+                if (num_workers < 0 || num_workers > MAX_WORKERS) usage(argv[0]);
+                break;
+            case 'S':
+                sessions = atoi(optarg);
+                if (sessions <= 0) usage(argv[0]);
+                break;
+            case 'm':
+                store_mb = atol(optarg);
+                if (store_mb <= 0) usage(argv[0]);
+                break;
+            case 'c':
+                cache_mb = atol(optarg);
+                if (cache_mb < 0) usage(argv[0]);
+                break;
+            case 'p':
+                port = atoi(optarg);
+                if (port <= 0 || port > 65535) usage(argv[0]);
+                break;
+            case 's':
+                crossover = atoi(optarg);
+                if (crossover < 0) usage(argv[0]);
+                break;
+            case 'b':
+                if (!backend_select(optarg)) usage(argv[0]);
+                break;
+            case 'v':
+                backend_set_verbose(1);
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+    
+    store_set_budget((size_t)store_mb << 20);
+    cache_set_budget((size_t)cache_mb << 20);
+    gemm_set_strassen_crossover(crossover);
+    if (!sessions) {
+        sessions = STAGE_SESSIONS_PER_WORKER * num_workers;
+        if (sessions < STAGE_MIN_SESSIONS) sessions = STAGE_MIN_SESSIONS;
+    }
+    if (!stage_set_capacity(sessions)) {
+        fprintf(stderr, "%s", "cannot allocate transfer sessions.");
+        exit(1);
+    }
+    fprintf(stderr, "compute backend: %s\n", backend_name());
+    
+    /*
+     * A fixed port lets several instances share a host (clients address them
+     * as host:port); protocol 0 keeps svc_register away from the portmapper
+     * so they do not replace each other's mapping.
+     */
+    int udp_sock = RPC_ANYSOCK, tcp_sock = RPC_ANYSOCK;
+    int udp_proto = IPPROTO_UDP, tcp_proto = IPPROTO_TCP;
+    if (port) {
+        udp_sock = bound_socket(SOCK_DGRAM, port);
+        tcp_sock = bound_socket(SOCK_STREAM, port);
+        if (udp_sock < 0 || tcp_sock < 0) {
+            perror("bind");
+            exit(1);
+        }
+        udp_proto = tcp_proto = 0;
+    } else {
+        pmap_unset(MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS);
+        pmap_unset(MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS2);
+    }
+    
+    transp = udp_xprt = svcudp_create(udp_sock);
+    if (transp == NULL) {
+        fprintf(stderr, "%s", "cannot create udp service.");
+        exit(1);
+    }
+    if (!svc_register(transp, MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS, dispatch_prog_1, udp_proto)) {
+        fprintf(stderr, "%s", "unable to register (MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS, udp).");
+        exit(1);
+    }
+    if (!svc_register(transp, MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS2, dispatch_prog_2, udp_proto)) {
+        fprintf(stderr, "%s", "unable to register (MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS2, udp).");
+        exit(1);
+    }
+    
+    transp = svctcp_create(tcp_sock, 0, 0);
+    if (transp == NULL) {
+        fprintf(stderr, "%s", "cannot create tcp service.");
+        exit(1);
+    }
+    if (!svc_register(transp, MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS, dispatch_prog_1, tcp_proto)) {
+        fprintf(stderr, "%s", "unable to register (MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS, tcp).");
+        exit(1);
+    }
+    if (!svc_register(transp, MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS2, dispatch_prog_2, tcp_proto)) {
+        fprintf(stderr, "%s", "unable to register (MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS2, tcp).");
+        exit(1);
+    }
+    listener_fd = transp->xp_fd;
+    
+    if (num_workers > 0) {
+        run_pool(num_workers);
+    } else {
+        svc_run();
+    }
+    fprintf(stderr, "%s", "svc_run returned");
+    exit(1);
+}
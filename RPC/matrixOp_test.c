@@ -6,7 +6,17 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "matrixOp.h"
+#include "matrixOp_transfer.h"
+#include "matrixOp_async.h"
+#include "matrixOp_distributed.h"
+#include "matrixOp_shm.h"
+#include "matrixOp_codec.h"
 
 #define ASSERT(condition, message) \
     do { \
@@ -260,6 +270,31 @@ void test_error_conditions(CLIENT *clnt) {
     ASSERT(strstr(result2->error_msg, "square") != NULL, 
            "Should return appropriate error message");
     
+    // Test case 5.3: a shape larger than its payload is refused instead of read past
+    matrix lying = { 4000, 4000, { 4, dataA1 } };
+    matrix_result *result3 = matrix_transpose_1(&lying, clnt);
+    ASSERT(result3 != NULL && !result3->success && strstr(result3->error_msg, "does not match") != NULL,
+           "Transpose with a short payload should fail");
+    matrix_pair pair3 = { lying, lying };
+    result3 = matrix_add_1(&pair3, clnt);
+    ASSERT(result3 != NULL && !result3->success && strstr(result3->error_msg, "does not match") != NULL,
+           "Addition with a short payload should fail");
+    
+    // Test case 5.4: shapes whose element count wraps to zero in 32 bits are refused, not read
+    matrix wide = { 4, 1 << 30, { 0, NULL } }, tall = { 1 << 30, 4, { 0, NULL } };
+    matrix_pair pair4 = { wide, tall };
+    result3 = matrix_mult_1(&pair4, clnt);
+    ASSERT(result3 != NULL && !result3->success && strstr(result3->error_msg, "does not match") != NULL,
+           "Multiplication with an overflowing shape should fail");
+    matrix32_pair pair32 = { { 4, 1 << 30, { 0, NULL } }, { 1 << 30, 4, { 0, NULL } } };
+    matrix32_result *result32 = matrix_mult32_1(&pair32, clnt);
+    ASSERT(result32 != NULL && !result32->success && strstr(result32->error_msg, "does not match") != NULL,
+           "Single-precision multiplication with an overflowing shape should fail");
+    matrix huge = { 65536, 65536, { 0, NULL } };
+    result3 = matrix_inverse_1(&huge, clnt);
+    ASSERT(result3 != NULL && !result3->success && strstr(result3->error_msg, "does not match") != NULL,
+           "Inverse with an overflowing shape should fail");
+    
     free(A2->data.data_val); free(A2);
 }
 
@@ -274,6 +309,1474 @@ void test_connection(CLIENT *clnt) {
     printf("✅ PASS: Server connection successful\n");
 }
 
+/* Copy streamed result rows into a flat buffer */
+static int store_rows(int row, int rows, int cols, const double *data, void *ctx) {
+    memcpy((double *)ctx + (size_t)row * cols, data, (size_t)rows * cols * sizeof(double));
+    return 1;
+}
+
+/* Test 7: Staged transfers for matrices larger than MAX_SIZE */
+void test_staged_transfer(CLIENT *clnt, const char *server_address) {
+    printf("\n=== Test 7: Staged Transfer ===\n");
+    
+    // Test case 7.1: 150x130 * 130x90 multiplication, far above MAX_SIZE
+    int m = 150, k = 130, n = 90;
+    double *A = (double *)malloc(m * k * sizeof(double));
+    double *B = (double *)malloc(k * n * sizeof(double));
+    double *C = (double *)calloc(m * k, sizeof(double));
+    double *expected = (double *)calloc(m * n, sizeof(double));
+    for (int i = 0; i < m * k; i++) A[i] = (i % 13) - 6;
+    for (int i = 0; i < k * n; i++) B[i] = (i % 7) * 0.5;
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            for (int p = 0; p < k; p++)
+                expected[i * n + j] += A[i * k + p] * B[p * n + j];
+    
+    const char *error = NULL;
+    int rows = 0, cols = 0;
+    int ok = transfer_run(clnt, OP_MULT, m, k, A, k, n, B, store_rows, C, &rows, &cols, &error);
+    ASSERT(ok, "Staged 150x130*130x90 multiplication should succeed");
+    ASSERT(rows == m && cols == n, "Staged multiplication should report a 150x90 result");
+    int same = 1;
+    for (int i = 0; i < m * n; i++) {
+        if (fabs(C[i] - expected[i]) > EPSILON) same = 0;
+    }
+    ASSERT(same, "Staged multiplication result should be correct");
+    
+    // Test case 7.2: transpose assembled from column tiles, exercising in-place placement
+    stage_request request = { OP_TRANSPOSE, m, k, 0, 0 };
+    stage_status *status = stage_begin_1(&request, clnt);
+    ASSERT(status != NULL && status->success, "Staged transpose session should open");
+    int session = status ? status->session : 0;
+    
+    double *tile_data = (double *)malloc(m * 50 * sizeof(double));
+    int tiles_ok = 1;
+    for (int col = 0; col < k; col += 50) {
+        int width = (k - col < 50) ? k - col : 50;
+        for (int i = 0; i < m; i++)
+            memcpy(tile_data + i * width, A + i * k + col, width * sizeof(double));
+        stage_tile tile = { session, 0, 0, col, m, width, { m * width, tile_data } };
+        status = stage_append_1(&tile, clnt);
+        if (status == NULL || !status->success) tiles_ok = 0;
+    }
+    ASSERT(tiles_ok, "Column tiles should be accepted");
+    
+    stage_range early = { session, 0, 10 };
+    stage_rows *rows_reply = stage_read_1(&early, clnt);
+    ASSERT(rows_reply != NULL && !rows_reply->success, "Reading before commit should fail");
+    
+    status = stage_commit_1(&session, clnt);
+    ASSERT(status != NULL && status->success && status->rows == k && status->cols == m,
+           "Staged transpose commit should report a 130x150 result");
+    ASSERT(transfer_read(clnt, session, k, m, store_rows, C, &error),
+           "Staged transpose result should stream back");
+    same = 1;
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < k; j++)
+            if (C[j * m + i] != A[i * k + j]) same = 0;
+    ASSERT(same, "Staged transpose result should be correct");
+    
+    int *ended = stage_end_1(&session, clnt);
+    ASSERT(ended != NULL && *ended == 1, "Session should be released");
+    
+    // Test case 7.3: tiles outside the operand are rejected
+    request.first_rows = 4;
+    request.first_cols = 4;
+    status = stage_begin_1(&request, clnt);
+    session = status ? status->session : 0;
+    stage_tile bad = { session, 0, 3, 0, 2, 2, { 4, tile_data } };
+    status = stage_append_1(&bad, clnt);
+    ASSERT(status != NULL && !status->success && strstr(status->error_msg, "outside") != NULL,
+           "Tile outside the operand should be rejected");
+    
+    // Re-sent and overlapping tiles count once, so a missing row still blocks the commit
+    stage_tile top = { session, 0, 0, 0, 2, 4, { 8, tile_data } };
+    stage_tile middle = { session, 0, 1, 0, 2, 4, { 8, tile_data } };
+    stage_tile last = { session, 0, 3, 0, 1, 4, { 4, tile_data } };
+    stage_append_1(&top, clnt);
+    stage_append_1(&top, clnt);
+    stage_append_1(&middle, clnt);
+    status = stage_commit_1(&session, clnt);
+    ASSERT(status != NULL && !status->success && strstr(status->error_msg, "incomplete") != NULL,
+           "Commit with a row never sent should fail despite repeated tiles");
+    status = stage_append_1(&last, clnt);
+    status = status != NULL && status->success ? stage_commit_1(&session, clnt) : NULL;
+    ASSERT(status != NULL && status->success, "Commit should succeed once every row has arrived");
+    stage_end_1(&session, clnt);
+    
+    // Test case 7.4: sessions left open by a client that disconnected are reclaimed once the table is full
+    CLIENT *leaker = clnt_create(server_address, MATRIX_OPERATIONS_PROG, MATRIX_OPERATIONS_VERS, "tcp");
+    int leaked = 0, full = 0;
+    while (leaker != NULL && !full && leaked < 4096) {
+        status = stage_begin_1(&request, leaker);
+        if (status != NULL && status->success) leaked++;
+        else full = status != NULL && strstr(status->error_msg, "Too many") != NULL;
+        if (status == NULL) break;
+    }
+    ASSERT(full && leaked > 0, "Sessions left open should eventually fill the table");
+    if (leaker != NULL) clnt_destroy(leaker);
+    usleep(100000);
+    status = stage_begin_1(&request, clnt);
+    ASSERT(status != NULL && status->success, "A new session should reclaim one of the disconnected client's");
+    session = status ? status->session : 0;
+    stage_end_1(&session, clnt);
+    
+    free(A); free(B); free(C); free(expected); free(tile_data);
+}
+
+/* Test 8: Server buffers are reused across requests without stale data */
+void test_buffer_reuse(CLIENT *clnt) {
+    printf("\n=== Test 8: Buffer Reuse ===\n");
+    
+    // Test case 8.1: a full-size 10x10 product followed by a small one
+    double big[100];
+    for (int i = 0; i < 100; i++) big[i] = (i % 10 == i / 10) ? 2.0 : 0.0;
+    matrix *I2 = create_test_matrix_data(10, 10, big);
+    matrix_pair pair;
+    pair.first = *I2;
+    pair.second = *I2;
+    matrix_result *result = matrix_mult_1(&pair, clnt);
+    ASSERT(result != NULL && result->success && result->result_matrix.data.data_val[0] == 4.0,
+           "10x10 multiplication should succeed");
+    
+    double dataA[] = {1, 2, 3, 4};
+    double expected[] = {7, 10, 15, 22};
+    matrix *A = create_test_matrix_data(2, 2, dataA);
+    matrix *expected_mat = create_test_matrix_data(2, 2, expected);
+    pair.first = *A;
+    pair.second = *A;
+    result = matrix_mult_1(&pair, clnt);
+    ASSERT(result != NULL && result->success && matrices_equal(&result->result_matrix, expected_mat, EPSILON),
+           "Smaller product after a larger one should not see stale accumulator data");
+    
+    // Test case 8.2: a failed inverse returns no matrix data
+    double singular[] = {1, 2, 2, 4};
+    matrix *S = create_test_matrix_data(2, 2, singular);
+    result = matrix_inverse_1(S, clnt);
+    ASSERT(result != NULL && !result->success && result->result_matrix.data.data_len == 0,
+           "Singular inverse should not return a matrix");
+    
+    // Test case 8.3: many requests in a row keep returning correct results
+    int same = 1;
+    for (int iter = 0; iter < 200 && same; iter++) {
+        big[iter % 100] += 1.0;
+        I2->data.data_val[iter % 100] = big[iter % 100];
+        result = matrix_transpose_1(I2, clnt);
+        if (result == NULL || !result->success) {
+            same = 0;
+            break;
+        }
+        for (int i = 0; i < 10; i++)
+            for (int j = 0; j < 10; j++)
+                if (result->result_matrix.data.data_val[j * 10 + i] != big[i * 10 + j]) same = 0;
+    }
+    ASSERT(same, "200 consecutive transposes should all be correct");
+    
+    free(I2->data.data_val); free(I2);
+    free(A->data.data_val); free(A);
+    free(S->data.data_val); free(S);
+    free(expected_mat->data.data_val); free(expected_mat);
+}
+
+/* Test 9: Server-resident matrices addressed by handle */
+void test_matrix_store(CLIENT *clnt) {
+    printf("\n=== Test 9: Matrix Store ===\n");
+    const char *error = NULL;
+    
+    // Test case 9.1: chain (A * B)^T on small stored matrices
+    double dataA[] = {1, 2, 3, 4, 5, 6};
+    double dataB[] = {7, 8, 9, 10, 11, 12};
+    double expected[] = {58, 139, 64, 154};
+    int a = 0, b = 0, ab = 0, abt = 0, rows = 0, cols = 0;
+    ASSERT(transfer_store(clnt, 2, 3, dataA, &a, &error) && a > 0, "2x3 matrix should be stored");
+    ASSERT(transfer_store(clnt, 3, 2, dataB, &b, &error) && b > 0 && b != a, "3x2 matrix should get its own handle");
+    ASSERT(transfer_apply(clnt, OP_MULT, a, b, &ab, &rows, &cols, &error) && rows == 2 && cols == 2,
+           "Multiplying stored matrices should give a 2x2 handle");
+    ASSERT(transfer_apply(clnt, OP_TRANSPOSE, ab, 0, &abt, &rows, &cols, &error),
+           "Transposing a stored result should succeed");
+    double C[4] = {0};
+    ASSERT(transfer_fetch(clnt, abt, 2, 2, store_rows, C, &error) && memcmp(C, expected, sizeof(C)) == 0,
+           "Fetched (A*B)^T should be correct");
+    
+    // Test case 9.2: shape errors and released handles
+    int bad = 0;
+    ASSERT(!transfer_apply(clnt, OP_ADD, a, b, &bad, NULL, NULL, &error) && strstr(error, "same dimensions") != NULL,
+           "Adding stored matrices of different shapes should fail");
+    int *freed = store_free_1(&ab, clnt);
+    ASSERT(freed != NULL && *freed == 1, "Stored matrix should be released");
+    ASSERT(!transfer_apply(clnt, OP_TRANSPOSE, ab, 0, &bad, NULL, NULL, &error) && strstr(error, "handle") != NULL,
+           "Released handle should be rejected");
+    freed = store_free_1(&ab, clnt);
+    ASSERT(freed != NULL && *freed == 0, "Releasing a handle twice should report failure");
+    matrix huge = { 65536, 65536, { 0, NULL } };
+    handle_result *put = store_put_1(&huge, clnt);
+    ASSERT(put != NULL && !put->success && strstr(put->error_msg, "does not match") != NULL,
+           "Storing a shape that overflows 32 bits should fail");
+    
+    // Test case 9.3: a staged upload larger than MAX_SIZE, inverted on the server
+    int n = 120, big = 0, inv = 0;
+    double *M = (double *)malloc(n * n * sizeof(double));
+    double *R = (double *)calloc(n * n, sizeof(double));
+    for (int i = 0; i < n * n; i++) M[i] = (i / n == i % n) ? 4.0 : ((i * 37) % 11) / 110.0;
+    ASSERT(transfer_store(clnt, n, n, M, &big, &error), "120x120 matrix should be stored through a staged upload");
+    ASSERT(transfer_apply(clnt, OP_INVERSE, big, 0, &inv, &rows, &cols, &error) && rows == n && cols == n,
+           "Stored matrix should be inverted into a new handle");
+    int prod = 0;
+    ASSERT(transfer_apply(clnt, OP_MULT, big, inv, &prod, NULL, NULL, &error) &&
+           transfer_fetch(clnt, prod, n, n, store_rows, R, &error),
+           "M * M^-1 should be computed and fetched");
+    double max_error = 0.0;
+    for (int i = 0; i < n * n; i++) {
+        double err = fabs(R[i] - ((i / n == i % n) ? 1.0 : 0.0));
+        if (err > max_error) max_error = err;
+    }
+    ASSERT(max_error < 1e-9, "M * M^-1 should be the identity");
+    
+    int handles[] = { a, b, abt, big, inv, prod };
+    for (int i = 0; i < 6; i++) store_free_1(&handles[i], clnt);
+    free(M); free(R);
+}
+
+/* Test 10: Expression graphs evaluated in one call */
+void test_expression(CLIENT *clnt) {
+    printf("\n=== Test 10: Expression Evaluation ===\n");
+    
+    // Test case 10.1: (A*B)^T + C^-1 in a single round trip
+    double dataA[] = {1, 2, 3, 4, 5, 6};
+    double dataB[] = {1, 0, 2, 1, 0, 3};
+    double dataC[] = {2, 0, 0, 4};
+    matrix operands[3] = {
+        { 2, 3, { 6, dataA } },
+        { 3, 2, { 6, dataB } },
+        { 2, 2, { 4, dataC } },
+    };
+    expr_node nodes[] = {
+        { EXPR_OPERAND, 0, 0, 0 },      /* 0: A */
+        { EXPR_OPERAND, 1, 0, 0 },      /* 1: B */
+        { EXPR_MULT, 0, 0, 1 },         /* 2: A*B */
+        { EXPR_TRANSPOSE, 0, 2, 0 },    /* 3: (A*B)^T */
+        { EXPR_OPERAND, 2, 0, 0 },      /* 4: C */
+        { EXPR_INVERSE, 0, 4, 0 },      /* 5: C^-1 */
+        { EXPR_ADD, 0, 3, 5 },          /* 6: (A*B)^T + C^-1 */
+    };
+    expr_request request = { { 3, operands }, { 7, nodes }, 0 };
+    double expected[] = {5.5, 14, 11, 23.25};
+    matrix expected_mat = { 2, 2, { 4, expected } };
+    
+    expr_result *result = evaluate_1(&request, clnt);
+    ASSERT(result != NULL && result->success, "(A*B)^T + C^-1 should evaluate");
+    ASSERT(result != NULL && matrices_equal(&result->result_matrix, &expected_mat, EPSILON),
+           "(A*B)^T + C^-1 should be correct");
+    
+    // Test case 10.2: A^T * B^T + (B*A)^T, both products folded into the sum
+    expr_node nodes2[] = {
+        { EXPR_OPERAND, 0, 0, 0 },      /* 0: A (2x3) */
+        { EXPR_OPERAND, 1, 0, 0 },      /* 1: B (3x2) */
+        { EXPR_TRANSPOSE, 0, 0, 0 },    /* 2: A^T */
+        { EXPR_TRANSPOSE, 0, 1, 0 },    /* 3: B^T */
+        { EXPR_MULT, 0, 2, 3 },         /* 4: A^T * B^T (3x3) */
+        { EXPR_MULT, 0, 1, 0 },         /* 5: B*A (3x3) */
+        { EXPR_TRANSPOSE, 0, 5, 0 },    /* 6: (B*A)^T */
+        { EXPR_ADD, 0, 4, 6 },          /* 7 */
+    };
+    expr_request request2 = { { 2, operands }, { 8, nodes2 }, 0 };
+    double expected2[] = {2, 12, 24, 4, 18, 30, 6, 24, 36};
+    matrix expected_mat2 = { 3, 3, { 9, expected2 } };
+    result = evaluate_1(&request2, clnt);
+    ASSERT(result != NULL && result->success && matrices_equal(&result->result_matrix, &expected_mat2, EPSILON),
+           "A^T*B^T + (B*A)^T should be correct");
+    
+    // Test case 10.3: bad graphs are rejected
+    expr_node forward[] = { { EXPR_TRANSPOSE, 0, 1, 0 }, { EXPR_OPERAND, 0, 0, 0 } };
+    expr_request bad = { { 1, operands }, { 2, forward }, 0 };
+    result = evaluate_1(&bad, clnt);
+    ASSERT(result != NULL && !result->success, "Reference to a later node should be rejected");
+    expr_node mismatch[] = { { EXPR_OPERAND, 0, 0, 0 }, { EXPR_ADD, 0, 0, 0 }, { EXPR_MULT, 0, 0, 1 } };
+    bad.nodes.nodes_val = mismatch;
+    bad.nodes.nodes_len = 3;
+    result = evaluate_1(&bad, clnt);
+    ASSERT(result != NULL && !result->success && strstr(result->error_msg, "multiplication") != NULL,
+           "Shape mismatch inside the graph should be reported");
+    matrix huge = { 4, 1 << 30, { 0, NULL } };
+    expr_node wrap[] = { { EXPR_OPERAND, 0, 0, 0 }, { EXPR_TRANSPOSE, 0, 0, 0 } };
+    expr_request overflow = { { 1, &huge }, { 2, wrap }, 0 };
+    result = evaluate_1(&overflow, clnt);
+    ASSERT(result != NULL && !result->success && strstr(result->error_msg, "does not match") != NULL,
+           "An inline operand whose shape overflows 32 bits should be rejected");
+    
+    // Test case 10.4: stored 150x140 operands, M*N^T + P kept on the server
+    int m = 150, k = 140;
+    double *M = (double *)malloc(m * k * sizeof(double));
+    double *N = (double *)malloc(m * k * sizeof(double));
+    double *P = (double *)malloc(m * m * sizeof(double));
+    double *R = (double *)calloc(m * m, sizeof(double));
+    for (int i = 0; i < m * k; i++) { M[i] = (i % 9) - 4; N[i] = (i % 5) * 0.25; }
+    for (int i = 0; i < m * m; i++) P[i] = i % 3;
+    const char *error = NULL;
+    int hm = 0, hn = 0, hp = 0;
+    transfer_store(clnt, m, k, M, &hm, &error);
+    transfer_store(clnt, m, k, N, &hn, &error);
+    transfer_store(clnt, m, m, P, &hp, &error);
+    expr_node nodes3[] = {
+        { EXPR_HANDLE, hm, 0, 0 },
+        { EXPR_HANDLE, hn, 0, 0 },
+        { EXPR_TRANSPOSE, 0, 1, 0 },
+        { EXPR_MULT, 0, 0, 2 },
+        { EXPR_HANDLE, hp, 0, 0 },
+        { EXPR_ADD, 0, 3, 4 },
+    };
+    expr_request request3 = { { 0, NULL }, { 6, nodes3 }, 0 };
+    result = evaluate_1(&request3, clnt);
+    ASSERT(result != NULL && !result->success && strstr(result->error_msg, "keep") != NULL,
+           "Result above MAX_SIZE should require keep");
+    request3.keep = 1;
+    result = evaluate_1(&request3, clnt);
+    int hr = (result != NULL && result->success) ? result->handle : 0;
+    ASSERT(hr > 0, "Kept expression result should return a handle");
+    ASSERT(transfer_fetch(clnt, hr, m, m, store_rows, R, &error), "Kept result should be fetched");
+    double max_error = 0.0;
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < m; j++) {
+            double x = P[i * m + j];
+            for (int p = 0; p < k; p++) x += M[i * k + p] * N[j * k + p];
+            if (fabs(x - R[i * m + j]) > max_error) max_error = fabs(x - R[i * m + j]);
+        }
+    }
+    ASSERT(max_error < 1e-9, "Stored M*N^T + P should be correct");
+    
+    int handles[] = { hm, hn, hp, hr };
+    for (int i = 0; i < 4; i++) store_free_1(&handles[i], clnt);
+    free(M); free(N); free(P); free(R);
+}
+
+/* Test 11: LU factorization, direct solves and determinants */
+void test_lu_solve(CLIENT *clnt) {
+    printf("\n=== Test 11: LU, Solve and Determinant ===\n");
+    
+    // Test case 11.1: packed LU factors reproduce PA
+    double dataA[] = {0, 2, 1, 4, 1, 3, 2, 5, 1};
+    matrix *A = create_test_matrix_data(3, 3, dataA);
+    lu_result *lu = matrix_lu_1(A, clnt);
+    ASSERT(lu != NULL && lu->success && lu->pivots.pivots_len == 3, "LU factorization should succeed");
+    if (lu != NULL && lu->success) {
+        double PA[9], LU[9] = {0};
+        const double *f = lu->lu.data.data_val;
+        memcpy(PA, dataA, sizeof(PA));
+        for (int j = 0; j < 3; j++) {
+            int p = lu->pivots.pivots_val[j];
+            for (int c = 0; c < 3; c++) {
+                double t = PA[j * 3 + c]; PA[j * 3 + c] = PA[p * 3 + c]; PA[p * 3 + c] = t;
+            }
+        }
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                for (int k = 0; k <= (i < j ? i : j); k++)
+                    LU[i * 3 + j] += (k == i ? 1.0 : f[i * 3 + k]) * f[k * 3 + j];
+        int same = 1;
+        for (int i = 0; i < 9; i++) if (fabs(PA[i] - LU[i]) > EPSILON) same = 0;
+        ASSERT(fabs(f[0]) >= 2.0 && same, "L*U should equal the pivoted A");
+    }
+    
+    // Test case 11.2: solve with two right-hand sides
+    double dataB[] = {5, 1, 16, 2, 17, 3};
+    matrix *B = create_test_matrix_data(3, 2, dataB);
+    matrix_pair pair = { *A, *B };
+    matrix_result *result = matrix_solve_1(&pair, clnt);
+    ASSERT(result != NULL && result->success, "Solve should succeed");
+    if (result != NULL && result->success) {
+        double residual = 0.0;
+        for (int i = 0; i < 3; i++)
+            for (int c = 0; c < 2; c++) {
+                double r = -dataB[i * 2 + c];
+                for (int k = 0; k < 3; k++) r += dataA[i * 3 + k] * result->result_matrix.data.data_val[k * 2 + c];
+                if (fabs(r) > residual) residual = fabs(r);
+            }
+        ASSERT(residual < 1e-12, "A*X should reproduce B");
+    }
+    
+    // Test case 11.3: determinants, including a singular matrix
+    det_result *det = matrix_det_1(A, clnt);
+    ASSERT(det != NULL && det->success && fabs(det->determinant - 22.0) < EPSILON, "det(A) should be 22");
+    double singular[] = {1, 2, 2, 4};
+    matrix *S = create_test_matrix_data(2, 2, singular);
+    det = matrix_det_1(S, clnt);
+    ASSERT(det != NULL && det->success && det->determinant == 0.0, "Singular determinant should be 0");
+    pair.first = *S;
+    pair.second = *S;
+    result = matrix_solve_1(&pair, clnt);
+    ASSERT(result != NULL && !result->success, "Solving a singular system should fail");
+    
+    // Test case 11.4: staged 200x200 solve
+    int n = 200;
+    double *M = (double *)malloc(n * n * sizeof(double));
+    double *rhs = (double *)malloc(n * sizeof(double));
+    double *x = (double *)calloc(n, sizeof(double));
+    srand(11);
+    for (int i = 0; i < n * n; i++) M[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < n; i++) rhs[i] = i % 4;
+    const char *error = NULL;
+    int ok = transfer_run(clnt, OP_SOLVE, n, n, M, n, 1, rhs, store_rows, x, NULL, NULL, &error);
+    ASSERT(ok, "Staged 200x200 solve should succeed");
+    double residual = 0.0;
+    for (int i = 0; i < n; i++) {
+        double r = -rhs[i];
+        for (int k = 0; k < n; k++) r += M[i * n + k] * x[k];
+        if (fabs(r) > residual) residual = fabs(r);
+    }
+    ASSERT(residual < 1e-9, "Staged solve residual should be small");
+    
+    // Test case 11.5: shapes whose element count wraps to zero in 32 bits are refused
+    matrix huge = { 65536, 65536, { 0, NULL } };
+    det = matrix_det_1(&huge, clnt);
+    ASSERT(det != NULL && !det->success && strstr(det->error_msg, "does not match") != NULL,
+           "Determinant with an overflowing shape should fail");
+    lu = matrix_lu_1(&huge, clnt);
+    ASSERT(lu != NULL && !lu->success && strstr(lu->error_msg, "does not match") != NULL,
+           "LU with an overflowing shape should fail");
+    double identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    matrix eye = { 4, 4, { 16, identity } }, wide = { 4, 1 << 30, { 0, NULL } };
+    matrix_pair pair5 = { eye, wide };
+    result = matrix_solve_1(&pair5, clnt);
+    ASSERT(result != NULL && !result->success && strstr(result->error_msg, "does not match") != NULL,
+           "Solve with an overflowing right-hand side should fail");
+    
+    free(A->data.data_val); free(A);
+    free(B->data.data_val); free(B);
+    free(S->data.data_val); free(S);
+    free(M); free(rhs); free(x);
+}
+
+/* Test 12: Repeated requests are served from the result cache */
+void test_result_cache(CLIENT *clnt) {
+    printf("\n=== Test 12: Result Cache ===\n");
+    
+    cache_stats *stats = cache_stats_1(NULL, clnt);
+    ASSERT(stats != NULL, "Cache statistics should be available");
+    if (stats == NULL) return;
+    if (stats->budget == 0) {
+        printf("Result cache disabled on this server, skipping\n");
+        return;
+    }
+    cache_stats before = *stats;
+    
+    /* Operands unique to this run, so results cached by earlier runs cannot hit */
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    double salt = (now.tv_sec % 100000) + now.tv_usec * 1e-6;
+    
+    // Test case 12.1: the same inverse twice hits once and returns the same result
+    double data[] = {4 + salt, 7, 2, 6.5};
+    matrix *A = create_test_matrix_data(2, 2, data);
+    matrix_result *result = matrix_inverse_1(A, clnt);
+    matrix first = { 2, 2, { 4, NULL } };
+    double first_data[4];
+    ASSERT(result != NULL && result->success, "First inverse should succeed");
+    if (result != NULL) memcpy(first_data, result->result_matrix.data.data_val, sizeof(first_data));
+    first.data.data_val = first_data;
+    result = matrix_inverse_1(A, clnt);
+    ASSERT(result != NULL && result->success && matrices_equal(&result->result_matrix, &first, 0.0),
+           "Repeated inverse should return the identical result");
+    stats = cache_stats_1(NULL, clnt);
+    ASSERT(stats != NULL && stats->hits == before.hits + 1 && stats->misses == before.misses + 1,
+           "Repeated inverse should count a miss and then a hit");
+    
+    // Test case 12.2: a changed operand misses
+    before = *stats;
+    A->data.data_val[3] += 1.0;
+    result = matrix_inverse_1(A, clnt);
+    stats = cache_stats_1(NULL, clnt);
+    ASSERT(result != NULL && result->success && stats != NULL && stats->misses == before.misses + 1,
+           "Changed operand should miss the cache");
+    
+    // Test case 12.3: a repeated staged product is served from the cache
+    int n = 130;
+    double *M = (double *)malloc(n * n * sizeof(double));
+    double *R1 = (double *)calloc(n * n, sizeof(double));
+    double *R2 = (double *)calloc(n * n, sizeof(double));
+    for (int i = 0; i < n * n; i++) M[i] = (i % 17) * 0.125 + salt;
+    const char *error = NULL;
+    before = *stats;
+    int ok = transfer_run(clnt, OP_MULT, n, n, M, n, n, M, store_rows, R1, NULL, NULL, &error) &&
+             transfer_run(clnt, OP_MULT, n, n, M, n, n, M, store_rows, R2, NULL, NULL, &error);
+    stats = cache_stats_1(NULL, clnt);
+    ASSERT(ok && stats != NULL && stats->hits == before.hits + 1 && memcmp(R1, R2, n * n * sizeof(double)) == 0,
+           "Repeated staged product should hit the cache");
+    ASSERT(stats != NULL && stats->bytes <= stats->budget, "Cache should stay within its budget");
+    
+    free(A->data.data_val); free(A);
+    free(M); free(R1); free(R2);
+}
+
+static int store_rows32(int row, int rows, int cols, const float *data, void *ctx) {
+    memcpy((float *)ctx + (size_t)row * cols, data, (size_t)rows * cols * sizeof(float));
+    return 1;
+}
+
+/* Test 13: float32 transfers and kernels, mixed-precision solve */
+void test_mixed_precision(CLIENT *clnt) {
+    printf("\n=== Test 13: Single and Mixed Precision ===\n");
+    
+    // Test case 13.1: single-call float32 product
+    float a32[] = {1, 2, 3, 4, 5, 6};
+    float b32[] = {7, 8, 9, 10, 11, 12};
+    matrix32_pair pair32 = { { 2, 3, { 6, a32 } }, { 3, 2, { 6, b32 } } };
+    matrix32_result *r32 = matrix_mult32_1(&pair32, clnt);
+    ASSERT(r32 != NULL && r32->success && r32->result_matrix.data.data_len == 4 &&
+           r32->result_matrix.data.data_val[0] == 58.0f && r32->result_matrix.data.data_val[3] == 154.0f,
+           "float32 product should be exact for small integers");
+    
+    // Test case 13.2: staged float32 product against a double reference
+    int m = 150, k = 140, n = 130;
+    float *A = (float *)malloc(m * k * sizeof(float));
+    float *B = (float *)malloc(k * n * sizeof(float));
+    float *C = (float *)calloc(m * n, sizeof(float));
+    srand(13);
+    for (int i = 0; i < m * k; i++) A[i] = (float)rand() / RAND_MAX - 0.5f;
+    for (int i = 0; i < k * n; i++) B[i] = (float)rand() / RAND_MAX - 0.5f;
+    const char *error = NULL;
+    int rows = 0, cols = 0;
+    int ok = transfer_run32(clnt, OP_MULT32, m, k, A, k, n, B, store_rows32, C, &rows, &cols, &error);
+    ASSERT(ok && rows == m && cols == n, "Staged float32 product should succeed");
+    double max_error = 0.0;
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++) {
+            double ref = 0.0;
+            for (int p = 0; p < k; p++) ref += (double)A[i * k + p] * B[p * n + j];
+            if (fabs(ref - C[i * n + j]) > max_error) max_error = fabs(ref - C[i * n + j]);
+        }
+    ASSERT(max_error < 1e-4, "float32 product should match to single precision");
+    
+    // Test case 13.3: mixed-precision solve reaches double accuracy
+    int size = 300;
+    double *M = (double *)malloc(size * size * sizeof(double));
+    double *rhs = (double *)malloc(size * 2 * sizeof(double));
+    double *x = (double *)calloc(size * 2, sizeof(double));
+    for (int i = 0; i < size * size; i++) M[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < size * 2; i++) rhs[i] = (double)rand() / RAND_MAX;
+    ok = transfer_run(clnt, OP_SOLVE_MIXED, size, size, M, size, 2, rhs, store_rows, x, NULL, NULL, &error);
+    ASSERT(ok, "Mixed-precision solve should succeed");
+    double residual = 0.0;
+    for (int i = 0; i < size; i++)
+        for (int c = 0; c < 2; c++) {
+            double r = -rhs[i * 2 + c];
+            for (int p = 0; p < size; p++) r += M[i * size + p] * x[p * 2 + c];
+            if (fabs(r) > residual) residual = fabs(r);
+        }
+    ASSERT(residual < 1e-10, "Refined solution should have a double-precision residual");
+    
+    // Test case 13.4: singular systems still fail
+    double singular[] = {1, 2, 2, 4};
+    ok = transfer_run(clnt, OP_SOLVE_MIXED, 2, 2, singular, 2, 1, rhs, store_rows, x, NULL, NULL, &error);
+    ASSERT(!ok, "Mixed-precision solve of a singular system should fail");
+    
+    free(A); free(B); free(C);
+    free(M); free(rhs); free(x);
+}
+
+/* Random CSR matrix with sorted columns and about density * cols nonzeros per row */
+static void random_csr(csr_matrix *m, int rows, int cols, double density) {
+    int capacity = (int)(rows * cols * density * 2) + rows + 16;
+    m->rows = rows;
+    m->cols = cols;
+    m->row_ptr.row_ptr_len = rows + 1;
+    m->row_ptr.row_ptr_val = (int *)malloc((rows + 1) * sizeof(int));
+    m->col_idx.col_idx_val = (int *)malloc(capacity * sizeof(int));
+    m->values.values_val = (double *)malloc(capacity * sizeof(double));
+    int nnz = 0;
+    m->row_ptr.row_ptr_val[0] = 0;
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols && nnz < capacity; j++) {
+            if ((double)rand() / RAND_MAX < density) {
+                m->col_idx.col_idx_val[nnz] = j;
+                m->values.values_val[nnz] = (double)rand() / RAND_MAX - 0.5;
+                nnz++;
+            }
+        }
+        m->row_ptr.row_ptr_val[i + 1] = nnz;
+    }
+    m->col_idx.col_idx_len = nnz;
+    m->values.values_len = nnz;
+}
+
+static void csr_dense(const csr_matrix *m, double *out) {
+    memset(out, 0, (size_t)m->rows * m->cols * sizeof(double));
+    for (int i = 0; i < m->rows; i++)
+        for (int p = m->row_ptr.row_ptr_val[i]; p < m->row_ptr.row_ptr_val[i + 1]; p++)
+            out[(size_t)i * m->cols + m->col_idx.col_idx_val[p]] += m->values.values_val[p];
+}
+
+static void free_csr(csr_matrix *m) {
+    free(m->row_ptr.row_ptr_val);
+    free(m->col_idx.col_idx_val);
+    free(m->values.values_val);
+}
+
+/* Test 14: CSR sparse matrices */
+void test_sparse(CLIENT *clnt) {
+    printf("\n=== Test 14: Sparse Matrices ===\n");
+    
+    // Test case 14.1: SpMV on a 3x4 matrix
+    int ptr[] = {0, 2, 2, 4};
+    int idx[] = {0, 3, 1, 2};
+    double val[] = {2, -1, 4, 0.5};
+    double x[] = {1, 2, 3, 4};
+    sparse_vector mv = { { 3, 4, { 4, ptr }, { 4, idx }, { 4, val } }, { 4, x } };
+    vector_result *vr = sparse_mv_1(&mv, clnt);
+    ASSERT(vr != NULL && vr->success && vr->y.y_len == 3 &&
+           vr->y.y_val[0] == -2.0 && vr->y.y_val[1] == 0.0 && vr->y.y_val[2] == 9.5,
+           "SpMV should match the dense product");
+    
+    // Test case 14.2: sparse-sparse product against a dense reference
+    int m = 200, k = 300, n = 150;
+    csr_matrix A, B;
+    srand(14);
+    random_csr(&A, m, k, 0.02);
+    random_csr(&B, k, n, 0.03);
+    double *dA = (double *)malloc(m * k * sizeof(double));
+    double *dB = (double *)malloc(k * n * sizeof(double));
+    double *ref = (double *)calloc(m * n, sizeof(double));
+    double *got = (double *)malloc(m * n * sizeof(double));
+    csr_dense(&A, dA);
+    csr_dense(&B, dB);
+    for (int i = 0; i < m; i++)
+        for (int p = 0; p < k; p++)
+            for (int j = 0; j < n; j++) ref[i * n + j] += dA[i * k + p] * dB[p * n + j];
+    csr_pair pair = { A, B };
+    csr_result *cr = sparse_mult_1(&pair, clnt);
+    ASSERT(cr != NULL && cr->success && cr->result.rows == m && cr->result.cols == n,
+           "SpGEMM should succeed");
+    if (cr != NULL && cr->success) {
+        int sorted = 1;
+        for (int i = 0; i < m; i++)
+            for (int p = cr->result.row_ptr.row_ptr_val[i] + 1; p < cr->result.row_ptr.row_ptr_val[i + 1]; p++)
+                if (cr->result.col_idx.col_idx_val[p] <= cr->result.col_idx.col_idx_val[p - 1]) sorted = 0;
+        csr_dense(&cr->result, got);
+        double diff = 0.0;
+        for (int i = 0; i < m * n; i++) if (fabs(got[i] - ref[i]) > diff) diff = fabs(got[i] - ref[i]);
+        ASSERT(sorted && diff < 1e-12, "SpGEMM should match the dense product with sorted rows");
+    }
+    
+    // Test case 14.3: transposing twice gives the original back
+    cr = sparse_transpose_1(&A, clnt);
+    ASSERT(cr != NULL && cr->success && cr->result.rows == k, "Sparse transpose should succeed");
+    if (cr != NULL && cr->success) {
+        csr_matrix T = cr->result;
+        cr = sparse_transpose_1(&T, clnt);
+        ASSERT(cr != NULL && cr->success &&
+               cr->result.col_idx.col_idx_len == A.col_idx.col_idx_len &&
+               memcmp(cr->result.row_ptr.row_ptr_val, A.row_ptr.row_ptr_val, (m + 1) * sizeof(int)) == 0 &&
+               memcmp(cr->result.col_idx.col_idx_val, A.col_idx.col_idx_val, A.col_idx.col_idx_len * sizeof(int)) == 0 &&
+               memcmp(cr->result.values.values_val, A.values.values_val, A.values.values_len * sizeof(double)) == 0,
+               "(A^T)^T should equal A");
+    }
+    
+    // Test case 14.4: sparse times stored dense, and dense <-> CSR conversion
+    const char *error = NULL;
+    int hB = 0, hC = 0, rows = 0, cols = 0;
+    handle_result *hr = sparse_to_dense_1(&B, clnt);
+    ASSERT(hr != NULL && hr->success && hr->rows == k && hr->cols == n, "Sparse to dense should store the matrix");
+    if (hr != NULL && hr->success) hB = hr->handle;
+    sparse_dense_op op = { A, hB };
+    hr = sparse_mult_dense_1(&op, clnt);
+    ASSERT(hr != NULL && hr->success, "Sparse times stored dense should succeed");
+    if (hr != NULL && hr->success) {
+        hC = hr->handle;
+        rows = hr->rows;
+        cols = hr->cols;
+        int ok = transfer_fetch(clnt, hC, rows, cols, store_rows, got, &error);
+        double diff = 0.0;
+        for (int i = 0; i < m * n; i++) if (fabs(got[i] - ref[i]) > diff) diff = fabs(got[i] - ref[i]);
+        ASSERT(ok && rows == m && cols == n && diff < 1e-12, "Sparse-dense product should match the reference");
+    }
+    cr = sparse_from_dense_1(&hB, clnt);
+    ASSERT(cr != NULL && cr->success && cr->result.values.values_len == B.values.values_len &&
+           memcmp(cr->result.col_idx.col_idx_val, B.col_idx.col_idx_val, B.col_idx.col_idx_len * sizeof(int)) == 0,
+           "Dense to sparse should recover the CSR structure");
+    store_free_1(&hB, clnt);
+    store_free_1(&hC, clnt);
+    
+    // Test case 14.5: malformed CSR is rejected
+    idx[1] = 4;
+    vr = sparse_mv_1(&mv, clnt);
+    ASSERT(vr != NULL && !vr->success, "Out-of-range column index should be rejected");
+    
+    free_csr(&A); free_csr(&B);
+    free(dA); free(dB); free(ref); free(got);
+}
+
+static uint64_t swap_bytes(double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return __builtin_bswap64(bits);
+}
+
+/* Test 15: version 2 raw payloads */
+void test_raw_payloads(CLIENT *clnt, const char *server_address) {
+    printf("\n=== Test 15: Raw Payloads ===\n");
+    
+    // Test case 15.1: transfer_connect negotiates version 2
+    CLIENT *clnt2 = transfer_connect(server_address);
+    rpcvers_t vers = 0;
+    if (clnt2 != NULL) clnt_control(clnt2, CLGET_VERS, (char *)&vers);
+    ASSERT(clnt2 != NULL && vers == MATRIX_OPERATIONS_VERS2, "transfer_connect should use version 2");
+    if (clnt2 == NULL) return;
+    
+    // Test case 15.2: staged product over raw payloads matches version 1 bit for bit
+    int m = 150, k = 130, n = 90;
+    double *A = (double *)malloc(m * k * sizeof(double));
+    double *B = (double *)malloc(k * n * sizeof(double));
+    double *C1 = (double *)calloc(m * n, sizeof(double));
+    double *C2 = (double *)calloc(m * n, sizeof(double));
+    srand(15);
+    for (int i = 0; i < m * k; i++) A[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < k * n; i++) B[i] = (double)rand() / RAND_MAX - 0.5;
+    const char *error = NULL;
+    int ok = transfer_run(clnt, OP_MULT, m, k, A, k, n, B, store_rows, C1, NULL, NULL, &error) &&
+             transfer_run(clnt2, OP_MULT, m, k, A, k, n, B, store_rows, C2, NULL, NULL, &error);
+    ASSERT(ok && memcmp(C1, C2, m * n * sizeof(double)) == 0,
+           "Raw payload product should equal the XDR product");
+    
+    // Test case 15.3: a tile in the other byte order is converted on arrival
+    double values[] = {1.5, -2.25, 3e100, 4e-300, 0.0, -0.0};
+    uint64_t swapped[6];
+    for (int i = 0; i < 6; i++) swapped[i] = swap_bytes(values[i]);
+    int order = *(const unsigned char *)&(int){1} ? ORDER_BIG_ENDIAN : ORDER_LITTLE_ENDIAN;
+    stage_request req = { OP_STORE, 2, 3, 0, 0 };
+    stage_status *st = stage_begin_2(&req, clnt2);
+    int session = (st != NULL && st->success) ? st->session : 0;
+    stage_tile_raw tile = { session, 0, 0, 0, 2, 3, (byte_order)order, { sizeof(swapped), (char *)swapped } };
+    st = stage_append_raw_2(&tile, clnt2);
+    ok = st != NULL && st->success;
+    st = stage_commit_2(&session, clnt2);
+    ok = ok && st != NULL && st->success;
+    stage_range range = { session, 0, 2 };
+    stage_rows_raw *rr = stage_read_raw_2(&range, clnt2);
+    double back[6];
+    if (ok && rr != NULL && rr->success && rr->data.data_len == sizeof(back)) {
+        memcpy(back, rr->data.data_val, sizeof(back));
+        if (rr->order == (byte_order)order) {
+            for (int i = 0; i < 6; i++) {
+                uint64_t bits = swap_bytes(back[i]);
+                memcpy(&back[i], &bits, sizeof(bits));
+            }
+        }
+    } else {
+        ok = 0;
+    }
+    ASSERT(ok && memcmp(back, values, sizeof(back)) == 0, "Byte-swapped tile should round-trip exactly");
+    
+    // Test case 15.4: payload length must match the tile shape
+    tile.data.data_len = sizeof(swapped) - 8;
+    tile.row = 1;
+    tile.rows = 1;
+    st = stage_append_raw_2(&tile, clnt2);
+    ASSERT(st != NULL && !st->success, "Short raw tile should be rejected");
+    stage_end_2(&session, clnt2);
+    
+    // Test case 15.5: version 1 handles keep working alongside
+    int *ping = ping_1(NULL, clnt);
+    ASSERT(ping != NULL, "Version 1 handle should still be served");
+    
+    clnt_destroy(clnt2);
+    free(A); free(B); free(C1); free(C2);
+}
+
+static void count_completion(int ok, const char *error, void *ctx) {
+    (void)error;
+    if (ok) __atomic_fetch_add((int *)ctx, 1, __ATOMIC_RELAXED);
+}
+
+/* Test 16: pipelined requests over several connections */
+void test_async_client(const char *server_address) {
+    printf("\n=== Test 16: Pipelined Client ===\n");
+    
+    async_client *ac = async_create(server_address, 4, 16);
+    ASSERT(ac != NULL, "Async client should connect");
+    if (ac == NULL) return;
+    
+    // Test case 16.1: futures deliver each reply to its own result
+    enum { CALLS = 200 };
+    double A[4] = {1, 2, 3, 4};
+    double scale[CALLS][4];
+    matrix_pair pairs[CALLS];
+    matrix_result results[CALLS];
+    async_call *calls[CALLS];
+    memset(results, 0, sizeof(results));
+    for (int i = 0; i < CALLS; i++) {
+        double s = i + 1;
+        scale[i][0] = s; scale[i][1] = 0; scale[i][2] = 0; scale[i][3] = s;
+        pairs[i] = (matrix_pair){ { 2, 2, { 4, A } }, { 2, 2, { 4, scale[i] } } };
+        calls[i] = async_submit(ac, MATRIX_MULT, (xdrproc_t)xdr_matrix_pair, &pairs[i],
+                                (xdrproc_t)xdr_matrix_result, &results[i]);
+    }
+    int matched = 0;
+    for (int i = 0; i < CALLS; i++) {
+        const char *error = NULL;
+        if (calls[i] && async_wait(calls[i], &error) && results[i].success &&
+            results[i].result_matrix.data.data_val[3] == 4.0 * (i + 1)) {
+            matched++;
+        }
+        xdr_free((xdrproc_t)xdr_matrix_result, (char *)&results[i]);
+    }
+    ASSERT(matched == CALLS, "Every future should carry its own product");
+    
+    // Test case 16.2: callbacks run for every call before drain returns
+    int completed = 0;
+    int *pings = (int *)calloc(CALLS, sizeof(int));
+    for (int i = 0; i < CALLS; i++) {
+        async_submit_cb(ac, PING, (xdrproc_t)xdr_void, NULL, (xdrproc_t)xdr_int, &pings[i],
+                        count_completion, &completed);
+    }
+    async_drain(ac);
+    ASSERT(completed == CALLS, "Drain should wait for all callbacks");
+    
+    // Test case 16.3: server-side errors come back as replies, not transport failures
+    matrix_pair bad = { { 2, 2, { 4, A } }, { 1, 4, { 4, A } } };
+    matrix_result bad_result;
+    memset(&bad_result, 0, sizeof(bad_result));
+    async_call *call = async_submit(ac, MATRIX_MULT, (xdrproc_t)xdr_matrix_pair, &bad,
+                                    (xdrproc_t)xdr_matrix_result, &bad_result);
+    int ok = call != NULL && async_wait(call, NULL);
+    ASSERT(ok && !bad_result.success, "Incompatible product should fail inside the reply");
+    xdr_free((xdrproc_t)xdr_matrix_result, (char *)&bad_result);
+    
+    async_destroy(ac);
+    free(pings);
+    
+    // Test case 16.4: unreachable hosts are reported at creation
+    ASSERT(async_create("invalid.host.invalid", 2, 4) == NULL, "Unknown host should fail to connect");
+}
+
+/* Test 17: one product tiled across several endpoints */
+void test_distributed_mult(const char *server_address) {
+    printf("\n=== Test 17: Distributed Multiplication ===\n");
+    
+    int m = 200, k = 150, n = 170;
+    double *A = (double *)malloc(m * k * sizeof(double));
+    double *B = (double *)malloc(k * n * sizeof(double));
+    double *C = (double *)calloc(m * n, sizeof(double));
+    double *ref = (double *)calloc(m * n, sizeof(double));
+    srand(17);
+    for (int i = 0; i < m * k; i++) A[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < k * n; i++) B[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < m; i++)
+        for (int p = 0; p < k; p++)
+            for (int j = 0; j < n; j++) ref[i * n + j] += A[i * k + p] * B[p * n + j];
+    
+    // Test case 17.1: edge tiles and inner-dimension panels summed on the servers
+    const char *endpoints[] = { server_address, server_address, "localhost:1" };
+    distributed_options options = { 64, 48, 0 };
+    distributed_report report;
+    const char *error = NULL;
+    int ok = distributed_mult(endpoints, 3, m, k, n, A, B, C, &options, &report, &error);
+    double diff = 0.0;
+    for (int i = 0; i < m * n; i++) if (fabs(C[i] - ref[i]) > diff) diff = fabs(C[i] - ref[i]);
+    ASSERT(ok && diff < 1e-12, "Distributed product should match the reference");
+    
+    // Test case 17.2: every tile is accounted for and the dead endpoint is skipped
+    ASSERT(ok && report.tiles == 12 && report.tiles_done[0] + report.tiles_done[1] == 12 &&
+           report.tiles_done[2] == 0 && report.endpoints_lost == 1,
+           "Tiles should be shared by the reachable endpoints");
+    
+    // Test case 17.3: no reachable endpoint fails cleanly
+    ok = distributed_mult(endpoints + 2, 1, m, k, n, A, B, C, NULL, NULL, &error);
+    ASSERT(!ok, "Product without a reachable endpoint should fail");
+    
+    free(A); free(B); free(C); free(ref);
+}
+
+static const proc_stats *find_proc_stats(const server_stats *stats, int proc) {
+    for (u_int i = 0; i < stats->procs.procs_len; i++) {
+        if (stats->procs.procs_val[i].proc == proc) return &stats->procs.procs_val[i];
+    }
+    return NULL;
+}
+
+static u_quad_t histogram_total(const u_quad_t *buckets) {
+    u_quad_t total = 0;
+    for (int b = 0; b < STATS_BUCKETS; b++) total += buckets[b];
+    return total;
+}
+
+/* Test 18: server-side per-procedure statistics */
+void test_server_stats(CLIENT *clnt, const char *server_address) {
+    printf("\n=== Test 18: Server Statistics ===\n");
+    
+    CLIENT *clnt2 = transfer_connect(server_address);
+    ASSERT(clnt2 != NULL, "Version 2 handle should connect");
+    if (clnt2 == NULL) return;
+    
+    // Test case 18.1: a reset snapshot starts counting over
+    int reset = 1;
+    server_stats *stats = stats_2(&reset, clnt2);
+    ASSERT(stats != NULL, "STATS call should succeed");
+    xdr_free((xdrproc_t)xdr_server_stats, (char *)stats);
+    
+    double a[] = {1, 2, 3, 4, 5, 6};
+    double b[] = {1, 0, 0, 1, 1, 1};
+    matrix_pair pair = { {2, 3, {6, a}}, {3, 2, {6, b}} };
+    /* Same connection as STATS: a worker counts a call after replying, and keeps the connection until then */
+    for (int i = 0; i < 3; i++) matrix_mult_2(&pair, clnt2);
+    matrix_pair bad = { {2, 3, {6, a}}, {2, 3, {6, b}} };
+    matrix_result *r = matrix_mult_2(&bad, clnt2);
+    ASSERT(r != NULL && !r->success, "Incompatible product should fail");
+    
+    reset = 0;
+    stats = stats_2(&reset, clnt2);
+    const proc_stats *mult = stats ? find_proc_stats(stats, MATRIX_MULT) : NULL;
+    
+    // Test case 18.2: calls, errors and bytes for the procedure
+    ASSERT(mult != NULL && mult->calls == 4 && mult->errors == 1,
+           "matrix_mult should count 4 calls and 1 error since the reset");
+    ASSERT(mult != NULL && mult->bytes_in >= 4 * 12 * sizeof(double) && mult->bytes_out > 0,
+           "matrix_mult should count request and reply bytes");
+    
+    // Test case 18.3: every call lands in each phase histogram once
+    ASSERT(mult != NULL && histogram_total(mult->decode_us) == 4 &&
+           histogram_total(mult->compute_us) == 4 && histogram_total(mult->encode_us) == 4,
+           "Decode, compute and encode histograms should each hold every call");
+    
+    // Test case 18.4: procedures not called since the reset are left out
+    ASSERT(stats != NULL && find_proc_stats(stats, MATRIX_INVERSE) == NULL,
+           "Uncalled procedures should not be reported");
+    if (stats) xdr_free((xdrproc_t)xdr_server_stats, (char *)stats);
+    
+    clnt_destroy(clnt2);
+}
+
+/* Test 19: products above the Strassen crossover */
+void test_strassen(CLIENT *clnt) {
+    printf("\n=== Test 19: Strassen-Winograd Multiplication ===\n");
+    
+    // Odd, unequal dimensions past the default crossover: one level of recursion plus peeling
+    int m = 1101, k = 1033, n = 1045;
+    double *A = (double *)malloc((size_t)m * k * sizeof(double));
+    double *B = (double *)malloc((size_t)k * n * sizeof(double));
+    double *C = (double *)calloc((size_t)m * n, sizeof(double));
+    double *ref = (double *)calloc((size_t)m * n, sizeof(double));
+    srand(19);
+    for (size_t i = 0; i < (size_t)m * k; i++) A[i] = (double)rand() / RAND_MAX - 0.5;
+    for (size_t i = 0; i < (size_t)k * n; i++) B[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < m; i++)
+        for (int p = 0; p < k; p++) {
+            double a = A[(size_t)i * k + p];
+            for (int j = 0; j < n; j++) ref[(size_t)i * n + j] += a * B[(size_t)p * n + j];
+        }
+    
+    // Test case 19.1: staged product matches the classical product
+    const char *error = NULL;
+    int ok = transfer_run(clnt, OP_MULT, m, k, A, k, n, B, store_rows, C, NULL, NULL, &error);
+    double diff = 0.0;
+    for (size_t i = 0; i < (size_t)m * n; i++) if (fabs(C[i] - ref[i]) > diff) diff = fabs(C[i] - ref[i]);
+    ASSERT(ok && diff < 1e-10, "Strassen-Winograd product should match the reference");
+    
+    free(A); free(B); free(C); free(ref);
+}
+
+/* Test 20: staged transposes, in place for square operands */
+void test_blocked_transpose(CLIENT *clnt) {
+    printf("\n=== Test 20: Blocked Transpose ===\n");
+    
+    int shapes[][2] = { {300, 300}, {301, 170}, {66, 514} };
+    const char *names[] = { "Square staged transpose (in place) should be exact",
+                            "Odd rectangular staged transpose should be exact",
+                            "Wide staged transpose should be exact" };
+    for (int t = 0; t < 3; t++) {
+        int rows = shapes[t][0], cols = shapes[t][1];
+        double *A = (double *)malloc((size_t)rows * cols * sizeof(double));
+        double *T = (double *)calloc((size_t)rows * cols, sizeof(double));
+        for (int i = 0; i < rows * cols; i++) A[i] = i * 0.5 - 7.0;
+        
+        const char *error = NULL;
+        int ok = transfer_run(clnt, OP_TRANSPOSE, rows, cols, A, 0, 0, NULL, store_rows, T, NULL, NULL, &error);
+        for (int i = 0; ok && i < rows; i++)
+            for (int j = 0; j < cols; j++)
+                if (T[(size_t)j * rows + i] != A[(size_t)i * cols + j]) ok = 0;
+        ASSERT(ok, names[t]);
+        free(A); free(T);
+    }
+}
+
+/* Test 21: GEMM and SYRK on stored matrices */
+void test_gemm_syrk(CLIENT *clnt, const char *server_address) {
+    printf("\n=== Test 21: GEMM and SYRK ===\n");
+    
+    CLIENT *clnt2 = transfer_connect(server_address);
+    ASSERT(clnt2 != NULL, "Version 2 handle should connect");
+    if (clnt2 == NULL) return;
+    
+    int k = 150, m = 90, n = 110, s = 300, sk = 70;
+    double *A = (double *)malloc(k * m * sizeof(double));
+    double *B = (double *)malloc(k * n * sizeof(double));
+    double *C = (double *)malloc(m * n * sizeof(double));
+    double *S = (double *)malloc(s * sk * sizeof(double));
+    double *out = (double *)malloc(s * s * sizeof(double));
+    srand(21);
+    for (int i = 0; i < k * m; i++) A[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < k * n; i++) B[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < m * n; i++) C[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < s * sk; i++) S[i] = (double)rand() / RAND_MAX - 0.5;
+    
+    const char *error = NULL;
+    int a = 0, b = 0, c = 0, sh = 0;
+    int ok = transfer_store(clnt, k, m, A, &a, &error) && transfer_store(clnt, k, n, B, &b, &error) &&
+             transfer_store(clnt, m, n, C, &c, &error) && transfer_store(clnt, s, sk, S, &sh, &error);
+    ASSERT(ok, "Operands should be stored");
+    
+    // Test case 21.1: 2 * A^T * B - C without materializing A^T
+    gemm_request g = { a, b, c, 1, 0, 2.0, -1.0 };
+    handle_result *r = gemm_2(&g, clnt2);
+    ok = r != NULL && r->success && r->rows == m && r->cols == n;
+    int gh = ok ? r->handle : 0;
+    ok = ok && transfer_fetch(clnt, gh, m, n, store_rows, out, &error);
+    double diff = 0.0;
+    for (int i = 0; ok && i < m; i++)
+        for (int j = 0; j < n; j++) {
+            double sum = 0.0;
+            for (int p = 0; p < k; p++) sum += A[p * m + i] * B[p * n + j];
+            diff = fmax(diff, fabs(out[i * n + j] - (2.0 * sum - C[i * n + j])));
+        }
+    ASSERT(ok && diff < 1e-12, "GEMM with transA, alpha and beta should match the reference");
+    
+    // Test case 21.2: mismatched inner dimensions are rejected
+    gemm_request bad = { a, b, 0, 0, 0, 1.0, 0.0 };
+    r = gemm_2(&bad, clnt2);
+    ASSERT(r != NULL && !r->success && strstr(r->error_msg, "Incompatible") != NULL,
+           "GEMM with mismatched inner dimensions should fail");
+    
+    // Test case 21.3: S * S^T across several SYRK blocks comes back symmetric
+    syrk_request y = { sh, 0, 0, 1.0, 0.0 };
+    r = syrk_2(&y, clnt2);
+    ok = r != NULL && r->success && r->rows == s && r->cols == s;
+    int yh = ok ? r->handle : 0;
+    ok = ok && transfer_fetch(clnt, yh, s, s, store_rows, out, &error);
+    diff = 0.0;
+    for (int i = 0; ok && i < s; i++)
+        for (int j = 0; j < s; j++) {
+            double sum = 0.0;
+            for (int p = 0; p < sk; p++) sum += S[i * sk + p] * S[j * sk + p];
+            diff = fmax(diff, fabs(out[i * s + j] - sum));
+        }
+    ASSERT(ok && diff < 1e-12, "SYRK should match S * S^T in both triangles");
+    
+    int handles[] = { a, b, c, sh, gh, yh };
+    for (int i = 0; i < 6; i++) store_free_1(&handles[i], clnt);
+    clnt_destroy(clnt2);
+    free(A); free(B); free(C); free(S); free(out);
+}
+
+/* Test 22: compressed tiles and result rows */
+void test_compressed_payloads(const char *server_address) {
+    printf("\n=== Test 22: Compressed Payloads ===\n");
+    
+    CLIENT *clnt2 = transfer_connect(server_address);
+    ASSERT(clnt2 != NULL, "Version 2 handle should connect");
+    if (clnt2 == NULL) return;
+    
+    // Banded operands with small integer entries: mostly zero bytes after shuffling
+    int rows = 400, cols = 300;
+    double *A = (double *)calloc((size_t)rows * cols, sizeof(double));
+    double *B = (double *)calloc((size_t)rows * cols, sizeof(double));
+    double *C = (double *)calloc((size_t)rows * cols, sizeof(double));
+    for (int i = 0; i < rows; i++)
+        for (int j = i - 2; j <= i + 2; j++)
+            if (j >= 0 && j < cols) {
+                A[(size_t)i * cols + j] = (i + j) % 7;
+                B[(size_t)i * cols + j] = -((i * j) % 5);
+            }
+    
+    int reset = 1;
+    server_stats *stats = stats_2(&reset, clnt2);
+    if (stats) xdr_free((xdrproc_t)xdr_server_stats, (char *)stats);
+    
+    // Test case 22.1: a staged sum round-trips exactly with compression on
+    transfer_set_compression(1);
+    const char *error = NULL;
+    int ok = transfer_run(clnt2, OP_ADD, rows, cols, A, rows, cols, B, store_rows, C, NULL, NULL, &error);
+    for (size_t i = 0; ok && i < (size_t)rows * cols; i++) if (C[i] != A[i] + B[i]) ok = 0;
+    ASSERT(ok, "Compressed staged sum should be exact");
+    
+    // Test case 22.2: tiles and rows both shrank several-fold on the wire
+    reset = 0;
+    stats = stats_2(&reset, clnt2);
+    const proc_stats *up = stats ? find_proc_stats(stats, STAGE_APPEND_PACKED) : NULL;
+    const proc_stats *down = stats ? find_proc_stats(stats, STAGE_READ_PACKED) : NULL;
+    ASSERT(up != NULL && up->codec_raw_bytes == 2ull * rows * cols * sizeof(double) &&
+           up->codec_packed_bytes * 4 < up->codec_raw_bytes,
+           "Uploaded tiles should be compressed at least 4x");
+    ASSERT(down != NULL && down->codec_raw_bytes == (u_quad_t)rows * cols * sizeof(double) &&
+           down->codec_packed_bytes * 4 < down->codec_raw_bytes,
+           "Result rows should be compressed at least 4x");
+    if (stats) xdr_free((xdrproc_t)xdr_server_stats, (char *)stats);
+    
+    // Test case 22.3: random data, which barely compresses, still round-trips
+    srand(22);
+    for (size_t i = 0; i < (size_t)rows * cols; i++) A[i] = (double)rand() / RAND_MAX - 0.5;
+    int handle = 0;
+    ok = transfer_store(clnt2, rows, cols, A, &handle, &error) &&
+         transfer_fetch(clnt2, handle, rows, cols, store_rows, C, &error);
+    ASSERT(ok && memcmp(A, C, (size_t)rows * cols * sizeof(double)) == 0,
+           "Random matrix should round-trip with compression on");
+    store_free_2(&handle, clnt2);
+    transfer_set_compression(0);
+    
+    // Test case 22.4: smooth and near-constant data pack even though their low mantissa planes are noise
+    size_t count = 65536, bytes = count * sizeof(double);
+    double *raw = (double *)malloc(bytes), *back = (double *)malloc(bytes);
+    unsigned char *packed = (unsigned char *)malloc(bytes);
+    for (size_t i = 0; i < count; i++) raw[i] = sin(i * 0.001);
+    size_t smooth = codec_pack(raw, bytes, packed);
+    ok = smooth && smooth < bytes - bytes / 5 && codec_unpack(packed, smooth, back, bytes) &&
+         memcmp(raw, back, bytes) == 0;
+    ASSERT(ok, "Smooth data should pack by a fifth and round-trip");
+    for (size_t i = 0; i < count; i++) raw[i] = 1.0 + 1e-9 * rand() / RAND_MAX;
+    size_t flat = codec_pack(raw, bytes, packed);
+    ok = flat && flat < bytes / 2 && codec_unpack(packed, flat, back, bytes) && memcmp(raw, back, bytes) == 0;
+    ASSERT(ok, "Near-constant data should pack by half and round-trip");
+    free(raw); free(back); free(packed);
+    
+    clnt_destroy(clnt2);
+    free(A); free(B); free(C);
+}
+
+/* Test 23: operations in a shared memory segment */
+void test_shared_memory(const char *server_address) {
+    printf("\n=== Test 23: Shared Memory Transport ===\n");
+    
+    CLIENT *clnt2 = transfer_connect(server_address);
+    ASSERT(clnt2 != NULL, "Version 2 handle should connect");
+    if (clnt2 == NULL) return;
+    
+    // Test case 23.1: the server attaches a segment created here
+    int m = 120, k = 90, n = 70;
+    size_t a_off = 0, b_off = (size_t)m * k * sizeof(double), c_off = b_off + (size_t)k * n * sizeof(double);
+    transfer_segment seg;
+    const char *error = NULL;
+    int ok = transfer_shm_create(clnt2, c_off + (size_t)m * n * sizeof(double), &seg, &error);
+    ASSERT(ok, "Server should attach a local shared memory segment");
+    if (!ok) {
+        clnt_destroy(clnt2);
+        return;
+    }
+    
+    // Test case 23.2: a product computed in place matches the reference
+    double *A = (double *)((char *)seg.base + a_off);
+    double *B = (double *)((char *)seg.base + b_off);
+    double *C = (double *)((char *)seg.base + c_off);
+    srand(23);
+    for (int i = 0; i < m * k; i++) A[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < k * n; i++) B[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < m * n; i++) C[i] = 99.0;
+    int rows = 0, cols = 0;
+    ok = transfer_shm_apply(clnt2, &seg, OP_MULT, a_off, m, k, b_off, k, n, c_off, &rows, &cols, &error);
+    double diff = 0.0;
+    for (int i = 0; ok && i < m; i++)
+        for (int j = 0; j < n; j++) {
+            double sum = 0.0;
+            for (int p = 0; p < k; p++) sum += A[i * k + p] * B[p * n + j];
+            diff = fmax(diff, fabs(C[i * n + j] - sum));
+        }
+    ASSERT(ok && rows == m && cols == n && diff < 1e-12, "Shared memory product should match the reference");
+    
+    // Test case 23.3: a later call sees the client's new data without re-attaching
+    B[0] += 1.0;
+    ok = transfer_shm_apply(clnt2, &seg, OP_TRANSPOSE, b_off, k, n, 0, 0, 0, c_off, &rows, &cols, &error);
+    ASSERT(ok && rows == n && cols == k && C[0] == B[0] && C[1] == B[n],
+           "Transpose should read the operand as last written");
+    
+    // Test case 23.4: results overlapping an operand or past the segment are rejected
+    ok = transfer_shm_apply(clnt2, &seg, OP_MULT, a_off, m, k, b_off, k, n, b_off, NULL, NULL, &error);
+    ASSERT(!ok && strstr(error, "overlaps") != NULL, "Result overlapping an operand should be rejected");
+    ok = transfer_shm_apply(clnt2, &seg, OP_TRANSPOSE, a_off, m, k, 0, 0, 0, seg.size - 8, NULL, NULL, &error);
+    ASSERT(!ok && strstr(error, "outside") != NULL, "Result past the segment end should be rejected");
+    
+    // Test case 23.5: only matrixOp segment names can be attached
+    char *name = "/dev/../etc";
+    shm_attach_result *att = shm_attach_2(&name, clnt2);
+    ASSERT(att != NULL && !att->success, "Foreign shared memory names should be refused");
+    
+    // Test case 23.6: a detached segment is gone for later calls
+    transfer_segment gone = seg;
+    transfer_shm_destroy(clnt2, &seg);
+    shm_result *r = shm_apply_2(&(shm_request){ gone.segment, OP_TRANSPOSE, { 0, 2, 2 }, { 0, 0, 0 }, 64 }, clnt2);
+    ASSERT(r != NULL && !r->success, "Calls on a detached segment should fail");
+    
+    // Test case 23.7: a segment truncated after attach is refused instead of faulting the server
+    char trunc_name[SHM_NAME_MAX];
+    snprintf(trunc_name, sizeof(trunc_name), "%strunc-%d", SHM_NAME_PREFIX, (int)getpid());
+    int fd = shm_open(trunc_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    size_t square = 512 * 512 * sizeof(double);
+    ok = fd >= 0 && ftruncate(fd, (off_t)(3 * square)) == 0;
+    name = trunc_name;
+    att = ok ? shm_attach_2(&name, clnt2) : NULL;
+    int shrunk = att != NULL && att->success ? att->segment : 0;
+    if (fd >= 0) shm_unlink(trunc_name);
+    ok = shrunk && ftruncate(fd, 0) == 0;
+    r = ok ? shm_apply_2(&(shm_request){ shrunk, OP_MULT, { 0, 512, 512 }, { square, 512, 512 }, 2 * square }, clnt2) : NULL;
+    ASSERT(r != NULL && !r->success && strstr(r->error_msg, "outside") != NULL,
+           "Operands in a truncated segment should be rejected");
+    int *detached = shrunk ? shm_detach_2(&shrunk, clnt2) : NULL;
+    ASSERT(detached != NULL && *detached == 1, "Server should survive and detach the truncated segment");
+    if (fd >= 0) close(fd);
+    
+    clnt_destroy(clnt2);
+}
+
+/*
+ * 5-point finite-difference operator on a k x k grid in CSR: 4 on the
+ * diagonal, -1 - c to the west and -1 + c to the east (c = 0 is the
+ * symmetric Poisson matrix), -1 to the north and south
+ */
+static void grid_operator(int k, double c, csr_matrix *m) {
+    int n = k * k;
+    int *ptr = (int *)malloc((n + 1) * sizeof(int));
+    int *idx = (int *)malloc(5 * n * sizeof(int));
+    double *val = (double *)malloc(5 * n * sizeof(double));
+    int nnz = 0;
+    for (int i = 0; i < n; i++) {
+        int r = i / k, col = i % k;
+        ptr[i] = nnz;
+        if (r > 0) { idx[nnz] = i - k; val[nnz++] = -1.0; }
+        if (col > 0) { idx[nnz] = i - 1; val[nnz++] = -1.0 - c; }
+        idx[nnz] = i; val[nnz++] = 4.0;
+        if (col < k - 1) { idx[nnz] = i + 1; val[nnz++] = -1.0 + c; }
+        if (r < k - 1) { idx[nnz] = i + k; val[nnz++] = -1.0; }
+    }
+    ptr[n] = nnz;
+    *m = (csr_matrix){ n, n, { n + 1, ptr }, { nnz, idx }, { nnz, val } };
+}
+
+/* ||b - A x|| / ||b|| for a CSR A */
+static double csr_relative_residual(const csr_matrix *a, const double *b, const double *x) {
+    double r2 = 0.0, b2 = 0.0;
+    for (int i = 0; i < a->rows; i++) {
+        double s = b[i];
+        for (int p = a->row_ptr.row_ptr_val[i]; p < a->row_ptr.row_ptr_val[i + 1]; p++)
+            s -= a->values.values_val[p] * x[a->col_idx.col_idx_val[p]];
+        r2 += s * s;
+        b2 += b[i] * b[i];
+    }
+    return sqrt(r2 / b2);
+}
+
+/* Test 24: CG and GMRES */
+void test_krylov(CLIENT *clnt, const char *server_address) {
+    printf("\n=== Test 24: Krylov Solvers ===\n");
+    
+    CLIENT *clnt2 = transfer_connect(server_address);
+    ASSERT(clnt2 != NULL, "Version 2 handle should connect");
+    if (clnt2 == NULL) return;
+    
+    int k = 40, n = k * k;
+    csr_matrix poisson, convection;
+    grid_operator(k, 0.0, &poisson);
+    grid_operator(k, 0.4, &convection);
+    double *b = (double *)malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) b[i] = 1.0 + (i % 7) * 0.1;
+    krylov_request req = { 0, poisson, { n, b }, { 0, NULL }, 1e-10, 1000, PRECOND_NONE, 0 };
+    
+    // Test case 24.1: CG converges on the Poisson matrix, and ILU(0) cuts the iterations
+    int plain = 0, ilu = 0;
+    krylov_result *r = solve_cg_2(&req, clnt2);
+    int ok = r != NULL && r->success && r->converged && r->residuals.residuals_len == (u_int)r->iterations + 1 &&
+             r->residuals.residuals_val[r->iterations] <= 1e-10 && csr_relative_residual(&poisson, b, r->x.x_val) < 1e-9;
+    if (ok) plain = r->iterations;
+    ASSERT(ok, "CG should solve the Poisson system and report its residual history");
+    req.precond = PRECOND_ILU0;
+    r = solve_cg_2(&req, clnt2);
+    ok = r != NULL && r->success && r->converged && csr_relative_residual(&poisson, b, r->x.x_val) < 1e-9;
+    if (ok) ilu = r->iterations;
+    ASSERT(ok && ilu < plain / 2, "ILU(0)-preconditioned CG should need under half the iterations");
+    
+    // Test case 24.2: GMRES with each preconditioner solves the nonsymmetric system
+    req.sparse = convection;
+    const char *names[] = { "Unpreconditioned GMRES should converge", "Jacobi GMRES should converge",
+                            "ILU(0) GMRES should converge" };
+    for (int pc = PRECOND_NONE; pc <= PRECOND_ILU0; pc++) {
+        req.precond = (krylov_precond)pc;
+        req.restart = 20;
+        r = solve_gmres_2(&req, clnt2);
+        ok = r != NULL && r->success && r->converged && csr_relative_residual(&convection, b, r->x.x_val) < 1e-9;
+        ASSERT(ok, names[pc]);
+    }
+    
+    // Test case 24.3: the iteration cap stops GMRES without converging
+    req.precond = PRECOND_NONE;
+    req.max_iter = 5;
+    r = solve_gmres_2(&req, clnt2);
+    ASSERT(r != NULL && r->success && !r->converged && r->iterations == 5 && r->residuals.residuals_len == 6,
+           "GMRES should stop unconverged at max_iter");
+    
+    // Test case 24.4: Jacobi CG on a stored dense SPD matrix
+    int d = 200;
+    double *A = (double *)malloc(d * d * sizeof(double));
+    for (int i = 0; i < d; i++)
+        for (int j = 0; j < d; j++) A[i * d + j] = i == j ? 10.0 + i % 5 : 1.0 / (1.0 + abs(i - j));
+    const char *error = NULL;
+    int handle = 0;
+    ok = transfer_store(clnt, d, d, A, &handle, &error);
+    req = (krylov_request){ handle, { 0, 0, { 0, NULL }, { 0, NULL }, { 0, NULL } }, { d, b }, { 0, NULL },
+                            1e-12, 500, PRECOND_JACOBI, 0 };
+    r = ok ? solve_cg_2(&req, clnt2) : NULL;
+    double diff = 0.0;
+    for (int i = 0; r != NULL && r->success && i < d; i++) {
+        double s = 0.0;
+        for (int j = 0; j < d; j++) s += A[i * d + j] * r->x.x_val[j];
+        diff = fmax(diff, fabs(s - b[i]));
+    }
+    ASSERT(r != NULL && r->success && r->converged && diff < 1e-9, "Dense CG should solve the stored system");
+    
+    // Test case 24.5: ILU(0) needs a sparse operand and CG a positive definite one
+    req.precond = PRECOND_ILU0;
+    r = solve_cg_2(&req, clnt2);
+    ASSERT(r != NULL && !r->success && strstr(r->error_msg, "sparse") != NULL, "Dense ILU(0) should be refused");
+    for (int i = 0; i < d; i++) A[i * d + i] = -A[i * d + i];
+    int negative = 0;
+    ok = transfer_store(clnt, d, d, A, &negative, &error);
+    req.handle = negative;
+    req.precond = PRECOND_NONE;
+    r = ok ? solve_cg_2(&req, clnt2) : NULL;
+    ASSERT(r != NULL && !r->success && strstr(r->error_msg, "positive definite") != NULL,
+           "CG on a negative definite matrix should fail");
+    
+    store_free_1(&handle, clnt);
+    store_free_1(&negative, clnt);
+    clnt_destroy(clnt2);
+    free(poisson.row_ptr.row_ptr_val); free(poisson.col_idx.col_idx_val); free(poisson.values.values_val);
+    free(convection.row_ptr.row_ptr_val); free(convection.col_idx.col_idx_val); free(convection.values.values_val);
+    free(A); free(b);
+}
+
+/* Largest entry of A X - B, or of A^T (A X - B) when normal is set; A is m x n, B m x nrhs */
+static double lstsq_residual(int m, int n, int nrhs, const double *A, const double *X, const double *B, int normal) {
+    double *r = (double *)malloc((size_t)m * nrhs * sizeof(double)), worst = 0.0;
+    for (int i = 0; i < m; i++)
+        for (int c = 0; c < nrhs; c++) {
+            double s = -B[i * nrhs + c];
+            for (int j = 0; j < n; j++) s += A[(size_t)i * n + j] * X[j * nrhs + c];
+            r[i * nrhs + c] = s;
+            if (!normal) worst = fmax(worst, fabs(s));
+        }
+    for (int j = 0; normal && j < n; j++)
+        for (int c = 0; c < nrhs; c++) {
+            double s = 0.0;
+            for (int i = 0; i < m; i++) s += A[(size_t)i * n + j] * r[i * nrhs + c];
+            worst = fmax(worst, fabs(s));
+        }
+    free(r);
+    return worst;
+}
+
+/* Test 25: Householder QR and least squares */
+void test_qr_lstsq(CLIENT *clnt, const char *server_address) {
+    printf("\n=== Test 25: QR and Least Squares ===\n");
+    
+    CLIENT *clnt2 = transfer_connect(server_address);
+    ASSERT(clnt2 != NULL, "Version 2 handle should connect");
+    if (clnt2 == NULL) return;
+    
+    srand(25);
+    double small[96], rhs[24], x[24];
+    for (int i = 0; i < 96; i++) small[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < 24; i++) rhs[i] = (double)rand() / RAND_MAX - 0.5;
+    
+    // Test case 25.1: thin QR of a 12 x 8 matrix: Q^T Q = I, R upper triangular, Q R = A
+    matrix a = { 12, 8, { 96, small } };
+    qr_result *qr = matrix_qr_2(&a, clnt2);
+    int ok = qr != NULL && qr->success && qr->q.rows == 12 && qr->q.cols == 8 && qr->r.rows == 8 && qr->r.cols == 8;
+    double orth = 0.0, recon = 0.0, lower = 0.0;
+    for (int i = 0; ok && i < 8; i++)
+        for (int j = 0; j < 8; j++) {
+            double s = 0.0;
+            for (int r = 0; r < 12; r++) s += qr->q.data.data_val[r * 8 + i] * qr->q.data.data_val[r * 8 + j];
+            orth = fmax(orth, fabs(s - (i == j)));
+            if (i > j) lower = fmax(lower, fabs(qr->r.data.data_val[i * 8 + j]));
+        }
+    for (int i = 0; ok && i < 12; i++)
+        for (int j = 0; j < 8; j++) {
+            double s = 0.0;
+            for (int r = 0; r < 8; r++) s += qr->q.data.data_val[i * 8 + r] * qr->r.data.data_val[r * 8 + j];
+            recon = fmax(recon, fabs(s - small[i * 8 + j]));
+        }
+    ASSERT(ok && orth < 1e-12 && lower == 0.0 && recon < 1e-12, "Q R should reproduce A with orthonormal Q");
+    
+    // Test case 25.2: overdetermined 12 x 8 system: the residual is orthogonal to A's columns
+    matrix_pair pair = { a, { 12, 2, { 24, rhs } } };
+    matrix_result *res = matrix_lstsq_2(&pair, clnt2);
+    ok = res != NULL && res->success && res->result_matrix.rows == 8 && res->result_matrix.cols == 2;
+    ASSERT(ok && lstsq_residual(12, 8, 2, small, res->result_matrix.data.data_val, rhs, 1) < 1e-12,
+           "Least squares should satisfy the normal equations");
+    
+    // Test case 25.3: underdetermined 4 x 12 system: exact, and the minimum-norm solution lies in A's row space
+    matrix wide = { 4, 12, { 48, small } };
+    pair = (matrix_pair){ wide, { 4, 2, { 8, rhs } } };
+    res = matrix_lstsq_2(&pair, clnt2);
+    ok = res != NULL && res->success && res->result_matrix.rows == 12 &&
+         lstsq_residual(4, 12, 2, small, res->result_matrix.data.data_val, rhs, 0) < 1e-12;
+    if (ok) memcpy(x, res->result_matrix.data.data_val, 24 * sizeof(double));
+    double at[48];
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 12; j++) at[j * 4 + i] = small[i * 12 + j];
+    pair = (matrix_pair){ { 12, 4, { 48, at } }, { 12, 2, { 24, x } } };
+    res = ok ? matrix_lstsq_2(&pair, clnt2) : NULL;
+    double *y = res != NULL && res->success ? res->result_matrix.data.data_val : NULL;
+    ASSERT(y != NULL && lstsq_residual(12, 4, 2, at, y, x, 0) < 1e-12, "Underdetermined solution should have minimum norm");
+    
+    // Test case 25.4: a repeated column is rank deficient; shapes that overflow 32 bits are refused
+    for (int i = 0; i < 12; i++) small[i * 8 + 5] = small[i * 8 + 2];
+    pair = (matrix_pair){ a, { 12, 2, { 24, rhs } } };
+    res = matrix_lstsq_2(&pair, clnt2);
+    ASSERT(res != NULL && !res->success && strstr(res->error_msg, "rank deficient") != NULL,
+           "Rank-deficient least squares should fail");
+    matrix huge = { 65536, 65536, { 0, NULL } };
+    qr_result *bad = matrix_qr_2(&huge, clnt2);
+    ASSERT(bad != NULL && !bad->success && strstr(bad->error_msg, "does not match") != NULL,
+           "QR of a shape that overflows 32 bits should fail");
+    pair = (matrix_pair){ { 4, 1 << 30, { 0, NULL } }, { 4, 1, { 4, rhs } } };
+    res = matrix_lstsq_2(&pair, clnt2);
+    ASSERT(res != NULL && !res->success && strstr(res->error_msg, "does not match") != NULL,
+           "Least squares with a shape that overflows 32 bits should fail");
+    
+    // Test case 25.5: staged 600 x 150 fit of a consistent system recovers the coefficients
+    int m = 600, n = 150;
+    double *A = (double *)malloc((size_t)m * n * sizeof(double));
+    double *X = (double *)malloc(n * 2 * sizeof(double));
+    double *B = (double *)calloc((size_t)m * 2, sizeof(double));
+    double *out = (double *)malloc((size_t)m * n * sizeof(double));
+    for (int i = 0; i < m * n; i++) A[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < n * 2; i++) X[i] = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            for (int c = 0; c < 2; c++) B[i * 2 + c] += A[i * n + j] * X[j * 2 + c];
+    const char *error = NULL;
+    int rows = 0, cols = 0;
+    ok = transfer_run(clnt, OP_LSTSQ, m, n, A, m, 2, B, store_rows, out, &rows, &cols, &error);
+    double diff = 0.0;
+    for (int i = 0; ok && i < n * 2; i++) diff = fmax(diff, fabs(out[i] - X[i]));
+    ASSERT(ok && rows == n && cols == 2 && diff < 1e-10, "Staged least squares should recover the coefficients");
+    
+    // Test case 25.6: STORE_QR of a stored 600 x 150 matrix keeps both factors on the server
+    int handle = 0;
+    ok = transfer_store(clnt, m, n, A, &handle, &error);
+    qr_handles *h = ok ? store_qr_2(&handle, clnt2) : NULL;
+    ok = h != NULL && h->success && h->rows == m && h->cols == n && h->k == n;
+    int product = 0;
+    ok = ok && transfer_apply(clnt, OP_MULT, h->q, h->r, &product, &rows, &cols, &error) &&
+         transfer_fetch(clnt, product, m, n, store_rows, out, &error);
+    diff = 0.0;
+    for (int i = 0; ok && i < m * n; i++) diff = fmax(diff, fabs(out[i] - A[i]));
+    ASSERT(ok && diff < 1e-12, "Stored Q times stored R should reproduce A");
+    
+    if (h != NULL && h->success) {
+        store_free_1(&h->q, clnt);
+        store_free_1(&h->r, clnt);
+    }
+    store_free_1(&product, clnt);
+    store_free_1(&handle, clnt);
+    clnt_destroy(clnt2);
+    free(A); free(X); free(B); free(out);
+}
+
 int main(int argc, char *argv[]) {
     if (argc != 2) {
         printf("Usage: %s <server_address>\n", argv[0]);
@@ -303,6 +1806,25 @@ int main(int argc, char *argv[]) {
     test_matrix_transpose(clnt);
     test_matrix_inverse(clnt);
     test_error_conditions(clnt);
+    test_staged_transfer(clnt, server_address);
+    test_buffer_reuse(clnt);
+    test_matrix_store(clnt);
+    test_expression(clnt);
+    test_lu_solve(clnt);
+    test_result_cache(clnt);
+    test_mixed_precision(clnt);
+    test_sparse(clnt);
+    test_raw_payloads(clnt, server_address);
+    test_async_client(server_address);
+    test_distributed_mult(server_address);
+    test_server_stats(clnt, server_address);
+    test_strassen(clnt);
+    test_blocked_transpose(clnt);
+    test_gemm_syrk(clnt, server_address);
+    test_compressed_payloads(server_address);
+    test_shared_memory(server_address);
+    test_krylov(clnt, server_address);
+    test_qr_lstsq(clnt, server_address);
     
     // Print summary
     printf("\n========================================\n");
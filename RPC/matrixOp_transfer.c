@@ -0,0 +1,540 @@
+/*
+ * matrixOp_transfer.c - Client-side staged transfers for matrices larger than MAX_SIZE
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <arpa/inet.h>
+#include "matrixOp_transfer.h"
+#include "matrixOp_codec.h"
+#include "matrixOp_shm.h"
+
+/* Stub default per-call timeout, and the one used while the server computes */
+#define TRANSFER_CALL_TIMEOUT 25
+#define TRANSFER_COMMIT_TIMEOUT 600
+
+/* Server messages live in the stub's static reply, so keep a copy per thread */
+static __thread char error_buffer[128];
+
+static const char *keep_error(const char *msg) {
+    snprintf(error_buffer, sizeof(error_buffer), "%s", msg ? msg : "Error: Unknown failure");
+    return error_buffer;
+}
+
+static void set_timeout(CLIENT *clnt, int seconds) {
+    struct timeval tv = { seconds, 0 };
+    clnt_control(clnt, CLSET_TIMEOUT, (char *)&tv);
+}
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define NATIVE_ORDER ORDER_LITTLE_ENDIAN
+#else
+#define NATIVE_ORDER ORDER_BIG_ENDIAN
+#endif
+
+/* Compression is chosen per thread, like the stub results it works through */
+static __thread int compress_payloads;
+static __thread double *codec_buffer;
+
+void transfer_set_compression(int on) {
+    compress_payloads = on;
+}
+
+/* Tile-sized buffer for packing uploads and unpacking reads; malloc'd, so aligned for doubles */
+static double *codec_scratch(void) {
+    if (!codec_buffer) codec_buffer = (double *)malloc(MAX_TILE_BYTES);
+    return codec_buffer;
+}
+
+/* Version 2 handles move matrix data as raw bytes instead of per-element XDR */
+static int raw_payloads(CLIENT *clnt) {
+    rpcvers_t vers = MATRIX_OPERATIONS_VERS;
+    clnt_control(clnt, CLGET_VERS, (char *)&vers);
+    return vers >= MATRIX_OPERATIONS_VERS2;
+}
+
+/* Connect straight to host:port, skipping the portmapper; version 2 unless the server lacks it */
+static CLIENT *connect_port(const char *host, int port) {
+    struct addrinfo hints, *found;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, NULL, &hints, &found) != 0) {
+        rpc_createerr.cf_stat = RPC_UNKNOWNHOST;
+        return NULL;
+    }
+    struct sockaddr_in addr = *(struct sockaddr_in *)found->ai_addr;
+    freeaddrinfo(found);
+    addr.sin_port = htons(port);
+    
+    rpcvers_t versions[] = { MATRIX_OPERATIONS_VERS2, MATRIX_OPERATIONS_VERS };
+    for (int i = 0; i < 2; i++) {
+        int sock = RPC_ANYSOCK;
+        CLIENT *clnt = clnttcp_create(&addr, MATRIX_OPERATIONS_PROG, versions[i], &sock, 0, 0);
+        if (clnt == NULL) return NULL;
+        struct timeval tv = { TRANSFER_CALL_TIMEOUT, 0 };
+        enum clnt_stat status = clnt_call(clnt, NULLPROC, (xdrproc_t)xdr_void, NULL,
+                                          (xdrproc_t)xdr_void, NULL, tv);
+        if (status == RPC_SUCCESS) return clnt;
+        clnt_destroy(clnt);
+        if (status != RPC_PROGVERSMISMATCH) {
+            rpc_createerr.cf_stat = status;
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+CLIENT *transfer_connect(const char *host) {
+    /* host:port names an instance started with -p; a second colon means an IPv6 address */
+    const char *colon = strrchr(host, ':');
+    if (colon && colon != host && memchr(host, ':', colon - host) == NULL) {
+        char name[256];
+        int port = atoi(colon + 1);
+        if (port <= 0 || port > 65535 || (size_t)(colon - host) >= sizeof(name)) {
+            rpc_createerr.cf_stat = RPC_UNKNOWNHOST;
+            return NULL;
+        }
+        memcpy(name, host, colon - host);
+        name[colon - host] = '\0';
+        return connect_port(name, port);
+    }
+    
+    rpcvers_t vers;
+    return clnt_create_vers(host, MATRIX_OPERATIONS_PROG, &vers,
+                            MATRIX_OPERATIONS_VERS, MATRIX_OPERATIONS_VERS2, "tcp");
+}
+
+/* Send one operand as row blocks of at most MAX_TILE elements, in double or float32 tiles */
+static int upload_blocks(CLIENT *clnt, int session, int operand, int rows, int cols,
+                         const double *data, const float *data32, const char **error) {
+    int block = MAX_TILE / cols;
+    int raw = raw_payloads(clnt);
+    
+    if (block < 1) {
+        *error = "Error: Row wider than MAX_TILE elements";
+        return 0;
+    }
+    
+    for (int row = 0; row < rows; row += block) {
+        int count = (rows - row < block) ? rows - row : block;
+        stage_status *status;
+        
+        if (data32) {
+            stage_tile32 tile = { session, operand, row, 0, count, cols,
+                                  { count * cols, (float *)(data32 + (size_t)row * cols) } };
+            status = stage_append32_1(&tile, clnt);
+        } else if (raw && compress_payloads) {
+            /* Fall back to plain bytes (CODEC_NONE) for small or incompressible tiles */
+            size_t bytes = (size_t)count * cols * sizeof(double);
+            const double *rows_in = data + (size_t)row * cols;
+            char *packed = (char *)codec_scratch();
+            size_t packed_bytes = packed ? codec_pack(rows_in, bytes, packed) : 0;
+            stage_tile_packed tile = { session, operand, row, 0, count, cols, NATIVE_ORDER,
+                                       packed_bytes ? CODEC_SHUFFLE_DEFLATE : CODEC_NONE,
+                                       { packed_bytes ? packed_bytes : bytes,
+                                         packed_bytes ? packed : (char *)rows_in } };
+            status = stage_append_packed_2(&tile, clnt);
+        } else if (raw) {
+            /* Encoded straight from the caller's rows with one copy */
+            stage_tile_raw tile = { session, operand, row, 0, count, cols, NATIVE_ORDER,
+                                    { count * cols * sizeof(double), (char *)(data + (size_t)row * cols) } };
+            status = stage_append_raw_2(&tile, clnt);
+        } else {
+            stage_tile tile = { session, operand, row, 0, count, cols,
+                                { count * cols, (double *)(data + (size_t)row * cols) } };
+            status = stage_append_1(&tile, clnt);
+        }
+        if (status == NULL) {
+            *error = keep_error(clnt_sperror(clnt, "append"));
+            return 0;
+        }
+        int ok = status->success;
+        if (!ok) *error = keep_error(status->error_msg);
+        xdr_free((xdrproc_t)xdr_stage_status, (char *)status);
+        if (!ok) return 0;
+    }
+    return 1;
+}
+
+int transfer_upload(CLIENT *clnt, int session, int operand,
+                    int rows, int cols, const double *data, const char **error) {
+    return upload_blocks(clnt, session, operand, rows, cols, data, NULL, error);
+}
+
+int transfer_upload32(CLIENT *clnt, int session, int operand,
+                      int rows, int cols, const float *data, const char **error) {
+    return upload_blocks(clnt, session, operand, rows, cols, NULL, data, error);
+}
+
+/* Swap raw rows in place if the server's byte order differs from ours, then pass them on */
+static int deliver_raw(int row, int rows, int cols, byte_order order, double *data,
+                       transfer_rows_fn on_rows, void *ctx, const char **error) {
+    if (order != NATIVE_ORDER) {
+        uint64_t *bits = (uint64_t *)data;
+        for (size_t i = 0; i < (size_t)rows * cols; i++) bits[i] = __builtin_bswap64(bits[i]);
+    }
+    if (on_rows && !on_rows(row, rows, cols, data, ctx)) {
+        *error = "Error: Result consumer stopped the transfer";
+        return 0;
+    }
+    return 1;
+}
+
+/* Compressed read: the server packs the rows when that shrinks them */
+static int read_packed_block(CLIENT *clnt, int id, int from_store, int row, int block,
+                             transfer_rows_fn on_rows, void *ctx, int *got, const char **error) {
+    packed_range range = { id, row, block, CODEC_SHUFFLE_DEFLATE };
+    stage_rows_packed *reply = from_store ? store_read_packed_2(&range, clnt)
+                                          : stage_read_packed_2(&range, clnt);
+    if (reply == NULL) {
+        *error = keep_error(clnt_sperror(clnt, "read"));
+        return 0;
+    }
+    size_t bytes = (size_t)reply->rows * reply->cols * sizeof(double);
+    double *data = (double *)reply->data.data_val;
+    int ok = reply->success && reply->rows > 0 && bytes <= MAX_TILE_BYTES;
+    if (!ok) {
+        *error = keep_error(reply->success ? "Error: Raw rows do not match their shape" : reply->error_msg);
+    } else if (reply->codec == CODEC_SHUFFLE_DEFLATE) {
+        data = codec_scratch();
+        ok = data && codec_unpack(reply->data.data_val, reply->data.data_len, data, bytes);
+        if (!ok) *error = "Error: Corrupt compressed payload";
+    } else if (reply->codec != CODEC_NONE || reply->data.data_len != bytes) {
+        *error = "Error: Raw rows do not match their shape";
+        ok = 0;
+    }
+    if (ok) ok = deliver_raw(reply->row, reply->rows, reply->cols, reply->order, data, on_rows, ctx, error);
+    *got = reply->rows;
+    xdr_free((xdrproc_t)xdr_stage_rows_packed, (char *)reply);
+    return ok;
+}
+
+/* Version 2 read: the rows arrive as raw bytes in the server's order */
+static int read_raw_block(CLIENT *clnt, int id, int from_store, int row, int block,
+                          transfer_rows_fn on_rows, void *ctx, int *got, const char **error) {
+    if (compress_payloads) return read_packed_block(clnt, id, from_store, row, block, on_rows, ctx, got, error);
+    stage_rows_raw *reply;
+    if (from_store) {
+        handle_range range = { id, row, block };
+        reply = store_read_raw_2(&range, clnt);
+    } else {
+        stage_range range = { id, row, block };
+        reply = stage_read_raw_2(&range, clnt);
+    }
+    if (reply == NULL) {
+        *error = keep_error(clnt_sperror(clnt, "read"));
+        return 0;
+    }
+    size_t count = (size_t)reply->rows * reply->cols;
+    int ok = reply->success && reply->rows > 0 && reply->data.data_len == count * sizeof(double);
+    if (!ok) {
+        *error = keep_error(reply->success ? "Error: Raw rows do not match their shape" : reply->error_msg);
+    } else {
+        /* XDR decodes opaque data into a malloc'd buffer, so it is aligned for doubles */
+        ok = deliver_raw(reply->row, reply->rows, reply->cols, reply->order,
+                         (double *)reply->data.data_val, on_rows, ctx, error);
+    }
+    *got = reply->rows;
+    xdr_free((xdrproc_t)xdr_stage_rows_raw, (char *)reply);
+    return ok;
+}
+
+/* Pull row blocks from a committed session (from_store = 0) or a stored matrix (1) */
+static int read_blocks(CLIENT *clnt, int id, int from_store, int rows, int cols,
+                       transfer_rows_fn on_rows, void *ctx, const char **error) {
+    int block = MAX_TILE / cols;
+    int raw = raw_payloads(clnt);
+    
+    for (int row = 0; row < rows; ) {
+        if (raw) {
+            int got = 0;
+            if (!read_raw_block(clnt, id, from_store, row, block, on_rows, ctx, &got, error)) return 0;
+            row += got;
+            continue;
+        }
+        stage_rows *reply;
+        if (from_store) {
+            handle_range range = { id, row, block };
+            reply = store_read_1(&range, clnt);
+        } else {
+            stage_range range = { id, row, block };
+            reply = stage_read_1(&range, clnt);
+        }
+        if (reply == NULL) {
+            *error = keep_error(clnt_sperror(clnt, "read"));
+            return 0;
+        }
+        /* Hand each block to the consumer, then release the decoded rows before the next call */
+        int ok = reply->success && reply->rows > 0;
+        if (!ok) {
+            *error = keep_error(reply->error_msg);
+        } else if (on_rows && !on_rows(reply->row, reply->rows, reply->cols, reply->data.data_val, ctx)) {
+            *error = "Error: Result consumer stopped the transfer";
+            ok = 0;
+        }
+        row += reply->rows;
+        xdr_free((xdrproc_t)xdr_stage_rows, (char *)reply);
+        if (!ok) return 0;
+    }
+    return 1;
+}
+
+int transfer_read(CLIENT *clnt, int session, int rows, int cols,
+                  transfer_rows_fn on_rows, void *ctx, const char **error) {
+    return read_blocks(clnt, session, 0, rows, cols, on_rows, ctx, error);
+}
+
+int transfer_read32(CLIENT *clnt, int session, int rows, int cols,
+                    transfer_rows32_fn on_rows, void *ctx, const char **error) {
+    int block = MAX_TILE / cols;
+    
+    for (int row = 0; row < rows; ) {
+        stage_range range = { session, row, block };
+        stage_rows32 *reply = stage_read32_1(&range, clnt);
+        if (reply == NULL) {
+            *error = keep_error(clnt_sperror(clnt, "read"));
+            return 0;
+        }
+        int ok = reply->success && reply->rows > 0;
+        if (!ok) {
+            *error = keep_error(reply->error_msg);
+        } else if (on_rows && !on_rows(reply->row, reply->rows, reply->cols, reply->data.data_val, ctx)) {
+            *error = "Error: Result consumer stopped the transfer";
+            ok = 0;
+        }
+        row += reply->rows;
+        xdr_free((xdrproc_t)xdr_stage_rows32, (char *)reply);
+        if (!ok) return 0;
+    }
+    return 1;
+}
+
+static int binary_op(matrix_op op) {
+    return op == OP_ADD || op == OP_MULT || op == OP_SOLVE ||
+           op == OP_MULT32 || op == OP_SOLVE_MIXED || op == OP_LSTSQ;
+}
+
+/* Open a session for op on operands of the given shapes */
+static int begin_session(CLIENT *clnt, matrix_op op, int a_rows, int a_cols,
+                         int b_rows, int b_cols, int *session, const char **error) {
+    stage_request request;
+    
+    memset(&request, 0, sizeof(request));
+    request.op = op;
+    request.first_rows = a_rows;
+    request.first_cols = a_cols;
+    if (binary_op(op)) {
+        request.second_rows = b_rows;
+        request.second_cols = b_cols;
+    }
+    
+    stage_status *status = stage_begin_1(&request, clnt);
+    if (status == NULL) {
+        *error = keep_error(clnt_sperror(clnt, "begin"));
+        return 0;
+    }
+    int ok = status->success;
+    if (ok) *session = status->session;
+    else *error = keep_error(status->error_msg);
+    xdr_free((xdrproc_t)xdr_stage_status, (char *)status);
+    return ok;
+}
+
+/* Commit a session and report the result shape */
+static int commit_session(CLIENT *clnt, int session, int *rows, int *cols, const char **error) {
+    /* Large products and inverses can take longer than the default call timeout */
+    set_timeout(clnt, TRANSFER_COMMIT_TIMEOUT);
+    stage_status *status = stage_commit_1(&session, clnt);
+    set_timeout(clnt, TRANSFER_CALL_TIMEOUT);
+    if (status == NULL) {
+        *error = keep_error(clnt_sperror(clnt, "commit"));
+        return 0;
+    }
+    int ok = status->success;
+    if (ok) {
+        *rows = status->rows;
+        *cols = status->cols;
+    } else {
+        *error = keep_error(status->error_msg);
+    }
+    xdr_free((xdrproc_t)xdr_stage_status, (char *)status);
+    return ok;
+}
+
+int transfer_run(CLIENT *clnt, matrix_op op,
+                 int a_rows, int a_cols, const double *A,
+                 int b_rows, int b_cols, const double *B,
+                 transfer_rows_fn on_rows, void *ctx,
+                 int *out_rows, int *out_cols, const char **error) {
+    int session, rows, cols;
+    int ok = 0;
+    
+    if (!begin_session(clnt, op, a_rows, a_cols, b_rows, b_cols, &session, error)) return 0;
+    if (!transfer_upload(clnt, session, 0, a_rows, a_cols, A, error)) goto done;
+    if (binary_op(op) && !transfer_upload(clnt, session, 1, b_rows, b_cols, B, error)) goto done;
+    if (!commit_session(clnt, session, &rows, &cols, error)) goto done;
+    if (out_rows) *out_rows = rows;
+    if (out_cols) *out_cols = cols;
+    
+    ok = transfer_read(clnt, session, rows, cols, on_rows, ctx, error);
+    
+done:
+    stage_end_1(&session, clnt);
+    return ok;
+}
+
+int transfer_run32(CLIENT *clnt, matrix_op op,
+                   int a_rows, int a_cols, const float *A,
+                   int b_rows, int b_cols, const float *B,
+                   transfer_rows32_fn on_rows, void *ctx,
+                   int *out_rows, int *out_cols, const char **error) {
+    int session, rows, cols;
+    int ok = 0;
+    
+    if (!begin_session(clnt, op, a_rows, a_cols, b_rows, b_cols, &session, error)) return 0;
+    if (!transfer_upload32(clnt, session, 0, a_rows, a_cols, A, error)) goto done;
+    if (binary_op(op) && !transfer_upload32(clnt, session, 1, b_rows, b_cols, B, error)) goto done;
+    if (!commit_session(clnt, session, &rows, &cols, error)) goto done;
+    if (out_rows) *out_rows = rows;
+    if (out_cols) *out_cols = cols;
+    
+    ok = transfer_read32(clnt, session, rows, cols, on_rows, ctx, error);
+    
+done:
+    stage_end_1(&session, clnt);
+    return ok;
+}
+
+/* Copy the handle out of a store reply and release it */
+static int take_handle(CLIENT *clnt, handle_result *reply, const char *call,
+                       int *handle, int *rows, int *cols, const char **error) {
+    if (reply == NULL) {
+        *error = keep_error(clnt_sperror(clnt, call));
+        return 0;
+    }
+    int ok = reply->success;
+    if (ok) {
+        *handle = reply->handle;
+        if (rows) *rows = reply->rows;
+        if (cols) *cols = reply->cols;
+    } else {
+        *error = keep_error(reply->error_msg);
+    }
+    xdr_free((xdrproc_t)xdr_handle_result, (char *)reply);
+    return ok;
+}
+
+int transfer_store(CLIENT *clnt, int rows, int cols, const double *data,
+                   int *handle, const char **error) {
+    /* Small matrices fit in a single call */
+    if ((size_t)rows * cols <= MAX_SIZE) {
+        matrix m = { rows, cols, { rows * cols, (double *)data } };
+        return take_handle(clnt, store_put_1(&m, clnt), "store", handle, NULL, NULL, error);
+    }
+    
+    int session, out_rows, out_cols;
+    if (!begin_session(clnt, OP_STORE, rows, cols, 0, 0, &session, error)) return 0;
+    
+    int ok = transfer_upload(clnt, session, 0, rows, cols, data, error) &&
+             commit_session(clnt, session, &out_rows, &out_cols, error);
+    /* Adopting ends the session; otherwise it is released here */
+    if (ok && take_handle(clnt, store_adopt_1(&session, clnt), "adopt", handle, NULL, NULL, error)) {
+        return 1;
+    }
+    stage_end_1(&session, clnt);
+    return 0;
+}
+
+int transfer_apply(CLIENT *clnt, matrix_op op, int first, int second,
+                   int *handle, int *rows, int *cols, const char **error) {
+    handle_op args = { op, first, second };
+    
+    set_timeout(clnt, TRANSFER_COMMIT_TIMEOUT);
+    handle_result *reply = store_apply_1(&args, clnt);
+    set_timeout(clnt, TRANSFER_CALL_TIMEOUT);
+    return take_handle(clnt, reply, "apply", handle, rows, cols, error);
+}
+
+int transfer_fetch(CLIENT *clnt, int handle, int rows, int cols,
+                   transfer_rows_fn on_rows, void *ctx, const char **error) {
+    return read_blocks(clnt, handle, 1, rows, cols, on_rows, ctx, error);
+}
+
+int transfer_shm_create(CLIENT *clnt, size_t size, transfer_segment *seg, const char **error) {
+    static int created;
+    char name[SHM_NAME_MAX];
+    snprintf(name, sizeof(name), "%s%d-%d", SHM_NAME_PREFIX, (int)getpid(),
+             __atomic_add_fetch(&created, 1, __ATOMIC_RELAXED));
+    
+    memset(seg, 0, sizeof(*seg));
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        *error = "Error: Cannot create shared memory segment";
+        return 0;
+    }
+    void *base = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0) {
+        base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(name);
+        *error = "Error: Cannot map shared memory segment";
+        return 0;
+    }
+    
+    char *arg = name;
+    shm_attach_result *reply = shm_attach_2(&arg, clnt);
+    shm_unlink(name);
+    if (reply == NULL || !reply->success || reply->size != size) {
+        *error = keep_error(reply == NULL ? clnt_sperror(clnt, "attach") :
+                            reply->success ? "Error: Server mapped a different size" : reply->error_msg);
+        if (reply != NULL && reply->success) shm_detach_2(&reply->segment, clnt);
+        if (reply != NULL) xdr_free((xdrproc_t)xdr_shm_attach_result, (char *)reply);
+        munmap(base, size);
+        return 0;
+    }
+    seg->segment = reply->segment;
+    seg->base = base;
+    seg->size = size;
+    xdr_free((xdrproc_t)xdr_shm_attach_result, (char *)reply);
+    return 1;
+}
+
+int transfer_shm_apply(CLIENT *clnt, const transfer_segment *seg, matrix_op op,
+                       size_t a_offset, int a_rows, int a_cols,
+                       size_t b_offset, int b_rows, int b_cols,
+                       size_t out_offset, int *out_rows, int *out_cols, const char **error) {
+    shm_request args = { seg->segment, op, { a_offset, a_rows, a_cols },
+                         { b_offset, b_rows, b_cols }, out_offset };
+    
+    set_timeout(clnt, TRANSFER_COMMIT_TIMEOUT);
+    shm_result *reply = shm_apply_2(&args, clnt);
+    set_timeout(clnt, TRANSFER_CALL_TIMEOUT);
+    if (reply == NULL) {
+        *error = keep_error(clnt_sperror(clnt, "shm apply"));
+        return 0;
+    }
+    int ok = reply->success;
+    if (!ok) {
+        *error = keep_error(reply->error_msg);
+    } else {
+        if (out_rows) *out_rows = reply->rows;
+        if (out_cols) *out_cols = reply->cols;
+    }
+    xdr_free((xdrproc_t)xdr_shm_result, (char *)reply);
+    return ok;
+}
+
+void transfer_shm_destroy(CLIENT *clnt, transfer_segment *seg) {
+    if (seg->segment) shm_detach_2(&seg->segment, clnt);
+    if (seg->base) munmap(seg->base, seg->size);
+    memset(seg, 0, sizeof(*seg));
+}
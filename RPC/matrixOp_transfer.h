@@ -0,0 +1,117 @@
+/*
+ * matrixOp_transfer.h - Client-side staged transfers for matrices larger than MAX_SIZE
+ */
+
+#ifndef MATRIXOP_TRANSFER_H
+#define MATRIXOP_TRANSFER_H
+
+#include "matrixOp.h"
+
+/*
+ * Connect over TCP at the highest interface version the server offers.
+ * On a version 2 handle the transfers below move matrix data as raw
+ * doubles; servers that only speak version 1 get the XDR encoding.
+ * "host:port" reaches a server started with -p port directly.
+ */
+CLIENT *transfer_connect(const char *host);
+
+/*
+ * With compression on, version 2 transfers from this thread send tiles and
+ * ask for result rows byte-shuffled and deflated whenever that shrinks
+ * them (see COMPRESS_MIN_BYTES). Pays off for structured matrices over
+ * slow links; needs a server with the STAGE_APPEND_PACKED procedures.
+ */
+void transfer_set_compression(int on);
+
+/* Called for each block of result rows as it arrives; return 0 to abort the read */
+typedef int (*transfer_rows_fn)(int row, int rows, int cols, const double *data, void *ctx);
+
+/* Upload one operand of an open session as row blocks of at most MAX_TILE elements */
+int transfer_upload(CLIENT *clnt, int session, int operand,
+                    int rows, int cols, const double *data, const char **error);
+
+/* Stream the committed result of a session to on_rows, block by block */
+int transfer_read(CLIENT *clnt, int session, int rows, int cols,
+                  transfer_rows_fn on_rows, void *ctx, const char **error);
+
+/*
+ * Run an operation on operands of any size up to MAX_STAGE_DIM:
+ * begin, upload, commit, stream result rows to on_rows, end.
+ * B is ignored for unary operations. Returns 1 on success; on failure
+ * *error points at a static or server-provided message.
+ */
+int transfer_run(CLIENT *clnt, matrix_op op,
+                 int a_rows, int a_cols, const double *A,
+                 int b_rows, int b_cols, const double *B,
+                 transfer_rows_fn on_rows, void *ctx,
+                 int *out_rows, int *out_cols, const char **error);
+
+/*
+ * Single-precision wire format: tiles and result rows travel as float32,
+ * half the bytes of the calls above. Operands are widened to double on the
+ * server, so they can be combined with any operation; pair them with
+ * OP_MULT32 to also compute in float32, or OP_SOLVE_MIXED for a float32
+ * factorization refined to double accuracy.
+ */
+typedef int (*transfer_rows32_fn)(int row, int rows, int cols, const float *data, void *ctx);
+
+int transfer_upload32(CLIENT *clnt, int session, int operand,
+                      int rows, int cols, const float *data, const char **error);
+
+int transfer_read32(CLIENT *clnt, int session, int rows, int cols,
+                    transfer_rows32_fn on_rows, void *ctx, const char **error);
+
+/* transfer_run with float32 operands and result rows */
+int transfer_run32(CLIENT *clnt, matrix_op op,
+                   int a_rows, int a_cols, const float *A,
+                   int b_rows, int b_cols, const float *B,
+                   transfer_rows32_fn on_rows, void *ctx,
+                   int *out_rows, int *out_cols, const char **error);
+
+/*
+ * Server-resident matrices: upload once, chain operations by handle and
+ * fetch only the results that are needed. Handles may be evicted when the
+ * server's store runs out of budget; calls then fail with an error.
+ */
+
+/* Keep a matrix on the server; small ones go in one call, larger ones are staged */
+int transfer_store(CLIENT *clnt, int rows, int cols, const double *data,
+                   int *handle, const char **error);
+
+/* Run op on stored matrices (second is ignored for unary ops); the result stays on the server */
+int transfer_apply(CLIENT *clnt, matrix_op op, int first, int second,
+                   int *handle, int *rows, int *cols, const char **error);
+
+/* Stream a stored rows x cols matrix to on_rows, block by block */
+int transfer_fetch(CLIENT *clnt, int handle, int rows, int cols,
+                   transfer_rows_fn on_rows, void *ctx, const char **error);
+
+/*
+ * Shared memory for clients on the server's host: operands and results
+ * live in one segment mapped by both processes, and calls carry only byte
+ * offsets. The name is unlinked once the server has attached it, so the
+ * memory goes away with the last of the two mappings.
+ */
+typedef struct {
+    int segment;            /* the server's id for it */
+    void *base;
+    size_t size;
+} transfer_segment;
+
+/* Create and map a segment of size bytes and have the server attach it */
+int transfer_shm_create(CLIENT *clnt, size_t size, transfer_segment *seg, const char **error);
+
+/*
+ * Run op on rows x cols operands at byte offsets into the segment (second
+ * is ignored for unary ops), writing the result at out_offset. Offsets
+ * are multiples of 8 and the result must not overlap the operands.
+ */
+int transfer_shm_apply(CLIENT *clnt, const transfer_segment *seg, matrix_op op,
+                       size_t a_offset, int a_rows, int a_cols,
+                       size_t b_offset, int b_rows, int b_cols,
+                       size_t out_offset, int *out_rows, int *out_cols, const char **error);
+
+/* Detach the segment from the server and unmap it */
+void transfer_shm_destroy(CLIENT *clnt, transfer_segment *seg);
+
+#endif /* MATRIXOP_TRANSFER_H */
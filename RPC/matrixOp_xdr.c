@@ -45,3 +45,1496 @@ xdr_matrix_result (XDR *xdrs, matrix_result *objp)
 		 return FALSE;
 	return TRUE;
 }
+
+bool_t
+xdr_matrix32 (XDR *xdrs, matrix32 *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_SIZE,
+		sizeof (float), (xdrproc_t) xdr_float))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_matrix32_pair (XDR *xdrs, matrix32_pair *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_matrix32 (xdrs, &objp->first))
+		 return FALSE;
+	 if (!xdr_matrix32 (xdrs, &objp->second))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_matrix32_result (XDR *xdrs, matrix32_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_matrix32 (xdrs, &objp->result_matrix))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_lu_result (XDR *xdrs, lu_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_matrix (xdrs, &objp->lu))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->pivots.pivots_val, (u_int *) &objp->pivots.pivots_len, MAX_SIZE,
+		sizeof (int), (xdrproc_t) xdr_int))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_det_result (XDR *xdrs, det_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_double (xdrs, &objp->determinant))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_cache_stats (XDR *xdrs, cache_stats *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_quad_t (xdrs, &objp->hits))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->misses))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->evictions))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->entries))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->bytes))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->budget))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_matrix_op (XDR *xdrs, matrix_op *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_enum (xdrs, (enum_t *) objp))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_stage_request (XDR *xdrs, stage_request *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		 if (!xdr_matrix_op (xdrs, &objp->op))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 4 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->first_rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->first_cols))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->second_rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->second_cols))
+				 return FALSE;
+		} else {
+			IXDR_PUT_LONG(buf, objp->first_rows);
+			IXDR_PUT_LONG(buf, objp->first_cols);
+			IXDR_PUT_LONG(buf, objp->second_rows);
+			IXDR_PUT_LONG(buf, objp->second_cols);
+		}
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		 if (!xdr_matrix_op (xdrs, &objp->op))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 4 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->first_rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->first_cols))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->second_rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->second_cols))
+				 return FALSE;
+		} else {
+			objp->first_rows = IXDR_GET_LONG(buf);
+			objp->first_cols = IXDR_GET_LONG(buf);
+			objp->second_rows = IXDR_GET_LONG(buf);
+			objp->second_cols = IXDR_GET_LONG(buf);
+		}
+	 return TRUE;
+	}
+
+	 if (!xdr_matrix_op (xdrs, &objp->op))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->first_rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->first_cols))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->second_rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->second_cols))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_stage_tile (XDR *xdrs, stage_tile *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 6 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->session))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->operand))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->col))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->session);
+		IXDR_PUT_LONG(buf, objp->operand);
+		IXDR_PUT_LONG(buf, objp->row);
+		IXDR_PUT_LONG(buf, objp->col);
+		IXDR_PUT_LONG(buf, objp->rows);
+		IXDR_PUT_LONG(buf, objp->cols);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 6 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->session))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->operand))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->col))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		objp->session = IXDR_GET_LONG(buf);
+		objp->operand = IXDR_GET_LONG(buf);
+		objp->row = IXDR_GET_LONG(buf);
+		objp->col = IXDR_GET_LONG(buf);
+		objp->rows = IXDR_GET_LONG(buf);
+		objp->cols = IXDR_GET_LONG(buf);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->session))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->operand))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->row))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->col))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_stage_range (XDR *xdrs, stage_range *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->session))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->row))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_stage_status (XDR *xdrs, stage_status *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->session))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_stage_rows (XDR *xdrs, stage_rows *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		 if (!xdr_int (xdrs, &objp->success))
+			 return FALSE;
+		 if (!xdr_string (xdrs, &objp->error_msg, 100))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->row);
+		IXDR_PUT_LONG(buf, objp->rows);
+		IXDR_PUT_LONG(buf, objp->cols);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		 if (!xdr_int (xdrs, &objp->success))
+			 return FALSE;
+		 if (!xdr_string (xdrs, &objp->error_msg, 100))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		objp->row = IXDR_GET_LONG(buf);
+		objp->rows = IXDR_GET_LONG(buf);
+		objp->cols = IXDR_GET_LONG(buf);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->row))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_stage_tile32 (XDR *xdrs, stage_tile32 *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 6 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->session))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->operand))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->col))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->session);
+		IXDR_PUT_LONG(buf, objp->operand);
+		IXDR_PUT_LONG(buf, objp->row);
+		IXDR_PUT_LONG(buf, objp->col);
+		IXDR_PUT_LONG(buf, objp->rows);
+		IXDR_PUT_LONG(buf, objp->cols);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE,
+			sizeof (float), (xdrproc_t) xdr_float))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 6 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->session))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->operand))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->col))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		objp->session = IXDR_GET_LONG(buf);
+		objp->operand = IXDR_GET_LONG(buf);
+		objp->row = IXDR_GET_LONG(buf);
+		objp->col = IXDR_GET_LONG(buf);
+		objp->rows = IXDR_GET_LONG(buf);
+		objp->cols = IXDR_GET_LONG(buf);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE,
+			sizeof (float), (xdrproc_t) xdr_float))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->session))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->operand))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->row))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->col))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE,
+		sizeof (float), (xdrproc_t) xdr_float))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_stage_rows32 (XDR *xdrs, stage_rows32 *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		 if (!xdr_int (xdrs, &objp->success))
+			 return FALSE;
+		 if (!xdr_string (xdrs, &objp->error_msg, 100))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->row);
+		IXDR_PUT_LONG(buf, objp->rows);
+		IXDR_PUT_LONG(buf, objp->cols);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE,
+			sizeof (float), (xdrproc_t) xdr_float))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		 if (!xdr_int (xdrs, &objp->success))
+			 return FALSE;
+		 if (!xdr_string (xdrs, &objp->error_msg, 100))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		objp->row = IXDR_GET_LONG(buf);
+		objp->rows = IXDR_GET_LONG(buf);
+		objp->cols = IXDR_GET_LONG(buf);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE,
+			sizeof (float), (xdrproc_t) xdr_float))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->row))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE,
+		sizeof (float), (xdrproc_t) xdr_float))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_handle_op (XDR *xdrs, handle_op *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_matrix_op (xdrs, &objp->op))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->first))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->second))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_handle_range (XDR *xdrs, handle_range *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->handle))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->row))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_handle_result (XDR *xdrs, handle_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->handle))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_expr_kind (XDR *xdrs, expr_kind *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_enum (xdrs, (enum_t *) objp))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_expr_node (XDR *xdrs, expr_node *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_expr_kind (xdrs, &objp->kind))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->arg))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->left))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->right))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_expr_request (XDR *xdrs, expr_request *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_array (xdrs, (char **)&objp->operands.operands_val, (u_int *) &objp->operands.operands_len, MAX_EXPR_OPERANDS,
+		sizeof (matrix), (xdrproc_t) xdr_matrix))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->nodes.nodes_val, (u_int *) &objp->nodes.nodes_len, MAX_EXPR_NODES,
+		sizeof (expr_node), (xdrproc_t) xdr_expr_node))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->keep))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_expr_result (XDR *xdrs, expr_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->handle))
+		 return FALSE;
+	 if (!xdr_matrix (xdrs, &objp->result_matrix))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_csr_matrix (XDR *xdrs, csr_matrix *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->row_ptr.row_ptr_val, (u_int *) &objp->row_ptr.row_ptr_len, MAX_ROW_PTR,
+		sizeof (int), (xdrproc_t) xdr_int))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->col_idx.col_idx_val, (u_int *) &objp->col_idx.col_idx_len, MAX_NNZ,
+		sizeof (int), (xdrproc_t) xdr_int))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->values.values_val, (u_int *) &objp->values.values_len, MAX_NNZ,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_csr_pair (XDR *xdrs, csr_pair *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_csr_matrix (xdrs, &objp->first))
+		 return FALSE;
+	 if (!xdr_csr_matrix (xdrs, &objp->second))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_csr_result (XDR *xdrs, csr_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_csr_matrix (xdrs, &objp->result))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_sparse_vector (XDR *xdrs, sparse_vector *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_csr_matrix (xdrs, &objp->a))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->x.x_val, (u_int *) &objp->x.x_len, MAX_SPARSE_DIM,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_vector_result (XDR *xdrs, vector_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->y.y_val, (u_int *) &objp->y.y_len, MAX_SPARSE_DIM,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_sparse_dense_op (XDR *xdrs, sparse_dense_op *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_csr_matrix (xdrs, &objp->a))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->handle))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_krylov_precond (XDR *xdrs, krylov_precond *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_enum (xdrs, (enum_t *) objp))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_krylov_request (XDR *xdrs, krylov_request *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->handle))
+		 return FALSE;
+	 if (!xdr_csr_matrix (xdrs, &objp->sparse))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->b.b_val, (u_int *) &objp->b.b_len, MAX_SPARSE_DIM,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->x0.x0_val, (u_int *) &objp->x0.x0_len, MAX_SPARSE_DIM,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	 if (!xdr_double (xdrs, &objp->tol))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->max_iter))
+		 return FALSE;
+	 if (!xdr_krylov_precond (xdrs, &objp->precond))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->restart))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_krylov_result (XDR *xdrs, krylov_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->converged))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->iterations))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->x.x_val, (u_int *) &objp->x.x_len, MAX_SPARSE_DIM,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->residuals.residuals_val, (u_int *) &objp->residuals.residuals_len, MAX_KRYLOV_HISTORY,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_qr_result (XDR *xdrs, qr_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_matrix (xdrs, &objp->q))
+		 return FALSE;
+	 if (!xdr_matrix (xdrs, &objp->r))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_qr_handles (XDR *xdrs, qr_handles *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		 if (!xdr_int (xdrs, &objp->success))
+			 return FALSE;
+		 if (!xdr_string (xdrs, &objp->error_msg, 100))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 5 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->q))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->r))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->k))
+				 return FALSE;
+		} else {
+			IXDR_PUT_LONG(buf, objp->q);
+			IXDR_PUT_LONG(buf, objp->r);
+			IXDR_PUT_LONG(buf, objp->rows);
+			IXDR_PUT_LONG(buf, objp->cols);
+			IXDR_PUT_LONG(buf, objp->k);
+		}
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		 if (!xdr_int (xdrs, &objp->success))
+			 return FALSE;
+		 if (!xdr_string (xdrs, &objp->error_msg, 100))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 5 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->q))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->r))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->k))
+				 return FALSE;
+		} else {
+			objp->q = IXDR_GET_LONG(buf);
+			objp->r = IXDR_GET_LONG(buf);
+			objp->rows = IXDR_GET_LONG(buf);
+			objp->cols = IXDR_GET_LONG(buf);
+			objp->k = IXDR_GET_LONG(buf);
+		}
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->q))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->r))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->k))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_byte_order (XDR *xdrs, byte_order *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_enum (xdrs, (enum_t *) objp))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_stage_tile_raw (XDR *xdrs, stage_tile_raw *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 6 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->session))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->operand))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->col))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->session);
+		IXDR_PUT_LONG(buf, objp->operand);
+		IXDR_PUT_LONG(buf, objp->row);
+		IXDR_PUT_LONG(buf, objp->col);
+		IXDR_PUT_LONG(buf, objp->rows);
+		IXDR_PUT_LONG(buf, objp->cols);
+		}
+		 if (!xdr_byte_order (xdrs, &objp->order))
+			 return FALSE;
+		 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE_BYTES))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 6 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->session))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->operand))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->col))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		objp->session = IXDR_GET_LONG(buf);
+		objp->operand = IXDR_GET_LONG(buf);
+		objp->row = IXDR_GET_LONG(buf);
+		objp->col = IXDR_GET_LONG(buf);
+		objp->rows = IXDR_GET_LONG(buf);
+		objp->cols = IXDR_GET_LONG(buf);
+		}
+		 if (!xdr_byte_order (xdrs, &objp->order))
+			 return FALSE;
+		 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE_BYTES))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->session))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->operand))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->row))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->col))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	 if (!xdr_byte_order (xdrs, &objp->order))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE_BYTES))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_stage_rows_raw (XDR *xdrs, stage_rows_raw *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		 if (!xdr_int (xdrs, &objp->success))
+			 return FALSE;
+		 if (!xdr_string (xdrs, &objp->error_msg, 100))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->row);
+		IXDR_PUT_LONG(buf, objp->rows);
+		IXDR_PUT_LONG(buf, objp->cols);
+		}
+		 if (!xdr_byte_order (xdrs, &objp->order))
+			 return FALSE;
+		 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE_BYTES))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		 if (!xdr_int (xdrs, &objp->success))
+			 return FALSE;
+		 if (!xdr_string (xdrs, &objp->error_msg, 100))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		objp->row = IXDR_GET_LONG(buf);
+		objp->rows = IXDR_GET_LONG(buf);
+		objp->cols = IXDR_GET_LONG(buf);
+		}
+		 if (!xdr_byte_order (xdrs, &objp->order))
+			 return FALSE;
+		 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE_BYTES))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->row))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	 if (!xdr_byte_order (xdrs, &objp->order))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE_BYTES))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_payload_codec (XDR *xdrs, payload_codec *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_enum (xdrs, (enum_t *) objp))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_stage_tile_packed (XDR *xdrs, stage_tile_packed *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 6 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->session))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->operand))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->col))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->session);
+		IXDR_PUT_LONG(buf, objp->operand);
+		IXDR_PUT_LONG(buf, objp->row);
+		IXDR_PUT_LONG(buf, objp->col);
+		IXDR_PUT_LONG(buf, objp->rows);
+		IXDR_PUT_LONG(buf, objp->cols);
+		}
+		 if (!xdr_byte_order (xdrs, &objp->order))
+			 return FALSE;
+		 if (!xdr_payload_codec (xdrs, &objp->codec))
+			 return FALSE;
+		 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE_BYTES))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 6 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->session))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->operand))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->col))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		objp->session = IXDR_GET_LONG(buf);
+		objp->operand = IXDR_GET_LONG(buf);
+		objp->row = IXDR_GET_LONG(buf);
+		objp->col = IXDR_GET_LONG(buf);
+		objp->rows = IXDR_GET_LONG(buf);
+		objp->cols = IXDR_GET_LONG(buf);
+		}
+		 if (!xdr_byte_order (xdrs, &objp->order))
+			 return FALSE;
+		 if (!xdr_payload_codec (xdrs, &objp->codec))
+			 return FALSE;
+		 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE_BYTES))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->session))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->operand))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->row))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->col))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	 if (!xdr_byte_order (xdrs, &objp->order))
+		 return FALSE;
+	 if (!xdr_payload_codec (xdrs, &objp->codec))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE_BYTES))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_packed_range (XDR *xdrs, packed_range *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->id))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->id);
+		IXDR_PUT_LONG(buf, objp->row);
+		IXDR_PUT_LONG(buf, objp->rows);
+		}
+		 if (!xdr_payload_codec (xdrs, &objp->accept))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->id))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+
+		} else {
+		objp->id = IXDR_GET_LONG(buf);
+		objp->row = IXDR_GET_LONG(buf);
+		objp->rows = IXDR_GET_LONG(buf);
+		}
+		 if (!xdr_payload_codec (xdrs, &objp->accept))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->id))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->row))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_payload_codec (xdrs, &objp->accept))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_stage_rows_packed (XDR *xdrs, stage_rows_packed *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		 if (!xdr_int (xdrs, &objp->success))
+			 return FALSE;
+		 if (!xdr_string (xdrs, &objp->error_msg, 100))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->row);
+		IXDR_PUT_LONG(buf, objp->rows);
+		IXDR_PUT_LONG(buf, objp->cols);
+		}
+		 if (!xdr_byte_order (xdrs, &objp->order))
+			 return FALSE;
+		 if (!xdr_payload_codec (xdrs, &objp->codec))
+			 return FALSE;
+		 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE_BYTES))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		 if (!xdr_int (xdrs, &objp->success))
+			 return FALSE;
+		 if (!xdr_string (xdrs, &objp->error_msg, 100))
+			 return FALSE;
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->row))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->rows))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->cols))
+				 return FALSE;
+
+		} else {
+		objp->row = IXDR_GET_LONG(buf);
+		objp->rows = IXDR_GET_LONG(buf);
+		objp->cols = IXDR_GET_LONG(buf);
+		}
+		 if (!xdr_byte_order (xdrs, &objp->order))
+			 return FALSE;
+		 if (!xdr_payload_codec (xdrs, &objp->codec))
+			 return FALSE;
+		 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE_BYTES))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->row))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	 if (!xdr_byte_order (xdrs, &objp->order))
+		 return FALSE;
+	 if (!xdr_payload_codec (xdrs, &objp->codec))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, MAX_TILE_BYTES))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_shm_attach_result (XDR *xdrs, shm_attach_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->segment))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->size))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_shm_operand (XDR *xdrs, shm_operand *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_quad_t (xdrs, &objp->offset))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_shm_request (XDR *xdrs, shm_request *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->segment))
+		 return FALSE;
+	 if (!xdr_matrix_op (xdrs, &objp->op))
+		 return FALSE;
+	 if (!xdr_shm_operand (xdrs, &objp->first))
+		 return FALSE;
+	 if (!xdr_shm_operand (xdrs, &objp->second))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->out))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_shm_result (XDR *xdrs, shm_result *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_int (xdrs, &objp->success))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->error_msg, 100))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->cols))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_gemm_request (XDR *xdrs, gemm_request *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 5 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->a))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->b))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->c))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->trans_a))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->trans_b))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->a);
+		IXDR_PUT_LONG(buf, objp->b);
+		IXDR_PUT_LONG(buf, objp->c);
+		IXDR_PUT_LONG(buf, objp->trans_a);
+		IXDR_PUT_LONG(buf, objp->trans_b);
+		}
+		 if (!xdr_double (xdrs, &objp->alpha))
+			 return FALSE;
+		 if (!xdr_double (xdrs, &objp->beta))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 5 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->a))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->b))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->c))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->trans_a))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->trans_b))
+				 return FALSE;
+
+		} else {
+		objp->a = IXDR_GET_LONG(buf);
+		objp->b = IXDR_GET_LONG(buf);
+		objp->c = IXDR_GET_LONG(buf);
+		objp->trans_a = IXDR_GET_LONG(buf);
+		objp->trans_b = IXDR_GET_LONG(buf);
+		}
+		 if (!xdr_double (xdrs, &objp->alpha))
+			 return FALSE;
+		 if (!xdr_double (xdrs, &objp->beta))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->a))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->b))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->c))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->trans_a))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->trans_b))
+		 return FALSE;
+	 if (!xdr_double (xdrs, &objp->alpha))
+		 return FALSE;
+	 if (!xdr_double (xdrs, &objp->beta))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_syrk_request (XDR *xdrs, syrk_request *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->a))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->c))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->trans))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_LONG(buf, objp->a);
+		IXDR_PUT_LONG(buf, objp->c);
+		IXDR_PUT_LONG(buf, objp->trans);
+		}
+		 if (!xdr_double (xdrs, &objp->alpha))
+			 return FALSE;
+		 if (!xdr_double (xdrs, &objp->beta))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_int (xdrs, &objp->a))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->c))
+				 return FALSE;
+			 if (!xdr_int (xdrs, &objp->trans))
+				 return FALSE;
+
+		} else {
+		objp->a = IXDR_GET_LONG(buf);
+		objp->c = IXDR_GET_LONG(buf);
+		objp->trans = IXDR_GET_LONG(buf);
+		}
+		 if (!xdr_double (xdrs, &objp->alpha))
+			 return FALSE;
+		 if (!xdr_double (xdrs, &objp->beta))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_int (xdrs, &objp->a))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->c))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->trans))
+		 return FALSE;
+	 if (!xdr_double (xdrs, &objp->alpha))
+		 return FALSE;
+	 if (!xdr_double (xdrs, &objp->beta))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_proc_stats (XDR *xdrs, proc_stats *objp)
+{
+	register int32_t *buf;
+
+	int i;
+	 if (!xdr_int (xdrs, &objp->proc))
+		 return FALSE;
+	 if (!xdr_string (xdrs, &objp->name, 32))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->calls))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->errors))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->bytes_in))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->bytes_out))
+		 return FALSE;
+	 if (!xdr_vector (xdrs, (char *)objp->decode_us, STATS_BUCKETS,
+		sizeof (u_quad_t), (xdrproc_t) xdr_u_quad_t))
+		 return FALSE;
+	 if (!xdr_vector (xdrs, (char *)objp->compute_us, STATS_BUCKETS,
+		sizeof (u_quad_t), (xdrproc_t) xdr_u_quad_t))
+		 return FALSE;
+	 if (!xdr_vector (xdrs, (char *)objp->encode_us, STATS_BUCKETS,
+		sizeof (u_quad_t), (xdrproc_t) xdr_u_quad_t))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->codec_raw_bytes))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->codec_packed_bytes))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->codec_us))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_server_stats (XDR *xdrs, server_stats *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_quad_t (xdrs, &objp->elapsed_ms))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->procs.procs_val, (u_int *) &objp->procs.procs_len, MAX_STATS_PROCS,
+		sizeof (proc_stats), (xdrproc_t) xdr_proc_stats))
+		 return FALSE;
+	return TRUE;
+}